@@ -0,0 +1,893 @@
+/// Compile-time benchmark of the Triton compiler.
+///
+/// Compiles a corpus of Triton IR kernels from TTIR down to assembly with the
+/// NVIDIA and AMD pipelines of the Python backends
+/// (third_party/*/backend/compiler.py), without a GPU, and reports the wall
+/// time of each pass, the peak RSS and the size of the IR of each stage as
+/// JSON, to track the throughput of the compiler across commits.
+///
+/// The pipelines below must be kept in sync with the backends. Device
+/// libraries are not linked and the PTX is not assembled, as these depend on
+/// the CUDA and ROCm installations rather than on the compiler.
+#include "./RegisterTritonDialects.h"
+
+#include "TritonAMDGPUToLLVM/TargetUtils.h"
+#include "lib/Target/LLVMIR/LLVMPasses.h"
+#include "mlir/Dialect/LLVMIR/Transforms/InlinerInterfaceImpl.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Target/LLVMIR/Dialect/Builtin/BuiltinToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Dialect/NVVM/NVVMToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Dialect/ROCDL/ROCDLToLLVMIRTranslation.h"
+#include "mlir/Target/LLVMIR/Export.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/IPO/AlwaysInliner.h"
+
+#include <chrono>
+#include <fstream>
+#include <sys/resource.h>
+
+using namespace llvm;
+
+static cl::list<std::string> InputFilenames(cl::Positional, cl::OneOrMore,
+                                            cl::desc("<TTIR kernels>"));
+
+static cl::opt<std::string> OutputFilename("o",
+                                           cl::desc("Output JSON filename"),
+                                           cl::value_desc("filename"),
+                                           cl::init("-"));
+
+static cl::list<std::string>
+    Targets("targets", cl::desc("Targets to compile for (cuda:<capability> or "
+                                "hip:<arch>)"),
+            cl::CommaSeparated, cl::list_init<std::string>({"cuda:80",
+                                                            "cuda:90",
+                                                            "hip:gfx942"}));
+
+static cl::opt<unsigned>
+    Repeat("repeat",
+           cl::desc("Compile each kernel this many times and report the "
+                    "fastest compilation"),
+           cl::init(1));
+
+// Kernels of the corpus can override these with a comment of the form
+//   // compile-bench: num-warps=8 num-stages=2 schedule-register-pressure=1
+// Options given on the command line take precedence.
+static cl::opt<int> NumWarps("num-warps", cl::desc("Number of warps"),
+                             cl::init(4));
+static cl::opt<int>
+    NumStages("num-stages",
+              cl::desc("Number of pipeline stages (default: the default of "
+                       "the backend)"),
+              cl::init(-1));
+static cl::opt<int> NumCTAs("num-ctas", cl::desc("Number of CTAs"),
+                            cl::init(1));
+static cl::opt<bool> ScheduleRegisterPressure(
+    "schedule-register-pressure",
+    cl::desc("Run the register pressure scheduler, as the "
+             "schedule_register_pressure option of the backends does"),
+    cl::init(false));
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+//===----------------------------------------------------------------------===//
+// Measurements
+//===----------------------------------------------------------------------===//
+
+// Wall time of the passes of a stage, in the order they first ran. The time of
+// a pass excludes the passes nested in it (e.g. the canonicalizer run by the
+// inliner, or the function passes of a CGSCC pass).
+class PassTimes {
+public:
+  struct Entry {
+    std::string name;
+    double ms = 0;
+    unsigned runs = 0;
+  };
+
+  void begin(StringRef name) { stack.push_back({name.str(), Clock::now()}); }
+
+  void end() {
+    assert(!stack.empty() && "unbalanced pass timing");
+    Frame frame = stack.pop_back_val();
+    double ms = elapsedMs(frame.start);
+    Entry &entry = lookup(frame.name);
+    entry.ms += ms - frame.nestedMs;
+    ++entry.runs;
+    if (!stack.empty())
+      stack.back().nestedMs += ms;
+  }
+
+  // Times `fn` as a pass named `name`.
+  template <typename Fn> auto time(StringRef name, Fn &&fn) {
+    begin(name);
+    auto result = fn();
+    end();
+    return result;
+  }
+
+  ArrayRef<Entry> getEntries() const { return entries; }
+
+private:
+  struct Frame {
+    std::string name;
+    Clock::time_point start;
+    double nestedMs = 0;
+  };
+
+  Entry &lookup(StringRef name) {
+    auto [it, inserted] = indices.try_emplace(name, entries.size());
+    if (inserted)
+      entries.push_back({name.str()});
+    return entries[it->second];
+  }
+
+  SmallVector<Frame> stack;
+  std::vector<Entry> entries;
+  StringMap<size_t> indices;
+};
+
+class MLIRPassTimer : public mlir::PassInstrumentation {
+public:
+  explicit MLIRPassTimer(PassTimes &times) : times(times) {}
+
+  void runBeforePass(mlir::Pass *pass, mlir::Operation *) override {
+    times.begin(getName(pass));
+  }
+  void runAfterPass(mlir::Pass *pass, mlir::Operation *) override {
+    times.end();
+  }
+  void runAfterPassFailed(mlir::Pass *pass, mlir::Operation *) override {
+    times.end();
+  }
+
+private:
+  // Passes are named by their command line argument, as in triton-opt.
+  static StringRef getName(mlir::Pass *pass) {
+    StringRef argument = pass->getArgument();
+    return argument.empty() ? pass->getName() : argument;
+  }
+
+  PassTimes &times;
+};
+
+void registerPassTimes(PassInstrumentationCallbacks &callbacks,
+                       PassTimes &times) {
+  // Pass managers and adaptors only run other passes, which are timed instead.
+  auto isTimed = [](StringRef pass) {
+    return !isSpecialPass(pass, {"PassManager", "PassAdaptor"});
+  };
+  callbacks.registerBeforeNonSkippedPassCallback(
+      [&times, isTimed](StringRef pass, Any) {
+        if (isTimed(pass))
+          times.begin(pass);
+      });
+  callbacks.registerAfterPassCallback(
+      [&times, isTimed](StringRef pass, Any, const PreservedAnalyses &) {
+        if (isTimed(pass))
+          times.end();
+      });
+  callbacks.registerAfterPassInvalidatedCallback(
+      [&times, isTimed](StringRef pass, const PreservedAnalyses &) {
+        if (isTimed(pass))
+          times.end();
+      });
+}
+
+// Resets the peak RSS of the process so that it can be measured per stage.
+// Without support from the OS, the peak RSS of a stage is that of the process
+// so far.
+void resetPeakRSS() {
+#ifdef __linux__
+  std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+// Returns the peak RSS of the process in KiB.
+int64_t getPeakRSSKb() {
+#ifdef __linux__
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    StringRef field(line);
+    int64_t kb;
+    if (field.consume_front("VmHWM:") &&
+        !field.trim().split(' ').first.getAsInteger(10, kb))
+      return kb;
+  }
+#endif
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+struct StageResult {
+  std::string name;
+  double wallMs = 0;
+  int64_t peakRSSKb = 0;
+  // Size of the output of the stage, printed as in the cache.
+  int64_t irBytes = 0;
+  // Operations (MLIR), instructions (LLVM IR) or lines (assembly) of the
+  // output of the stage.
+  int64_t irOps = 0;
+  PassTimes passes;
+};
+
+struct KernelOptions {
+  int numWarps;
+  int numStages;
+  int numCTAs;
+  bool scheduleRegisterPressure;
+};
+
+struct KernelResult {
+  std::string name;
+  std::string file;
+  std::string target;
+  KernelOptions options;
+  std::vector<StageResult> stages;
+  std::string error;
+
+  double getWallMs() const {
+    double ms = 0;
+    for (const StageResult &stage : stages)
+      ms += stage.wallMs;
+    return ms;
+  }
+};
+
+// Runs `fn` as a stage of the compilation of `result`. Returns the stage, or
+// null if it failed.
+template <typename Fn>
+StageResult *runStage(KernelResult &result, StringRef name, Fn &&fn) {
+  StageResult &stage = result.stages.emplace_back();
+  stage.name = name.str();
+  resetPeakRSS();
+  Clock::time_point start = Clock::now();
+  bool succeeded = fn(stage.passes);
+  stage.wallMs = elapsedMs(start);
+  stage.peakRSSKb = getPeakRSSKb();
+  if (!succeeded) {
+    result.error = ("stage " + name + " failed").str();
+    return nullptr;
+  }
+  return &stage;
+}
+
+void measureIR(StageResult &stage, mlir::ModuleOp mod) {
+  std::string text;
+  raw_string_ostream os(text);
+  mod->print(os, mlir::OpPrintingFlags().enableDebugInfo());
+  stage.irBytes = os.str().size();
+  mod->walk([&](mlir::Operation *) { ++stage.irOps; });
+}
+
+void measureIR(StageResult &stage, StringRef text, int64_t numOps) {
+  stage.irBytes = text.size();
+  stage.irOps = numOps;
+}
+
+//===----------------------------------------------------------------------===//
+// Pipelines
+//===----------------------------------------------------------------------===//
+
+mlir::LogicalResult
+runPipeline(mlir::ModuleOp mod, PassTimes &times,
+            function_ref<void(mlir::PassManager &)> buildPipeline) {
+  mlir::PassManager pm(mod.getContext());
+  pm.addInstrumentation(std::make_unique<MLIRPassTimer>(times));
+  buildPipeline(pm);
+  return pm.run(mod);
+}
+
+// make_ttir, common to both backends.
+void buildTTIRPipeline(mlir::PassManager &pm, int numWarps,
+                       int threadsPerWarp) {
+  pm.addPass(mlir::createInlinerPass());
+  pm.addPass(mlir::triton::createRewriteTensorPointerPass());
+  pm.addPass(mlir::triton::createCombineOpsPass());
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::triton::createReorderBroadcastPass());
+  pm.addPass(mlir::createCSEPass());
+  pm.addPass(mlir::createLoopInvariantCodeMotionPass());
+  pm.addPass(mlir::createSymbolDCEPass());
+  pm.addPass(mlir::triton::createLoopUnrollPass(numWarps, threadsPerWarp));
+}
+
+// CUDABackend.make_ttgir
+void buildNVIDIATTGIRPipeline(mlir::PassManager &pm, int capability,
+                              const KernelOptions &options,
+                              mlir::triton::nvidia_gpu::ClusterInfo *cluster) {
+  using namespace mlir::triton;
+  pm.addPass(createConvertTritonToTritonGPUPass(
+      "cuda:" + std::to_string(capability), options.numWarps, 32,
+      options.numCTAs));
+  pm.addPass(gpu::createTritonGPUCoalesce());
+  if (capability / 10 >= 8)
+    pm.addPass(gpu::createTritonGPUF32DotTC());
+  pm.addPass(mlir::createTritonNvidiaGPUPlanCTAPass(cluster));
+  pm.addPass(gpu::createTritonGPURemoveLayoutConversions());
+  pm.addPass(gpu::createTritonGPUOptimizeThreadLocality());
+  pm.addPass(gpu::createTritonGPUAccelerateMatmul());
+  pm.addPass(gpu::createTritonGPURemoveLayoutConversions());
+  pm.addPass(gpu::createTritonGPUOptimizeDotOperands({capability >= 80}));
+  pm.addPass(mlir::createCSEPass());
+  if (capability / 10 >= 8) {
+    pm.addPass(gpu::createTritonGPUOptimizeAccumulatorInit());
+    pm.addPass(gpu::createTritonGPUCombineTensorSelectAndIf());
+    pm.addPass(gpu::createTritonGPUPipeline({options.numStages}));
+  }
+  pm.addPass(gpu::createTritonGPUPrefetch());
+  pm.addPass(gpu::createTritonGPUOptimizeDotOperands({capability >= 80}));
+  pm.addPass(gpu::createTritonGPURemoveLayoutConversions());
+  pm.addPass(gpu::createTritonGPUForwardSharedMemory());
+  pm.addPass(gpu::createTritonGPUReduceDataDuplication());
+  pm.addPass(gpu::createTritonGPUReorderInstructions());
+  if (options.scheduleRegisterPressure)
+    pm.addPass(gpu::createTritonGPUScheduleRegisterPressure({0}));
+  pm.addPass(mlir::createCSEPass());
+  pm.addPass(mlir::createSymbolDCEPass());
+  if (capability / 10 >= 9) {
+    pm.addPass(mlir::createTritonNvidiaGPUFenceInsertionPass());
+    pm.addPass(mlir::createTritonNvidiaGPUTMALoweringPass());
+  }
+  pm.addPass(mlir::createCanonicalizerPass());
+}
+
+// CUDABackend.make_llir, up to the translation to LLVM IR.
+void buildNVIDIALLIRPipeline(mlir::PassManager &pm, int capability) {
+  using namespace mlir::triton;
+  pm.addPass(NVIDIA::createDecomposeUnsupportedConversionsPass());
+  pm.addPass(gpu::createTritonGPUCombineTensorSelectAndIf());
+  pm.addPass(mlir::createConvertSCFToCFPass());
+  pm.addPass(mlir::createConvertIndexToLLVMPass());
+  pm.addPass(gpu::createAllocateSharedMemoryPass());
+  pm.addPass(createConvertTritonGPUToLLVMPass(capability));
+  pm.addPass(createConvertNVGPUToLLVMPass());
+  pm.addPass(mlir::createArithToLLVMConversionPass());
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::createCSEPass());
+  pm.addPass(mlir::createSymbolDCEPass());
+  pm.addPass(mlir::createLLVMDIScopePass());
+}
+
+bool hasMatrixCoreFeature(StringRef arch) {
+  using mlir::triton::AMD::ISAFamily;
+  switch (mlir::triton::AMD::deduceISAFamily(arch)) {
+  case ISAFamily::CDNA1:
+  case ISAFamily::CDNA2:
+  case ISAFamily::CDNA3:
+  case ISAFamily::RDNA3:
+    return true;
+  default:
+    return false;
+  }
+}
+
+// HIPBackend.make_ttgir, after the conversion to TritonGPU which the backend
+// runs with its own pass manager.
+void buildAMDTTGIRPipeline(mlir::PassManager &pm, StringRef arch,
+                           const KernelOptions &options) {
+  using namespace mlir::triton;
+  bool matrixCore = hasMatrixCoreFeature(arch);
+  pm.addPass(gpu::createTritonGPUCoalesce());
+  pm.addPass(gpu::createTritonGPURemoveLayoutConversions());
+  pm.addPass(gpu::createTritonGPUOptimizeThreadLocality());
+  pm.addPass(mlir::createTritonAMDGPUAccelerateMatmulPass(
+      arch.str(), /*matrixInstructionSize=*/0, /*kpack=*/1));
+  pm.addPass(gpu::createTritonGPURemoveLayoutConversions());
+  pm.addPass(mlir::createTritonAMDGPUOptimizeEpiloguePass());
+  pm.addPass(gpu::createTritonGPUOptimizeDotOperands({true}));
+  if (matrixCore) {
+    pm.addPass(mlir::createTritonAMDGPUStreamPipelineV2Pass(options.numStages));
+    pm.addPass(mlir::createCanonicalizerPass());
+  }
+  pm.addPass(createInsertInstructionSchedHintsPass());
+  pm.addPass(gpu::createTritonGPUOptimizeDotOperands({true}));
+  pm.addPass(gpu::createTritonGPURemoveLayoutConversions());
+  pm.addPass(gpu::createTritonGPUForwardSharedMemory());
+  pm.addPass(gpu::createTritonGPUReduceDataDuplication());
+  if (matrixCore) {
+    pm.addPass(mlir::createTritonAMDGPUReorderInstructionsPass());
+    if (options.scheduleRegisterPressure)
+      pm.addPass(gpu::createTritonGPUScheduleRegisterPressure({0}));
+  }
+  pm.addPass(mlir::createTritonAMDGPUCanonicalizePointersPass());
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::createCSEPass());
+  pm.addPass(mlir::createSymbolDCEPass());
+}
+
+// HIPBackend.make_llir, up to the translation to LLVM IR.
+void buildAMDLLIRPipeline(mlir::PassManager &pm, StringRef arch) {
+  using namespace mlir::triton;
+  pm.addPass(AMD::createDecomposeUnsupportedConversionsPass(arch));
+  pm.addPass(AMD::createOptimizeLDSUsagePass(arch, 0));
+  pm.addPass(mlir::createConvertSCFToCFPass());
+  pm.addPass(mlir::createConvertIndexToLLVMPass());
+  pm.addPass(gpu::createAllocateSharedMemoryPass());
+  pm.addPass(createConvertTritonAMDGPUToLLVMPass(arch, /*ftz=*/true));
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::createCSEPass());
+  pm.addPass(mlir::createConvertControlFlowToLLVMPass());
+  pm.addPass(mlir::createArithToLLVMConversionPass());
+  pm.addPass(mlir::createCanonicalizerPass());
+  pm.addPass(mlir::createCSEPass());
+  pm.addPass(mlir::createSymbolDCEPass());
+  pm.addPass(createLowerInstructionSchedHintsPass("default"));
+  pm.addPass(mlir::createLLVMDIScopePass());
+  pm.addPass(createConvertBuiltinFuncToLLVMPass());
+}
+
+std::unique_ptr<TargetMachine> createTargetMachine(StringRef triple,
+                                                   StringRef proc,
+                                                   StringRef features) {
+  std::string error;
+  const Target *target = TargetRegistry::lookupTarget(triple.str(), error);
+  if (!target) {
+    errs() << "target lookup error: " << error << "\n";
+    return nullptr;
+  }
+  TargetOptions options;
+  options.AllowFPOpFusion = FPOpFusion::Fast;
+  options.NoNaNsFPMath = true;
+  options.TrapUnreachable = true;
+  return std::unique_ptr<TargetMachine>(target->createTargetMachine(
+      triple, proc, features, options, Reloc::PIC_, std::nullopt,
+      CodeGenOptLevel::Aggressive));
+}
+
+// translate_to_asm in python/src/llvm.cc. Code generation is timed as a whole.
+bool emitAssembly(Module &mod, TargetMachine &machine, PassTimes &times,
+                  std::string &assembly) {
+  for (Function &fn : mod.functions())
+    if (!fn.hasFnAttribute(Attribute::NoInline))
+      fn.addFnAttr(Attribute::AlwaysInline);
+  times.time("always-inline", [&] {
+    legacy::PassManager pm;
+    pm.add(createAlwaysInlinerLegacyPass());
+    pm.add(createVerifierPass());
+    return pm.run(mod);
+  });
+  mod.setDataLayout(machine.createDataLayout());
+  return times.time("codegen", [&] {
+    raw_string_ostream stream(assembly);
+    buffer_ostream pstream(stream);
+    legacy::PassManager pm;
+    if (machine.addPassesToEmitFile(pm, pstream, nullptr,
+                                    CodeGenFileType::AssemblyFile))
+      return false;
+    pm.run(mod);
+    return true;
+  });
+}
+
+//===----------------------------------------------------------------------===//
+// Compilation
+//===----------------------------------------------------------------------===//
+
+struct Kernel {
+  std::string name;
+  std::string file;
+  std::string source;
+  KernelOptions options;
+};
+
+struct BenchTarget {
+  std::string name;
+  std::string backend;
+  std::string arch;
+};
+
+// The LLVM side of a target: triple, processor and features, and how the
+// backend prepares the module before optimizing it.
+struct LLVMTarget {
+  std::string triple;
+  std::string proc;
+  std::string features;
+  std::string asmStage;
+  function_ref<void(Module &)> prepare;
+};
+
+std::optional<BenchTarget> parseTarget(StringRef name) {
+  auto [backend, arch] = name.split(':');
+  int capability;
+  if ((backend == "cuda" && !arch.getAsInteger(10, capability)) ||
+      (backend == "hip" && arch.starts_with("gfx")))
+    return BenchTarget{name.str(), backend.str(), arch.str()};
+  return std::nullopt;
+}
+
+// Threads per warp: 32 on CUDA, and AMDBackend.warp_size on HIP, where RDNA
+// runs wave32 and CDNA wave64.
+int getWarpSize(const BenchTarget &target) {
+  StringRef arch = target.arch;
+  if (target.backend == "cuda" || arch.starts_with("gfx10") ||
+      arch.starts_with("gfx11") || arch.starts_with("gfx12"))
+    return 32;
+  return 64;
+}
+
+void parseDirectives(StringRef source, KernelOptions &options) {
+  SmallVector<StringRef> lines;
+  source.split(lines, '\n');
+  for (StringRef line : lines) {
+    line = line.trim();
+    if (!line.consume_front("// compile-bench:"))
+      continue;
+    SmallVector<StringRef> fields;
+    line.split(fields, ' ', /*MaxSplit=*/-1, /*KeepEmpty=*/false);
+    for (StringRef field : fields) {
+      auto [key, value] = field.split('=');
+      int intValue;
+      if (value.getAsInteger(10, intValue))
+        continue;
+      if (key == "num-warps")
+        options.numWarps = intValue;
+      else if (key == "num-stages")
+        options.numStages = intValue;
+      else if (key == "num-ctas")
+        options.numCTAs = intValue;
+      else if (key == "schedule-register-pressure")
+        options.scheduleRegisterPressure = intValue != 0;
+    }
+  }
+}
+
+std::optional<Kernel> loadKernel(StringRef path) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    errs() << path << ": " << buffer.getError().message() << "\n";
+    return std::nullopt;
+  }
+  Kernel kernel;
+  kernel.name = sys::path::stem(path).str();
+  kernel.file = path.str();
+  kernel.source = (*buffer)->getBuffer().str();
+  kernel.options = {NumWarps, NumStages, NumCTAs, ScheduleRegisterPressure};
+  parseDirectives(kernel.source, kernel.options);
+  if (NumWarps.getNumOccurrences())
+    kernel.options.numWarps = NumWarps;
+  if (NumStages.getNumOccurrences())
+    kernel.options.numStages = NumStages;
+  if (NumCTAs.getNumOccurrences())
+    kernel.options.numCTAs = NumCTAs;
+  if (ScheduleRegisterPressure.getNumOccurrences())
+    kernel.options.scheduleRegisterPressure = ScheduleRegisterPressure;
+  return kernel;
+}
+
+// Compiles the LLVM dialect module `mod` to assembly: translation to LLVM IR,
+// optimization and code generation, as the llir and ptx/amdgcn stages of the
+// backends do.
+void compileLLVM(mlir::ModuleOp mod, KernelResult &result,
+                 const LLVMTarget &target,
+                 function_ref<void(mlir::PassManager &)> buildLLIRPipeline) {
+  std::string llvmIR;
+  int64_t numInstructions = 0;
+  StageResult *stage = runStage(result, "llir", [&](PassTimes &times) {
+    if (failed(runPipeline(mod, times, buildLLIRPipeline)))
+      return false;
+    LLVMContext llvmContext;
+    std::unique_ptr<Module> llvmMod = times.time("translate-to-llvmir", [&] {
+      return mlir::translateModuleToLLVMIR(mod, llvmContext);
+    });
+    std::unique_ptr<TargetMachine> machine =
+        createTargetMachine(target.triple, target.proc, target.features);
+    if (!llvmMod || !machine)
+      return false;
+    llvmMod->setTargetTriple(target.triple);
+    llvmMod->setDataLayout(machine->createDataLayout());
+    target.prepare(*llvmMod);
+    // optimize_module in python/src/llvm.cc.
+    PassInstrumentationCallbacks callbacks;
+    registerPassTimes(callbacks, times);
+    optimizeModule(*llvmMod, OptimizationLevel::O3, machine.get(), &callbacks);
+    llvmIR = times.time("print-llvmir", [&] {
+      std::string text;
+      raw_string_ostream os(text);
+      os << *llvmMod;
+      return os.str();
+    });
+    numInstructions = llvmMod->getInstructionCount();
+    return true;
+  });
+  if (!stage)
+    return;
+  measureIR(*stage, llvmIR, numInstructions);
+
+  std::string assembly;
+  stage = runStage(result, target.asmStage, [&](PassTimes &times) {
+    LLVMContext llvmContext;
+    SMDiagnostic error;
+    std::unique_ptr<Module> llvmMod = times.time("parse-llvmir", [&] {
+      return parseIR(MemoryBufferRef(llvmIR, "llir"), error, llvmContext);
+    });
+    if (!llvmMod) {
+      error.print("triton-compile-bench", errs());
+      return false;
+    }
+    std::unique_ptr<TargetMachine> machine =
+        createTargetMachine(target.triple, target.proc, target.features);
+    if (!machine)
+      return false;
+    ScopedOptionOverrides flags;
+    if (machine->getTargetTriple().isNVPTX())
+      flags.set("nvptx-short-ptr", "true");
+    return emitAssembly(*llvmMod, *machine, times, assembly);
+  });
+  if (stage)
+    measureIR(*stage, assembly, StringRef(assembly).count('\n'));
+}
+
+void compileNVIDIA(mlir::ModuleOp mod, KernelResult &result,
+                   const BenchTarget &target) {
+  int capability = std::stoi(target.arch);
+  KernelOptions options = result.options;
+  if (options.numStages < 0)
+    options.numStages = 3;
+  result.options = options;
+
+  mlir::triton::nvidia_gpu::ClusterInfo cluster;
+  StageResult *stage = runStage(result, "ttgir", [&](PassTimes &times) {
+    return succeeded(runPipeline(mod, times, [&](mlir::PassManager &pm) {
+      buildNVIDIATTGIRPipeline(pm, capability, options, &cluster);
+    }));
+  });
+  if (!stage)
+    return;
+  measureIR(*stage, mod);
+
+  LLVMTarget llvmTarget;
+  llvmTarget.triple = "nvptx64-nvidia-cuda";
+  llvmTarget.proc =
+      capability == 90 ? "sm_90a" : "sm_" + std::to_string(capability);
+  llvmTarget.features = "+ptx83";
+  llvmTarget.asmStage = "ptx";
+  auto prepare = [](Module &llvmMod) {
+    // set_nvvm_reflect_ftz in the backend.
+    llvmMod.addModuleFlag(Module::Override, "nvvm-reflect-ftz", 1);
+  };
+  llvmTarget.prepare = prepare;
+  compileLLVM(mod, result, llvmTarget, [&](mlir::PassManager &pm) {
+    buildNVIDIALLIRPipeline(pm, capability);
+  });
+}
+
+void compileAMD(mlir::ModuleOp mod, KernelResult &result,
+                const BenchTarget &target) {
+  StringRef arch = target.arch;
+  int warpSize = getWarpSize(target);
+  KernelOptions options = result.options;
+  if (options.numStages < 0)
+    options.numStages = 2;
+  result.options = options;
+
+  StageResult *stage = runStage(result, "ttgir", [&](PassTimes &times) {
+    if (failed(runPipeline(mod, times, [&](mlir::PassManager &pm) {
+          pm.addPass(mlir::triton::createConvertTritonToTritonGPUPass(
+              "hip:" + target.arch, options.numWarps, warpSize,
+              options.numCTAs));
+        })))
+      return false;
+    return succeeded(runPipeline(mod, times, [&](mlir::PassManager &pm) {
+      buildAMDTTGIRPipeline(pm, arch, options);
+    }));
+  });
+  if (!stage)
+    return;
+  measureIR(*stage, mod);
+
+  LLVMTarget llvmTarget;
+  llvmTarget.triple = "amdgcn-amd-amdhsa";
+  llvmTarget.proc = target.arch;
+  llvmTarget.asmStage = "amdgcn";
+  auto prepare = [&](Module &llvmMod) {
+    // The kernel is the first function defined in the module.
+    for (Function &fn : llvmMod) {
+      if (fn.isDeclaration())
+        continue;
+      fn.setCallingConv(CallingConv::AMDGPU_KERNEL);
+      fn.addFnAttr("amdgpu-flat-work-group-size",
+                   "1," + std::to_string(options.numWarps * warpSize));
+      fn.addFnAttr("amdgpu-waves-per-eu", "1");
+      fn.addFnAttr("denormal-fp-math-f32", "ieee");
+      for (Argument &arg : fn.args())
+        if (!arg.hasByRefAttr() && !arg.hasNestAttr())
+          arg.addAttr(Attribute::InReg);
+      break;
+    }
+  };
+  llvmTarget.prepare = prepare;
+  compileLLVM(mod, result, llvmTarget, [&](mlir::PassManager &pm) {
+    buildAMDLLIRPipeline(pm, arch);
+  });
+}
+
+// Compiles `kernel` for `target` in a fresh context, as `triton.compile` does.
+KernelResult compileKernel(const mlir::DialectRegistry &registry,
+                           const Kernel &kernel, const BenchTarget &target) {
+  KernelResult result;
+  result.name = kernel.name;
+  result.file = kernel.file;
+  result.target = target.name;
+  result.options = kernel.options;
+
+  mlir::MLIRContext context(registry, mlir::MLIRContext::Threading::DISABLED);
+  context.loadAllAvailableDialects();
+  mlir::OwningOpRef<mlir::ModuleOp> mod =
+      mlir::parseSourceString<mlir::ModuleOp>(kernel.source, &context,
+                                              kernel.file);
+  if (!mod) {
+    result.error = "failed to parse " + kernel.file;
+    return result;
+  }
+
+  StageResult *stage = runStage(result, "ttir", [&](PassTimes &times) {
+    return succeeded(runPipeline(*mod, times, [&](mlir::PassManager &pm) {
+      buildTTIRPipeline(pm, result.options.numWarps, getWarpSize(target));
+    }));
+  });
+  if (!stage)
+    return result;
+  measureIR(*stage, *mod);
+
+  if (target.backend == "cuda")
+    compileNVIDIA(*mod, result, target);
+  else
+    compileAMD(*mod, result, target);
+  return result;
+}
+
+void writeJSON(raw_ostream &os, ArrayRef<KernelResult> results) {
+  json::OStream json(os, /*IndentSize=*/2);
+  json.object([&] {
+    json.attributeArray("kernels", [&] {
+      for (const KernelResult &kernel : results) {
+        json.object([&] {
+          json.attribute("name", kernel.name);
+          json.attribute("file", kernel.file);
+          json.attribute("target", kernel.target);
+          json.attribute("num_warps", kernel.options.numWarps);
+          json.attribute("num_stages", kernel.options.numStages);
+          json.attribute("num_ctas", kernel.options.numCTAs);
+          json.attribute("schedule_register_pressure",
+                         kernel.options.scheduleRegisterPressure);
+          json.attribute("wall_ms", kernel.getWallMs());
+          if (!kernel.error.empty())
+            json.attribute("error", kernel.error);
+          json.attributeArray("stages", [&] {
+            for (const StageResult &stage : kernel.stages) {
+              json.object([&] {
+                json.attribute("name", stage.name);
+                json.attribute("wall_ms", stage.wallMs);
+                json.attribute("peak_rss_kb", stage.peakRSSKb);
+                json.attribute("ir_bytes", stage.irBytes);
+                json.attribute("ir_ops", stage.irOps);
+                json.attributeArray("passes", [&] {
+                  for (const PassTimes::Entry &pass :
+                       stage.passes.getEntries()) {
+                    json.object([&] {
+                      json.attribute("name", pass.name);
+                      json.attribute("wall_ms", pass.ms);
+                      json.attribute("runs", pass.runs);
+                    });
+                  }
+                });
+              });
+            }
+          });
+        });
+      }
+    });
+  });
+  os << "\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  InitLLVM x(argc, argv);
+
+  LLVMInitializeNVPTXTargetInfo();
+  LLVMInitializeNVPTXTarget();
+  LLVMInitializeNVPTXTargetMC();
+  LLVMInitializeNVPTXAsmPrinter();
+  LLVMInitializeAMDGPUTargetInfo();
+  LLVMInitializeAMDGPUTarget();
+  LLVMInitializeAMDGPUTargetMC();
+  LLVMInitializeAMDGPUAsmPrinter();
+
+  cl::ParseCommandLineOptions(argc, argv,
+                              "Triton compile-time benchmark\n\n"
+                              "Compiles TTIR kernels to assembly and reports "
+                              "the time spent in each pass as JSON.\n");
+
+  mlir::DialectRegistry registry;
+  registerTritonDialects(registry);
+  mlir::registerBuiltinDialectTranslation(registry);
+  mlir::registerLLVMDialectTranslation(registry);
+  mlir::registerNVVMDialectTranslation(registry);
+  mlir::registerROCDLDialectTranslation(registry);
+  mlir::LLVM::registerInlinerInterface(registry);
+
+  std::vector<BenchTarget> targets;
+  for (StringRef name : Targets) {
+    std::optional<BenchTarget> target = parseTarget(name);
+    if (!target) {
+      errs() << "invalid target '" << name
+             << "', expected cuda:<capability> or hip:<arch>\n";
+      return 1;
+    }
+    targets.push_back(*target);
+  }
+
+  std::vector<Kernel> kernels;
+  for (StringRef path : InputFilenames) {
+    std::optional<Kernel> kernel = loadKernel(path);
+    if (!kernel)
+      return 1;
+    kernels.push_back(std::move(*kernel));
+  }
+
+  std::vector<KernelResult> results;
+  bool failed = false;
+  for (const Kernel &kernel : kernels) {
+    for (const BenchTarget &target : targets) {
+      std::optional<KernelResult> best;
+      for (unsigned i = 0; i < std::max(Repeat.getValue(), 1u); ++i) {
+        KernelResult result = compileKernel(registry, kernel, target);
+        bool done = !result.error.empty();
+        if (!best || done || result.getWallMs() < best->getWallMs())
+          best = std::move(result);
+        if (done)
+          break;
+      }
+      if (!best->error.empty()) {
+        errs() << kernel.file << " (" << target.name << "): " << best->error
+               << "\n";
+        failed = true;
+      }
+      results.push_back(std::move(*best));
+    }
+  }
+
+  std::error_code ec;
+  ToolOutputFile output(OutputFilename, ec, sys::fs::OF_Text);
+  if (ec) {
+    errs() << OutputFilename << ": " << ec.message() << "\n";
+    return 1;
+  }
+  writeJSON(output.os(), results);
+  output.keep();
+  return failed ? 1 : 0;
+}
@@ -5,11 +5,13 @@
 #include "mlir/IR/MLIRContext.h"
 
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
@@ -28,6 +30,8 @@ using namespace mlir;
 //
 // triton-tensor-layout -i input.mlir -t "tensor<1x128x128xf16>" -o output.txt -alias-names="blocked,mma" -use-hw-view
 //
+// triton-tensor-layout -l "#triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [32, 1], warpsPerCTA = [1, 4], order = [0, 1]}>" -t "tensor<32x32xf32>" -shared-layout "#triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 32, order = [1, 0]}>"
+//
 // An input file usually looks like:
 // '''
 // #mma = #triton_gpu.amd_mfma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [1, 1, 8], instrShape = [32, 32], isTransposed = false}>
@@ -71,6 +75,13 @@ static cl::opt<bool> UseHWPointOfView(
         "tensor's perspective (e.g., each element maps to xxx thread)."),
     cl::init(false), cl::cat(PrinterCategory));
 
+static cl::opt<std::string> SharedLayoutStr(
+    "shared-layout",
+    cl::desc("Shared memory layout attribute in string. If given, also print "
+             "the bank conflicts of moving the tensor between each printed "
+             "layout and this shared layout."),
+    cl::value_desc("layout-string"), cl::init(""), cl::cat(PrinterCategory));
+
 static cl::opt<std::string> TensorStr(
     "t", cl::desc("Tensor shape and element type (e.g., tensor<2x2xf32>)"),
     cl::init(""), cl::value_desc("tensor-type"), cl::cat(PrinterCategory));
@@ -93,6 +104,34 @@ LogicalResult layoutPrint(RankedTensorType tensorType, raw_ostream &os) {
   return failure();
 }
 
+LogicalResult bankConflictsPrint(RankedTensorType tensorType,
+                                raw_ostream &os) {
+  if (SharedLayoutStr.empty())
+    return success();
+
+  mlir::Attribute sharedLayout =
+      parseAttribute(SharedLayoutStr, tensorType.getContext());
+  if (!sharedLayout) {
+    llvm::errs() << "Invalid shared layout attribute: " << SharedLayoutStr
+                 << "\n";
+    return failure();
+  }
+
+  auto conflicts = triton::gpu::getBankConflicts(tensorType, sharedLayout);
+  if (!conflicts) {
+    llvm::errs() << "Can't analyze bank conflicts between "
+                 << tensorType.getEncoding() << " and " << sharedLayout
+                 << "\n";
+    return failure();
+  }
+  os << "Bank conflicts with " << sharedLayout << ": at worst "
+     << conflicts->maxDegree << "-way, on average "
+     << llvm::formatv("{0:F2}", conflicts->avgDegree) << "-way over "
+     << conflicts->numAccesses << " accesses of " << conflicts->vecElems
+     << " elements per thread\n";
+  return success();
+}
+
 LogicalResult printLayoutFromFile(MLIRContext *context, StringRef filename,
                                   ArrayRef<std::string> names,
                                   TensorType tensorTy, raw_string_ostream &ss) {
@@ -123,7 +162,9 @@ LogicalResult printLayoutFromFile(MLIRContext *context, StringRef filename,
     auto rankedTensorTy = RankedTensorType::get(
         tensorTy.getShape(), tensorTy.getElementType(), attr);
 
-    return layoutPrint(rankedTensorTy, ss);
+    if (failed(layoutPrint(rankedTensorTy, ss)))
+      return failure();
+    return bankConflictsPrint(rankedTensorTy, ss);
   };
 
   if (names.empty())
@@ -169,7 +210,9 @@ LogicalResult printLayoutFromString(MLIRContext *context,
 
   ss << "Print layout attribute: " << layout << "\n";
 
-  return layoutPrint(rankedTensorTy, ss);
+  if (failed(layoutPrint(rankedTensorTy, ss)))
+    return failure();
+  return bankConflictsPrint(rankedTensorTy, ss);
 }
 
 //===--------------------------------------------------------------------===//
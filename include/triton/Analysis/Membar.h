@@ -2,6 +2,7 @@
 #define TRITON_ANALYSIS_MEMBAR_H
 
 #include "Allocation.h"
+#include "mlir/IR/Dominance.h"
 #include "llvm/ADT/SmallPtrSet.h"
 
 #include <set>
@@ -128,9 +129,21 @@ private:
 
   void insertBarrier(Operation *operation, OpBuilder *builder);
 
+  /// Collects the ops marking the entry of the partitions of a
+  /// warp-specialized function.
+  void collectPartitionMarkers(FunctionOpInterface funcOp);
+
+  /// Returns the [bar_id, num_threads] of the named barrier the warps running
+  /// `operation` synchronize through.
+  DenseI32ArrayAttr getPartitionBarrier(Operation *operation);
+
 private:
   Allocation *allocation = nullptr;
   MembarFilterFn filter = nullptr;
+  /// Partition entries of a warp-specialized function, and the dominance
+  /// info that tells which partition an op belongs to.
+  SmallVector<Operation *> partitionMarkers;
+  std::unique_ptr<DominanceInfo> partitionDominance;
 };
 
 /// Postorder traversal on the callgraph to insert membar instructions
@@ -73,6 +73,11 @@ public:
 
   bool isReduceWithinCTA();
 
+  // The number of CTAs of the cluster holding distinct slices of the reduced
+  // axis. Their partial results are combined through distributed shared
+  // memory.
+  unsigned getCTASplitNumOnAxis();
+
   unsigned getAxis() { return axis; }
 
 private:
@@ -152,6 +157,126 @@ private:
   SmallVector<Type> srcElementTypes;
 };
 
+// Helper for the lowering of tt.sort and tt.topk. Both are lowered with a
+// bitonic sorting network along the axis: stages whose partner is in the same
+// thread are compare-and-swaps between registers, stages whose partner is in
+// another lane of the same warp use shuffleXor, and only stages whose partner
+// is in another warp go through shared memory.
+class SortLoweringHelper {
+public:
+  // The hardware index bit holding one bit of an element's position along the
+  // sort axis: bit `bit` of the `inDim` ("register", "lane" or "warp") index.
+  struct AxisBit {
+    StringAttr inDim;
+    int32_t bit;
+  };
+
+  explicit SortLoweringHelper(triton::SortOp op);
+  explicit SortLoweringHelper(triton::TopKOp op);
+
+  // Return true if the lowering of the op is supported, i.e. every bit of the
+  // position along the axis is held by a single register, lane or warp bit.
+  bool isSupported();
+  // Return the hardware location of each bit of the position along the axis,
+  // from the least to the most significant one.
+  ArrayRef<AxisBit> getAxisBits();
+  // Return true if no stage of the sorting network exchanges elements between
+  // warps.
+  bool isWarpSynchronous();
+  // Return the number of elements of the scratch space needed for one
+  // operand. The scratch space holds the whole per-CTA tensor.
+  unsigned getScratchSizeInElems();
+  // Return the size of the scratch space needed for the lowering.
+  unsigned getScratchSizeInBytes();
+
+  Location getLoc() { return op->getLoc(); }
+  unsigned getAxis() { return axis; }
+  // Return the number of elements to keep along the axis for tt.topk.
+  std::optional<unsigned> getK() { return k; }
+  llvm::ArrayRef<int64_t> getShape() { return srcShape; }
+  unsigned getNumOperands() { return srcElementTypes.size(); }
+  SmallVector<Type> getElementTypes() { return srcElementTypes; }
+  Attribute getSrcLayout() { return srcEncoding; }
+  Region &getComparator() { return *comparator; }
+
+private:
+  void init(ArrayRef<RankedTensorType> inputTypes);
+
+  Operation *op;
+  Region *comparator;
+  unsigned axis;
+  std::optional<unsigned> k;
+  Attribute srcEncoding;
+  llvm::ArrayRef<int64_t> srcShape;
+  SmallVector<Type> srcElementTypes;
+  std::optional<SmallVector<AxisBit>> axisBits;
+};
+
+// Helper for the lowering of tt.gather. The strategy is picked from the linear
+// layouts of the source and the indices:
+//   - ThreadLocal: every source element an index can point to is held by the
+//     thread holding the index, so the gather is a select between registers;
+//   - WarpLocal: every such element is held by the same warp, so the gather
+//     is a select between the results of shuffleIdx;
+//   - SharedMemory: the source is written to shared memory and read back at
+//     the gathered positions.
+class GatherLoweringHelper {
+public:
+  enum class Strategy { ThreadLocal, WarpLocal, SharedMemory };
+  using AxisBit = SortLoweringHelper::AxisBit;
+
+  explicit GatherLoweringHelper(triton::GatherOp op);
+
+  // Return true if the lowering of the op is supported. Gathers whose source
+  // and indices are not split across CTAs in the same way are not.
+  bool isSupported();
+  Strategy getStrategy() { return strategy; }
+  // Return the hardware location of each bit of the position along the axis
+  // in the source. Only valid for the ThreadLocal and WarpLocal strategies.
+  ArrayRef<AxisBit> getSrcAxisBits() { return srcAxisBits; }
+  // Return the size of the scratch space needed for the lowering.
+  unsigned getScratchSizeInBytes();
+
+private:
+  triton::GatherOp op;
+  bool supported = false;
+  Strategy strategy = Strategy::SharedMemory;
+  SmallVector<AxisBit> srcAxisBits;
+};
+
+// Helper for the lowering of tt.histogram. Two strategies are available:
+//   - WarpBallot: every warp computes its histogram with one ballot per bit of
+//     the bin index, and the warp histograms are combined with shared memory
+//     atomics. The cost per element grows with the number of bins.
+//   - Privatized: every warp owns a private histogram in shared memory that
+//     its threads update with atomics; the private histograms are then merged
+//     with a tree reduction. The cost per element does not depend on the
+//     number of bins, but the scratch space grows with the number of warps.
+// The strategy with the lowest estimated cost is picked.
+class HistogramLoweringHelper {
+public:
+  enum class Strategy { WarpBallot, Privatized };
+
+  explicit HistogramLoweringHelper(triton::HistogramOp op);
+
+  Strategy getStrategy();
+  // Return the number of bins, padded to at least one bin per lane.
+  unsigned getNumBins() { return numBins; }
+  unsigned getNumWarps() { return numWarps; }
+  unsigned getThreadsPerWarp() { return threadsPerWarp; }
+  // Return the estimated number of instructions per thread of each strategy.
+  unsigned getWarpBallotCost();
+  unsigned getPrivatizedCost();
+  // Return the size of the scratch space needed for the lowering.
+  unsigned getScratchSizeInBytes();
+
+private:
+  triton::HistogramOp op;
+  unsigned numBins;
+  unsigned numWarps;
+  unsigned threadsPerWarp;
+};
+
 // Decomposes a reshape into simpler pieces.
 //
 // As an example, suppose we have a reshape from [4,4,4] to [2,2,8,2].
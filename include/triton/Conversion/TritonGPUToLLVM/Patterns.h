@@ -17,6 +17,12 @@ void decomposeBlockedToDotLayoutConversion(ModuleOp module);
 /// |module| op.
 void decomposeSplatOpToSharedLayoutConversion(ModuleOp module);
 
+/// Converts the operands of `tt.sort` and `tt.topk` ops whose layout the
+/// sorting network cannot handle (see SortLoweringHelper::isSupported) to a
+/// blocked layout that keeps the sorted axis within a CTA, and converts the
+/// results back.
+void decomposeUnsupportedSortLayouts(ModuleOp module);
+
 /// Replaces `mma/mfma -> dot_op` with `mma/mfma -> blocked -> dot_op` in the
 /// given |module| op, but bypass the decomposition if |shortcutFn| returns
 /// true.
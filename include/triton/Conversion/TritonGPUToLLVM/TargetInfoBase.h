@@ -13,6 +13,13 @@ public:
   virtual Value ballot(RewriterBase &rewriter, Location loc, Type type,
                        Value cmp) const = 0;
 
+  // Synchronize all threads of all CTAs in the cluster. Shared memory writes
+  // issued before the barrier are visible to loadDShared from any CTA of the
+  // cluster after it.
+  //
+  // A target that does not support CTA clusters will assert.
+  virtual void barrierCluster(RewriterBase &rewriter, Location loc) const = 0;
+
   // Store/load a value from shared memory, either in the same CTA or, if
   // `ctaId` is non-nullopt, in another CTA in the same group.
   //
@@ -1173,8 +1173,54 @@ emitBaseIndexForLayout(Location loc, RewriterBase &rewriter,
   return idx;
 }
 
+// Function-scoped cache for emitIndices. While an instance is alive on the
+// current thread, the index math of each (function, layout, shape,
+// withCTAOffset) is emitted once at the function entry and its values are
+// reused by every later emitIndices call, whichever pattern makes it.
+//
+// A pattern that fails after requesting indices has its ops rolled back,
+// cached ones included. Each entry is therefore held by an anchor op that the
+// conversion does not track, and a stale entry is re-emitted on its next use.
+// Staleness is detected through the anchor's operands only: this relies on
+// the dialect conversion's CreateOperationRewrite::rollback dropping all uses
+// of an op before erasing it, which nulls the anchor's operands. A rewriter
+// that erases ops without dropping their uses would leave dangling entries.
+// test/Conversion/index-cache-rollback.mlir covers this. Anchors are erased
+// with the cache.
+class IndexCache {
+public:
+  IndexCache() : prev(current) { current = this; }
+  ~IndexCache() {
+    for (auto &it : indices)
+      it.second.anchor->erase();
+    current = prev;
+  }
+  IndexCache(const IndexCache &) = delete;
+  IndexCache &operator=(const IndexCache &) = delete;
+
+  // Returns the innermost live cache on this thread, or null.
+  static IndexCache *getCurrent() { return current; }
+
+  struct Entry {
+    SmallVector<SmallVector<Value>> indices;
+    Operation *anchor;
+
+    bool isRolledBack() const {
+      return llvm::any_of(anchor->getOperands(), [](Value v) { return !v; });
+    }
+  };
+
+  using Key = std::tuple<Operation * /*function*/, Attribute /*layout*/,
+                         Type /*shape*/, unsigned /*withCTAOffset*/>;
+  DenseMap<Key, Entry> indices;
+
+private:
+  static thread_local IndexCache *current;
+  IndexCache *prev;
+};
+
 // Emit indices calculation within each ConversionPattern, and returns a
-// [elemsPerThread X rank] index matrix.
+// [elemsPerThread X rank] index matrix. Uses the current IndexCache if any.
 SmallVector<SmallVector<Value>>
 emitIndices(Location loc, RewriterBase &rewriter, const TargetInfoBase &target,
             Attribute layout, RankedTensorType type, bool withCTAOffset);
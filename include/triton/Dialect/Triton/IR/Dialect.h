@@ -70,6 +70,15 @@ public:
   inferSplitOpEncoding(Attribute srcEnc, Attribute &dstEnc,
                        std::optional<Location> loc) const = 0;
 
+  // Computes the encoding of the result of an Int4ToFpOp from the encoding of
+  // its source (or the other way around if `fwdInference` is false) such that
+  // every packed i8 and the two values unpacked from it live in the same
+  // thread, in consecutive registers.
+  virtual LogicalResult
+  inferInt4ToFpOpEncoding(Attribute srcEnc, unsigned axis, Attribute &dstEnc,
+                          bool fwdInference,
+                          std::optional<Location> loc) const = 0;
+
   // Verify that the encoding are compatible to be used together in a dot
   // operation
   virtual LogicalResult
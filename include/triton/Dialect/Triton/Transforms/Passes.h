@@ -11,6 +11,9 @@ std::unique_ptr<Pass> createCombineOpsPass();
 std::unique_ptr<Pass> createReorderBroadcastPass();
 std::unique_ptr<Pass> createRewriteTensorPointerPass();
 std::unique_ptr<Pass> createLoopUnrollPass();
+std::unique_ptr<Pass> createLoopUnrollPass(int numWarps, int threadsPerWarp);
+std::unique_ptr<Pass> createLoopPeelingPass();
+std::unique_ptr<Pass> createLoopMultiVersioningPass();
 
 } // namespace triton
 
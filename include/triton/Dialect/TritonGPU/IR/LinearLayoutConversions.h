@@ -4,6 +4,7 @@
 #ifndef TRITON_DIALECT_TRITONGPU_IR_LINEARLAYOUTCONVERSIONS_H
 #define TRITON_DIALECT_TRITONGPU_IR_LINEARLAYOUTCONVERSIONS_H
 
+#include <functional>
 #include <optional>
 
 #include "triton/Tools/LinearLayout.h"
@@ -250,6 +251,44 @@ chooseStMatrixLayout(MLIRContext *ctx, RankedTensorType tensorTy,
                      ArrayRef<unsigned> repShape,
                      ArrayRef<unsigned> paddedRepShape,
                      ArrayRef<unsigned> order, int swizzleByteSize);
+// Bank conflicts of the warp-wide shared memory accesses made while moving a
+// register tensor to or from shared memory.
+//
+// Shared memory is modelled as 32 banks of 4 bytes serving 128 bytes per
+// wavefront, so a warp access wider than that is split into phases of
+// consecutive lanes.  The conflict degree of one access is the largest number
+// of distinct 4-byte words a single bank serves in a phase; 1 means
+// conflict-free.  Lanes touching the same word are served by a broadcast and
+// do not conflict, whether they read or write.
+struct BankConflicts {
+  // Conflict degree of the worst access.
+  int32_t maxDegree = 1;
+  // Conflict degree averaged over all accesses.
+  double avgDegree = 1.0;
+  // Number of vectorized accesses issued by each thread.
+  int32_t numAccesses = 0;
+  // Number of elements moved by one access of one thread.
+  int32_t vecElems = 1;
+};
+
+// Computes the bank conflicts of the accesses described by `regToShmem`, which
+// maps (register, lane, ...) to an "offset" out-dim measured in elements.  In-
+// dims other than register and lane are evaluated at 0, i.e. for the first
+// warp of the first block.  Each access moves `vecElems` consecutive registers.
+// If `padOffset` is given, it maps an offset to the padded offset that is
+// actually accessed.
+BankConflicts
+getBankConflicts(const LinearLayout &regToShmem, int elemBitWidth,
+                 int vecElems,
+                 std::function<int32_t(int32_t)> padOffset = nullptr);
+
+// Computes the bank conflicts of a local_load or local_store moving
+// `registerTy` to or from memory with the `sharedEnc` shared encoding,
+// vectorized like the LLVM lowering (at most 128 bits per access).  Returns
+// std::nullopt if either layout can't be converted to an LL.
+std::optional<BankConflicts> getBankConflicts(RankedTensorType registerTy,
+                                              Attribute sharedEnc);
+
 } // namespace mlir::triton::gpu
 
 #endif // TRITON_DIALECT_TRITONGPU_IR_LINEARLAYOUTCONVERSIONS_H
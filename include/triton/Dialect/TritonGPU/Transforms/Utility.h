@@ -43,6 +43,16 @@ Value getMemAccessPtr(Operation *op);
 // Return bitwidth of tensor element
 unsigned getElementBitWidth(RankedTensorType type);
 
+// Return the shared encoding, among an unswizzled one and a few xor-swizzled
+// candidates keeping each thread's vector contiguous, with the fewest bank
+// conflicts when `registerTy` is stored to and loaded back from shared memory.
+// Ties keep the simpler layout, so this returns the unswizzled encoding unless
+// swizzling helps.
+triton::gpu::SharedEncodingAttr
+getLeastConflictingSharedEncoding(RankedTensorType registerTy,
+                                  ArrayRef<unsigned> order,
+                                  triton::gpu::CTALayoutAttr ctaLayout);
+
 // Calculate the optimal number of elements per thread for a given operation
 // along an axis with greatest continuity.
 unsigned
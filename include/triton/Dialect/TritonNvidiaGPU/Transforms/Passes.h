@@ -52,6 +52,9 @@ createTritonNvidiaGPUFenceInsertionPass(int computeCapability = 90);
 
 std::unique_ptr<Pass> createTritonNvidiaGPUTMALoweringPass();
 
+std::unique_ptr<Pass>
+createTritonNvidiaGPUWarpSpecializePass(int numStages = 3);
+
 /// Generate the code for registering passes.
 #define GEN_PASS_REGISTRATION
 #include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h.inc"
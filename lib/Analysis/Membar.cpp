@@ -14,6 +14,7 @@ void MembarAnalysis::run(FuncBlockInfoMapT &funcBlockInfoMap) {
   FunctionOpInterface funcOp =
       dyn_cast<FunctionOpInterface>(allocation->getOperation());
   OpBuilder builder(funcOp.getContext());
+  collectPartitionMarkers(funcOp);
   resolve(funcOp, &funcBlockInfoMap, &builder);
 }
 
@@ -92,9 +93,48 @@ void MembarAnalysis::visitTerminator(Operation *op,
   llvm_unreachable("Unknown terminator encountered in membar analysis");
 }
 
+// Warp-specialized kernels mark the entry of each partition with the named
+// barrier its warps synchronize through, as [bar_id, num_threads].
+void MembarAnalysis::collectPartitionMarkers(FunctionOpInterface funcOp) {
+  auto mod = funcOp->getParentOfType<ModuleOp>();
+  if (!mod || !mod->hasAttr("triton_gpu.num-warp-groups-per-cta"))
+    return;
+  funcOp.walk([&](Operation *op) {
+    if (op->hasAttr("triton_gpu.partition_barrier"))
+      partitionMarkers.push_back(op);
+  });
+  partitionDominance = std::make_unique<DominanceInfo>(funcOp);
+}
+
+DenseI32ArrayAttr MembarAnalysis::getPartitionBarrier(Operation *op) {
+  if (!partitionDominance)
+    return {};
+  for (Operation *marker : partitionMarkers)
+    if (partitionDominance->properlyDominates(marker, op))
+      return marker->getAttrOfType<DenseI32ArrayAttr>(
+          "triton_gpu.partition_barrier");
+  // Outside of the partitions every warp group reaches the barrier.
+  auto mod = op->getParentOfType<ModuleOp>();
+  int numThreads = triton::gpu::TritonGPUDialect::getNumWarps(mod) *
+                   triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod) *
+                   mod->getAttrOfType<IntegerAttr>(
+                          "triton_gpu.num-warp-groups-per-cta")
+                       .getInt();
+  return DenseI32ArrayAttr::get(op->getContext(), {0, numThreads});
+}
+
 void MembarAnalysis::insertBarrier(Operation *op, OpBuilder *builder) {
   OpBuilder::InsertionGuard g(*builder);
   auto barrierOp = builder->create<gpu::BarrierOp>(op->getLoc());
+  // Only the warps of the partition reach a barrier inside of it. Barriers
+  // without a bar_id synchronize a single warp group in warp-specialized
+  // kernels, so the others are given the CTA barrier explicitly.
+  if (auto partitionBarrier = getPartitionBarrier(op)) {
+    barrierOp->setAttr("bar_id",
+                       builder->getI32IntegerAttr(partitionBarrier[0]));
+    barrierOp->setAttr("num_threads",
+                       builder->getI32IntegerAttr(partitionBarrier[1]));
+  }
 }
 
 void MembarAnalysis::update(Operation *op, BlockInfo *blockInfo,
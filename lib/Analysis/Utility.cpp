@@ -175,7 +175,7 @@ bool ReduceOpHelper::isWarpSynchronous() {
 SmallVector<unsigned> ReduceOpHelper::getScratchRepShape() {
   SmallVector<unsigned> smemShape;
   // that case doesn't need inter-warp communication
-  if (isWarpSynchronous())
+  if (isWarpSynchronous() && isReduceWithinCTA())
     return {0, 0};
 
   smemShape = convertType<unsigned>(getSrcShape());
@@ -203,13 +203,11 @@ bool ReduceOpHelper::isReduceWithinCTA() {
   return CTASplitNum[axis] == 1;
 }
 
-bool ReduceOpHelper::isSupportedLayout() {
-  // Layout optimization passes such as PlanCTAPass and
-  // RemoveLayoutConversionPass should avoid cross-CTA reduction
-  if (!isReduceWithinCTA()) {
-    return false;
-  }
+unsigned ReduceOpHelper::getCTASplitNumOnAxis() {
+  return getCTASplitNum(getSrcLayout())[getAxis()];
+}
 
+bool ReduceOpHelper::isSupportedLayout() {
   auto srcLayout = getSrcLayout();
   if (isa<BlockedEncodingAttr>(srcLayout)) {
     return true;
@@ -321,6 +319,260 @@ unsigned ScanLoweringHelper::getScratchSizeInBytes() {
   return elementSizeInBytes * getScratchSizeInElems();
 }
 
+// Find, for every bit of the position along `axis`, the single register, lane
+// or warp bit that holds it. Bases that move along the axis must not move
+// along any other dimension, otherwise the position of an element along the
+// axis is not a plain bit permutation of its hardware index.
+static std::optional<SmallVector<SortLoweringHelper::AxisBit>>
+findAxisBits(const LinearLayout &ll, unsigned axis, int64_t axisSize,
+             MLIRContext *ctx) {
+  using AxisBit = SortLoweringHelper::AxisBit;
+  StringAttr kAxisDim = StringAttr::get(ctx, "dim" + std::to_string(axis));
+  int32_t axisDimIdx = ll.getOutDimIndex(kAxisDim);
+  unsigned numAxisBits = llvm::Log2_64(axisSize);
+  SmallVector<std::optional<AxisBit>> bits(numAxisBits);
+  for (StringRef name : {"register", "lane", "warp", "block"}) {
+    StringAttr inDim = StringAttr::get(ctx, name);
+    for (int32_t i = 0; i < ll.getInDimSizeLog2(inDim); ++i) {
+      ArrayRef<int32_t> basis = ll.getBasis(inDim, i);
+      int32_t axisBasis = basis[axisDimIdx];
+      if (axisBasis == 0)
+        continue;
+      if (inDim.getValue() == "block" || !llvm::isPowerOf2_32(axisBasis))
+        return std::nullopt;
+      for (auto [dimIdx, dimBasis] : llvm::enumerate(basis)) {
+        if (dimIdx != axisDimIdx && dimBasis != 0)
+          return std::nullopt;
+      }
+      unsigned axisBit = llvm::Log2_32(axisBasis);
+      if (axisBit >= numAxisBits || bits[axisBit].has_value())
+        return std::nullopt;
+      bits[axisBit] = AxisBit{inDim, i};
+    }
+  }
+  if (!llvm::all_of(bits, [](auto &bit) { return bit.has_value(); }))
+    return std::nullopt;
+  return llvm::to_vector(llvm::map_range(bits, [](auto &bit) { return *bit; }));
+}
+
+SortLoweringHelper::SortLoweringHelper(triton::SortOp op)
+    : op(op.getOperation()), comparator(&op.getComparator()),
+      axis(op.getAxis()) {
+  init(op.getInputTypes());
+}
+
+SortLoweringHelper::SortLoweringHelper(triton::TopKOp op)
+    : op(op.getOperation()), comparator(&op.getComparator()),
+      axis(op.getAxis()), k(op.getK()) {
+  init(op.getInputTypes());
+}
+
+void SortLoweringHelper::init(ArrayRef<RankedTensorType> inputTypes) {
+  auto firstTy = inputTypes[0];
+  srcShape = firstTy.getShape();
+  srcEncoding = firstTy.getEncoding();
+  for (const auto &t : inputTypes) {
+    srcElementTypes.push_back(t.getElementType());
+    if (t.getShape() != srcShape) {
+      op->emitError() << "shape mismatch";
+    }
+    if (t.getEncoding() != srcEncoding) {
+      op->emitError() << "encoding mismatch";
+    }
+  }
+
+  if (!srcEncoding)
+    return;
+  auto ll = toLinearLayout(srcShape, srcEncoding);
+  if (!ll.has_value())
+    return;
+
+  axisBits = findAxisBits(*ll, axis, srcShape[axis], op->getContext());
+}
+
+bool SortLoweringHelper::isSupported() {
+  // TODO: Support layouts where a basis moves along the axis and along another
+  // dimension at the same time, and axes that are split across CTAs.
+  return axisBits.has_value();
+}
+
+ArrayRef<SortLoweringHelper::AxisBit> SortLoweringHelper::getAxisBits() {
+  assert(axisBits.has_value() && "unsupported layout");
+  return *axisBits;
+}
+
+bool SortLoweringHelper::isWarpSynchronous() {
+  if (!axisBits.has_value())
+    return true;
+  return llvm::none_of(*axisBits, [](const AxisBit &bit) {
+    return bit.inDim.getValue() == "warp";
+  });
+}
+
+unsigned SortLoweringHelper::getScratchSizeInElems() {
+  return product<int64_t>(getShapePerCTA(srcEncoding, srcShape));
+}
+
+unsigned SortLoweringHelper::getScratchSizeInBytes() {
+  // Warp-synchronous sorts are done entirely in registers. Top-k always goes
+  // through shared memory to extract the leading elements in the result
+  // layout.
+  if (!isSupported() || (isWarpSynchronous() && !k.has_value()))
+    return 0;
+  unsigned elementSizeInBytes = 0;
+  for (const auto &ty : srcElementTypes) {
+    elementSizeInBytes += ceil<unsigned>(ty.getIntOrFloatBitWidth(), 8);
+  }
+  return elementSizeInBytes * getScratchSizeInElems();
+}
+
+// Return true if every basis of `ll` moves along at most one dimension, by a
+// power of 2.
+static bool hasPermutationBases(const LinearLayout &ll) {
+  for (const auto &[inDim, inDimBases] : ll.getBases()) {
+    for (const auto &basis : inDimBases) {
+      unsigned numNonZero = 0;
+      for (int32_t b : basis) {
+        if (b == 0)
+          continue;
+        if (!llvm::isPowerOf2_32(b))
+          return false;
+        ++numNonZero;
+      }
+      if (numNonZero > 1)
+        return false;
+    }
+  }
+  return true;
+}
+
+GatherLoweringHelper::GatherLoweringHelper(triton::GatherOp op) : op(op) {
+  RankedTensorType srcTy = op.getSrc().getType();
+  RankedTensorType idxTy = op.getIndices().getType();
+  if (!srcTy.getEncoding() || !idxTy.getEncoding())
+    return;
+  auto srcLayout = toLinearLayout(srcTy.getShape(), srcTy.getEncoding());
+  auto idxLayout = toLinearLayout(idxTy.getShape(), idxTy.getEncoding());
+  if (!srcLayout || !idxLayout)
+    return;
+
+  MLIRContext *ctx = op.getContext();
+  unsigned axis = op.getAxis();
+  StringAttr kAxisDim = StringAttr::get(ctx, "dim" + std::to_string(axis));
+  StringAttr kLane = StringAttr::get(ctx, "lane");
+  StringAttr kWarp = StringAttr::get(ctx, "warp");
+  StringAttr kBlock = StringAttr::get(ctx, "block");
+  SmallVector<StringAttr> otherDims;
+  for (unsigned dim = 0; dim < srcTy.getRank(); ++dim) {
+    if (dim != axis)
+      otherDims.push_back(StringAttr::get(ctx, "dim" + std::to_string(dim)));
+  }
+
+  // Each CTA must hold whole source columns along the axis, and the columns
+  // the indices of a CTA point to.
+  supported = srcLayout->sublayoutIsZero({kBlock}, {kAxisDim}) &&
+              srcLayout->sublayout({kBlock}, otherDims) ==
+                  idxLayout->sublayout({kBlock}, otherDims);
+  if (!supported)
+    return;
+
+  // The gather stays within a warp if the source positions along the axis are
+  // held by registers and lanes only, and if the thread holding an index also
+  // holds, up to the lane bits along the axis, the source column it points
+  // to. The latter holds when lanes, warps and CTAs move along the other
+  // dimensions in the same way in both layouts; the other-dimension bits held
+  // by registers are then known at compile time for every index register.
+  if (!hasPermutationBases(*srcLayout) || !hasPermutationBases(*idxLayout))
+    return;
+  auto axisBits = findAxisBits(*srcLayout, axis, srcTy.getDimSize(axis), ctx);
+  if (!axisBits)
+    return;
+  if (llvm::any_of(*axisBits, [](const AxisBit &bit) {
+        return bit.inDim.getValue() == "warp";
+      }))
+    return;
+  if (srcLayout->sublayout({kLane, kWarp, kBlock}, otherDims) !=
+      idxLayout->sublayout({kLane, kWarp, kBlock}, otherDims))
+    return;
+
+  srcAxisBits = std::move(*axisBits);
+  bool inThread = llvm::all_of(srcAxisBits, [](const AxisBit &bit) {
+    return bit.inDim.getValue() == "register";
+  });
+  strategy = inThread ? Strategy::ThreadLocal : Strategy::WarpLocal;
+}
+
+bool GatherLoweringHelper::isSupported() { return supported; }
+
+unsigned GatherLoweringHelper::getScratchSizeInBytes() {
+  if (!isSupported() || strategy != Strategy::SharedMemory)
+    return 0;
+  RankedTensorType srcTy = op.getSrc().getType();
+  unsigned elems = product<int64_t>(getShapePerCTA(srcTy));
+  return elems * ceil<unsigned>(srcTy.getElementTypeBitWidth(), 8);
+}
+
+namespace {
+// Rough costs, in instructions, used to pick the histogram strategy. A shared
+// memory atomic accounts for the read-modify-write round trip and for the
+// serialization of lanes that hit the same bin.
+constexpr unsigned kSharedAtomicCost = 32;
+constexpr unsigned kBarrierCost = 16;
+// Keep the private histograms small enough to leave room for the rest of the
+// kernel in shared memory.
+constexpr unsigned kMaxPrivatizedHistogramBytes = 32 * 1024;
+} // namespace
+
+HistogramLoweringHelper::HistogramLoweringHelper(triton::HistogramOp op)
+    : op(op) {
+  auto mod = op->getParentOfType<ModuleOp>();
+  threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+  numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+  numBins = std::max<unsigned>(op.getType().getDimSize(0), threadsPerWarp);
+}
+
+unsigned HistogramLoweringHelper::getWarpBallotCost() {
+  unsigned elems = getTotalElemsPerThread(op.getSrc().getType());
+  unsigned numBits = llvm::Log2_32(numBins);
+  unsigned numLaneBits = llvm::Log2_32(threadsPerWarp);
+  unsigned binsPerThread = numBins / threadsPerWarp;
+  // One ballot per bit of the bin index, the lane mask, then a popcount for
+  // every bin owned by the thread.
+  unsigned perElem = 3 * numBits + 5 * numLaneBits +
+                     binsPerThread * (2 * (numBits - numLaneBits) + 2);
+  unsigned numThreads = threadsPerWarp * numWarps;
+  unsigned crossWarp = 3 * ceil<unsigned>(numBins, numThreads) +
+                       binsPerThread * (kSharedAtomicCost + 3) +
+                       2 * kBarrierCost;
+  return elems * perElem + crossWarp;
+}
+
+unsigned HistogramLoweringHelper::getPrivatizedCost() {
+  unsigned elems = getTotalElemsPerThread(op.getSrc().getType());
+  unsigned numThreads = threadsPerWarp * numWarps;
+  unsigned perElem = kSharedAtomicCost + 3;
+  unsigned init = 3 * ceil<unsigned>(numWarps * numBins, numThreads);
+  unsigned merge = 0;
+  for (unsigned step = numWarps / 2; step >= 1; step /= 2)
+    merge += 6 * ceil<unsigned>(step * numBins, numThreads) + kBarrierCost;
+  return elems * perElem + init + merge + 2 * kBarrierCost;
+}
+
+HistogramLoweringHelper::Strategy HistogramLoweringHelper::getStrategy() {
+  if (numWarps * numBins * 4 > kMaxPrivatizedHistogramBytes)
+    return Strategy::WarpBallot;
+  return getPrivatizedCost() < getWarpBallotCost() ? Strategy::Privatized
+                                                   : Strategy::WarpBallot;
+}
+
+unsigned HistogramLoweringHelper::getScratchSizeInBytes() {
+  unsigned elemBytes =
+      std::max<int>(8, op.getType().getElementTypeBitWidth()) / 8;
+  if (getStrategy() == Strategy::Privatized)
+    return numWarps * numBins * elemBytes;
+  return numBins * elemBytes;
+}
+
 SmallVector<std::pair<SmallVector<int64_t>, SmallVector<int64_t>>>
 getReshapeDecomposition(ArrayRef<int64_t> srcShape,
                         ArrayRef<int64_t> dstShape) {
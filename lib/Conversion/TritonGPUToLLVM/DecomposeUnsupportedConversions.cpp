@@ -111,4 +111,66 @@ void decomposeBlockedToDotLayoutConversion(ModuleOp module) {
   });
 }
 
+template <class Op>
+static void decomposeUnsupportedSortLayout(Op op, int numWarps,
+                                           int threadsPerWarp) {
+  SortLoweringHelper helper(op);
+  if (helper.isSupported())
+    return;
+  auto srcType = op.getInputTypes()[0];
+  unsigned rank = srcType.getRank();
+  unsigned axis = op.getAxis();
+  // One element per thread, and the CTAs of the CGA all hold the whole axis.
+  SmallVector<unsigned> sizePerThread(rank, 1);
+  SmallVector<unsigned> order = getOrder(srcType.getEncoding());
+  SmallVector<unsigned> CTAsPerCGA = getCTAsPerCGA(srcType.getEncoding());
+  SmallVector<unsigned> CTASplitNum = getCTASplitNum(srcType.getEncoding());
+  CTASplitNum[axis] = 1;
+  auto CTALayout = CTALayoutAttr::get(op.getContext(), CTAsPerCGA, CTASplitNum,
+                                      getCTAOrder(srcType.getEncoding()));
+  auto encoding = BlockedEncodingAttr::get(op.getContext(), srcType.getShape(),
+                                           sizePerThread, order, numWarps,
+                                           threadsPerWarp, CTALayout);
+
+  OpBuilder builder(op);
+  SmallVector<Value> srcs;
+  for (Value src : op.getSrcs()) {
+    auto type = cast<RankedTensorType>(src.getType());
+    srcs.push_back(builder.create<ConvertLayoutOp>(
+        op.getLoc(), RankedTensorType::get(type.getShape(),
+                                           type.getElementType(), encoding),
+        src));
+  }
+  Op newOp;
+  if constexpr (std::is_same_v<Op, triton::TopKOp>)
+    newOp = builder.create<Op>(op.getLoc(), srcs, axis, op.getK());
+  else
+    newOp = builder.create<Op>(op.getLoc(), srcs, axis);
+  addAttrs(newOp, op->getAttrs());
+  newOp.getComparator().takeBody(op.getComparator());
+  for (auto [result, newResult] :
+       llvm::zip(op.getResults(), newOp.getResults())) {
+    result.replaceAllUsesWith(builder.create<ConvertLayoutOp>(
+        op.getLoc(), result.getType(), newResult));
+  }
+  op.erase();
+}
+
+void decomposeUnsupportedSortLayouts(ModuleOp module) {
+  int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(module);
+  int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(module);
+  SmallVector<Operation *> sortOps;
+  module.walk([&](Operation *op) {
+    if (isa<triton::SortOp, triton::TopKOp>(op))
+      sortOps.push_back(op);
+  });
+  for (Operation *op : sortOps) {
+    if (auto sortOp = dyn_cast<triton::SortOp>(op))
+      decomposeUnsupportedSortLayout(sortOp, numWarps, threadsPerWarp);
+    else
+      decomposeUnsupportedSortLayout(cast<triton::TopKOp>(op), numWarps,
+                                     threadsPerWarp);
+  }
+}
+
 } // namespace mlir::triton::gpu
@@ -743,6 +743,74 @@ protected:
   const TargetInfoBase &targetInfo;
 };
 
+struct Int4ToFpOpConversion : public ConvertOpToLLVMPattern<Int4ToFpOp> {
+  using ConvertOpToLLVMPattern<Int4ToFpOp>::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(Int4ToFpOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op.getLoc();
+    auto typeConverter = getTypeConverter();
+    auto resultTy = op.getType();
+    Type elemTy = typeConverter->convertType(resultTy.getElementType());
+    Type pairTy = vec_ty(elemTy, 2);
+    bool isBF16 = resultTy.getElementType().isBF16();
+    bool isSigned = op.getIsSigned();
+
+    // Writing a nibble n into the low mantissa bits of 2^10 (fp16) or 2^7
+    // (bf16) gives exactly 2^10 + n (resp. 2^7 + n).  A whole byte is expanded
+    // at once into a pair of halves, lo nibble in the low half, and the
+    // exponent is OR'ed in for both of them; this is a couple of lop3/v_perm
+    // class instructions.  Signed values are flipped to excess-8 with the same
+    // logical op and the extra 8 is subtracted together with the exponent.
+    uint32_t magic = isBF16 ? 0x43004300 : 0x64006400;
+    double bias = isBF16 ? 128.0 : 1024.0;
+    if (isSigned) {
+      magic |= 0x00080008;
+      bias += 8.0;
+    }
+    Value biasVal = rewriter.create<LLVM::ConstantOp>(
+        loc, elemTy, rewriter.getFloatAttr(elemTy, bias));
+    Value biasPair = undef(pairTy);
+    biasPair = insert_element(biasPair, biasVal, i32_val(0));
+    biasPair = insert_element(biasPair, biasVal, i32_val(1));
+
+    SmallVector<Value> srcVals =
+        unpackI32(unpackLLElements(loc, adaptor.getSrc(), rewriter),
+                  op.getSrc().getType(), rewriter, loc, typeConverter);
+    SmallVector<Value> scaleVals;
+    if (adaptor.getScale())
+      scaleVals = unpackI32(unpackLLElements(loc, adaptor.getScale(), rewriter),
+                            resultTy, rewriter, loc, typeConverter);
+
+    SmallVector<Value> resultVals;
+    resultVals.reserve(2 * srcVals.size());
+    for (auto [i, packed] : llvm::enumerate(srcVals)) {
+      Value byte = zext(i32_ty, packed);
+      Value halves = or_(and_(byte, i32_val(0x0000000f)),
+                         and_(shl(byte, i32_val(12)), i32_val(0x000f0000)));
+      halves = isSigned ? xor_(halves, i32_val(magic))
+                        : or_(halves, i32_val(magic));
+      Value pair = rewriter.create<LLVM::FSubOp>(loc, bitcast(halves, pairTy),
+                                                 biasPair);
+      if (!scaleVals.empty()) {
+        Value scalePair = undef(pairTy);
+        scalePair = insert_element(scalePair, scaleVals[2 * i], i32_val(0));
+        scalePair = insert_element(scalePair, scaleVals[2 * i + 1], i32_val(1));
+        pair = fmul(pair, scalePair);
+      }
+      resultVals.push_back(extract_element(pair, i32_val(0)));
+      resultVals.push_back(extract_element(pair, i32_val(1)));
+    }
+
+    resultVals = packI32(resultVals, resultTy, rewriter, loc, typeConverter);
+    Value result =
+        packLLElements(loc, typeConverter, resultVals, rewriter, resultTy);
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+};
+
 } // namespace
 
 void mlir::triton::populateMinMaxFOpToLLVMPattern(
@@ -835,4 +903,5 @@ void mlir::triton::populateElementwiseOpToLLVMPatterns(
   patterns.add<AbsFOpConversion>(typeConverter, axisInfoAnalysis, benefit);
   patterns.add<IndexCastOpLowering>(typeConverter, axisInfoAnalysis, benefit);
   patterns.add<SelectOpConversion>(typeConverter, axisInfoAnalysis, benefit);
+  patterns.add<Int4ToFpOpConversion>(typeConverter, benefit);
 }
@@ -0,0 +1,222 @@
+#include "triton/Analysis/Utility.h"
+#include "triton/Conversion/TritonGPUToLLVM/PatternTritonGPUOpToLLVM.h"
+#include "triton/Conversion/TritonGPUToLLVM/TargetInfoBase.h"
+#include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+using ::mlir::triton::gpu::getShapePerCTA;
+using ::mlir::triton::gpu::toLinearLayout;
+
+namespace {
+
+class GatherOpConversion : public ConvertOpToLLVMPattern<GatherOp> {
+public:
+  GatherOpConversion(LLVMTypeConverter &typeConverter,
+                     const TargetInfoBase &targetInfo, PatternBenefit benefit)
+      : ConvertOpToLLVMPattern(typeConverter, benefit), targetInfo(targetInfo) {
+  }
+
+  LogicalResult
+  matchAndRewrite(GatherOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    GatherLoweringHelper helper(op);
+    if (!helper.isSupported())
+      return failure();
+    Location loc = op.getLoc();
+    SmallVector<Value> srcValues =
+        unpackLLElements(loc, adaptor.getSrc(), rewriter);
+    SmallVector<Value> idxValues =
+        unpackLLElements(loc, adaptor.getIndices(), rewriter);
+    // Indices are compared and combined as i32. In-bounds indices are
+    // non-negative, so narrower ones are zero-extended: an unsigned i8 index of
+    // 128 or more stays in bounds, and a negative signed one is out of bounds
+    // either way. The frontend widens them according to their signedness.
+    for (Value &idx : idxValues) {
+      unsigned bitwidth = idx.getType().getIntOrFloatBitWidth();
+      if (bitwidth > 32)
+        idx = trunc(i32_ty, idx);
+      else if (bitwidth < 32)
+        idx = zext(i32_ty, idx);
+    }
+
+    SmallVector<Value> results;
+    if (helper.getStrategy() == GatherLoweringHelper::Strategy::SharedMemory)
+      results = emitSharedMemoryGather(op, srcValues, idxValues, rewriter);
+    else
+      results = emitRegisterGather(op, helper, srcValues, idxValues, rewriter);
+
+    Value result = packLLElements(loc, getTypeConverter(), results, rewriter,
+                                  op.getType());
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+private:
+  // Gather from registers of the current thread, or of another lane of the
+  // same warp. For each index, the source register is the sum of a part known
+  // at compile time, given by the other-dimension coordinates of the index
+  // register, and of the index bits held by registers. All the candidate
+  // registers are read, through shuffleIdx when some index bits are held by
+  // lanes, and the right one is selected.
+  SmallVector<Value> emitRegisterGather(GatherOp op,
+                                        GatherLoweringHelper &helper,
+                                        ArrayRef<Value> srcValues,
+                                        ArrayRef<Value> idxValues,
+                                        ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    MLIRContext *ctx = op.getContext();
+    RankedTensorType srcTy = op.getSrc().getType();
+    RankedTensorType idxTy = op.getIndices().getType();
+    LinearLayout srcLayout =
+        *toLinearLayout(srcTy.getShape(), srcTy.getEncoding());
+    LinearLayout idxLayout =
+        *toLinearLayout(idxTy.getShape(), idxTy.getEncoding());
+    StringAttr kRegister = str_attr("register");
+    StringAttr kLane = str_attr("lane");
+    StringAttr kWarp = str_attr("warp");
+    StringAttr kBlock = str_attr("block");
+    StringAttr kAxisDim = str_attr("dim" + std::to_string(op.getAxis()));
+    auto srcOutDims = llvm::to_vector(srcLayout.getOutDimNames());
+
+    // Split the index bits by the hardware index holding them in the source.
+    SmallVector<std::pair<unsigned, int32_t>> regBits, laneBits;
+    for (auto [axisBit, hwBit] : llvm::enumerate(helper.getSrcAxisBits())) {
+      if (hwBit.inDim == kRegister)
+        regBits.push_back({axisBit, hwBit.bit});
+      else
+        laneBits.push_back({axisBit, hwBit.bit});
+    }
+
+    // Return bit `axisBit` of `idx` moved to bit `dstBit`.
+    auto getIndexBit = [&](Value idx, unsigned axisBit,
+                           int32_t dstBit) -> Value {
+      Value bit = and_(lshr(idx, i32_val(axisBit)), i32_val(1));
+      if (dstBit == 0)
+        return bit;
+      return shl(bit, i32_val(dstBit));
+    };
+
+    Value laneId;
+    if (!laneBits.empty()) {
+      Value threadId = getThreadId(rewriter, loc);
+      auto mod = op->getParentOfType<ModuleOp>();
+      Value warpSize =
+          i32_val(triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod));
+      laneId = urem(threadId, warpSize);
+    }
+    int32_t laneMask = 0;
+    for (auto [axisBit, laneBit] : laneBits)
+      laneMask |= 1 << laneBit;
+
+    SmallVector<Value> results;
+    for (auto [idxReg, idx] : llvm::enumerate(idxValues)) {
+      // Source register bits along the other dimensions.
+      llvm::SmallDenseMap<StringAttr, int32_t> coords;
+      for (auto [dim, coord] :
+           idxLayout.apply({{kRegister, static_cast<int32_t>(idxReg)},
+                            {kLane, 0},
+                            {kWarp, 0},
+                            {kBlock, 0}}))
+        coords[dim] = coord;
+      unsigned baseReg = 0;
+      for (int32_t i = 0; i < srcLayout.getInDimSizeLog2(kRegister); ++i) {
+        ArrayRef<int32_t> basis = srcLayout.getBasis(kRegister, i);
+        for (auto [dimIdx, b] : llvm::enumerate(basis)) {
+          StringAttr dim = srcOutDims[dimIdx];
+          if (dim != kAxisDim && b != 0 && (coords[dim] & b))
+            baseReg |= 1u << i;
+        }
+      }
+
+      Value srcLane;
+      if (!laneBits.empty()) {
+        srcLane = and_(laneId, i32_val(~laneMask));
+        for (auto [axisBit, laneBit] : laneBits)
+          srcLane = or_(srcLane, getIndexBit(idx, axisBit, laneBit));
+      }
+      Value regSel;
+      if (!regBits.empty()) {
+        regSel = i32_val(0);
+        for (auto [i, bits] : llvm::enumerate(regBits))
+          regSel = or_(regSel, getIndexBit(idx, bits.first, i));
+      }
+
+      Value result;
+      for (unsigned k = 0; k < (1u << regBits.size()); ++k) {
+        unsigned srcReg = baseReg;
+        for (auto [i, bits] : llvm::enumerate(regBits)) {
+          if (k & (1u << i))
+            srcReg |= 1u << bits.second;
+        }
+        Value value = srcValues[srcReg];
+        if (srcLane)
+          value = targetInfo.shuffleIdx(rewriter, loc, value, srcLane);
+        if (k == 0)
+          result = value;
+        else
+          result = select(icmp_eq(regSel, i32_val(k)), value, result);
+      }
+      results.push_back(result);
+    }
+    return results;
+  }
+
+  // Write the source to shared memory in row-major order and read it back at
+  // the gathered positions.
+  SmallVector<Value>
+  emitSharedMemoryGather(GatherOp op, ArrayRef<Value> srcValues,
+                         ArrayRef<Value> idxValues,
+                         ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    RankedTensorType srcTy = op.getSrc().getType();
+    RankedTensorType idxTy = op.getIndices().getType();
+    Type elemTy = getTypeConverter()->convertType(srcTy.getElementType());
+    Value smemBase =
+        LLVM::getSharedMemoryBase(loc, rewriter, targetInfo, op.getOperation());
+    SmallVector<int64_t> shapePerCTA = getShapePerCTA(srcTy);
+    unsigned axis = op.getAxis();
+
+    auto linearize = [&](ArrayRef<Value> multiDimIndex) {
+      Value linear = i32_val(0);
+      for (auto [idx, size] : llvm::zip(multiDimIndex, shapePerCTA))
+        linear = add(mul(linear, i32_val(size)), idx);
+      return linear;
+    };
+
+    auto srcIndices = emitIndices(loc, rewriter, targetInfo,
+                                  srcTy.getEncoding(), srcTy,
+                                  /*withCTAOffset=*/false);
+    for (auto [value, multiDimIndex] : llvm::zip(srcValues, srcIndices)) {
+      Value ptr = gep(smemBase.getType(), elemTy, smemBase,
+                      linearize(multiDimIndex));
+      targetInfo.storeShared(rewriter, loc, ptr, value, true_val());
+    }
+    barrier();
+
+    auto idxIndices = emitIndices(loc, rewriter, targetInfo,
+                                  idxTy.getEncoding(), idxTy,
+                                  /*withCTAOffset=*/false);
+    SmallVector<Value> results;
+    for (auto [idx, multiDimIndex] : llvm::zip(idxValues, idxIndices)) {
+      multiDimIndex[axis] = idx;
+      Value ptr = gep(smemBase.getType(), elemTy, smemBase,
+                      linearize(multiDimIndex));
+      results.push_back(
+          targetInfo.loadShared(rewriter, loc, ptr, elemTy, true_val()));
+    }
+    return results;
+  }
+
+  const TargetInfoBase &targetInfo;
+};
+
+} // namespace
+
+void mlir::triton::populateGatherOpToLLVMPatterns(
+    LLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    const TargetInfoBase &targetInfo, PatternBenefit benefit) {
+  patterns.add<GatherOpConversion>(typeConverter, targetInfo, benefit);
+}
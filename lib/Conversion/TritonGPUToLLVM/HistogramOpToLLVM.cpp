@@ -140,6 +140,92 @@ static SmallVector<Value> computeCrossWarpHistogram(
   return histogramValues;
 }
 
+// Compute the histogram with one private histogram per warp in shared memory.
+// Threads update the histogram of their warp with atomics, so atomics only
+// contend within a warp, and the private histograms are then summed with a
+// tree reduction into the one of warp 0.
+static SmallVector<Value> computePrivatizedHistogram(
+    Location loc, ConversionPatternRewriter &rewriter, RankedTensorType srcType,
+    Value baseSharedMemPtr, const SmallVector<Value> &srcValues, int numBins,
+    int numThreadPerWarp, const SmallVector<Value> &indices, Value threadId,
+    int numWarps, const TargetInfoBase &targetInfo) {
+  int numThreads = numThreadPerWarp * numWarps;
+  Value warpId = udiv(threadId, i32_val(numThreadPerWarp));
+  Value laneId = and_(threadId, i32_val(numThreadPerWarp - 1));
+  // Initialize the private histograms with zeros.
+  int64_t numElementPerThread = ceil<int64_t>(numWarps * numBins, numThreads);
+  for (int i = 0; i < numElementPerThread; ++i) {
+    Value offset = add(threadId, i32_val(i * numThreads));
+    Value sharedMemPtr =
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
+    targetInfo.storeShared(rewriter, loc, sharedMemPtr, i32_val(0),
+                           icmp_ult(offset, i32_val(numWarps * numBins)));
+  }
+  barrier();
+  Block *afterAtomics = nullptr;
+  // If some threads have replicated data we need to skip them when
+  // accumulating.
+  unsigned numThreadWithUniqueData =
+      triton::gpu::getThreadsPerWarpWithUniqueData(srcType.getEncoding(),
+                                                   srcType.getShape())[0];
+  unsigned numWarpsWithUniqueData =
+      mlir::triton::gpu::getWarpsPerCTAWithUniqueData(srcType.getEncoding(),
+                                                      srcType.getShape())[0];
+  if (numThreadWithUniqueData < numThreadPerWarp ||
+      numWarpsWithUniqueData < numWarps) {
+    Block *currentBlock = rewriter.getInsertionBlock();
+    afterAtomics =
+        rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+    Block *atomicBlock = rewriter.createBlock(afterAtomics);
+    rewriter.setInsertionPointToEnd(currentBlock);
+    Value cond = and_(icmp_ult(laneId, i32_val(numThreadWithUniqueData)),
+                      icmp_ult(warpId, i32_val(numWarpsWithUniqueData)));
+    rewriter.create<LLVM::CondBrOp>(loc, cond, atomicBlock, afterAtomics);
+    rewriter.setInsertionPointToStart(atomicBlock);
+  }
+  Value warpHistogram = gep(baseSharedMemPtr.getType(), i32_ty,
+                            baseSharedMemPtr, mul(warpId, i32_val(numBins)));
+  for (Value value : srcValues) {
+    // Like the ballot-based histogram, only the low bits of the value select
+    // the bin.
+    Value bin = and_(value, i32_val(numBins - 1));
+    Value sharedMemPtr =
+        gep(warpHistogram.getType(), i32_ty, warpHistogram, bin);
+    atomicAdd(sharedMemPtr, i32_val(1), loc, rewriter);
+  }
+  if (afterAtomics) {
+    rewriter.create<LLVM::BrOp>(loc, afterAtomics);
+    rewriter.setInsertionPointToStart(afterAtomics);
+  }
+  barrier();
+  // Tree reduction of the private histograms: at each step the first `step`
+  // histograms accumulate the next `step` ones.
+  for (int step = numWarps / 2; step >= 1; step /= 2) {
+    int numElems = step * numBins;
+    for (int i = 0; i < ceil<int>(numElems, numThreads); ++i) {
+      Value offset = add(threadId, i32_val(i * numThreads));
+      Value pred = icmp_ult(offset, i32_val(numElems));
+      Value dstPtr =
+          gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, offset);
+      Value srcPtr = gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr,
+                         add(offset, i32_val(numElems)));
+      Value lhs = targetInfo.loadShared(rewriter, loc, dstPtr, i32_ty, pred);
+      Value rhs = targetInfo.loadShared(rewriter, loc, srcPtr, i32_ty, pred);
+      targetInfo.storeShared(rewriter, loc, dstPtr, add(lhs, rhs), pred);
+    }
+    barrier();
+  }
+  // load the histogram to register with the right layout.
+  SmallVector<Value> histogramValues;
+  for (Value index : indices) {
+    Value sharedMemPtr =
+        gep(baseSharedMemPtr.getType(), i32_ty, baseSharedMemPtr, index);
+    Value val = load(i32_ty, sharedMemPtr);
+    histogramValues.push_back(val);
+  }
+  return histogramValues;
+}
+
 namespace {
 struct HistogramOpConversion
     : public ConvertOpToLLVMPattern<triton::HistogramOp> {
@@ -167,20 +253,12 @@ public:
            numThreadsPerWarp == 64 &&
                "Only supports 32 or 64 threads per warp");
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+    HistogramLoweringHelper helper(op);
     // Pad out the bins so that we have at least one bin per thread within a
     // warp.
-    numBins = std::max(numBins, numThreadsPerWarp);
+    numBins = helper.getNumBins();
     Value threadId = getThreadId(rewriter, loc);
     auto srcType = op.getSrc().getType();
-    // First compute a warp local histogram based on values owned by each warps.
-    SmallVector<Value> warpLevelHistogram = computeWarpLevelHistogram(
-        loc, srcType, srcValues, numBins, numThreadsPerWarp, threadId, rewriter,
-        targetInfo);
-
-    // Then use atomic to update the histogram in shared memory.
-    // TODO: we could skip this for cases with num_warps=1 as long as we can
-    // generate the right layout. Currently the warp level histogram generates
-    // data in the default blocked layout.
     Value baseSharedMemPtr =
         LLVM::getSharedMemoryBase(loc, rewriter, targetInfo, op.getOperation());
     auto dstType = op.getType();
@@ -190,9 +268,28 @@ public:
     SmallVector<Value> innerDimIndices;
     for (int i = 0; i < indices.size(); ++i)
       innerDimIndices.push_back(indices[i][0]);
-    SmallVector<Value> histogramValue = computeCrossWarpHistogram(
-        loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram, numBins,
-        numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+
+    SmallVector<Value> histogramValue;
+    if (helper.getStrategy() ==
+        HistogramLoweringHelper::Strategy::Privatized) {
+      histogramValue = computePrivatizedHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, srcValues, numBins,
+          numThreadsPerWarp, innerDimIndices, threadId, numWarps, targetInfo);
+    } else {
+      // First compute a warp local histogram based on values owned by each
+      // warps.
+      SmallVector<Value> warpLevelHistogram = computeWarpLevelHistogram(
+          loc, srcType, srcValues, numBins, numThreadsPerWarp, threadId,
+          rewriter, targetInfo);
+
+      // Then use atomic to update the histogram in shared memory.
+      // TODO: we could skip this for cases with num_warps=1 as long as we can
+      // generate the right layout. Currently the warp level histogram
+      // generates data in the default blocked layout.
+      histogramValue = computeCrossWarpHistogram(
+          loc, rewriter, srcType, baseSharedMemPtr, warpLevelHistogram,
+          numBins, numThreadsPerWarp, innerDimIndices, threadId, numWarps);
+    }
 
     Value results = packLLElements(loc, typeConverter, histogramValue, rewriter,
                                    op.getType());
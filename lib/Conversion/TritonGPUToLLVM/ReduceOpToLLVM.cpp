@@ -39,7 +39,7 @@ public:
     // Then reduce across threads within a warp.
     reduceWithinWarps(helper, accs, rewriter);
 
-    if (helper.isWarpSynchronous()) {
+    if (helper.isWarpSynchronous() && helper.isReduceWithinCTA()) {
       // If all the values to be reduced are within the same warp there is
       // nothing left to do.
       packResults(helper, accs, rewriter);
@@ -67,11 +67,22 @@ public:
     // We could avoid this barrier in some of the layouts, however this is not
     // the general case.
     // TODO: optimize the barrier in case the layouts are accepted.
-    sync(rewriter, loc, op);
+    //
+    // When the reduced axis is split across CTAs, the partial result of this
+    // CTA must also become visible to the other CTAs of the cluster.
+    if (helper.isReduceWithinCTA())
+      sync(rewriter, loc, op);
+    else
+      targetInfo.barrierCluster(rewriter, loc);
 
     // set output values
     loadReductionAndPackResult(helper, smemShape, smemBases, rewriter);
 
+    // Keep the shared memory of this CTA alive until every CTA of the cluster
+    // has read its partial result.
+    if (!helper.isReduceWithinCTA())
+      targetInfo.barrierCluster(rewriter, loc);
+
     return success();
   }
 
@@ -360,6 +371,64 @@ private:
     }
   }
 
+  // Ids of the CTAs in the cluster holding the partial results along the
+  // reduced axis, ordered by their position along the axis. All the other
+  // coordinates are the same as the ones of the current CTA.
+  SmallVector<Value> getPeerCTAIds(ReduceOpHelper &helper,
+                                   ConversionPatternRewriter &rewriter) const {
+    triton::ReduceOp op = helper.getOperation();
+    Location loc = op.getLoc();
+    auto srcLayout = helper.getSrcLayout();
+    auto CTAsPerCGA = triton::gpu::getCTAsPerCGA(srcLayout);
+    auto CTAOrder = triton::gpu::getCTAOrder(srcLayout);
+    Value clusterCTAId = targetInfo.getClusterCTAId(rewriter, loc);
+    SmallVector<Value> multiDimCTAId =
+        delinearize(rewriter, loc, clusterCTAId, CTAsPerCGA, CTAOrder);
+    SmallVector<Value> peerCTAIds;
+    for (unsigned k = 0; k < helper.getCTASplitNumOnAxis(); ++k) {
+      multiDimCTAId[op.getAxis()] = i32_val(k);
+      peerCTAIds.push_back(
+          linearize(rewriter, loc, multiDimCTAId, CTAsPerCGA, CTAOrder));
+    }
+    return peerCTAIds;
+  }
+
+  // Load the reduction of all the operands at `readOffset`. If `peerCTAIds` is
+  // not empty the partial results of these CTAs are combined through
+  // distributed shared memory. They are combined in the same order on every
+  // CTA so that the whole cluster observes the same result.
+  SmallVector<Value> loadReduction(ReduceOpHelper &helper,
+                                   SmallVector<Value> &smemBases,
+                                   Value readOffset,
+                                   ArrayRef<Value> peerCTAIds,
+                                   ConversionPatternRewriter &rewriter) const {
+    triton::ReduceOp op = helper.getOperation();
+    Location loc = op.getLoc();
+    SmallVector<Value> readPtrs(op.getNumOperands());
+    for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+      auto elemTy = getElementType(op, i);
+      readPtrs[i] =
+          gep(smemBases[i].getType(), elemTy, smemBases[i], readOffset);
+    }
+    SmallVector<Value> acc(op.getNumOperands());
+    if (peerCTAIds.empty()) {
+      for (unsigned i = 0; i < op.getNumOperands(); ++i)
+        acc[i] = load(getElementType(op, i), readPtrs[i]);
+      return acc;
+    }
+    for (auto [k, ctaId] : llvm::enumerate(peerCTAIds)) {
+      SmallVector<Value> cur(op.getNumOperands());
+      for (unsigned i = 0; i < op.getNumOperands(); ++i)
+        cur[i] = targetInfo.loadDShared(rewriter, loc, readPtrs[i], ctaId,
+                                        getElementType(op, i), true_val());
+      if (k == 0)
+        acc = cur;
+      else
+        accumulate(loc, rewriter, op.getCombineOp(), acc, cur);
+    }
+    return acc;
+  }
+
   // Load the final reduction from shared memory and replace the reduce result
   // with it.
   void loadReductionAndPackResult(ReduceOpHelper &helper,
@@ -368,52 +437,57 @@ private:
                                   ConversionPatternRewriter &rewriter) const {
     triton::ReduceOp op = helper.getOperation();
     Location loc = op.getLoc();
-    auto srcLayout = helper.getSrcLayout();
-    auto axis = op.getAxis();
     auto smemOrder = helper.getOrderWithAxisAtBeginning();
+    SmallVector<Value> peerCTAIds;
+    if (!helper.isReduceWithinCTA())
+      peerCTAIds = getPeerCTAIds(helper, rewriter);
     SmallVector<Value> results(op.getNumOperands());
-    for (unsigned i = 0; i < op.getNumOperands(); ++i) {
-      auto elemTy = getElementType(op, i);
-      if (auto resultTy =
-              dyn_cast<RankedTensorType>(op.getResult()[i].getType())) {
-        // nd-tensor where n >= 1
-        auto resultLayout = cast<SliceEncodingAttr>(resultTy.getEncoding());
-        unsigned resultElems = getTotalElemsPerThread(resultTy);
-        auto resultIndices = emitIndices(loc, rewriter, targetInfo,
-                                         resultLayout, resultTy, true);
-        auto resultShape = resultTy.getShape();
-        auto resultCTATile = getShapePerCTATile(resultLayout, resultShape);
-        assert(resultIndices.size() == resultElems);
-
-        SmallVector<Value> resultVals(resultElems);
-        for (size_t j = 0; j < resultElems; ++j) {
-          SmallVector<Value> readIdx = resultIndices[j];
-          readIdx.insert(readIdx.begin() + op.getAxis(), i32_val(0));
-          for (size_t resultIdx = 0, resultDim = resultShape.size();
-               resultIdx < resultDim; ++resultIdx) {
-            auto smemIdx = resultIdx < op.getAxis() ? resultIdx : resultIdx + 1;
-            if (resultCTATile[resultIdx] > smemShape[smemIdx] ||
-                resultShape[resultIdx] > smemShape[smemIdx]) {
-              // When srcShape smaller then src sizePerThread, only srcShape
-              // elements is accumulated in smem. Modulo smemShape effectively
-              // replicates srcShape elements to src sizePerThread.
-              readIdx[smemIdx] =
-                  urem(readIdx[smemIdx], i32_val(smemShape[smemIdx]));
-            }
+    // All the results share the same shape and encoding.
+    if (auto resultTy =
+            dyn_cast<RankedTensorType>(op.getResult()[0].getType())) {
+      // nd-tensor where n >= 1
+      auto resultLayout = cast<SliceEncodingAttr>(resultTy.getEncoding());
+      unsigned resultElems = getTotalElemsPerThread(resultTy);
+      auto resultIndices =
+          emitIndices(loc, rewriter, targetInfo, resultLayout, resultTy, true);
+      auto resultShape = resultTy.getShape();
+      auto resultCTATile = getShapePerCTATile(resultLayout, resultShape);
+      assert(resultIndices.size() == resultElems);
+
+      SmallVector<SmallVector<Value>> resultVals(
+          op.getNumOperands(), SmallVector<Value>(resultElems));
+      for (size_t j = 0; j < resultElems; ++j) {
+        SmallVector<Value> readIdx = resultIndices[j];
+        readIdx.insert(readIdx.begin() + op.getAxis(), i32_val(0));
+        for (size_t resultIdx = 0, resultDim = resultShape.size();
+             resultIdx < resultDim; ++resultIdx) {
+          auto smemIdx = resultIdx < op.getAxis() ? resultIdx : resultIdx + 1;
+          if (resultCTATile[resultIdx] > smemShape[smemIdx] ||
+              resultShape[resultIdx] > smemShape[smemIdx]) {
+            // When srcShape smaller then src sizePerThread, only srcShape
+            // elements is accumulated in smem. Modulo smemShape effectively
+            // replicates srcShape elements to src sizePerThread.
+            readIdx[smemIdx] =
+                urem(readIdx[smemIdx], i32_val(smemShape[smemIdx]));
           }
-          Value readOffset =
-              linearize(rewriter, loc, readIdx, smemShape, smemOrder);
-          Value readPtr =
-              gep(smemBases[i].getType(), elemTy, smemBases[i], readOffset);
-          resultVals[j] = load(elemTy, readPtr);
         }
+        Value readOffset =
+            linearize(rewriter, loc, readIdx, smemShape, smemOrder);
+        SmallVector<Value> vals =
+            loadReduction(helper, smemBases, readOffset, peerCTAIds, rewriter);
+        for (unsigned i = 0; i < op.getNumOperands(); ++i)
+          resultVals[i][j] = vals[i];
+      }
 
-        results[i] = packLLElements(loc, getTypeConverter(), resultVals,
+      for (unsigned i = 0; i < op.getNumOperands(); ++i) {
+        auto resultTy = cast<RankedTensorType>(op.getResult()[i].getType());
+        results[i] = packLLElements(loc, getTypeConverter(), resultVals[i],
                                     rewriter, resultTy);
-      } else {
-        // 0d-tensor -> scalar
-        results[i] = load(elemTy, smemBases[i]);
       }
+    } else {
+      // 0d-tensor -> scalar
+      results =
+          loadReduction(helper, smemBases, i32_val(0), peerCTAIds, rewriter);
     }
     rewriter.replaceOp(op, results);
   }
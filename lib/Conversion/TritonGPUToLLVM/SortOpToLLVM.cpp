@@ -0,0 +1,374 @@
+#include "ReduceScanCommon.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Conversion/TritonGPUToLLVM/PatternTritonGPUOpToLLVM.h"
+#include "triton/Conversion/TritonGPUToLLVM/TargetInfoBase.h"
+#include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include <numeric>
+
+using namespace mlir;
+using namespace mlir::triton;
+
+using ::mlir::triton::gpu::getShapePerCTA;
+using ::mlir::triton::gpu::getTotalElemsPerThread;
+
+namespace {
+
+using AxisBit = SortLoweringHelper::AxisBit;
+
+// Value of one bit of an element's position along the sort axis. The bit is a
+// compile-time constant when it is held by the register index.
+struct PositionBit {
+  std::optional<bool> constant;
+  Value value;
+};
+
+// Emits a bitonic sorting network along the axis of a sort or topk op. The
+// network has log2(N) * (log2(N) + 1) / 2 compare-and-swap steps. Each step
+// pairs every element with the one whose position differs in a single bit, and
+// depending on which hardware index holds that bit the partner is exchanged:
+//   - register: the partner lives in the same thread, no exchange is needed;
+//   - lane: the partner is fetched with a shuffleXor;
+//   - warp: the partner is exchanged through shared memory.
+class BitonicSorter {
+public:
+  BitonicSorter(SortLoweringHelper &helper, ConversionPatternRewriter &rewriter,
+                const TargetInfoBase &targetInfo, Value laneId, Value warpId)
+      : helper(helper), rewriter(rewriter), targetInfo(targetInfo),
+        loc(helper.getLoc()), laneId(laneId), warpId(warpId),
+        axisBits(helper.getAxisBits()) {}
+
+  // Shared memory used by the steps whose partner lives in another warp.
+  // `smemIndices[reg]` is the row-major offset of the element held in
+  // register `reg` within the per-CTA tensor and `axisStride` is the distance
+  // between two consecutive elements along the axis.
+  void setSharedMemory(ArrayRef<Value> bases, ArrayRef<Type> elemTys,
+                       ArrayRef<Value> indices, unsigned stride) {
+    smemBases = bases;
+    smemTypes = elemTys;
+    smemIndices = indices;
+    axisStride = stride;
+  }
+
+  // Sort `srcValues` in place, in the order defined by the comparator.
+  void sort(SmallVector<SmallVector<Value>> &srcValues) {
+    unsigned numBits = axisBits.size();
+    for (unsigned stage = 1; stage <= numBits; ++stage) {
+      for (int step = stage - 1; step >= 0; --step) {
+        StringRef inDim = axisBits[step].inDim.getValue();
+        if (inDim == "register")
+          compareAndSwapInThread(srcValues, stage, step);
+        else if (inDim == "lane")
+          compareAndSwapAcrossLanes(srcValues, stage, step);
+        else
+          compareAndSwapAcrossWarps(srcValues, stage, step);
+      }
+    }
+  }
+
+private:
+  // Return bit `bit` of the position along the axis of the element held in
+  // register `reg`. Bits past the axis size are zero, which makes the last
+  // stage of the network sort in ascending order.
+  PositionBit getPositionBit(unsigned bit, unsigned reg) {
+    if (bit >= axisBits.size())
+      return {false, {}};
+    const AxisBit &axisBit = axisBits[bit];
+    if (axisBit.inDim.getValue() == "register")
+      return {static_cast<bool>((reg >> axisBit.bit) & 1), {}};
+    auto it = runtimeBits.find(bit);
+    if (it != runtimeBits.end())
+      return {std::nullopt, it->second};
+    Value id = axisBit.inDim.getValue() == "lane" ? laneId : warpId;
+    Value isSet = icmp_ne(and_(id, i32_val(1 << axisBit.bit)), i32_val(0));
+    runtimeBits[bit] = isSet;
+    return {std::nullopt, isSet};
+  }
+
+  SmallVector<Value> selectValues(Value cond, ArrayRef<Value> trueValues,
+                                  ArrayRef<Value> falseValues) {
+    SmallVector<Value> ret;
+    for (auto [t, f] : llvm::zip(trueValues, falseValues))
+      ret.push_back(select(cond, t, f));
+    return ret;
+  }
+
+  // Return true if `lhs` must be ordered before `rhs`.
+  Value isOrderedBefore(ArrayRef<Value> lhs, ArrayRef<Value> rhs) {
+    return applyCombineOp(loc, rewriter, helper.getComparator(), lhs, rhs)[0];
+  }
+
+  // Both elements of each pair are held by the current thread.
+  void compareAndSwapInThread(SmallVector<SmallVector<Value>> &values,
+                              unsigned stage, unsigned step) {
+    unsigned regMask = 1u << axisBits[step].bit;
+    for (unsigned reg = 0; reg < values.size(); ++reg) {
+      if (reg & regMask)
+        continue;
+      SmallVector<Value> lower = values[reg];
+      SmallVector<Value> upper = values[reg | regMask];
+      // In a descending block, the lower position takes the element ordered
+      // last.
+      PositionBit descending = getPositionBit(stage, reg);
+      SmallVector<Value> first, second;
+      if (descending.constant) {
+        first = *descending.constant ? lower : upper;
+        second = *descending.constant ? upper : lower;
+      } else {
+        first = selectValues(descending.value, lower, upper);
+        second = selectValues(descending.value, upper, lower);
+      }
+      Value swap = isOrderedBefore(first, second);
+      values[reg] = selectValues(swap, upper, lower);
+      values[reg | regMask] = selectValues(swap, lower, upper);
+    }
+  }
+
+  // Keep either the element of the current thread or the one of its partner
+  // `others`. Both threads of a pair evaluate the comparator on the same
+  // arguments so they agree on whether the pair is swapped.
+  void compareAndSwapWithPartner(SmallVector<Value> &mine,
+                                 ArrayRef<Value> others, unsigned stage,
+                                 unsigned step, unsigned reg) {
+    PositionBit isUpper = getPositionBit(step, reg);
+    PositionBit descending = getPositionBit(stage, reg);
+    assert(!isUpper.constant && "partner must be in another thread");
+    // The comparator is evaluated as (upper, lower) in ascending blocks and as
+    // (lower, upper) in descending ones.
+    Value othersFirst;
+    if (!descending.constant)
+      othersFirst = icmp_eq(descending.value, isUpper.value);
+    else if (*descending.constant)
+      othersFirst = isUpper.value;
+    else
+      othersFirst = xor_(isUpper.value, true_val());
+    SmallVector<Value> first = selectValues(othersFirst, others, mine);
+    SmallVector<Value> second = selectValues(othersFirst, mine, others);
+    Value swap = isOrderedBefore(first, second);
+    mine = selectValues(swap, others, mine);
+  }
+
+  void compareAndSwapAcrossLanes(SmallVector<SmallVector<Value>> &values,
+                                 unsigned stage, unsigned step) {
+    int laneMask = 1 << axisBits[step].bit;
+    for (unsigned reg = 0; reg < values.size(); ++reg) {
+      SmallVector<Value> others;
+      for (Value v : values[reg])
+        others.push_back(targetInfo.shuffleXor(rewriter, loc, v, laneMask));
+      compareAndSwapWithPartner(values[reg], others, stage, step, reg);
+    }
+  }
+
+  void compareAndSwapAcrossWarps(SmallVector<SmallVector<Value>> &values,
+                                 unsigned stage, unsigned step) {
+    assert(!smemBases.empty() && "missing scratch buffer");
+    for (unsigned reg = 0; reg < values.size(); ++reg) {
+      for (unsigned i = 0; i < values[reg].size(); ++i) {
+        Value ptr = gep(smemBases[i].getType(), smemTypes[i], smemBases[i],
+                        smemIndices[reg]);
+        targetInfo.storeShared(rewriter, loc, ptr, values[reg][i], true_val());
+      }
+    }
+    barrier();
+    Value partnerOffset = i32_val(axisStride << step);
+    SmallVector<SmallVector<Value>> others(values.size());
+    for (unsigned reg = 0; reg < values.size(); ++reg) {
+      Value index = xor_(smemIndices[reg], partnerOffset);
+      for (unsigned i = 0; i < values[reg].size(); ++i) {
+        Value ptr =
+            gep(smemBases[i].getType(), smemTypes[i], smemBases[i], index);
+        others[reg].push_back(targetInfo.loadShared(rewriter, loc, ptr,
+                                                    smemTypes[i], true_val()));
+      }
+    }
+    // The next exchange overwrites the buffer.
+    barrier();
+    for (unsigned reg = 0; reg < values.size(); ++reg)
+      compareAndSwapWithPartner(values[reg], others[reg], stage, step, reg);
+  }
+
+  SortLoweringHelper &helper;
+  ConversionPatternRewriter &rewriter;
+  const TargetInfoBase &targetInfo;
+  Location loc;
+  Value laneId;
+  Value warpId;
+  ArrayRef<AxisBit> axisBits;
+  DenseMap<unsigned, Value> runtimeBits;
+
+  ArrayRef<Value> smemBases;
+  ArrayRef<Type> smemTypes;
+  ArrayRef<Value> smemIndices;
+  unsigned axisStride = 0;
+};
+
+template <typename SourceOp>
+class SortLikeOpConversion : public ConvertOpToLLVMPattern<SourceOp> {
+public:
+  static_assert(std::is_same_v<SourceOp, triton::SortOp> ||
+                std::is_same_v<SourceOp, triton::TopKOp>);
+  using OpAdaptor = typename SourceOp::Adaptor;
+
+  SortLikeOpConversion(LLVMTypeConverter &typeConverter,
+                       const TargetInfoBase &targetInfo, PatternBenefit benefit)
+      : ConvertOpToLLVMPattern<SourceOp>(typeConverter, benefit),
+        targetInfo(targetInfo) {}
+
+  LogicalResult
+  matchAndRewrite(SourceOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    SortLoweringHelper helper(op);
+    if (!helper.isSupported())
+      return failure();
+    Location loc = op.getLoc();
+    auto srcTy = op.getInputTypes()[0];
+
+    Value threadId = getThreadId(rewriter, loc);
+    auto mod = op->template getParentOfType<ModuleOp>();
+    unsigned iWarpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    Value warpSize = i32_val(iWarpSize);
+    Value warpId = udiv(threadId, warpSize);
+    Value laneId = urem(threadId, warpSize);
+
+    auto srcValues = unpackInputs(loc, adaptor.getOperands(), rewriter);
+    BitonicSorter sorter(helper, rewriter, targetInfo, laneId, warpId);
+
+    // Shared memory holds the whole per-CTA tensor of every operand, indexed
+    // in row-major order.
+    bool isTopK = std::is_same_v<SourceOp, triton::TopKOp>;
+    SmallVector<Value> smemBases;
+    SmallVector<Type> smemTypes;
+    SmallVector<Value> smemIndices;
+    SmallVector<int64_t> shapePerCTA = getShapePerCTA(srcTy);
+    if (!helper.isWarpSynchronous() || isTopK) {
+      smemBases = getSmemBases(op, helper, rewriter);
+      for (unsigned i = 0; i < helper.getNumOperands(); ++i)
+        smemTypes.push_back(getElementType(op, i));
+      smemIndices = emitRowMajorIndices(loc, rewriter, srcTy, shapePerCTA);
+      unsigned axisStride = product<int64_t>(
+          ArrayRef<int64_t>(shapePerCTA).drop_front(helper.getAxis() + 1));
+      sorter.setSharedMemory(smemBases, smemTypes, smemIndices, axisStride);
+    }
+
+    sorter.sort(srcValues);
+
+    SmallVector<SmallVector<Value>> resultValues;
+    if (isTopK) {
+      // Write back the sorted tensor and read the leading elements along the
+      // axis in the result layout.
+      for (unsigned reg = 0; reg < srcValues.size(); ++reg) {
+        for (unsigned i = 0; i < helper.getNumOperands(); ++i) {
+          Value ptr = gep(smemBases[i].getType(), smemTypes[i], smemBases[i],
+                          smemIndices[reg]);
+          targetInfo.storeShared(rewriter, loc, ptr, srcValues[reg][i],
+                                 true_val());
+        }
+      }
+      barrier();
+      auto dstTy = cast<RankedTensorType>(op->getResult(0).getType());
+      SmallVector<Value> dstIndices =
+          emitRowMajorIndices(loc, rewriter, dstTy, shapePerCTA);
+      for (Value index : dstIndices) {
+        SmallVector<Value> elems;
+        for (unsigned i = 0; i < helper.getNumOperands(); ++i) {
+          Value ptr =
+              gep(smemBases[i].getType(), smemTypes[i], smemBases[i], index);
+          elems.push_back(targetInfo.loadShared(rewriter, loc, ptr,
+                                                smemTypes[i], true_val()));
+        }
+        resultValues.push_back(std::move(elems));
+      }
+    } else {
+      resultValues = std::move(srcValues);
+    }
+
+    SmallVector<Value> results(helper.getNumOperands());
+    for (unsigned i = 0; i < helper.getNumOperands(); ++i) {
+      auto resultTy = cast<RankedTensorType>(op->getResult(i).getType());
+      SmallVector<Value> values;
+      for (auto &elems : resultValues)
+        values.push_back(elems[i]);
+      results[i] = packLLElements(loc, this->getTypeConverter(), values,
+                                  rewriter, resultTy);
+    }
+    rewriter.replaceOp(op, results);
+    return success();
+  }
+
+private:
+  // Return the pointee type of the shared memory pointer for operand i.
+  Type getElementType(SourceOp op, int i) const {
+    auto ty = op.getInputTypes()[i].getElementType();
+    return this->getTypeConverter()->convertType(ty);
+  }
+
+  SmallVector<SmallVector<Value>>
+  unpackInputs(Location loc, ValueRange operands,
+               ConversionPatternRewriter &rewriter) const {
+    SmallVector<SmallVector<Value>> srcValues;
+    for (Value operand : operands) {
+      auto values = unpackLLElements(loc, operand, rewriter);
+      srcValues.resize(values.size());
+      for (unsigned j = 0; j < values.size(); ++j)
+        srcValues[j].push_back(values[j]);
+    }
+    return srcValues;
+  }
+
+  // Return, for each register of `type`, the row-major offset of its element
+  // in a buffer of shape `bufferShape`.
+  SmallVector<Value> emitRowMajorIndices(Location loc,
+                                         ConversionPatternRewriter &rewriter,
+                                         RankedTensorType type,
+                                         ArrayRef<int64_t> bufferShape) const {
+    auto indices = emitIndices(loc, rewriter, targetInfo, type.getEncoding(),
+                               type, /*withCTAOffset=*/false);
+    SmallVector<Value> ret;
+    for (auto &multiDimIndex : indices) {
+      Value linear = i32_val(0);
+      for (auto [idx, size] : llvm::zip(multiDimIndex, bufferShape))
+        linear = add(mul(linear, i32_val(size)), idx);
+      ret.push_back(linear);
+    }
+    return ret;
+  }
+
+  // Operands are laid out one after another in descending order of their
+  // bitwidths so that every base stays aligned.
+  SmallVector<Value> getSmemBases(SourceOp op, SortLoweringHelper &helper,
+                                  ConversionPatternRewriter &rewriter) const {
+    Location loc = op.getLoc();
+    unsigned elems = helper.getScratchSizeInElems();
+    auto elemTys = helper.getElementTypes();
+    std::vector<unsigned> indices(elemTys.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    std::stable_sort(indices.begin(), indices.end(),
+                     [&](unsigned i, unsigned j) {
+                       return elemTys[i].getIntOrFloatBitWidth() >
+                              elemTys[j].getIntOrFloatBitWidth();
+                     });
+    SmallVector<Value> smemBases(elemTys.size());
+    smemBases[indices[0]] =
+        LLVM::getSharedMemoryBase(loc, rewriter, targetInfo, op.getOperation());
+    for (unsigned i = 1; i < indices.size(); ++i) {
+      Value prev = smemBases[indices[i - 1]];
+      smemBases[indices[i]] =
+          gep(prev.getType(), getElementType(op, indices[i - 1]), prev,
+              i32_val(elems));
+    }
+    return smemBases;
+  }
+
+  const TargetInfoBase &targetInfo;
+};
+
+} // namespace
+
+void mlir::triton::populateSortOpToLLVMPatterns(
+    LLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    const TargetInfoBase &targetInfo, PatternBenefit benefit) {
+  patterns.add<SortLikeOpConversion<triton::SortOp>>(typeConverter, targetInfo,
+                                                     benefit);
+  patterns.add<SortLikeOpConversion<triton::TopKOp>>(typeConverter, targetInfo,
+                                                     benefit);
+}
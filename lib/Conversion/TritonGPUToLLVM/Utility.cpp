@@ -203,9 +203,12 @@ applyLinearLayout(Location loc, RewriterBase &rewriter,
   return outIndices;
 }
 
-SmallVector<SmallVector<Value>>
-emitIndices(Location loc, RewriterBase &rewriter, const TargetInfoBase &target,
-            Attribute layout, RankedTensorType type, bool withCTAOffset) {
+thread_local IndexCache *IndexCache::current = nullptr;
+
+static SmallVector<SmallVector<Value>>
+emitIndicesUncached(Location loc, RewriterBase &rewriter,
+                    const TargetInfoBase &target, Attribute layout,
+                    RankedTensorType type, bool withCTAOffset) {
   MLIRContext *ctx = rewriter.getContext();
   auto shape = type.getShape();
 
@@ -263,6 +266,52 @@ emitIndices(Location loc, RewriterBase &rewriter, const TargetInfoBase &target,
   return ret;
 }
 
+SmallVector<SmallVector<Value>>
+emitIndices(Location loc, RewriterBase &rewriter, const TargetInfoBase &target,
+            Attribute layout, RankedTensorType type, bool withCTAOffset) {
+  IndexCache *cache = IndexCache::getCurrent();
+  Operation *parentOp = rewriter.getInsertionBlock()->getParentOp();
+  Operation *funcOp = isa<FunctionOpInterface>(parentOp)
+                          ? parentOp
+                          : parentOp->getParentOfType<FunctionOpInterface>();
+  if (!cache || !funcOp || funcOp->getRegion(0).empty())
+    return emitIndicesUncached(loc, rewriter, target, layout, type,
+                               withCTAOffset);
+
+  // The element type does not affect the indices, so key on the shape only.
+  Type shapeTy =
+      RankedTensorType::get(type.getShape(), rewriter.getIntegerType(8));
+  IndexCache::Key key{funcOp, layout, shapeTy, withCTAOffset};
+  auto it = cache->indices.find(key);
+  if (it != cache->indices.end()) {
+    if (!it->second.isRolledBack())
+      return it->second.indices;
+    it->second.anchor->erase();
+    cache->indices.erase(it);
+  }
+
+  // The entry block dominates every use within the function. The hoisted ops
+  // keep the requesting op's location so that line info survives.
+  OpBuilder::InsertionGuard guard(rewriter);
+  rewriter.setInsertionPointToStart(&funcOp->getRegion(0).front());
+  auto indices =
+      emitIndicesUncached(loc, rewriter, target, layout, type, withCTAOffset);
+
+  // Created behind the rewriter's back, the anchor survives a rollback of the
+  // requesting pattern while CreateOperationRewrite::rollback drops its
+  // operands along with the other uses of the rolled-back ops.
+  SmallVector<Value> flat;
+  for (auto &idx : indices)
+    flat.append(idx.begin(), idx.end());
+  OpBuilder builder(rewriter.getContext());
+  builder.setInsertionPoint(rewriter.getInsertionBlock(),
+                            rewriter.getInsertionPoint());
+  Operation *anchor =
+      builder.create<UnrealizedConversionCastOp>(loc, TypeRange(), flat);
+  cache->indices[key] = {indices, anchor};
+  return indices;
+}
+
 bool emitTransferBetweenRegistersAndShared(
     RankedTensorType registerTy, MemDescType sharedTy, Type elemLlvmTy,
     std::optional<int32_t> maxVecElems, Value shmemBase,
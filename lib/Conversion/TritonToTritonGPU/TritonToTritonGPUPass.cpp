@@ -341,6 +341,55 @@ struct TritonJoinOpPattern : public OpConversionPattern<triton::JoinOp> {
   }
 };
 
+struct TritonInt4ToFpOpPattern
+    : public OpConversionPattern<triton::Int4ToFpOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(Int4ToFpOp op, OpAdaptor adaptor,
+                                ConversionPatternRewriter &rewriter) const {
+    // The packed axis must be most-minor in the source layout so that both
+    // unpacked values stay in the thread holding the i8.  Other than that our
+    // choice of layout doesn't matter; it'll get fixed by
+    // RemoveLayoutConversions.
+    auto typeConverter = getTypeConverter<TritonGPUTypeConverter>();
+    auto src = adaptor.getSrc();
+    auto srcTy = cast<RankedTensorType>(src.getType());
+    auto srcEnc = dyn_cast<BlockedEncodingAttr>(srcTy.getEncoding());
+    unsigned axis = op.getAxis();
+    if (!srcEnc || srcEnc.getOrder().front() != axis) {
+      SmallVector<unsigned> order = {axis};
+      for (int i = srcTy.getRank() - 1; i >= 0; --i)
+        if (i != static_cast<int>(axis))
+          order.push_back(i);
+      srcEnc = BlockedEncodingAttr::get(
+          getContext(), srcTy.getShape(),
+          SmallVector<unsigned>(srcTy.getRank(), 1), order,
+          typeConverter->getNumWarps(), typeConverter->getThreadsPerWarp(),
+          typeConverter->getNumCTAs());
+      srcTy = RankedTensorType::get(srcTy.getShape(), srcTy.getElementType(),
+                                    srcEnc);
+      src = rewriter.create<ConvertLayoutOp>(op.getLoc(), srcTy, src);
+    }
+
+    Attribute retEnc;
+    if (failed(srcEnc.getDialect()
+                   .getRegisteredInterface<DialectInferLayoutInterface>()
+                   ->inferInt4ToFpOpEncoding(srcEnc, axis, retEnc,
+                                             /*fwdInference=*/true,
+                                             op.getLoc())))
+      return failure();
+    auto retTy = RankedTensorType::get(op.getType().getShape(),
+                                       op.getType().getElementType(), retEnc);
+    Value scale = adaptor.getScale();
+    if (scale)
+      scale = rewriter.create<ConvertLayoutOp>(op.getLoc(), retTy, scale);
+    addNamedAttrs(rewriter.replaceOpWithNewOp<triton::Int4ToFpOp>(
+                      op, retTy, src, scale, op.getAxis(), op.getIsSigned()),
+                  adaptor.getAttributes());
+    return success();
+  }
+};
+
 struct TritonSplitOpPattern : public OpConversionPattern<triton::SplitOp> {
   using OpConversionPattern::OpConversionPattern;
 
@@ -477,6 +526,42 @@ struct TritonScanPattern : public OpConversionPattern<triton::ScanOp> {
   }
 };
 
+struct TritonSortPattern : public OpConversionPattern<triton::SortOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::SortOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto newSort = rewriter.create<triton::SortOp>(
+        op.getLoc(), adaptor.getOperands(), adaptor.getAxis());
+    addNamedAttrs(newSort, adaptor.getAttributes());
+
+    auto &newComparator = newSort.getComparator();
+    rewriter.cloneRegionBefore(op.getComparator(), newComparator,
+                               newComparator.end());
+    rewriter.replaceOp(op, newSort.getResult());
+    return success();
+  }
+};
+
+struct TritonTopKPattern : public OpConversionPattern<triton::TopKOp> {
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::TopKOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto newTopK = rewriter.create<triton::TopKOp>(
+        op.getLoc(), adaptor.getOperands(), adaptor.getAxis(), adaptor.getK());
+    addNamedAttrs(newTopK, adaptor.getAttributes());
+
+    auto &newComparator = newTopK.getComparator();
+    rewriter.cloneRegionBefore(op.getComparator(), newComparator,
+                               newComparator.end());
+    rewriter.replaceOp(op, newTopK.getResult());
+    return success();
+  }
+};
+
 class TritonFuncOpPattern : public OpConversionPattern<triton::FuncOp> {
 public:
   using OpConversionPattern::OpConversionPattern;
@@ -535,16 +620,19 @@ void populateTritonPatterns(TritonGPUTypeConverter &typeConverter,
       GenericOpPattern<triton::PtrToIntOp>, GenericOpPattern<triton::SplatOp>,
       TritonBroadcastPattern, GenericOpPattern<triton::AddPtrOp>,
       TritonCatPattern, TritonJoinOpPattern, TritonSplitOpPattern,
+      TritonInt4ToFpOpPattern,
       GenericOpPattern<triton::ClampFOp>,
       GenericOpPattern<triton::PreciseSqrtOp>,
       GenericOpPattern<triton::PreciseDivFOp>,
       GenericOpPattern<triton::MulhiUIOp>,
       GenericOpPattern<triton::ElementwiseInlineAsmOp>, TritonReducePattern,
       GenericOpPattern<triton::ReduceReturnOp>, TritonScanPattern,
-      GenericOpPattern<triton::ScanReturnOp>,
+      GenericOpPattern<triton::ScanReturnOp>, TritonSortPattern,
+      TritonTopKPattern, GenericOpPattern<triton::SortReturnOp>,
       GenericOpPattern<triton::MakeRangeOp>, TritonExpandDimsPattern,
       TritonTransPattern, TritonDotPattern, GenericOpPattern<triton::LoadOp>,
       GenericOpPattern<triton::StoreOp>, GenericOpPattern<triton::HistogramOp>,
+      GenericOpPattern<triton::GatherOp>,
       GenericOpPattern<triton::ExternElementwiseOp>,
       GenericOpPattern<triton::PrintOp>, GenericOpPattern<triton::AssertOp>,
       GenericOpPattern<triton::AtomicCASOp>,
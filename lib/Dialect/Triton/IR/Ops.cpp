@@ -541,6 +541,184 @@ llvm::SmallVector<Type> ScanOp::getElementTypes() {
 
 unsigned ScanOp::getNumOperands() { return this->getOperands().size(); }
 
+// Helpers for Sort and TopK
+template <class Op> static LogicalResult verifySortLike(Op &op) {
+  if (op.getOperands().empty()) {
+    return op.emitOpError() << "must have at least 1 operand";
+  }
+  if (op.getNumOperands() != op.getNumResults()) {
+    return op.emitOpError() << "must have the same number of inputs as outputs";
+  }
+  auto srcTy = op.getInputTypes()[0];
+  int axis = op.getAxis();
+  if (axis < 0 || axis >= srcTy.getRank()) {
+    return op.emitOpError() << "axis " << axis << " is out of range for rank "
+                            << srcTy.getRank();
+  }
+  if (!llvm::isPowerOf2_64(srcTy.getShape()[axis])) {
+    return op.emitOpError() << "size of the sorted axis must be a power of 2";
+  }
+  for (auto [opElemTy, resTy] :
+       llvm::zip(op.getElementTypes(), op.getResultTypes())) {
+    if (opElemTy != cast<RankedTensorType>(resTy).getElementType()) {
+      return op.emitOpError() << "operand types and result types must agree";
+    }
+  }
+  return success();
+}
+
+template <class Op> static LogicalResult verifyComparatorRegion(Op &op) {
+  auto argElementTypes = op.getElementTypes();
+  const auto numArgs = 2 * argElementTypes.size();
+  auto &block = *op.getBody();
+  if (block.getNumArguments() != numArgs) {
+    return op.emitOpError() << "nested block must take " << numArgs
+                            << " arguments, but given block with "
+                            << block.getNumArguments() << " arguments";
+  }
+  for (unsigned i = 0; i < numArgs; ++i) {
+    const auto &blockArgTy = block.getArgument(i).getType();
+    const auto &argElemTy = argElementTypes[i % argElementTypes.size()];
+    if (blockArgTy != argElemTy) {
+      return op.emitOpError()
+             << "type mismatch on comparator. Expected argument " << i
+             << " to have type " << argElemTy << " but got " << blockArgTy;
+    }
+  }
+  if (!isa<SortReturnOp>(block.getTerminator())) {
+    return op.emitOpError() << "comparator must be terminated "
+                            << "with a SortReturnOp but got "
+                            << block.getTerminator();
+  }
+  return success();
+}
+
+//-- SortOp --
+void SortOp::build(OpBuilder &builder, OperationState &state,
+                   ValueRange operands, int axis) {
+  SmallVector<Type> inferredReturnTypes;
+  for (auto arg : operands)
+    inferredReturnTypes.push_back(arg.getType());
+  SortOp::build(builder, state, inferredReturnTypes, operands, axis);
+}
+
+LogicalResult
+SortOp::inferReturnTypes(MLIRContext *context, std::optional<Location> location,
+                         ValueRange operands, DictionaryAttr attributes,
+                         OpaqueProperties properties, RegionRange regions,
+                         SmallVectorImpl<Type> &inferredReturnTypes) {
+  for (auto arg : operands)
+    inferredReturnTypes.push_back(arg.getType());
+  return success();
+}
+
+LogicalResult SortOp::verify() { return verifySortLike(*this); }
+
+LogicalResult SortOp::verifyRegions() { return verifyComparatorRegion(*this); }
+
+llvm::SmallVector<RankedTensorType> SortOp::getInputTypes() {
+  return getInputTypesImpl(this->getOperands());
+}
+
+llvm::SmallVector<Type> SortOp::getElementTypes() {
+  return getElementTypesImpl(this->getOperands());
+}
+
+unsigned SortOp::getNumOperands() { return this->getOperands().size(); }
+
+//-- TopKOp --
+static Type inferTopKReturnType(RankedTensorType argTy, int axis, int k) {
+  auto retShape = argTy.getShape().vec();
+  retShape[axis] = k;
+  return RankedTensorType::get(retShape, argTy.getElementType(),
+                               argTy.getEncoding());
+}
+
+void TopKOp::build(OpBuilder &builder, OperationState &state,
+                   ValueRange operands, int axis, int k) {
+  SmallVector<Type> inferredReturnTypes;
+  for (auto arg : operands)
+    inferredReturnTypes.push_back(
+        inferTopKReturnType(cast<RankedTensorType>(arg.getType()), axis, k));
+  TopKOp::build(builder, state, inferredReturnTypes, operands, axis, k);
+}
+
+LogicalResult
+TopKOp::inferReturnTypes(MLIRContext *context, std::optional<Location> location,
+                         ValueRange operands, DictionaryAttr attributes,
+                         OpaqueProperties properties, RegionRange regions,
+                         SmallVectorImpl<Type> &inferredReturnTypes) {
+  Properties *prop = properties.as<Properties *>();
+  int axis = prop->axis.getInt();
+  int k = prop->k.getInt();
+  for (auto arg : operands) {
+    auto argTy = cast<RankedTensorType>(arg.getType());
+    if (axis < 0 || axis >= argTy.getRank())
+      return failure();
+    inferredReturnTypes.push_back(inferTopKReturnType(argTy, axis, k));
+  }
+  return success();
+}
+
+LogicalResult TopKOp::verify() {
+  if (failed(verifySortLike(*this)))
+    return failure();
+  int64_t axisSize = getInputTypes()[0].getShape()[getAxis()];
+  if (getK() <= 0 || getK() > axisSize || !llvm::isPowerOf2_32(getK())) {
+    return emitOpError() << "k must be a power of 2 no larger than the size of "
+                            "the axis, but got "
+                         << getK();
+  }
+  return success();
+}
+
+LogicalResult TopKOp::verifyRegions() { return verifyComparatorRegion(*this); }
+
+llvm::SmallVector<RankedTensorType> TopKOp::getInputTypes() {
+  return getInputTypesImpl(this->getOperands());
+}
+
+llvm::SmallVector<Type> TopKOp::getElementTypes() {
+  return getElementTypesImpl(this->getOperands());
+}
+
+unsigned TopKOp::getNumOperands() { return this->getOperands().size(); }
+
+//-- GatherOp --
+LogicalResult GatherOp::inferReturnTypes(
+    MLIRContext *context, std::optional<Location> location, ValueRange operands,
+    DictionaryAttr attributes, OpaqueProperties properties, RegionRange regions,
+    SmallVectorImpl<Type> &inferredReturnTypes) {
+  // The result has the shape and the encoding of the indices.
+  auto srcTy = cast<RankedTensorType>(operands[0].getType());
+  auto indicesTy = cast<RankedTensorType>(operands[1].getType());
+  inferredReturnTypes.push_back(
+      indicesTy.cloneWith(std::nullopt, srcTy.getElementType()));
+  return success();
+}
+
+LogicalResult GatherOp::verify() {
+  RankedTensorType srcTy = getSrc().getType();
+  RankedTensorType indicesTy = getIndices().getType();
+  int64_t rank = srcTy.getRank();
+  if (indicesTy.getRank() != rank) {
+    return emitOpError() << "indices must have the same rank as the source, "
+                         << indicesTy.getRank() << " != " << rank;
+  }
+  int axis = getAxis();
+  if (axis < 0 || axis >= rank) {
+    return emitOpError() << "axis " << axis << " is out of range for rank "
+                         << rank;
+  }
+  for (int64_t dim = 0; dim < rank; ++dim) {
+    if (dim != axis && srcTy.getDimSize(dim) != indicesTy.getDimSize(dim)) {
+      return emitOpError() << "indices and source must have the same size "
+                           << "on dimension " << dim;
+    }
+  }
+  return success();
+}
+
 //-- SplatOp --
 OpFoldResult SplatOp::fold(FoldAdaptor adaptor) {
   auto value = adaptor.getSrc();
@@ -738,6 +916,42 @@ LogicalResult FpToFpOp::verify() {
   return success();
 }
 
+//-- Int4ToFpOp --
+LogicalResult Int4ToFpOp::verify() {
+  auto srcTy = getSrc().getType();
+  auto resTy = getType();
+  auto rank = srcTy.getRank();
+  int axis = getAxis();
+  if (axis < 0 || axis >= rank)
+    return emitError("axis out of range");
+  if (!resTy.getElementType().isF16() && !resTy.getElementType().isBF16())
+    return emitError("result element type must be fp16 or bf16");
+  if (resTy.getRank() != rank)
+    return emitError("source and result must have the same rank");
+  for (int i = 0; i < rank; ++i) {
+    int64_t expected = srcTy.getDimSize(i) * (i == axis ? 2 : 1);
+    if (resTy.getDimSize(i) != expected)
+      return emitError("result shape must be the source shape with the axis "
+                       "dimension doubled");
+  }
+  if (getScale() && getScale().getType() != resTy)
+    return emitError("scale must have the same type as the result");
+
+  Attribute srcEnc = srcTy.getEncoding();
+  if (!srcEnc)
+    return success();
+  Attribute expectedEnc;
+  if (cast<DialectInferLayoutInterface>(&srcEnc.getDialect())
+          ->inferInt4ToFpOpEncoding(srcEnc, axis, expectedEnc,
+                                    /*fwdInference=*/true, getLoc())
+          .failed())
+    return failure();
+  if (resTy.getEncoding() != expectedEnc)
+    return emitError("result encoding does not match the source encoding "
+                     "with the axis doubled");
+  return success();
+}
+
 //-- BroadcastOp --
 LogicalResult BroadcastOp::canonicalize(BroadcastOp op,
                                         PatternRewriter &rewriter) {
@@ -0,0 +1,220 @@
+#include <memory>
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "triton-loop-multiversioning"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::triton {
+
+namespace {
+
+bool accessesMemory(scf::ForOp forOp) {
+  return forOp
+      ->walk([](Operation *op) {
+        return isa<LoadOp, StoreOp>(op) ? WalkResult::interrupt()
+                                        : WalkResult::advance();
+      })
+      .wasInterrupted();
+}
+
+class LoopMultiVersioningPass
+    : public TritonLoopMultiVersioningBase<LoopMultiVersioningPass> {
+
+  // Whether the alignment of `arg` is unknown at compile time and worth
+  // checking at runtime.
+  bool isCandidate(FuncOp funcOp, BlockArgument arg) {
+    Type type = arg.getType();
+    if (!isa<PointerType>(type) &&
+        !(type.isInteger() && type.getIntOrFloatBitWidth() > 1))
+      return false;
+    auto divisibility = funcOp.getArgAttrOfType<IntegerAttr>(
+        arg.getArgNumber(), "tt.divisibility");
+    return !divisibility || divisibility.getInt() < alignment;
+  }
+
+  // Emits `arg % alignment == 0`.
+  Value createAlignmentCheck(OpBuilder &builder, Location loc,
+                             BlockArgument arg) {
+    Value value = arg;
+    if (isa<PointerType>(arg.getType()))
+      value = builder.create<PtrToIntOp>(loc, builder.getI64Type(), arg);
+    Type intTy = value.getType();
+    Value mask = builder.create<arith::ConstantOp>(
+        loc, builder.getIntegerAttr(intTy, alignment - 1));
+    Value zero = builder.create<arith::ConstantOp>(
+        loc, builder.getIntegerAttr(intTy, 0));
+    Value rem = builder.create<arith::AndIOp>(loc, value, mask);
+    return builder.create<arith::CmpIOp>(loc, arith::CmpIPredicate::eq, rem,
+                                         zero);
+  }
+
+  // Emits a copy of `arg` that AxisInfo knows is a multiple of `alignment`.
+  Value createAlignedValue(OpBuilder &builder, Location loc,
+                           BlockArgument arg) {
+    if (isa<PointerType>(arg.getType())) {
+      Value zero = builder.create<arith::ConstantIntOp>(loc, 0, 32);
+      auto addPtr = builder.create<AddPtrOp>(loc, arg.getType(), arg, zero);
+      addPtr->setAttr("tt.divisibility",
+                      builder.getI32TensorAttr({int32_t(alignment)}));
+      return addPtr;
+    }
+    Value factor = builder.create<arith::ConstantOp>(
+        loc, builder.getIntegerAttr(arg.getType(), alignment));
+    Value quotient = builder.create<arith::DivSIOp>(loc, arg, factor);
+    return builder.create<arith::MulIOp>(loc, quotient, factor);
+  }
+
+  void versionLoop(FuncOp funcOp, scf::ForOp forOp,
+                   DenseMap<Value, Value> &alignmentChecks) {
+    Block *entry = &funcOp.getBody().front();
+
+    // Walk the addresses the loop accesses back to the function arguments,
+    // staying in the entry block. Only pointers and the integers that reach
+    // their offsets are followed: the alignment of loop bounds and of stored
+    // values has no bearing on vectorization.
+    SetVector<BlockArgument> args;
+    DenseSet<Operation *> slice;
+    DenseSet<Value> visited;
+    SmallVector<Value> worklist;
+    forOp->walk([&](Operation *op) {
+      if (auto load = dyn_cast<LoadOp>(op))
+        worklist.push_back(load.getPtr());
+      else if (auto store = dyn_cast<StoreOp>(op))
+        worklist.push_back(store.getPtr());
+    });
+    while (!worklist.empty()) {
+      Value value = worklist.pop_back_val();
+      if (!visited.insert(value).second)
+        continue;
+      if (auto arg = dyn_cast<BlockArgument>(value)) {
+        if (arg.getOwner() == entry) {
+          if (isCandidate(funcOp, arg))
+            args.insert(arg);
+          continue;
+        }
+        // A loop-carried address comes from its init and yielded values. The
+        // induction variable only depends on the loop bounds.
+        if (auto loop = dyn_cast<scf::ForOp>(arg.getOwner()->getParentOp())) {
+          if (OpOperand *init = loop.getTiedLoopInit(arg)) {
+            worklist.push_back(init->get());
+            worklist.push_back(loop.getTiedLoopYieldedValue(arg)->get());
+          }
+        }
+        continue;
+      }
+      Operation *def = value.getDefiningOp();
+      if (def->getBlock() == entry)
+        slice.insert(def);
+      else if (!forOp->isAncestor(def))
+        continue;
+      if (auto loop = dyn_cast<scf::ForOp>(def)) {
+        auto result = cast<OpResult>(value);
+        worklist.push_back(loop.getTiedLoopInit(result)->get());
+        auto yield = cast<scf::YieldOp>(loop.getBody()->getTerminator());
+        worklist.push_back(yield.getOperand(result.getResultNumber()));
+        continue;
+      }
+      if (auto makeTensorPtr = dyn_cast<MakeTensorPtrOp>(def)) {
+        worklist.push_back(makeTensorPtr.getBase());
+        llvm::append_range(worklist, makeTensorPtr.getStrides());
+        llvm::append_range(worklist, makeTensorPtr.getOffsets());
+        continue;
+      }
+      def->walk([&](Operation *nested) {
+        for (Value operand : nested->getOperands())
+          if (!def->isAncestor(operand.getParentRegion()->getParentOp()))
+            worklist.push_back(operand);
+      });
+    }
+    if (args.empty())
+      return;
+    LDBG("versioning on " << args.size() << " arguments: " << forOp);
+
+    OpBuilder builder(forOp);
+    Location loc = forOp.getLoc();
+    Value cond;
+    for (BlockArgument arg : args) {
+      Value &check = alignmentChecks[arg];
+      if (!check) {
+        OpBuilder entryBuilder = OpBuilder::atBlockBegin(entry);
+        check = createAlignmentCheck(entryBuilder, loc, arg);
+      }
+      cond = cond ? builder.create<arith::AndIOp>(loc, cond, check) : check;
+    }
+
+    auto ifOp = builder.create<scf::IfOp>(loc, forOp.getResultTypes(), cond,
+                                          /*withElseRegion=*/true);
+
+    // Aligned version: rebuild the computations that depend on the checked
+    // arguments from their aligned copies. Ops with side effects or regions
+    // keep using the original values.
+    OpBuilder thenBuilder = ifOp.getThenBodyBuilder();
+    IRMapping mapping;
+    DenseSet<Value> derived;
+    for (BlockArgument arg : args) {
+      mapping.map(arg, createAlignedValue(thenBuilder, loc, arg));
+      derived.insert(arg);
+    }
+    for (Operation &op : entry->without_terminator()) {
+      if (&op == ifOp.getOperation())
+        break;
+      if (!slice.contains(&op) || op.getNumRegions() != 0 ||
+          !isMemoryEffectFree(&op))
+        continue;
+      if (llvm::none_of(op.getOperands(),
+                        [&](Value v) { return derived.contains(v); }))
+        continue;
+      thenBuilder.clone(op, mapping);
+      derived.insert(op.result_begin(), op.result_end());
+    }
+    Operation *alignedLoop = thenBuilder.clone(*forOp, mapping);
+
+    forOp->replaceAllUsesWith(ifOp);
+    Block *elseBlock = ifOp.elseBlock();
+    if (forOp.getNumResults() == 0) {
+      forOp->moveBefore(elseBlock->getTerminator());
+    } else {
+      thenBuilder.create<scf::YieldOp>(loc, alignedLoop->getResults());
+      forOp->moveBefore(elseBlock, elseBlock->end());
+      OpBuilder::atBlockEnd(elseBlock).create<scf::YieldOp>(
+          loc, forOp.getResults());
+    }
+  }
+
+public:
+  void runOnOperation() override {
+    getOperation()->walk([&](FuncOp funcOp) {
+      if (funcOp.isExternal())
+        return;
+      SmallVector<scf::ForOp> loops;
+      for (auto forOp : funcOp.getBody().front().getOps<scf::ForOp>())
+        if (accessesMemory(forOp))
+          loops.push_back(forOp);
+      DenseMap<Value, Value> alignmentChecks;
+      for (scf::ForOp forOp : loops)
+        versionLoop(funcOp, forOp, alignmentChecks);
+    });
+  }
+};
+
+} // anonymous namespace
+
+std::unique_ptr<mlir::Pass> createLoopMultiVersioningPass() {
+  return std::make_unique<LoopMultiVersioningPass>();
+}
+
+} // namespace mlir::triton
@@ -0,0 +1,280 @@
+#include <memory>
+
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/Triton/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/Triton/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "triton-loop-peeling"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir::triton {
+
+static const char *numStagesAttrName = "tt.num_stages";
+
+namespace {
+
+// Integer value of the form
+//   ivCoeff * iv + sum(scale * term) + [min, max]
+// where iv is the induction variable of the loop, the terms are scalars
+// defined outside the loop, and [min, max] covers the constant offsets taken
+// by the elements of a tensor (e.g. from tt.make_range).
+struct AffineRange {
+  int64_t ivCoeff = 0;
+  SmallVector<std::pair<Value, int64_t>> terms;
+  int64_t min = 0;
+  int64_t max = 0;
+
+  void add(const AffineRange &other) {
+    ivCoeff += other.ivCoeff;
+    terms.append(other.terms.begin(), other.terms.end());
+    min += other.min;
+    max += other.max;
+  }
+
+  void scale(int64_t factor) {
+    ivCoeff *= factor;
+    for (auto &term : terms)
+      term.second *= factor;
+    min *= factor;
+    max *= factor;
+    if (factor < 0)
+      std::swap(min, max);
+  }
+};
+
+std::optional<AffineRange> getAffineRange(Value value, scf::ForOp forOp) {
+  AffineRange range;
+  if (value == forOp.getInductionVar()) {
+    range.ivCoeff = 1;
+    return range;
+  }
+  APInt constant;
+  if (matchPattern(value, m_ConstantInt(&constant))) {
+    range.min = range.max = constant.getSExtValue();
+    return range;
+  }
+
+  Operation *def = value.getDefiningOp();
+  if (auto makeRange = dyn_cast_or_null<MakeRangeOp>(def)) {
+    range.min = makeRange.getStart();
+    range.max = makeRange.getEnd() - 1;
+    return range;
+  }
+  if (isa_and_nonnull<SplatOp, BroadcastOp, ExpandDimsOp>(def))
+    return getAffineRange(def->getOperand(0), forOp);
+  if (isa_and_nonnull<arith::AddIOp, arith::SubIOp>(def)) {
+    auto lhs = getAffineRange(def->getOperand(0), forOp);
+    auto rhs = getAffineRange(def->getOperand(1), forOp);
+    if (!lhs || !rhs)
+      return std::nullopt;
+    if (isa<arith::SubIOp>(def))
+      rhs->scale(-1);
+    lhs->add(*rhs);
+    return lhs;
+  }
+  if (isa_and_nonnull<arith::MulIOp>(def)) {
+    for (int i = 0; i < 2; ++i) {
+      APInt factor;
+      if (!matchPattern(def->getOperand(1 - i), m_ConstantInt(&factor)))
+        continue;
+      auto other = getAffineRange(def->getOperand(i), forOp);
+      if (!other)
+        return std::nullopt;
+      other->scale(factor.getSExtValue());
+      return other;
+    }
+    return std::nullopt;
+  }
+
+  if (value.getType().isIntOrIndex() && forOp.isDefinedOutsideOfLoop(value)) {
+    range.terms.push_back({value, 1});
+    return range;
+  }
+  return std::nullopt;
+}
+
+// Collects, for each comparison the mask is a conjunction of, the affine
+// range of an expression that is positive for every element exactly when the
+// comparison holds for every element.
+bool getMaskConditions(Value mask, scf::ForOp forOp,
+                       SmallVectorImpl<AffineRange> &conditions) {
+  Operation *def = mask.getDefiningOp();
+  if (isa_and_nonnull<SplatOp, BroadcastOp, ExpandDimsOp>(def))
+    return getMaskConditions(def->getOperand(0), forOp, conditions);
+  if (auto andOp = dyn_cast_or_null<arith::AndIOp>(def))
+    return getMaskConditions(andOp.getLhs(), forOp, conditions) &&
+           getMaskConditions(andOp.getRhs(), forOp, conditions);
+  auto cmpOp = dyn_cast_or_null<arith::CmpIOp>(def);
+  if (!cmpOp)
+    return false;
+
+  Value lhs = cmpOp.getLhs();
+  Value rhs = cmpOp.getRhs();
+  // Turn `lhs < rhs` into `rhs - lhs > 0` and `lhs <= rhs` into
+  // `rhs - lhs + 1 > 0`.
+  int64_t bias = 0;
+  switch (cmpOp.getPredicate()) {
+  case arith::CmpIPredicate::slt:
+    break;
+  case arith::CmpIPredicate::sle:
+    bias = 1;
+    break;
+  case arith::CmpIPredicate::sgt:
+    std::swap(lhs, rhs);
+    break;
+  case arith::CmpIPredicate::sge:
+    std::swap(lhs, rhs);
+    bias = 1;
+    break;
+  default:
+    return false;
+  }
+  auto lhsRange = getAffineRange(lhs, forOp);
+  auto rhsRange = getAffineRange(rhs, forOp);
+  if (!lhsRange || !rhsRange)
+    return false;
+  lhsRange->scale(-1);
+  rhsRange->add(*lhsRange);
+  rhsRange->min += bias;
+  rhsRange->max += bias;
+  // Only bounds that tighten as the loop advances leave an all-true prefix.
+  if (rhsRange->ivCoeff >= 0)
+    return false;
+  conditions.push_back(*rhsRange);
+  return true;
+}
+
+Value getMask(Operation *op) {
+  if (auto load = dyn_cast<LoadOp>(op))
+    return load.getMask();
+  if (auto store = dyn_cast<StoreOp>(op))
+    return store.getMask();
+  return {};
+}
+
+void dropMask(Operation *op) {
+  if (auto load = dyn_cast<LoadOp>(op)) {
+    load.getMaskMutable().clear();
+    load.getOtherMutable().clear();
+  } else {
+    cast<StoreOp>(op).getMaskMutable().clear();
+  }
+}
+
+class LoopPeelingPass : public TritonLoopPeelingBase<LoopPeelingPass> {
+
+  // Emits the first iteration value at which `condition` may stop holding
+  // for every element, i.e. ceildiv(sum(terms) + min, -ivCoeff).
+  Value createConditionBound(OpBuilder &builder, Location loc, Type ivTy,
+                             const AffineRange &condition) {
+    auto createConstant = [&](int64_t value) -> Value {
+      return builder.create<arith::ConstantOp>(
+          loc, builder.getIntegerAttr(ivTy, value));
+    };
+    Value sum = createConstant(condition.min);
+    for (auto [term, scale] : condition.terms) {
+      Value scaled = term;
+      if (scale != 1)
+        scaled =
+            builder.create<arith::MulIOp>(loc, term, createConstant(scale));
+      sum = builder.create<arith::AddIOp>(loc, sum, scaled);
+    }
+    if (condition.ivCoeff == -1)
+      return sum;
+    return builder.create<arith::CeilDivSIOp>(
+        loc, sum, createConstant(-condition.ivCoeff));
+  }
+
+  bool peel(scf::ForOp forOp) {
+    Type ivTy = forOp.getInductionVar().getType();
+    SmallVector<Operation *> peeled;
+    SmallVector<AffineRange> conditions;
+    forOp.getBody()->walk([&](Operation *op) {
+      Value mask = getMask(op);
+      if (!mask)
+        return;
+      SmallVector<AffineRange> opConditions;
+      if (!getMaskConditions(mask, forOp, opConditions))
+        return;
+      bool typesMatch = llvm::all_of(opConditions, [&](const AffineRange &c) {
+        return llvm::all_of(c.terms, [&](auto term) {
+          return term.first.getType() == ivTy;
+        });
+      });
+      if (!typesMatch)
+        return;
+      peeled.push_back(op);
+      conditions.append(opConditions);
+    });
+    if (peeled.empty())
+      return false;
+    LDBG("peeling " << peeled.size() << " masked ops off " << forOp);
+
+    // The main loop runs the iterations below the smallest bound, rounded up
+    // to the loop's step and clamped to its range.
+    OpBuilder builder(forOp);
+    Location loc = forOp.getLoc();
+    Value lb = forOp.getLowerBound();
+    Value ub = forOp.getUpperBound();
+    Value step = forOp.getStep();
+    Value split;
+    for (const AffineRange &condition : conditions) {
+      Value bound = createConditionBound(builder, loc, ivTy, condition);
+      split = split ? builder.create<arith::MinSIOp>(loc, split, bound) : bound;
+    }
+    split = builder.create<arith::MinSIOp>(loc, split, ub);
+    split = builder.create<arith::MaxSIOp>(loc, split, lb);
+    std::optional<int64_t> constStep = getConstantIntValue(step);
+    if (!constStep || *constStep != 1) {
+      Value numIters = builder.create<arith::CeilDivSIOp>(
+          loc, builder.create<arith::SubIOp>(loc, split, lb), step);
+      split = builder.create<arith::AddIOp>(
+          loc, lb, builder.create<arith::MulIOp>(loc, numIters, step));
+    }
+
+    IRMapping mapping;
+    auto mainLoop = cast<scf::ForOp>(builder.clone(*forOp, mapping));
+    mainLoop.getUpperBoundMutable().assign(split);
+    for (Operation *op : peeled)
+      dropMask(mapping.lookup(op));
+
+    forOp.getLowerBoundMutable().assign(split);
+    forOp.getInitArgsMutable().assign(mainLoop.getResults());
+    forOp->setAttr(numStagesAttrName, builder.getI32IntegerAttr(1));
+    return true;
+  }
+
+public:
+  void runOnOperation() override {
+    SmallVector<scf::ForOp> loops;
+    getOperation()->walk([&](scf::ForOp forOp) {
+      // Loops kept out of pipelining, including remainders peeled by an
+      // earlier run, are left alone.
+      auto numStages = forOp->getAttrOfType<IntegerAttr>(numStagesAttrName);
+      if (numStages && numStages.getInt() <= 1)
+        return;
+      loops.push_back(forOp);
+    });
+    for (scf::ForOp forOp : loops)
+      (void)peel(forOp);
+  }
+};
+
+} // anonymous namespace
+
+std::unique_ptr<mlir::Pass> createLoopPeelingPass() {
+  return std::make_unique<LoopPeelingPass>();
+}
+
+} // namespace mlir::triton
@@ -1,6 +1,7 @@
 #include <memory>
 
 #include "mlir/Dialect/SCF/Utils/Utils.h"
+#include "mlir/Dialect/Utils/StaticValueUtils.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
@@ -11,6 +12,7 @@
 #include "triton/Analysis/Utility.h"
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/Transforms/Passes.h"
+#include "triton/Tools/Sys/GetEnv.hpp"
 #include "llvm/Support/Debug.h"
 
 #define GEN_PASS_CLASSES
@@ -23,6 +25,25 @@
 namespace mlir::triton {
 
 static const char *loopUnrollFactorAttrName = "tt.loop_unroll_factor";
+static const char *numStagesAttrName = "tt.num_stages";
+
+// Registers each thread may spend on the values an automatically unrolled
+// loop keeps live; the program-wide budget scales with its thread count.
+static constexpr int64_t kRegisterBudgetPerThread = 128;
+
+// Bytes of registers a value occupies across the whole program. Scalars are
+// negligible next to tensors and are not counted.
+static int64_t getLiveBytes(Type type) {
+  auto tensorTy = dyn_cast<RankedTensorType>(type);
+  if (!tensorTy)
+    return 0;
+  Type elemTy = tensorTy.getElementType();
+  int64_t elemBytes =
+      isa<PointerType>(elemTy)
+          ? 8
+          : std::max<int64_t>(elemTy.getIntOrFloatBitWidth() / 8, 1);
+  return tensorTy.getNumElements() * elemBytes;
+}
 
 namespace {
 
@@ -37,20 +58,103 @@ class LoopUnrollPass : public TritonLoopUnrollBase<LoopUnrollPass> {
     return 1;
   }
 
+  // Picks an unroll factor for a loop without tt.loop_unroll_factor. Only
+  // innermost loops with a constant trip count are considered, and the factor
+  // must divide the trip count so no remainder loop is generated. The unrolled
+  // body is bounded both in op count and in the bytes of tensors it defines;
+  // the latter is an upper bound of the registers kept live once the copies
+  // are interleaved by the scheduler.
+  int getAutoUnrollFactor(scf::ForOp forOp) {
+    if (forOp->hasAttr(numStagesAttrName)) {
+      forOp.emitRemark("not unrolled: loop is tagged for software pipelining");
+      return 1;
+    }
+    bool isInnermost = true;
+    bool hasDot = false;
+    int64_t numOps = 0;
+    int64_t bodyBytes = 0;
+    forOp.getBody()->walk([&](Operation *op) {
+      if (isa<LoopLikeOpInterface>(op))
+        isInnermost = false;
+      if (isa<DotOp>(op))
+        hasDot = true;
+      if (op == forOp.getBody()->getTerminator())
+        return;
+      ++numOps;
+      for (Type type : op->getResultTypes())
+        bodyBytes += getLiveBytes(type);
+    });
+    if (!isInnermost) {
+      forOp.emitRemark("not unrolled: loop is not innermost");
+      return 1;
+    }
+    if (hasDot) {
+      forOp.emitRemark("not unrolled: loop is left to the software pipeliner");
+      return 1;
+    }
+
+    std::optional<int64_t> lb = getConstantIntValue(forOp.getLowerBound());
+    std::optional<int64_t> ub = getConstantIntValue(forOp.getUpperBound());
+    std::optional<int64_t> step = getConstantIntValue(forOp.getStep());
+    if (!lb || !ub || !step || *step <= 0) {
+      forOp.emitRemark("not unrolled: trip count is not a constant");
+      return 1;
+    }
+    int64_t tripCount = *ub > *lb ? llvm::divideCeil(*ub - *lb, *step) : 0;
+    if (tripCount < 2) {
+      forOp.emitRemark() << "not unrolled: trip count " << tripCount
+                         << " is too small";
+      return 1;
+    }
+
+    int64_t carriedBytes = 0;
+    for (Value arg : forOp.getRegionIterArgs())
+      carriedBytes += getLiveBytes(arg.getType());
+    int64_t registerBudgetBytes =
+        kRegisterBudgetPerThread * 4 * numWarps * threadsPerWarp;
+    for (int64_t factor = std::min<int64_t>(tripCount, maxUnrollFactor);
+         factor > 1; --factor) {
+      if (tripCount % factor != 0 || factor * numOps > maxUnrolledOps ||
+          carriedBytes + factor * bodyBytes > registerBudgetBytes)
+        continue;
+      forOp.emitRemark() << "unrolled by " << factor << ": trip count "
+                         << tripCount << ", " << numOps << " ops, "
+                         << carriedBytes + factor * bodyBytes
+                         << " live bytes";
+      return factor;
+    }
+    forOp.emitRemark() << "not unrolled: body of " << numOps << " ops and "
+                       << carriedBytes + bodyBytes
+                       << " live bytes leaves no room to unroll";
+    return 1;
+  }
+
 public:
   LoopUnrollPass() = default;
   LoopUnrollPass(const LoopUnrollPass &) {}
+  // constructor with the program shape set explicitly.
+  LoopUnrollPass(int numWarps, int threadsPerWarp) {
+    this->numWarps = numWarps;
+    this->threadsPerWarp = threadsPerWarp;
+  }
   void runOnOperation() override {
     LDBG("Loop unroll pass");
-    SmallVector<scf::ForOp, 4> loops;
+    bool useAutoUnroll =
+        autoUnroll || triton::tools::getBoolEnv("TRITON_AUTO_UNROLL");
+    SmallVector<std::pair<scf::ForOp, int>, 4> loops;
     getOperation()->walk([&](scf::ForOp forOp) {
+      // An explicit factor, including 1, always overrides the heuristic.
+      int unrollFactor =
+          forOp->hasAttr(mlir::triton::loopUnrollFactorAttrName) ||
+                  !useAutoUnroll
+              ? getUnrollFactorOrDefault(forOp)
+              : getAutoUnrollFactor(forOp);
       // Bail out for loops with unroll factor <= 1.
-      if (getUnrollFactorOrDefault(forOp) > 1)
-        loops.push_back(forOp);
+      if (unrollFactor > 1)
+        loops.push_back({forOp, unrollFactor});
     });
 
-    for (auto loop : loops) {
-      auto unrollFactor = getUnrollFactorOrDefault(loop);
+    for (auto [loop, unrollFactor] : loops) {
       loop->removeAttr(mlir::triton::loopUnrollFactorAttrName);
       LDBG("Unrolling loop by " << unrollFactor << " times\n" << loop);
       (void)loopUnrollByFactor(loop, unrollFactor);
@@ -64,4 +168,9 @@ std::unique_ptr<mlir::Pass> createLoopUnrollPass() {
   return std::make_unique<LoopUnrollPass>();
 }
 
+std::unique_ptr<mlir::Pass> createLoopUnrollPass(int numWarps,
+                                                 int threadsPerWarp) {
+  return std::make_unique<LoopUnrollPass>(numWarps, threadsPerWarp);
+}
+
 } // namespace mlir::triton
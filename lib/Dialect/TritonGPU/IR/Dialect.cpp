@@ -2734,6 +2734,53 @@ struct TritonGPUInferLayoutInterface
                            ArrayRef(enc.getCTAOrder()).drop_front(1)));
     return success();
   }
+
+  LogicalResult
+  inferInt4ToFpOpEncoding(Attribute srcEnc, unsigned axis, Attribute &dstEnc,
+                          bool fwdInference,
+                          std::optional<Location> loc) const override {
+    // The two values unpacked from an i8 must be consecutive registers of the
+    // thread holding it, so we scale the number of elements per thread along
+    // the packed axis.
+    auto scale = [&](unsigned n, StringRef what) -> FailureOr<unsigned> {
+      if (fwdInference)
+        return 2 * n;
+      if (n % 2 != 0)
+        return emitOptionalError(loc, "Int4ToFpOp requires an even ", what,
+                                 " along the packed axis");
+      return n / 2;
+    };
+    if (auto enc = mlir::dyn_cast<BlockedEncodingAttr>(srcEnc)) {
+      if (enc.getOrder()[0] != axis)
+        return emitOptionalError(
+            loc, "Int4ToFpOp requires the packed axis to be most-minor");
+      SmallVector<unsigned> sizePerThread(enc.getSizePerThread());
+      auto size = scale(sizePerThread[axis], "sizePerThread");
+      if (failed(size))
+        return failure();
+      sizePerThread[axis] = *size;
+      dstEnc = BlockedEncodingAttr::get(
+          enc.getContext(), sizePerThread, enc.getThreadsPerWarp(),
+          enc.getWarpsPerCTA(), enc.getOrder(), enc.getCTALayout());
+      return success();
+    }
+    if (auto enc = mlir::dyn_cast<DotOperandEncodingAttr>(srcEnc)) {
+      unsigned rank = getOrder(enc.getParent()).size();
+      unsigned kDim = enc.getOpIdx() == 0 ? rank - 1 : rank - 2;
+      if (axis != kDim || enc.getKWidth() == 0)
+        return emitOptionalError(loc, "Int4ToFpOp on a dot operand requires "
+                                      "packing along K and a kWidth");
+      auto kWidth = scale(enc.getKWidth(), "kWidth");
+      if (failed(kWidth))
+        return failure();
+      dstEnc = DotOperandEncodingAttr::get(enc.getContext(), enc.getOpIdx(),
+                                           enc.getParent(), *kWidth);
+      return success();
+    }
+    return emitOptionalError(
+        loc, "Int4ToFpOp can only operate on BlockedEncoding or "
+             "DotOperandEncoding");
+  }
 };
 
 //===----------------------------------------------------------------------===//
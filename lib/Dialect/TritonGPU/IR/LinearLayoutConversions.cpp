@@ -1169,4 +1169,81 @@ chooseStMatrixLayout(MLIRContext *ctx, RankedTensorType tensorTy,
         ctx, tensorTy, repShape, paddedRepShape, order, swizzleByteSize);
 }
 
+BankConflicts getBankConflicts(const LinearLayout &regToShmem,
+                               int elemBitWidth, int vecElems,
+                               std::function<int32_t(int32_t)> padOffset) {
+  assert(!regToShmem.getInDimNames().empty());
+  MLIRContext *ctx = regToShmem.getInDimNames().begin()->getContext();
+  StringAttr kRegister = S("register");
+  StringAttr kLane = S("lane");
+  StringAttr kOffset = S("offset");
+
+  constexpr int kNumBanks = 32;
+  constexpr int kBankBytes = 4;
+  constexpr int kWavefrontBytes = kNumBanks * kBankBytes;
+
+  int numRegs = regToShmem.getInDimSize(kRegister);
+  int numLanes = regToShmem.getInDimSize(kLane);
+  vecElems = std::max(1, std::min(vecElems, numRegs));
+  int accessBytes = std::max(1, vecElems * elemBitWidth / 8);
+  int numPhases =
+      std::max(1, numLanes * std::max(accessBytes, kBankBytes) /
+                      kWavefrontBytes);
+  int lanesPerPhase = std::max(1, numLanes / numPhases);
+
+  BankConflicts ret;
+  ret.vecElems = vecElems;
+  int64_t totalDegree = 0;
+  for (int reg = 0; reg < numRegs; reg += vecElems) {
+    int degree = 1;
+    for (int phase = 0; phase < numLanes; phase += lanesPerPhase) {
+      // Distinct words requested from each bank.
+      SmallVector<llvm::SmallDenseSet<int64_t, 4>> bankWords(kNumBanks);
+      for (int lane = phase; lane < phase + lanesPerPhase; lane++) {
+        SmallVector<std::pair<StringAttr, int32_t>> ins;
+        for (StringAttr inDim : regToShmem.getInDimNames())
+          ins.push_back(
+              {inDim, inDim == kRegister ? reg : inDim == kLane ? lane : 0});
+        int32_t offset = 0;
+        for (auto [outDim, value] : regToShmem.apply(ins))
+          if (outDim == kOffset)
+            offset = value;
+        if (padOffset)
+          offset = padOffset(offset);
+        int64_t firstByte = int64_t(offset) * elemBitWidth / 8;
+        for (int64_t word = firstByte / kBankBytes;
+             word <= (firstByte + accessBytes - 1) / kBankBytes; word++)
+          bankWords[word % kNumBanks].insert(word);
+      }
+      for (const auto &words : bankWords)
+        degree = std::max<int>(degree, words.size());
+    }
+    ret.maxDegree = std::max(ret.maxDegree, degree);
+    totalDegree += degree;
+    ret.numAccesses++;
+  }
+  if (ret.numAccesses > 0)
+    ret.avgDegree = double(totalDegree) / ret.numAccesses;
+  return ret;
+}
+
+std::optional<BankConflicts> getBankConflicts(RankedTensorType registerTy,
+                                              Attribute sharedEnc) {
+  int elemBitWidth = isa<PointerType>(registerTy.getElementType())
+                         ? 64
+                         : registerTy.getElementTypeBitWidth();
+  std::optional<LinearLayout> regLayout =
+      toLinearLayout(registerTy.getShape(), registerTy.getEncoding());
+  std::optional<LinearLayout> sharedLayout =
+      toLinearLayout(registerTy.getShape(), sharedEnc, elemBitWidth);
+  if (!regLayout.has_value() || !sharedLayout.has_value())
+    return std::nullopt;
+
+  // (register, lane, warp, block) -> (offset, block)
+  LinearLayout regToShmem = regLayout->invertAndCompose(*sharedLayout);
+  int vecElems = std::min<int>(regToShmem.getNumConsecutiveInOut(),
+                               std::max(1, 128 / elemBitWidth));
+  return getBankConflicts(regToShmem, elemBitWidth, vecElems);
+}
+
 } // namespace mlir::triton::gpu
@@ -159,6 +159,82 @@ static Value getSharedMemoryMMAOperand(Value v, mlir::PatternRewriter &rewriter,
   return rewriter.create<LocalAllocOp>(arg.getLoc(), newType, arg);
 }
 
+// Promotes a floating point operand to `promotedType`. tt.fp_to_fp only
+// lowers conversions from and to fp8, so wider types are extended with
+// arith.extf.
+static Value promoteOperand(OpBuilder &builder, Location loc, Value operand,
+                            Type promotedType) {
+  Type tensorPromotedType = cast<RankedTensorType>(operand.getType())
+                                .cloneWith(std::nullopt, promotedType);
+  if (getElementTypeOrSelf(operand).getIntOrFloatBitWidth() > 8)
+    return builder.create<arith::ExtFOp>(loc, tensorPromotedType, operand);
+  return builder.create<FpToFpOp>(loc, tensorPromotedType, operand);
+}
+
+// Returns the 3D layout of the broadcasted product SkinnyDotToReduce lowers
+// `dotOp` to, or std::nullopt if the dot is not a skinny-M dot it handles.
+//
+// The layout splits K across lanes first and then across warps, gives
+// whatever is left to N, and keeps a vector of contiguous N elements in each
+// thread.
+static std::optional<BlockedEncodingAttr>
+getSkinnyDotProductLayout(DotOp dotOp) {
+  // Largest M handled by the skinny-M lowering.
+  constexpr int64_t kMaxM = 8;
+  // Upper bound on the number of broadcasted products held by each thread.
+  constexpr int64_t kMaxElemsPerThread = 256;
+
+  RankedTensorType retType = dotOp.getType();
+  if (!retType.getEncoding() ||
+      !isa<BlockedEncodingAttr>(retType.getEncoding()))
+    return std::nullopt;
+  if (retType.getRank() != 2)
+    return std::nullopt;
+  auto mod = dotOp->getParentOfType<ModuleOp>();
+  if (TritonGPUDialect::getNumCTAs(mod) != 1)
+    return std::nullopt;
+
+  auto aType = dotOp.getA().getType();
+  auto bType = dotOp.getB().getType();
+  Type aElTy = aType.getElementType();
+  Type bElTy = bType.getElementType();
+  Type dElTy = retType.getElementType();
+  bool isFloat = isa<FloatType>(aElTy) && isa<FloatType>(dElTy);
+  bool isInt = aElTy.isInteger(8) && dElTy.isInteger(32);
+  if (aElTy != bElTy || !(isFloat || isInt))
+    return std::nullopt;
+  // Operands are only ever promoted to the accumulator type.
+  if (aElTy.getIntOrFloatBitWidth() > dElTy.getIntOrFloatBitWidth())
+    return std::nullopt;
+
+  int64_t M = aType.getShape()[0];
+  int64_t K = aType.getShape()[1];
+  int64_t N = bType.getShape()[1];
+  if (M > kMaxM)
+    return std::nullopt;
+
+  unsigned numWarps = TritonGPUDialect::getNumWarps(mod);
+  unsigned threadsPerWarp = TritonGPUDialect::getThreadsPerWarp(mod);
+  unsigned vecN = std::min<int64_t>(
+      N, std::max<unsigned>(1, 128 / bElTy.getIntOrFloatBitWidth()));
+  unsigned lanesK = std::min<int64_t>(threadsPerWarp, K);
+  unsigned lanesN = threadsPerWarp / lanesK;
+  unsigned warpsK =
+      std::min<int64_t>(numWarps, std::max<int64_t>(1, K / lanesK));
+  unsigned warpsN = numWarps / warpsK;
+  int64_t elemsPerThread =
+      M * llvm::divideCeil(K, lanesK * warpsK) *
+      std::max<int64_t>(vecN, llvm::divideCeil(N, lanesN * warpsN));
+  if (elemsPerThread > kMaxElemsPerThread)
+    return std::nullopt;
+
+  MLIRContext *ctx = dotOp.getContext();
+  auto CTALayout = CTALayoutAttr::get(ctx, {1, 1, 1}, {1, 1, 1}, {2, 1, 0});
+  return BlockedEncodingAttr::get(
+      ctx, {static_cast<unsigned>(M), 1, vecN}, {1, lanesK, lanesN},
+      {1, warpsK, warpsN}, {2, 1, 0}, CTALayout);
+}
+
 class BlockedToMMA : public mlir::OpRewritePattern<DotOp> {
   int computeCapability;
   mutable int mmaV1Counter{}; // used to generate ID for MMAv1 encoding
@@ -244,6 +320,13 @@ public:
     int versionMajor = getMMAVersionSafe(computeCapability, dotOp);
     if (!(versionMajor >= 1 && versionMajor <= 3))
       return failure();
+    // Skinny-M dots are decomposed into a reduction rather than padded to the
+    // MMA instruction shape. The ones it does not take (several CTAs, or a
+    // product too large for registers) keep the 16-row minimum of MMA and go
+    // to the FMA lowering.
+    if (getSkinnyDotProductLayout(dotOp) ||
+        retShapePerCTA[retShapePerCTA.size() - 2] < 16)
+      return failure();
 
     auto instrShape = mmaVersionToInstrShape(
         versionMajor, retShapePerCTA, dotOp.getA().getType().getElementType(),
@@ -341,14 +424,97 @@ public:
     return success();
   }
 };
-} // namespace
 
-static Value promoteOperand(OpBuilder &builder, Location loc, Value operand,
-                            Type promotedType) {
-  Type tensorPromotedType = cast<RankedTensorType>(operand.getType())
-                                .cloneWith(std::nullopt, promotedType);
-  return builder.create<FpToFpOp>(loc, tensorPromotedType, operand);
-}
+// Decomposes dots with very few rows (e.g. the decode phase of a transformer,
+// where M is the batch size) into a broadcasted multiply followed by a
+// reduction along K:
+//
+//   d[m, n] = c[m, n] + sum_k(a[m, k, 1] * b[1, k, n])
+//
+// The product lives in a 3D blocked layout that splits K across the lanes and
+// warps and keeps a vector of contiguous N elements in each thread, so B is
+// loaded with vectorized accesses and the reduction over K lowers to warp
+// shuffles (plus one shared memory round trip when K is split across warps).
+// Padding such dots to the MMA instruction shape wastes most of the tensor
+// core, and the FMA lowering walks K sequentially in every thread.
+class SkinnyDotToReduce : public mlir::OpRewritePattern<DotOp> {
+public:
+  SkinnyDotToReduce(mlir::MLIRContext *context)
+      : OpRewritePattern<DotOp>(context, /*benefit=*/2) {}
+
+  mlir::LogicalResult
+  matchAndRewrite(triton::DotOp dotOp,
+                  mlir::PatternRewriter &rewriter) const override {
+    std::optional<BlockedEncodingAttr> blocked3d =
+        getSkinnyDotProductLayout(dotOp);
+    if (!blocked3d)
+      return failure();
+
+    RankedTensorType oldRetType = dotOp.getType();
+    Type dElTy = oldRetType.getElementType();
+    bool isFloat = isa<FloatType>(dElTy);
+    int64_t M = dotOp.getA().getType().getShape()[0];
+    int64_t K = dotOp.getA().getType().getShape()[1];
+    int64_t N = dotOp.getB().getType().getShape()[1];
+
+    MLIRContext *ctx = dotOp.getContext();
+    auto aEncoding = SliceEncodingAttr::get(ctx, 2, *blocked3d);
+    auto bEncoding = SliceEncodingAttr::get(ctx, 0, *blocked3d);
+    auto dEncoding = SliceEncodingAttr::get(ctx, 1, *blocked3d);
+
+    Location loc = dotOp.getLoc();
+    // Move an operand to its slice of the product layout and promote it to
+    // the accumulator type before it is broadcast.
+    auto prepareOperand = [&](Value v, Attribute encoding, int axis) -> Value {
+      auto vType = cast<RankedTensorType>(v.getType());
+      v = rewriter.create<ConvertLayoutOp>(
+          loc,
+          RankedTensorType::get(vType.getShape(), vType.getElementType(),
+                                encoding),
+          v);
+      if (vType.getElementType() != dElTy) {
+        if (isFloat)
+          v = promoteOperand(rewriter, loc, v, dElTy);
+        else
+          v = rewriter.create<arith::ExtSIOp>(
+              loc, RankedTensorType::get(vType.getShape(), dElTy, encoding),
+              v);
+      }
+      v = rewriter.create<ExpandDimsOp>(loc, v, axis);
+      auto bcastType = RankedTensorType::get({M, K, N}, dElTy, *blocked3d);
+      return rewriter.create<BroadcastOp>(loc, bcastType, v);
+    };
+    Value a = prepareOperand(dotOp.getA(), aEncoding, 2);
+    Value b = prepareOperand(dotOp.getB(), bEncoding, 0);
+    Value prod =
+        isFloat ? rewriter.create<arith::MulFOp>(loc, a, b).getResult()
+                : rewriter.create<arith::MulIOp>(loc, a, b).getResult();
+
+    auto reduce = rewriter.create<ReduceOp>(loc, ValueRange{prod}, 1);
+    {
+      OpBuilder::InsertionGuard g(rewriter);
+      Block *combine = rewriter.createBlock(&reduce.getCombineOp(), {},
+                                            {dElTy, dElTy}, {loc, loc});
+      Value lhs = combine->getArgument(0);
+      Value rhs = combine->getArgument(1);
+      Value sum =
+          isFloat ? rewriter.create<arith::AddFOp>(loc, lhs, rhs).getResult()
+                  : rewriter.create<arith::AddIOp>(loc, lhs, rhs).getResult();
+      rewriter.create<ReduceReturnOp>(loc, sum);
+    }
+
+    auto accType =
+        RankedTensorType::get(oldRetType.getShape(), dElTy, dEncoding);
+    Value acc = rewriter.create<ConvertLayoutOp>(loc, accType, dotOp.getC());
+    Value partial = reduce.getResult()[0];
+    Value d =
+        isFloat ? rewriter.create<arith::AddFOp>(loc, acc, partial).getResult()
+                : rewriter.create<arith::AddIOp>(loc, acc, partial).getResult();
+    rewriter.replaceOpWithNewOp<ConvertLayoutOp>(dotOp, oldRetType, d);
+    return success();
+  }
+};
+} // namespace
 
 // promote operands of dot op if the existing combination is not natively
 // supported.
@@ -551,6 +717,7 @@ public:
     mlir::RewritePatternSet patterns(context);
     patterns.add<BlockedToMMA, ScaledBlockedToMMAv2>(context,
                                                      computeCapability);
+    patterns.add<SkinnyDotToReduce>(context);
     if (applyPatternsAndFoldGreedily(m, std::move(patterns)).failed()) {
       signalPassFailure();
     }
@@ -0,0 +1,166 @@
+#include "mlir/Analysis/DataFlowFramework.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Analysis/Alias.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "tritongpu-forward-shared-memory"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir {
+namespace triton {
+namespace gpu {
+
+#define GEN_PASS_DEF_TRITONGPUFORWARDSHAREDMEMORY
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+class SharedMemoryForwarder {
+public:
+  explicit SharedMemoryForwarder(SharedMemoryAliasAnalysis *analysis)
+      : analysis(analysis) {}
+
+  // Returns the tensor last written to the buffer `load` reads, if it is
+  // known at the load.
+  Value getForwardedValue(LocalLoadOp load) const {
+    Value buffer = load.getSrc();
+    if (auto alloc = buffer.getDefiningOp<LocalAllocOp>()) {
+      if (alloc.getSrc() && !alloc.getType().getMutableMemory())
+        return alloc.getSrc();
+    }
+    for (Operation *op = load->getPrevNode(); op; op = op->getPrevNode()) {
+      if (auto store = dyn_cast<LocalStoreOp>(op)) {
+        if (store.getDst() == buffer)
+          return store.getSrc();
+      }
+      if (auto alloc = dyn_cast<LocalAllocOp>(op)) {
+        if (alloc.getResult() == buffer)
+          return alloc.getSrc();
+      }
+      if (mayWriteTo(op, buffer))
+        return {};
+    }
+    return {};
+  }
+
+private:
+  bool mayAlias(Value lhs, Value rhs) const {
+    const DenseSet<Value> &lhsAllocs = getAllocs(lhs);
+    const DenseSet<Value> &rhsAllocs = getAllocs(rhs);
+    // No known buffer means the alias analysis gave up on the value.
+    if (lhsAllocs.empty() || rhsAllocs.empty())
+      return true;
+    return llvm::any_of(lhsAllocs,
+                        [&](Value alloc) { return rhsAllocs.contains(alloc); });
+  }
+
+  const DenseSet<Value> &getAllocs(Value value) const {
+    return analysis->getLatticeElement(value)->getValue().getAllocs();
+  }
+
+  // Whether `op`, or any op nested in it, may write to or free shared memory
+  // aliasing `buffer`. Ops with unknown effects are assumed to.
+  bool mayWriteTo(Operation *op, Value buffer) const {
+    auto result = op->walk([&](Operation *nested) {
+      if (isa<mlir::gpu::BarrierOp>(nested))
+        return WalkResult::advance();
+      auto memInterface = dyn_cast<MemoryEffectOpInterface>(nested);
+      if (!memInterface) {
+        if (nested->hasTrait<OpTrait::HasRecursiveMemoryEffects>())
+          return WalkResult::advance();
+        return WalkResult::interrupt();
+      }
+      SmallVector<SideEffects::EffectInstance<MemoryEffects::Effect>> effects;
+      memInterface.getEffects(effects);
+      for (const auto &effect : effects) {
+        if (!isa<MemoryEffects::Write, MemoryEffects::Free>(effect.getEffect()))
+          continue;
+        if (isa<triton::GlobalMemory>(effect.getResource()))
+          continue;
+        Value written = effect.getValue();
+        if (!written || !isa<MemDescType>(written.getType()) ||
+            mayAlias(written, buffer))
+          return WalkResult::interrupt();
+      }
+      return WalkResult::advance();
+    });
+    return result.wasInterrupted();
+  }
+
+  SharedMemoryAliasAnalysis *analysis;
+};
+
+// Erases shared memory buffers that are only written to or freed.
+void eraseWriteOnlyAllocs(ModuleOp m) {
+  SmallVector<LocalAllocOp> allocs;
+  m.walk([&](LocalAllocOp alloc) { allocs.push_back(alloc); });
+  for (LocalAllocOp alloc : allocs) {
+    bool writeOnly = llvm::all_of(alloc->getUsers(), [&](Operation *user) {
+      if (isa<LocalDeallocOp>(user))
+        return true;
+      auto store = dyn_cast<LocalStoreOp>(user);
+      return store && store.getDst() == alloc.getResult();
+    });
+    if (!writeOnly)
+      continue;
+    LDBG("erasing " << alloc);
+    for (Operation *user : llvm::make_early_inc_range(alloc->getUsers()))
+      user->erase();
+    alloc->erase();
+  }
+}
+
+} // namespace
+
+class TritonGPUForwardSharedMemoryPass
+    : public impl::TritonGPUForwardSharedMemoryBase<
+          TritonGPUForwardSharedMemoryPass> {
+public:
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    std::unique_ptr<DataFlowSolver> solver = createDataFlowSolver();
+    auto *analysis = solver->load<SharedMemoryAliasAnalysis>();
+    if (failed(solver->initializeAndRun(m)))
+      return signalPassFailure();
+    SharedMemoryForwarder forwarder(analysis);
+
+    SmallVector<LocalLoadOp> loads;
+    m.walk([&](LocalLoadOp load) { loads.push_back(load); });
+    for (LocalLoadOp load : loads) {
+      // Loads waiting on an async copy read what the copy wrote.
+      if (load.getToken())
+        continue;
+      Value forwarded = forwarder.getForwardedValue(load);
+      if (!forwarded)
+        continue;
+      auto srcTy = cast<RankedTensorType>(forwarded.getType());
+      RankedTensorType dstTy = load.getType();
+      if (srcTy.getShape() != dstTy.getShape() ||
+          srcTy.getElementType() != dstTy.getElementType())
+        continue;
+      if (srcTy.getEncoding() != dstTy.getEncoding()) {
+        if (cvtNeedsSharedMemory(srcTy, dstTy))
+          continue;
+        OpBuilder builder(load);
+        forwarded =
+            builder.create<ConvertLayoutOp>(load.getLoc(), dstTy, forwarded);
+      }
+      LDBG("forwarding " << forwarded << " to " << load);
+      load.getResult().replaceAllUsesWith(forwarded);
+      load.erase();
+    }
+
+    eraseWriteOnlyAllocs(m);
+  }
+};
+
+} // namespace gpu
+} // namespace triton
+} // namespace mlir
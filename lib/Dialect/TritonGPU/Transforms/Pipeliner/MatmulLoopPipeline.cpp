@@ -320,10 +320,9 @@ getSharedEncoding(Operation *loadOp, bool isMMAV3) {
     return localAllocEnc;
   }
 
-  // Use non-swizzled layout for loads that do not feed into dot ops.
-  // TODO: This won't be optimal for 2D tensors.
-  return ttg::SharedEncodingAttr::get(ty.getContext(), 1, 1, 1, order,
-                                      ctaLayout);
+  // Loads that do not feed into dot ops are read back in their own layout, so
+  // pick the swizzle with the fewest bank conflicts for that layout.
+  return getLeastConflictingSharedEncoding(ty, order, ctaLayout);
 }
 
 // Create a map from load ops to their indirection level and the
@@ -278,7 +278,12 @@ SmallVector<Value> LayoutPropagation::propagateToUsers(Value value,
     if (user->hasTrait<OpTrait::SameOperandsAndResultEncoding>() ||
         user->hasTrait<OpTrait::Elementwise>() ||
         isa<ReduceOp, ExpandDimsOp, ReshapeOp, TransOp, JoinOp, SplitOp,
-            ConvertLayoutOp>(user)) {
+            Int4ToFpOp, ConvertLayoutOp>(user)) {
+      // The layout of an int4 upcast is driven by its packed source; the scale
+      // just follows the result.
+      auto int4ToFp = dyn_cast<Int4ToFpOp>(user);
+      if (int4ToFp && use.get() == int4ToFp.getScale())
+        continue;
       setEncoding(user->getResults(), info, changed, user);
       continue;
     }
@@ -457,8 +462,13 @@ Operation *LayoutPropagation::cloneElementwise(OpBuilder &rewriter,
   }
 
   for (OpOperand &operand : op->getOpOperands()) {
+    // The scale of an int4 upcast has the layout of its result.
+    auto int4ToFp = dyn_cast<Int4ToFpOp>(op);
+    Attribute enc = int4ToFp && operand.get() == int4ToFp.getScale()
+                        ? encoding
+                        : *operandEnc;
     newOp->setOperand(operand.getOperandNumber(),
-                      getValueAs(operand.get(), *operandEnc));
+                      getValueAs(operand.get(), enc));
   }
 
   for (unsigned i = 0, e = op->getNumResults(); i < e; ++i) {
@@ -697,7 +707,7 @@ Operation *LayoutPropagation::rewriteOp(Operation *op) {
   if (op->hasTrait<OpTrait::SameOperandsAndResultEncoding>() ||
       op->hasTrait<OpTrait::Elementwise>() ||
       isa<ReduceOp, ExpandDimsOp, ReshapeOp, TransOp, JoinOp, SplitOp,
-          ConvertLayoutOp, nvidia_gpu::WarpGroupDotWaitOp>(op)) {
+          Int4ToFpOp, ConvertLayoutOp, nvidia_gpu::WarpGroupDotWaitOp>(op)) {
     Operation *newOp = cloneElementwise(rewriter, op, encoding);
     for (auto [oldResult, newResult] :
          llvm::zip(op->getResults(), newOp->getResults())) {
@@ -0,0 +1,113 @@
+#include "triton/Analysis/Allocation.h"
+#include "triton/Analysis/Utility.h"
+#include "triton/Dialect/Triton/IR/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/FormatVariadic.h"
+
+namespace mlir {
+namespace triton {
+namespace gpu {
+
+#define GEN_PASS_DEF_TRITONGPUREPORTBANKCONFLICTS
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+void emitBankConflictRemark(Operation *op, StringRef access,
+                            const BankConflicts &conflicts) {
+  op->emitRemark() << access << " has at worst " << conflicts.maxDegree
+                   << "-way and on average "
+                   << llvm::formatv("{0:F2}", conflicts.avgDegree).str()
+                   << "-way bank conflicts over " << conflicts.numAccesses
+                   << " accesses of " << conflicts.vecElems << " elements";
+}
+
+// Models the scratch buffer accesses of a convert_layout the way the
+// LinearLayout-based lowering emits them: a store of the source and a load of
+// the destination through the padded layout chosen by
+// chooseShemLayoutForRegToRegConversion.
+std::optional<std::pair<BankConflicts, BankConflicts>>
+getConvertLayoutBankConflicts(ConvertLayoutOp cvtOp) {
+  MLIRContext *ctx = cvtOp.getContext();
+  RankedTensorType srcTy = cvtOp.getSrc().getType();
+  RankedTensorType dstTy = cvtOp.getType();
+  if (!cvtNeedsSharedMemory(srcTy, dstTy))
+    return std::nullopt;
+  std::optional<LinearLayout> srcLayout =
+      toLinearLayout(srcTy.getShape(), srcTy.getEncoding());
+  std::optional<LinearLayout> dstLayout =
+      toLinearLayout(dstTy.getShape(), dstTy.getEncoding());
+  if (!srcLayout.has_value() || !dstLayout.has_value() ||
+      isCrossCTAConversion(srcLayout->invertAndCompose(*dstLayout)))
+    return std::nullopt;
+  ScratchConfig scratchConfig = getScratchConfigForCvt(srcTy, dstTy);
+  if (scratchConfig.repShape.empty())
+    return std::nullopt;
+
+  auto tensorShapePerCTA = convertType<unsigned, int64_t>(
+      getShapePerCTA(srcTy.getEncoding(), dstTy.getShape()));
+  LinearLayout sharedLayout = chooseShemLayoutForRegToRegConversion(
+      ctx, tensorShapePerCTA, scratchConfig.repShape, scratchConfig.order);
+  LinearLayout storeLayout =
+      getLayoutWithinBlock(*srcLayout).invertAndCompose(sharedLayout);
+  LinearLayout loadLayout =
+      getLayoutWithinBlock(*dstLayout).invertAndCompose(sharedLayout);
+
+  unsigned paddedStride = scratchConfig.repShape[scratchConfig.order[0]];
+  unsigned paddedSize =
+      scratchConfig.paddedRepShape[scratchConfig.order[0]] - paddedStride;
+  auto padOffset = [=](int32_t offset) -> int32_t {
+    return offset + offset / paddedStride * paddedSize;
+  };
+  // The lowering moves pointers as i64 and sub-byte integers as i8.
+  Type elemTy = srcTy.getElementType();
+  int elemBitWidth = isa<PointerType>(elemTy)
+                         ? 64
+                         : std::max(8u, elemTy.getIntOrFloatBitWidth());
+  return std::make_pair(getBankConflicts(storeLayout, elemBitWidth,
+                                         scratchConfig.inVec, padOffset),
+                        getBankConflicts(loadLayout, elemBitWidth,
+                                         scratchConfig.outVec, padOffset));
+}
+
+} // namespace
+
+class TritonGPUReportBankConflictsPass
+    : public impl::TritonGPUReportBankConflictsBase<
+          TritonGPUReportBankConflictsPass> {
+public:
+  void runOnOperation() override {
+    getOperation()->walk([&](Operation *op) {
+      if (auto allocOp = dyn_cast<LocalAllocOp>(op)) {
+        if (!allocOp.getSrc())
+          return;
+        if (auto conflicts = getBankConflicts(allocOp.getSrc().getType(),
+                                              allocOp.getType().getEncoding()))
+          emitBankConflictRemark(op, "shared memory store", *conflicts);
+      } else if (auto storeOp = dyn_cast<LocalStoreOp>(op)) {
+        if (auto conflicts = getBankConflicts(storeOp.getSrc().getType(),
+                                              storeOp.getDst()
+                                                  .getType()
+                                                  .getEncoding()))
+          emitBankConflictRemark(op, "shared memory store", *conflicts);
+      } else if (auto loadOp = dyn_cast<LocalLoadOp>(op)) {
+        if (auto conflicts = getBankConflicts(
+                loadOp.getType(), loadOp.getSrc().getType().getEncoding()))
+          emitBankConflictRemark(op, "shared memory load", *conflicts);
+      } else if (auto cvtOp = dyn_cast<ConvertLayoutOp>(op)) {
+        if (auto conflicts = getConvertLayoutBankConflicts(cvtOp)) {
+          emitBankConflictRemark(op, "layout conversion store",
+                                 conflicts->first);
+          emitBankConflictRemark(op, "layout conversion load",
+                                 conflicts->second);
+        }
+      }
+    });
+  }
+};
+
+} // namespace gpu
+} // namespace triton
+} // namespace mlir
@@ -0,0 +1,297 @@
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Support/LLVM.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+#include <set>
+
+#define DEBUG_TYPE "tritongpu-schedule-register-pressure"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace mlir {
+namespace triton {
+namespace gpu {
+
+#define GEN_PASS_DEF_TRITONGPUSCHEDULEREGISTERPRESSURE
+#include "triton/Dialect/TritonGPU/Transforms/Passes.h.inc"
+
+namespace {
+
+// Estimated number of 32-bit registers a value occupies in each thread.
+// Shared memory descriptors, tokens and the like live outside the register
+// file and count as 0.
+int64_t getRegisterFootprint(Type type) {
+  auto getScalarRegs = [](Type scalarTy) -> int64_t {
+    if (isa<PointerType>(scalarTy))
+      return 2;
+    if (scalarTy.isIntOrIndexOrFloat())
+      return llvm::divideCeil(scalarTy.getIntOrFloatBitWidth(), 32);
+    return 0;
+  };
+  if (auto tensorTy = dyn_cast<RankedTensorType>(type)) {
+    if (!isa_and_nonnull<DistributedEncodingTrait>(tensorTy.getEncoding()))
+      return 0;
+    Type elemTy = tensorTy.getElementType();
+    int64_t elems = getTotalElemsPerThread(tensorTy);
+    if (isa<PointerType>(elemTy))
+      return 2 * elems;
+    return llvm::divideCeil(elems * elemTy.getIntOrFloatBitWidth(), 32);
+  }
+  return getScalarRegs(type);
+}
+
+bool isGlobalLoad(Operation *op) {
+  return isa<LoadOp, AsyncCopyGlobalToLocalOp>(op);
+}
+
+// Dependence graph of the non-terminator ops of a block.
+class BlockScheduler {
+public:
+  explicit BlockScheduler(Block *block) : block(block) {
+    for (Operation &op : block->without_terminator()) {
+      index[&op] = ops.size();
+      ops.push_back(&op);
+    }
+    preds.resize(ops.size());
+    succs.resize(ops.size());
+    buildDependences();
+    computeLastUses();
+  }
+
+  size_t size() const { return ops.size(); }
+  ArrayRef<Operation *> getOriginalOrder() const { return ops; }
+
+  // Peak estimated live registers when the ops execute in `order`.
+  int64_t getPeakPressure(ArrayRef<Operation *> order) const {
+    llvm::SmallDenseMap<Value, unsigned> remainingUses = usesInBlock;
+    int64_t live = liveInRegs;
+    int64_t peak = live;
+    for (Operation *op : order) {
+      for (Value result : op->getResults())
+        live += getRegisterFootprint(result.getType());
+      peak = std::max(peak, live);
+      live -= releasedBy(op, remainingUses);
+    }
+    return peak;
+  }
+
+  // List-schedules the block. Under the budget, ready global loads go first
+  // and other ops keep their original order; over it, the op whose execution
+  // frees the most registers goes first.
+  SmallVector<Operation *> schedule(int64_t budget) const {
+    SmallVector<unsigned> numPendingPreds;
+    for (const auto &p : preds)
+      numPendingPreds.push_back(p.size());
+    std::set<unsigned> ready;
+    for (unsigned i = 0; i < ops.size(); ++i)
+      if (numPendingPreds[i] == 0)
+        ready.insert(i);
+
+    llvm::SmallDenseMap<Value, unsigned> remainingUses = usesInBlock;
+    int64_t live = liveInRegs;
+    SmallVector<Operation *> order;
+    while (!ready.empty()) {
+      unsigned pick = *ready.begin();
+      if (live <= budget) {
+        for (unsigned i : ready) {
+          if (isGlobalLoad(ops[i])) {
+            pick = i;
+            break;
+          }
+        }
+      } else {
+        int64_t bestDelta = std::numeric_limits<int64_t>::max();
+        for (unsigned i : ready) {
+          int64_t delta = getDelta(ops[i], remainingUses);
+          if (delta < bestDelta) {
+            bestDelta = delta;
+            pick = i;
+          }
+        }
+      }
+      ready.erase(pick);
+      Operation *op = ops[pick];
+      order.push_back(op);
+      for (Value result : op->getResults())
+        live += getRegisterFootprint(result.getType());
+      live -= releasedBy(op, remainingUses);
+      for (unsigned succ : succs[pick])
+        if (--numPendingPreds[succ] == 0)
+          ready.insert(succ);
+    }
+    assert(order.size() == ops.size() && "dependence cycle in a block");
+    return order;
+  }
+
+private:
+  void addEdge(unsigned from, unsigned to) {
+    if (from == to || !preds[to].insert(from).second)
+      return;
+    succs[from].push_back(to);
+  }
+
+  // SSA edges, including uses nested in regions, and memory edges: an op that
+  // may write depends on every earlier memory op, and an op that only reads
+  // depends on the last op that may write.
+  void buildDependences() {
+    std::optional<unsigned> lastWriter;
+    SmallVector<unsigned> readersSinceWrite;
+    for (auto [i, op] : llvm::enumerate(ops)) {
+      op->walk([&](Operation *nested) {
+        for (Value operand : nested->getOperands()) {
+          Operation *def = operand.getDefiningOp();
+          if (def && def->getBlock() == block && index.count(def))
+            addEdge(index.lookup(def), i);
+        }
+      });
+
+      if (isMemoryEffectFree(op))
+        continue;
+      auto memInterface = dyn_cast<MemoryEffectOpInterface>(op);
+      bool onlyReads = op->getNumRegions() == 0 && memInterface &&
+                       memInterface.onlyHasEffect<MemoryEffects::Read>();
+      if (onlyReads) {
+        if (lastWriter)
+          addEdge(*lastWriter, i);
+        readersSinceWrite.push_back(i);
+        continue;
+      }
+      if (lastWriter)
+        addEdge(*lastWriter, i);
+      for (unsigned reader : readersSinceWrite)
+        addEdge(reader, i);
+      readersSinceWrite.clear();
+      lastWriter = i;
+    }
+  }
+
+  // Counts the in-block uses of every value the block's ops read. Values
+  // defined outside the block are live throughout it (a loop body needs them
+  // again on the next iteration), as are values used by the terminator or
+  // outside the block, so those are never released.
+  void computeLastUses() {
+    DenseSet<Value> liveIn;
+    for (Operation *op : ops) {
+      op->walk([&](Operation *nested) {
+        for (Value operand : nested->getOperands()) {
+          if (op->isAncestor(operand.getParentRegion()->getParentOp()))
+            continue;
+          ++usesInBlock[operand];
+          if (operand.getParentBlock() != block) {
+            liveIn.insert(operand);
+            escaping.insert(operand);
+          } else if (isa<BlockArgument>(operand)) {
+            liveIn.insert(operand);
+          }
+        }
+      });
+    }
+    for (Value value : liveIn)
+      liveInRegs += getRegisterFootprint(value.getType());
+    for (Value operand : block->getTerminator()->getOperands())
+      escaping.insert(operand);
+    for (Operation *op : ops)
+      for (Value result : op->getResults())
+        for (Operation *user : result.getUsers())
+          if (!block->findAncestorOpInBlock(*user))
+            escaping.insert(result);
+  }
+
+  // Registers freed once `op` has executed, updating the remaining use counts.
+  int64_t releasedBy(Operation *op,
+                     llvm::SmallDenseMap<Value, unsigned> &remainingUses) const {
+    int64_t released = 0;
+    op->walk([&](Operation *nested) {
+      for (Value operand : nested->getOperands()) {
+        auto it = remainingUses.find(operand);
+        if (it == remainingUses.end() || it->second == 0)
+          continue;
+        if (--it->second == 0 && !escaping.contains(operand))
+          released += getRegisterFootprint(operand.getType());
+      }
+    });
+    for (Value result : op->getResults())
+      if (!usesInBlock.count(result) && !escaping.contains(result))
+        released += getRegisterFootprint(result.getType());
+    return released;
+  }
+
+  // Net change of live registers if `op` executed next.
+  int64_t getDelta(Operation *op,
+                   llvm::SmallDenseMap<Value, unsigned> remainingUses) const {
+    int64_t defined = 0;
+    for (Value result : op->getResults())
+      defined += getRegisterFootprint(result.getType());
+    return defined - releasedBy(op, remainingUses);
+  }
+
+  Block *block;
+  SmallVector<Operation *> ops;
+  DenseMap<Operation *, unsigned> index;
+  SmallVector<llvm::SmallDenseSet<unsigned, 4>> preds;
+  SmallVector<SmallVector<unsigned>> succs;
+  llvm::SmallDenseMap<Value, unsigned> usesInBlock;
+  DenseSet<Value> escaping;
+  int64_t liveInRegs = 0;
+};
+
+} // namespace
+
+class TritonGPUScheduleRegisterPressurePass
+    : public impl::TritonGPUScheduleRegisterPressureBase<
+          TritonGPUScheduleRegisterPressurePass> {
+public:
+  using impl::TritonGPUScheduleRegisterPressureBase<
+      TritonGPUScheduleRegisterPressurePass>::
+      TritonGPUScheduleRegisterPressureBase;
+
+  void runOnOperation() override {
+    ModuleOp m = getOperation();
+    int64_t budget = registerBudget;
+    if (budget <= 0) {
+      // Enough registers for one CTA per SM with a 64K register file, capped
+      // at the per-thread hardware limit.
+      int numThreads = TritonGPUDialect::getNumWarps(m) *
+                       TritonGPUDialect::getThreadsPerWarp(m);
+      budget = std::min<int64_t>(255, 65536 / std::max(numThreads, 1));
+    }
+
+    m.walk([&](FunctionOpInterface funcOp) {
+      int64_t peakBefore = 0;
+      int64_t peakAfter = 0;
+      SmallVector<Block *> blocks;
+      funcOp->walk([&](Block *block) {
+        if (!block->empty() && block->back().hasTrait<OpTrait::IsTerminator>())
+          blocks.push_back(block);
+      });
+      for (Block *block : blocks) {
+        BlockScheduler scheduler(block);
+        if (scheduler.size() < 2)
+          continue;
+        int64_t before = scheduler.getPeakPressure(scheduler.getOriginalOrder());
+        SmallVector<Operation *> order = scheduler.schedule(budget);
+        int64_t after = scheduler.getPeakPressure(order);
+        LDBG("block with " << scheduler.size() << " ops: peak " << before
+                           << " -> " << after << " registers");
+        if (after > before && after > budget) {
+          after = before;
+        } else {
+          Operation *terminator = block->getTerminator();
+          for (Operation *op : order)
+            op->moveBefore(terminator);
+        }
+        peakBefore = std::max(peakBefore, before);
+        peakAfter = std::max(peakAfter, after);
+      }
+      funcOp->emitRemark() << "estimated peak register pressure: "
+                           << peakBefore << " before and " << peakAfter
+                           << " after scheduling, budget " << budget;
+    });
+  }
+};
+
+} // namespace gpu
+} // namespace triton
+} // namespace mlir
@@ -12,6 +12,7 @@
 #include "triton/Dialect/Triton/IR/Dialect.h"
 #include "triton/Dialect/Triton/IR/Utility.h"
 #include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/IR/LinearLayoutConversions.h"
 #include "triton/Dialect/TritonGPU/Transforms/Utility.h"
 #include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
 #include "llvm/Support/Debug.h"
@@ -108,6 +109,40 @@ unsigned getElementBitWidth(RankedTensorType type) {
   return typeForMem.getIntOrFloatBitWidth();
 }
 
+triton::gpu::SharedEncodingAttr
+getLeastConflictingSharedEncoding(RankedTensorType registerTy,
+                                  ArrayRef<unsigned> order,
+                                  triton::gpu::CTALayoutAttr ctaLayout) {
+  MLIRContext *ctx = registerTy.getContext();
+  auto unswizzled =
+      triton::gpu::SharedEncodingAttr::get(ctx, 1, 1, 1, order, ctaLayout);
+  auto best = unswizzled;
+  auto bestConflicts = triton::gpu::getBankConflicts(registerTy, unswizzled);
+  if (!bestConflicts || bestConflicts->maxDegree == 1 || order.size() < 2)
+    return best;
+
+  // Swizzle whole vectors so every access stays contiguous, and only within
+  // the columns of the inner dimension.
+  unsigned vec = bestConflicts->vecElems;
+  int64_t numCols = registerTy.getShape()[order[0]];
+  for (unsigned maxPhase = 2; maxPhase * vec <= numCols && maxPhase <= 32;
+       maxPhase *= 2) {
+    for (unsigned perPhase = 1; perPhase <= 8; perPhase *= 2) {
+      auto candidate = triton::gpu::SharedEncodingAttr::get(
+          ctx, vec, perPhase, maxPhase, order, ctaLayout);
+      auto conflicts = triton::gpu::getBankConflicts(registerTy, candidate);
+      if (!conflicts || conflicts->vecElems < vec)
+        continue;
+      if (std::make_pair(conflicts->avgDegree, conflicts->maxDegree) <
+          std::make_pair(bestConflicts->avgDegree, bestConflicts->maxDegree)) {
+        best = candidate;
+        bestConflicts = conflicts;
+      }
+    }
+  }
+  return best;
+}
+
 unsigned getNumElementsPerThread(Operation *op, SmallVector<unsigned> order,
                                  ModuleAxisInfoAnalysis &axisInfoAnalysis) {
   Value val = getMemAccessPtr(op);
@@ -325,6 +360,20 @@ static std::optional<Attribute> inferDstEncoding(SplitOp op, Attribute srcEnc) {
   return std::nullopt;
 }
 
+static std::optional<Attribute> inferDstEncoding(Int4ToFpOp op,
+                                                 Attribute srcEnc) {
+  Attribute dstEnc;
+  if (srcEnc.getDialect()
+          .getRegisteredInterface<DialectInferLayoutInterface>()
+          ->inferInt4ToFpOpEncoding(srcEnc, op.getAxis(), dstEnc,
+                                    /*fwdInference=*/true,
+                                    /*loc=*/std::nullopt)
+          .succeeded()) {
+    return dstEnc;
+  }
+  return std::nullopt;
+}
+
 static std::optional<Attribute> inferSrcEncoding(triton::ReduceOp op,
                                                  Attribute encoding) {
   auto sliceEncoding = mlir::dyn_cast<triton::gpu::SliceEncodingAttr>(encoding);
@@ -365,6 +414,20 @@ static std::optional<Attribute> inferSrcEncoding(SplitOp op, Attribute dstEnc) {
   return std::nullopt;
 }
 
+static std::optional<Attribute> inferSrcEncoding(Int4ToFpOp op,
+                                                 Attribute dstEnc) {
+  Attribute srcEnc;
+  if (dstEnc.getDialect()
+          .getRegisteredInterface<DialectInferLayoutInterface>()
+          ->inferInt4ToFpOpEncoding(dstEnc, op.getAxis(), srcEnc,
+                                    /*fwdInference=*/false,
+                                    /*loc=*/std::nullopt)
+          .succeeded()) {
+    return srcEnc;
+  }
+  return std::nullopt;
+}
+
 static std::optional<Attribute>
 inferTransOpDstEncoding(Attribute srcEnc, ArrayRef<int32_t> order) {
   // Simply forward to the existing inferTransOpEncoding function.
@@ -446,8 +509,8 @@ static bool isSingleValue(Value value) {
 }
 
 std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
-  if (isa<triton::ScanOp>(op)) {
-    // Scan only supports blocked encoding at the moment.
+  if (isa<triton::ScanOp, triton::SortOp, triton::TopKOp>(op)) {
+    // Scan and sort only support blocked encoding at the moment.
     if (!isa<triton::gpu::BlockedEncodingAttr>(encoding))
       return std::nullopt;
   }
@@ -467,6 +530,8 @@ std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
     return inferSrcEncoding(join, encoding);
   if (auto split = dyn_cast<triton::SplitOp>(op))
     return inferSrcEncoding(split, encoding);
+  if (auto int4ToFp = dyn_cast<triton::Int4ToFpOp>(op))
+    return inferSrcEncoding(int4ToFp, encoding);
   if (auto trans = dyn_cast<triton::TransOp>(op))
     return inferSrcEncoding(trans, encoding);
   if (auto reshape = dyn_cast<triton::ReshapeOp>(op))
@@ -476,7 +541,7 @@ std::optional<Attribute> inferSrcEncoding(Operation *op, Attribute encoding) {
 }
 
 std::optional<Attribute> inferDstEncoding(Operation *op, Attribute encoding) {
-  if (isa<triton::ScanOp>(op)) {
+  if (isa<triton::ScanOp, triton::SortOp, triton::TopKOp>(op)) {
     if (!isa<triton::gpu::BlockedEncodingAttr>(encoding))
       return std::nullopt;
   }
@@ -494,6 +559,8 @@ std::optional<Attribute> inferDstEncoding(Operation *op, Attribute encoding) {
     return inferDstEncoding(join, encoding);
   if (auto split = dyn_cast<triton::SplitOp>(op))
     return inferDstEncoding(split, encoding);
+  if (auto int4ToFp = dyn_cast<triton::Int4ToFpOp>(op))
+    return inferDstEncoding(int4ToFp, encoding);
   if (auto trans = dyn_cast<triton::TransOp>(op))
     return inferDstEncoding(trans, encoding);
   if (auto reshape = dyn_cast<triton::ReshapeOp>(op))
@@ -820,6 +887,12 @@ getConvertBackwardSlice(Value root, SetVector<Value> &slice,
       if (isa<triton::CatOp>(definingOp))
         return failure();
       for (Value operand : definingOp->getOperands()) {
+        // The scale of an int4 upcast has the layout of its result.
+        auto int4ToFp = dyn_cast<triton::Int4ToFpOp>(definingOp);
+        if (int4ToFp && operand == int4ToFp.getScale()) {
+          enqueue(operand, encoding);
+          continue;
+        }
         auto srcEncoding = inferSrcEncoding(definingOp, encoding);
         if (!srcEncoding)
           return failure();
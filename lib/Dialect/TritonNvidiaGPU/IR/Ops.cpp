@@ -160,6 +160,38 @@ void WaitBarrierOp::getEffects(
                        mlir::triton::gpu::SharedMemory::get());
 }
 
+// -- ArriveBarrierOp --
+LogicalResult ArriveBarrierOp::verify() {
+  if (failed(verifyBarrierType(*this, getAlloc().getType())))
+    return failure();
+  return success();
+}
+
+void ArriveBarrierOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  effects.emplace_back(MemoryEffects::Read::get(), &getAllocMutable(),
+                       mlir::triton::gpu::SharedMemory::get());
+  effects.emplace_back(MemoryEffects::Write::get(), &getAllocMutable(),
+                       mlir::triton::gpu::SharedMemory::get());
+}
+
+// -- RegAllocOp / RegDeallocOp --
+static LogicalResult verifyRegCount(Operation *op, int regCount) {
+  if (regCount < 24 || regCount > 256 || regCount % 8 != 0)
+    return op->emitOpError(
+        "register count must be a multiple of 8 between 24 and 256");
+  return success();
+}
+
+LogicalResult RegAllocOp::verify() {
+  return verifyRegCount(*this, getRegCount());
+}
+
+LogicalResult RegDeallocOp::verify() {
+  return verifyRegCount(*this, getRegCount());
+}
+
 // -- AsyncTMACopyGlobalToLocalOp --
 LogicalResult AsyncTMACopyGlobalToLocalOp::verify() {
   if (failed(verifyBarrierType(*this, getBarrier().getType())))
@@ -340,12 +340,19 @@ bool CTAPlanner::processReduce(triton::FuncOp &funcOp) {
     llvm::SmallVector<unsigned> CTASplitNum = CTAsPerCGA;
 
     // If numCTAs > 1 and the only dimension is the reduced dimension, after the
-    // above two for-loops, CTAsPerCGA = [0] and remainingCTAs = numCTAs. We set
-    // CTAsPerCGA[0] = numCTAs and keep CTASplitNum[0] = 1 to ensure that no
-    // cross-CTA reduction is required, although this will introduce duplicated
-    // calculation
-    if (remainingCTAs > 0)
+    // above two for-loops, CTAsPerCGA = [1] and remainingCTAs = numCTAs. Split
+    // the reduced dimension across the cluster when it is wide enough; the
+    // partial results are then combined through distributed shared memory.
+    // Otherwise set CTAsPerCGA[0] = numCTAs and keep CTASplitNum[0] = 1 so
+    // that no cross-CTA reduction is required, although this will introduce
+    // duplicated calculation.
+    if (rank == 1 && remainingCTAs > 1 &&
+        srcShape[axis] / sizePerThread[axis] >= remainingCTAs) {
+      CTAsPerCGA[axis] *= remainingCTAs;
+      CTASplitNum[axis] *= remainingCTAs;
+    } else if (remainingCTAs > 0) {
       CTAsPerCGA[order[rank - 1]] *= remainingCTAs;
+    }
 
     auto CTALayout =
         ttg::CTALayoutAttr::get(context, CTAsPerCGA, CTASplitNum, CTAOrder);
@@ -1003,8 +1010,13 @@ struct PlanCTAPass : public TritonGPUPlanCTAPassBase<PlanCTAPass> {
     if (ttg::TritonGPUDialect::getNumCTAs(mod) == 1)
       return;
 
+    // Without a caller-provided ClusterInfo (e.g. in triton-opt), the planned
+    // cluster shape is discarded.
+    ttng::ClusterInfo localClusterInfo;
+    ttng::ClusterInfo *info = clusterInfo ? clusterInfo : &localClusterInfo;
+
     mod.walk([&](triton::FuncOp funcOp) {
-      CTAPlanner planner(clusterInfo);
+      CTAPlanner planner(info);
       planner.run(funcOp);
 
       // FIXME: Clone funcOp so that the IR change can be identified after
@@ -0,0 +1,397 @@
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "triton/Dialect/Triton/IR/Utility.h"
+#include "triton/Dialect/TritonGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonGPU/Transforms/PipeliningUtility.h"
+#include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
+#include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/Debug.h"
+
+//===----------------------------------------------------------------------===//
+//
+// This pass splits a loop feeding warp_group_dot from TMA loads between two
+// warp groups. The producer warp group only issues the TMA copies, into a
+// ring of num-stages shared memory buffers, while the consumer warp group runs
+// the rest of the loop on the buffers. Each slot of the ring has a "full"
+// mbarrier, completed by the TMA transaction, and an "empty" mbarrier the
+// consumer threads arrive on once they are done with the slot. The producer
+// gives registers up to the consumer before entering its loop.
+//
+// The consumer keeps warp group 0 so that the layouts of the tensors it
+// computes do not change; the producer is warp group 1. The loop is rewritten
+// before software pipelining, which the ring replaces, and the whole kernel
+// after the loop only runs in the consumer.
+//
+//===----------------------------------------------------------------------===//
+
+using namespace mlir;
+namespace tt = ::mlir::triton;
+namespace ttg = ::mlir::triton::gpu;
+namespace ttng = ::mlir::triton::nvidia_gpu;
+
+#define GEN_PASS_CLASSES
+#include "triton/Dialect/TritonNvidiaGPU/Transforms/Passes.h.inc"
+
+#define DEBUG_TYPE "triton-nvidia-gpu-warp-specialize"
+#define DBGS() (llvm::dbgs() << "[" DEBUG_TYPE "]: ")
+#define LDBG(X) LLVM_DEBUG(DBGS() << X << "\n")
+
+namespace {
+
+constexpr int kProducerWarpGroup = 1;
+// Named barriers the partitions synchronize through; 0 is the CTA barrier.
+// Warp group i uses barrier i + 1, which is also what the barriers emitted by
+// the lowering of its ops are lowered to.
+constexpr int kConsumerBarrierId = 1;
+constexpr int kProducerBarrierId = kProducerWarpGroup + 1;
+
+// A TMA load of the loop and the local_alloc it is only used by.
+struct RingLoad {
+  tt::ExperimentalDescriptorLoadOp load;
+  ttg::LocalAllocOp alloc;
+  Value ring;
+};
+
+SmallVector<RingLoad> getRingLoads(scf::ForOp forOp) {
+  SmallVector<RingLoad> loads;
+  bool hasDot = false;
+  unsigned numLoads = 0;
+  forOp.getBody()->walk([&](Operation *op) {
+    hasDot |= isa<ttng::WarpGroupDotOp>(op);
+    numLoads += isa<tt::ExperimentalDescriptorLoadOp>(op);
+  });
+  Block *body = forOp.getBody();
+  for (auto load : body->getOps<tt::ExperimentalDescriptorLoadOp>()) {
+    if (!load->hasOneUse())
+      return {};
+    auto alloc = dyn_cast<ttg::LocalAllocOp>(*load->user_begin());
+    if (!alloc || alloc->getBlock() != body)
+      return {};
+    loads.push_back({load, alloc, Value()});
+  }
+  // Loads nested in the body would have to be split as well.
+  if (!hasDot || loads.empty() || numLoads != loads.size())
+    return {};
+  return loads;
+}
+
+// Whether the ops of the kernel before the loop may run in both warp groups.
+bool canRunInBothGroups(scf::ForOp forOp) {
+  for (Operation &op : llvm::make_range(forOp->getBlock()->begin(),
+                                        forOp->getIterator())) {
+    if (isMemoryEffectFree(&op))
+      continue;
+    auto memEffects = dyn_cast<MemoryEffectOpInterface>(&op);
+    if (!memEffects)
+      return false;
+    SmallVector<MemoryEffects::EffectInstance> effects;
+    memEffects.getEffects(effects);
+    for (const auto &effect : effects)
+      if (isa<MemoryEffects::Write>(effect.getEffect()) &&
+          effect.getResource() != ttg::SharedMemory::get())
+        return false;
+  }
+  return true;
+}
+
+Value createConstant(OpBuilder &builder, Location loc, int64_t value,
+                     int width = 32) {
+  return builder.create<arith::ConstantIntOp>(loc, value, width);
+}
+
+Value createBarrierView(OpBuilder &builder, Location loc, Value barriers,
+                        Value slot) {
+  auto barriersTy = cast<tt::MemDescType>(barriers.getType());
+  auto viewTy = tt::MemDescType::get(
+      {1}, barriersTy.getElementType(), barriersTy.getEncoding(),
+      barriersTy.getMemorySpace(), /*mutableMemory=*/true);
+  return builder.create<ttg::MemDescSubviewOp>(loc, viewTy, barriers, slot);
+}
+
+Value createBufferView(OpBuilder &builder, Location loc, Value ring,
+                       Value slot) {
+  auto ringTy = cast<tt::MemDescType>(ring.getType());
+  auto viewTy = tt::MemDescType::get(
+      ringTy.getShape().drop_front(), ringTy.getElementType(),
+      ringTy.getEncoding(), ringTy.getMemorySpace(), /*mutableMemory=*/true);
+  SmallVector<Value> offsets(ringTy.getRank(),
+                             createConstant(builder, loc, 0));
+  offsets[0] = slot;
+  return builder.create<ttg::MemDescSubviewOp>(loc, viewTy, ring, offsets);
+}
+
+Value createBarriers(OpBuilder &builder, Location loc, int numStages,
+                     int count) {
+  MLIRContext *ctx = builder.getContext();
+  auto ctaLayout = ttg::CTALayoutAttr::get(ctx, /*CTAsPerCGA=*/{1},
+                                           /*CTASplitNum=*/{1},
+                                           /*CTAOrder=*/{0});
+  auto encoding = ttg::SharedEncodingAttr::get(ctx, 1, 1, 1, {0}, ctaLayout);
+  auto barriersTy = tt::MemDescType::get(
+      {numStages}, builder.getI64Type(), encoding,
+      ttg::SharedMemorySpaceAttr::get(ctx), /*mutableMemory=*/true);
+  Value barriers = builder.create<ttg::LocalAllocOp>(loc, barriersTy, Value());
+  for (int i = 0; i < numStages; ++i) {
+    Value idx = createConstant(builder, loc, i);
+    Value view = createBarrierView(builder, loc, barriers, idx);
+    builder.create<ttng::InitBarrierOp>(loc, view, count);
+  }
+  return barriers;
+}
+
+void invalidateBarriers(OpBuilder &builder, Location loc, Value barriers) {
+  int numStages = cast<tt::MemDescType>(barriers.getType()).getShape()[0];
+  for (int i = 0; i < numStages; ++i) {
+    Value idx = createConstant(builder, loc, i);
+    Value view = createBarrierView(builder, loc, barriers, idx);
+    builder.create<ttng::InvalBarrierOp>(loc, view);
+  }
+}
+
+// Emits, at the start of the body of `loop`, the slot of the ring the
+// iteration uses and the parity of the phase the barriers of the slot are in.
+std::pair<Value, Value> createSlotAndPhase(scf::ForOp loop, int numStages) {
+  OpBuilder builder = OpBuilder::atBlockBegin(loop.getBody());
+  Location loc = loop.getLoc();
+  Value iteration = builder.create<arith::DivSIOp>(
+      loc,
+      builder.create<arith::SubIOp>(loc, loop.getInductionVar(),
+                                    loop.getLowerBound()),
+      loop.getStep());
+  Value numStagesVal = createConstant(builder, loc, numStages);
+  Value slot = builder.create<arith::RemSIOp>(loc, iteration, numStagesVal);
+  Value round = builder.create<arith::DivSIOp>(loc, iteration, numStagesVal);
+  Value one = createConstant(builder, loc, 1);
+  Value phase = builder.create<arith::AndIOp>(loc, round, one);
+  return {slot, phase};
+}
+
+// Erases everything in the body of `loop` that `roots` do not depend on. The
+// loop-carried values nothing depends on are carried unchanged.
+void pruneLoop(scf::ForOp loop, ArrayRef<Operation *> roots) {
+  Block *body = loop.getBody();
+  auto yield = cast<scf::YieldOp>(body->getTerminator());
+  DenseSet<Operation *> live;
+  llvm::BitVector liveArgs(loop.getNumRegionIterArgs());
+  SmallVector<Value> worklist;
+  auto addOperands = [&](Operation *op) {
+    op->walk([&](Operation *nested) {
+      worklist.append(nested->operand_begin(), nested->operand_end());
+    });
+  };
+  for (Operation *root : roots) {
+    live.insert(root);
+    addOperands(root);
+  }
+  while (!worklist.empty()) {
+    Value value = worklist.pop_back_val();
+    if (auto arg = dyn_cast<BlockArgument>(value)) {
+      if (arg.getOwner() != body || arg == loop.getInductionVar())
+        continue;
+      unsigned idx = arg.getArgNumber() - 1;
+      if (!liveArgs.test(idx)) {
+        liveArgs.set(idx);
+        worklist.push_back(yield.getOperand(idx));
+      }
+      continue;
+    }
+    Operation *def = body->findAncestorOpInBlock(*value.getDefiningOp());
+    if (def && live.insert(def).second)
+      addOperands(def);
+  }
+
+  for (auto [idx, arg] : llvm::enumerate(loop.getRegionIterArgs()))
+    if (!liveArgs.test(idx))
+      yield.setOperand(idx, arg);
+  for (Operation &op :
+       llvm::make_early_inc_range(llvm::reverse(body->without_terminator())))
+    if (!live.contains(&op))
+      op.erase();
+}
+
+class WarpSpecializePass
+    : public TritonNvidiaGPUWarpSpecializePassBase<WarpSpecializePass> {
+public:
+  WarpSpecializePass() = default;
+  WarpSpecializePass(int numStages) { this->numStages = numStages; }
+
+  void runOnOperation() override {
+    ModuleOp mod = getOperation();
+    if (mod->hasAttr("triton_gpu.num-warp-groups-per-cta"))
+      return;
+    bool specialized = false;
+    mod.walk([&](tt::FuncOp funcOp) {
+      if (funcOp.isExternal() || funcOp.getNumResults() != 0 ||
+          !funcOp.getBody().hasOneBlock())
+        return;
+      // The kernel after the loop moves to the consumer, so only the first
+      // loop of the kernel is split.
+      for (auto forOp : funcOp.getBody().front().getOps<scf::ForOp>()) {
+        SmallVector<RingLoad> loads = getRingLoads(forOp);
+        if (loads.empty() || !forOp.getInductionVar().getType().isInteger(32) ||
+            !canRunInBothGroups(forOp))
+          continue;
+        specialize(forOp, loads);
+        specialized = true;
+        break;
+      }
+    });
+    if (specialized)
+      mod->setAttr("triton_gpu.num-warp-groups-per-cta",
+                   IntegerAttr::get(IntegerType::get(mod.getContext(), 32), 2));
+  }
+
+private:
+  void specialize(scf::ForOp forOp, MutableArrayRef<RingLoad> loads) {
+    LDBG("specializing " << forOp);
+    auto mod = forOp->getParentOfType<ModuleOp>();
+    int numThreads = ttg::TritonGPUDialect::getNumWarps(mod) *
+                     ttg::TritonGPUDialect::getThreadsPerWarp(mod);
+    int depth = numStages;
+    if (auto attr = forOp->getAttrOfType<IntegerAttr>(tt::kNumStagesAttrName))
+      depth = std::max<int>(attr.getInt(), 1);
+    Location loc = forOp.getLoc();
+    Block *block = forOp->getBlock();
+    OpBuilder builder(forOp);
+
+    int64_t bytesPerStage = 0;
+    for (RingLoad &ringLoad : loads) {
+      auto allocTy = ringLoad.alloc.getType();
+      SmallVector<int64_t> shape(allocTy.getShape());
+      shape.insert(shape.begin(), depth);
+      auto ringTy = tt::MemDescType::get(
+          shape, allocTy.getElementType(), allocTy.getEncoding(),
+          allocTy.getMemorySpace(), /*mutableMemory=*/true);
+      ringLoad.ring = builder.create<ttg::LocalAllocOp>(loc, ringTy, Value());
+      bytesPerStage += product(allocTy.getShape()) *
+                       allocTy.getElementType().getIntOrFloatBitWidth() / 8;
+    }
+    Value fullBarriers = createBarriers(builder, loc, depth, /*count=*/1);
+    Value emptyBarriers = createBarriers(builder, loc, depth, numThreads);
+    // The barriers are initialized by a consumer thread, and used by both warp
+    // groups.
+    int numCTAThreads = numThreads * (kProducerWarpGroup + 1);
+    auto initBarrier = builder.create<gpu::BarrierOp>(loc);
+    initBarrier->setAttr("bar_id", builder.getI32IntegerAttr(0));
+    initBarrier->setAttr("num_threads",
+                         builder.getI32IntegerAttr(numCTAThreads));
+
+    Value warpGroupId =
+        builder.create<ttng::GetWarpGroupIdOp>(loc, builder.getI32Type());
+    Value isProducer = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, warpGroupId,
+        createConstant(builder, loc, kProducerWarpGroup));
+    auto ifOp = builder.create<scf::IfOp>(loc, isProducer,
+                                          /*withElseRegion=*/true);
+
+    // Producer: wait for the slot to be empty, then fill it.
+    OpBuilder thenBuilder = ifOp.getThenBodyBuilder();
+    auto regDealloc =
+        thenBuilder.create<ttng::RegDeallocOp>(loc, producerRegCount);
+    regDealloc->setAttr("triton_gpu.partition_barrier",
+                        thenBuilder.getDenseI32ArrayAttr(
+                            {kProducerBarrierId, numThreads}));
+    IRMapping producerMapping;
+    auto producerLoop =
+        cast<scf::ForOp>(thenBuilder.clone(*forOp, producerMapping));
+    auto [producerSlot, producerPhase] =
+        createSlotAndPhase(producerLoop, depth);
+    SmallVector<Operation *> producerOps;
+    OpBuilder producerBuilder(
+        producerMapping.lookup(loads.front().load.getResult()).getDefiningOp());
+    Value pred = createConstant(producerBuilder, loc, 1, /*width=*/1);
+    // An empty barrier has not completed a phase yet, which waiting on the
+    // parity of the phase before the first one lets through.
+    Value emptyPhase = producerBuilder.create<arith::XOrIOp>(
+        loc, producerPhase, createConstant(producerBuilder, loc, 1));
+    Value emptyBarrier =
+        createBarrierView(producerBuilder, loc, emptyBarriers, producerSlot);
+    producerOps.push_back(producerBuilder.create<ttng::WaitBarrierOp>(
+        loc, emptyBarrier, emptyPhase));
+    Value fullBarrier =
+        createBarrierView(producerBuilder, loc, fullBarriers, producerSlot);
+    producerOps.push_back(producerBuilder.create<ttng::BarrierExpectOp>(
+        loc, fullBarrier, bytesPerStage, pred));
+    for (RingLoad &ringLoad : loads) {
+      auto load = cast<tt::ExperimentalDescriptorLoadOp>(
+          producerMapping.lookup(ringLoad.load.getResult()).getDefiningOp());
+      producerBuilder.setInsertionPoint(load);
+      Value buffer =
+          createBufferView(producerBuilder, loc, ringLoad.ring, producerSlot);
+      producerOps.push_back(
+          producerBuilder.create<ttng::AsyncTMACopyGlobalToLocalOp>(
+              loc, load.getDescPtr(), load.getIndices(), fullBarrier, buffer,
+              pred));
+    }
+    pruneLoop(producerLoop, producerOps);
+
+    // Consumer: wait for the slot to be full, and release it at the end of
+    // the iteration.
+    OpBuilder elseBuilder = ifOp.getElseBodyBuilder();
+    auto regAlloc = elseBuilder.create<ttng::RegAllocOp>(loc, consumerRegCount);
+    regAlloc->setAttr("triton_gpu.partition_barrier",
+                      elseBuilder.getDenseI32ArrayAttr(
+                          {kConsumerBarrierId, numThreads}));
+    IRMapping consumerMapping;
+    auto consumerLoop =
+        cast<scf::ForOp>(elseBuilder.clone(*forOp, consumerMapping));
+    auto [consumerSlot, consumerPhase] =
+        createSlotAndPhase(consumerLoop, depth);
+    OpBuilder consumerBuilder(
+        consumerMapping.lookup(loads.front().load.getResult()).getDefiningOp());
+    Value filledBarrier =
+        createBarrierView(consumerBuilder, loc, fullBarriers, consumerSlot);
+    consumerBuilder.create<ttng::WaitBarrierOp>(loc, filledBarrier,
+                                                consumerPhase);
+    SmallVector<Value> buffers;
+    for (RingLoad &ringLoad : loads)
+      buffers.push_back(
+          createBufferView(consumerBuilder, loc, ringLoad.ring, consumerSlot));
+    for (auto [ringLoad, buffer] : llvm::zip(loads, buffers)) {
+      Operation *alloc =
+          consumerMapping.lookup(ringLoad.alloc.getResult()).getDefiningOp();
+      Operation *load =
+          consumerMapping.lookup(ringLoad.load.getResult()).getDefiningOp();
+      tt::replaceUsesAndPropagateType(consumerBuilder, alloc, buffer);
+      alloc->erase();
+      load->erase();
+    }
+    consumerBuilder.setInsertionPoint(consumerLoop.getBody()->getTerminator());
+    consumerBuilder.create<ttng::ArriveBarrierOp>(
+        loc,
+        createBarrierView(consumerBuilder, loc, emptyBarriers, consumerSlot));
+    // Drop the coordinate computations only the loads used.
+    for (Operation &op : llvm::make_early_inc_range(
+             llvm::reverse(consumerLoop.getBody()->without_terminator())))
+      if (isOpTriviallyDead(&op))
+        op.erase();
+
+    // The ring replaces software pipelining of both loops.
+    for (scf::ForOp loop : {producerLoop, consumerLoop})
+      loop->setAttr(tt::kNumStagesAttrName, builder.getI32IntegerAttr(1));
+
+    // The rest of the kernel only runs in the consumer.
+    Operation *elseYield = ifOp.elseBlock()->getTerminator();
+    for (Operation &op : llvm::make_early_inc_range(llvm::make_range(
+             std::next(forOp->getIterator()),
+             block->getTerminator()->getIterator())))
+      op.moveBefore(elseYield);
+    forOp->replaceAllUsesWith(consumerLoop.getResults());
+    forOp.erase();
+
+    builder.setInsertionPointAfter(ifOp);
+    invalidateBarriers(builder, loc, fullBarriers);
+    invalidateBarriers(builder, loc, emptyBarriers);
+  }
+};
+
+} // namespace
+
+std::unique_ptr<Pass>
+mlir::createTritonNvidiaGPUWarpSpecializePass(int numStages) {
+  return std::make_unique<WarpSpecializePass>(numStages);
+}
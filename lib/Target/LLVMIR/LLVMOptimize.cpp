@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+/// Implements the LLVM optimization pipeline shared by the Python bindings
+/// and the command line tools.
+//===----------------------------------------------------------------------===//
+#include "LLVMPasses.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Transforms/InstCombine/InstCombine.h"
+
+using namespace llvm;
+
+void ScopedOptionOverrides::set(StringRef name, StringRef value) {
+  auto options = cl::getRegisteredOptions();
+  auto it = options.find(name);
+  if (it == options.end() || it->second->getNumOccurrences())
+    return;
+  it->second->addOccurrence(/*pos=*/0, name, value);
+  overridden.push_back(it->second);
+}
+
+ScopedOptionOverrides::~ScopedOptionOverrides() {
+  for (cl::Option *option : overridden)
+    option->reset();
+}
+
+void llvm::optimizeModule(Module &mod, OptimizationLevel level,
+                          TargetMachine *machine,
+                          PassInstrumentationCallbacks *callbacks,
+                          function_ref<void(PassBuilder &,
+                                            ModuleAnalysisManager &)>
+                              configure) {
+  LoopAnalysisManager lam;
+  FunctionAnalysisManager fam;
+  CGSCCAnalysisManager cgam;
+  ModuleAnalysisManager mam;
+
+  PipelineTuningOptions tuningOptions;
+  tuningOptions.LoopUnrolling = true;
+  tuningOptions.LoopInterleaving = true;
+  tuningOptions.LoopVectorization = true;
+  // The SLP vectorizer also applies some scheduling that helps performance, so
+  // it stays enabled. Without a target machine it may create large vectors;
+  // see the overrides below for targets.
+  tuningOptions.SLPVectorization = true;
+  PassBuilder pb(machine, tuningOptions, std::nullopt, callbacks);
+
+  ScopedOptionOverrides slpOverrides;
+  if (machine && machine->getTargetTriple().isNVPTX()) {
+    // NVPTX only has 32-bit packed arithmetic (f16x2, bf16x2), but the SLP
+    // vectorizer's default minimum vector size of 128 bits would keep it from
+    // forming those. Restrict it to exactly 32 bits; the 128-bit loads and
+    // stores are formed by the load/store vectorizer when generating PTX.
+    slpOverrides.set("slp-min-reg-size", "32");
+    slpOverrides.set("slp-max-reg-size", "32");
+  }
+
+  if (configure)
+    configure(pb, mam);
+
+  pb.registerModuleAnalyses(mam);
+  pb.registerCGSCCAnalyses(cgam);
+  pb.registerFunctionAnalyses(fam);
+  pb.registerLoopAnalyses(lam);
+  pb.crossRegisterProxies(lam, fam, cgam, mam);
+
+  pb.registerVectorizerStartEPCallback(
+      [](FunctionPassManager &fpm, OptimizationLevel) {
+        // Triton generates large structure of scalars which may pessimise
+        // optimizations, we run a pass to break up phi of struct to make sure
+        // all the struct are removed for the following passes.
+        fpm.addPass(BreakStructPhiNodesPass());
+        fpm.addPass(InstCombinePass());
+      });
+  ModulePassManager mpm = pb.buildPerModuleDefaultPipeline(level);
+  mpm.run(mod, mam);
+}
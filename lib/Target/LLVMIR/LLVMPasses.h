@@ -1,6 +1,10 @@
+#include "llvm/ADT/STLFunctionalExtras.h"
+#include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Pass.h"
+#include "llvm/Passes/OptimizationLevel.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/Support/CommandLine.h"
 
 namespace llvm {
 
@@ -13,4 +17,31 @@ struct BreakStructPhiNodesPass : PassInfoMixin<BreakStructPhiNodesPass> {
   static StringRef name() { return "BreakStructPhiNodesPass"; }
 };
 
+// Overrides registered command line options until destroyed. Options that
+// were set on the command line are left untouched. Command line options are
+// process-wide, so callers must not run concurrently.
+class ScopedOptionOverrides {
+public:
+  void set(StringRef name, StringRef value);
+  ~ScopedOptionOverrides();
+
+private:
+  SmallVector<cl::Option *> overridden;
+};
+
+class PassBuilder;
+class PassInstrumentationCallbacks;
+class TargetMachine;
+
+// Runs the default LLVM pipeline of the given level on `mod`, with Triton's
+// preprocessing passes at the start of vectorization. `machine` may be null,
+// in which case no target cost model is used. `configure` is called with the
+// pass builder and the module analyses before the pipeline is built, e.g. to
+// register plugins or instrumentations.
+void optimizeModule(
+    Module &mod, OptimizationLevel level, TargetMachine *machine,
+    PassInstrumentationCallbacks *callbacks = nullptr,
+    function_ref<void(PassBuilder &, ModuleAnalysisManager &)> configure =
+        nullptr);
+
 } // namespace llvm
@@ -1,9 +1,17 @@
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
+#include <optional>
 #include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <stdexcept>
+#include <tuple>
 #include <type_traits>
+#include <vector>
 
 namespace py = pybind11;
 
@@ -302,6 +310,283 @@ makeAtomicRMWOp(pybind11::dtype dtype, const uint64_t *ptr, const void *val,
   return atomic_op;
 }
 
+// Encodings of the special values of a floating-point format.
+//   IEEE: all-ones exponent encodes inf (zero mantissa) and NaN.
+//   FN:   no inf; all-ones exponent and mantissa encode NaN (e.g. e4m3fn).
+//   FNUZ: no inf and no negative zero; the negative zero encodes NaN.
+enum class FloatKind { IEEE, FN, FNUZ };
+
+// (bitwidth, exponent bits, mantissa bits, exponent bias, kind)
+using FloatFormat = std::tuple<int, int, int, int, FloatKind>;
+
+double decodeFloat(uint64_t code, const FloatFormat &format) {
+  auto [bits, expBits, mantBits, bias, kind] = format;
+  uint64_t signBit = 1ull << (bits - 1);
+  uint64_t mantMask = (1ull << mantBits) - 1;
+  uint64_t expMax = (1ull << expBits) - 1;
+  bool sign = code & signBit;
+  uint64_t mant = code & mantMask;
+  uint64_t exp = (code & (signBit - 1)) >> mantBits;
+  if ((kind == FloatKind::IEEE && exp == expMax && mant != 0) ||
+      (kind == FloatKind::FN && exp == expMax && mant == mantMask) ||
+      (kind == FloatKind::FNUZ && code == signBit))
+    return std::numeric_limits<double>::quiet_NaN();
+  double value;
+  if (kind == FloatKind::IEEE && exp == expMax)
+    value = std::numeric_limits<double>::infinity();
+  else if (exp == 0)
+    value = std::ldexp(static_cast<double>(mant), 1 - bias - mantBits);
+  else
+    value = std::ldexp(static_cast<double>(mant | (mantMask + 1)),
+                       static_cast<int>(exp) - bias - mantBits);
+  return sign ? -value : value;
+}
+
+// Rounds a double to the given format, matching the GPU conversions: RTNE
+// unless rtz is set, and saturating to the largest finite value for 8-bit
+// formats (cvt.satfinite).
+uint64_t encodeFloat(double value, const FloatFormat &format, bool rtz) {
+  auto [bits, expBits, mantBits, bias, kind] = format;
+  uint64_t signBit = 1ull << (bits - 1);
+  uint64_t mantMask = (1ull << mantBits) - 1;
+  uint64_t expMax = (1ull << expBits) - 1;
+  uint64_t inf = expMax << mantBits;
+  uint64_t maxFinite = kind == FloatKind::IEEE ? inf - 1
+                       : kind == FloatKind::FN ? inf | (mantMask - 1)
+                                               : signBit - 1;
+  bool saturate = bits == 8 || kind != FloatKind::IEEE;
+  if (std::isnan(value)) {
+    if (kind == FloatKind::IEEE)
+      return inf | (1ull << (mantBits - 1));
+    return kind == FloatKind::FN ? inf | mantMask : signBit;
+  }
+  bool sign = std::signbit(value);
+  double mag = std::fabs(value);
+  uint64_t code;
+  if (std::isinf(mag)) {
+    code = saturate ? maxFinite : inf;
+  } else if (mag == 0) {
+    code = 0;
+  } else {
+    int exp;
+    std::frexp(mag, &exp);
+    // frexp returns a mantissa in [0.5, 1).
+    int unbiased = exp - 1;
+    int minExp = 1 - bias;
+    double scaled = std::ldexp(mag, mantBits - std::max(unbiased, minExp));
+    double rounded = std::floor(scaled);
+    if (!rtz) {
+      double frac = scaled - rounded;
+      if (frac > 0.5 || (frac == 0.5 && std::fmod(rounded, 2.0) != 0))
+        rounded += 1;
+    }
+    uint64_t quantized = static_cast<uint64_t>(rounded);
+    // Subnormals and normals share the same encoding formula; rounding up into
+    // the next binade carries into the exponent field.
+    if (unbiased < minExp)
+      code = quantized;
+    else
+      code = (static_cast<uint64_t>(unbiased + bias) << mantBits) + quantized -
+             (mantMask + 1);
+    if (code > maxFinite)
+      code = saturate || rtz ? maxFinite : inf;
+  }
+  if (kind == FloatKind::FNUZ && code == 0)
+    return 0;
+  return sign ? code | signBit : code;
+}
+
+// Conversion tables for formats of at most 16 bits, indexed by the source
+// encoding.
+const std::vector<uint64_t> &getConversionTable(const FloatFormat &src,
+                                                const FloatFormat &dst,
+                                                bool rtz) {
+  static std::map<std::tuple<FloatFormat, FloatFormat, bool>,
+                  std::vector<uint64_t>>
+      tables;
+  auto key = std::make_tuple(src, dst, rtz);
+  auto it = tables.find(key);
+  if (it != tables.end())
+    return it->second;
+  std::vector<uint64_t> table(1ull << std::get<0>(src));
+  for (uint64_t code = 0; code < table.size(); ++code)
+    table[code] = encodeFloat(decodeFloat(code, src), dst, rtz);
+  return tables.emplace(key, std::move(table)).first->second;
+}
+
+template <typename SrcT, typename DstT>
+void convertFloats(const SrcT *src, DstT *dst, size_t numel,
+                   const FloatFormat &srcFormat, const FloatFormat &dstFormat,
+                   bool rtz) {
+  if constexpr (sizeof(SrcT) <= 2) {
+    const auto &table = getConversionTable(srcFormat, dstFormat, rtz);
+    for (size_t i = 0; i < numel; ++i)
+      dst[i] = static_cast<DstT>(table[src[i]]);
+  } else {
+    for (size_t i = 0; i < numel; ++i)
+      dst[i] = static_cast<DstT>(
+          encodeFloat(decodeFloat(src[i], srcFormat), dstFormat, rtz));
+  }
+}
+
+// Calls fn with a null pointer of the unsigned integer type of the given
+// bitwidth.
+template <typename Fn> void dispatchUInt(int bits, Fn &&fn) {
+  switch (bits) {
+  case 8:
+    return fn(static_cast<uint8_t *>(nullptr));
+  case 16:
+    return fn(static_cast<uint16_t *>(nullptr));
+  case 32:
+    return fn(static_cast<uint32_t *>(nullptr));
+  case 64:
+    return fn(static_cast<uint64_t *>(nullptr));
+  default:
+    throw std::invalid_argument("Unsupported floating-point bitwidth");
+  }
+}
+
+// Records the byte ranges written by stores and atomics to a set of tracked
+// buffers, so that the launcher only copies the modified parts of host copies
+// of kernel arguments back to the device.
+class WriteTracker {
+public:
+  using Range = std::pair<uint64_t, uint64_t>;
+
+  // Starts tracking the given (base, size) buffers; an empty list disables
+  // tracking.
+  void reset(const std::vector<Range> &bufs) {
+    buffers.clear();
+    ranges.assign(bufs.size(), {});
+    run.reset();
+    for (size_t i = 0; i < bufs.size(); ++i)
+      buffers[bufs[i].first] = {bufs[i].first + bufs[i].second, i};
+  }
+
+  bool active() const { return !buffers.empty(); }
+
+  void record(uint64_t addr, uint64_t size) {
+    // Stores mostly walk memory contiguously; extend the current run.
+    if (run && addr == run->end && addr + size <= run->bufEnd) {
+      run->end += size;
+      return;
+    }
+    flush();
+    auto it = buffers.upper_bound(addr);
+    if (it == buffers.begin())
+      return;
+    --it;
+    auto [bufEnd, idx] = it->second;
+    if (addr + size > bufEnd)
+      return;
+    run = Run{idx, it->first, addr, addr + size, bufEnd};
+  }
+
+  // Returns, for each tracked buffer, the sorted (offset, size) ranges that
+  // were written. Ranges closer than `gap` bytes are merged. Tracking stops.
+  std::vector<std::vector<Range>> collect(uint64_t gap) {
+    flush();
+    std::vector<std::vector<Range>> ret(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      auto &bufRanges = ranges[i];
+      std::sort(bufRanges.begin(), bufRanges.end());
+      for (auto [begin, end] : bufRanges) {
+        if (!ret[i].empty() &&
+            begin <= ret[i].back().first + ret[i].back().second + gap) {
+          uint64_t last = ret[i].back().first + ret[i].back().second;
+          ret[i].back().second += std::max(end, last) - last;
+        } else {
+          ret[i].emplace_back(begin, end - begin);
+        }
+      }
+    }
+    reset({});
+    return ret;
+  }
+
+private:
+  struct Run {
+    size_t idx;
+    uint64_t base, begin, end, bufEnd;
+  };
+
+  void flush() {
+    if (run)
+      ranges[run->idx].emplace_back(run->begin - run->base,
+                                    run->end - run->base);
+    run.reset();
+  }
+
+  // base -> (end, index)
+  std::map<uint64_t, std::pair<uint64_t, size_t>> buffers;
+  // Written [begin, end) offsets, per buffer.
+  std::vector<std::vector<Range>> ranges;
+  std::optional<Run> run;
+};
+
+WriteTracker writeTracker;
+
+// Saves the bytes that stores and atomics are about to overwrite, so that a
+// batched launch that has to be replayed sequentially can undo its writes
+// without snapshotting whole arguments up front.
+class UndoLog {
+public:
+  void enable(bool on) {
+    enabled = on;
+    entries.clear();
+  }
+
+  bool active() const { return enabled; }
+
+  void save(uint64_t addr, uint64_t size) {
+    auto *src = reinterpret_cast<const char *>(addr);
+    // Extend the last entry when writes walk memory contiguously.
+    if (!entries.empty() &&
+        entries.back().addr + entries.back().bytes.size() == addr) {
+      entries.back().bytes.insert(entries.back().bytes.end(), src, src + size);
+      return;
+    }
+    entries.push_back({addr, std::vector<char>(src, src + size)});
+  }
+
+  // Restores the saved bytes, newest first, and clears the log.
+  void undo() {
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it)
+      memcpy(reinterpret_cast<void *>(it->addr), it->bytes.data(),
+             it->bytes.size());
+    entries.clear();
+  }
+
+private:
+  struct Entry {
+    uint64_t addr;
+    std::vector<char> bytes;
+  };
+
+  bool enabled = false;
+  std::vector<Entry> entries;
+};
+
+UndoLog undoLog;
+
+void saveWrites(const uint64_t *ptr, const bool *mask, size_t numel,
+                size_t itemsize) {
+  if (!undoLog.active())
+    return;
+  for (size_t i = 0; i < numel; ++i)
+    if (!mask || mask[i])
+      undoLog.save(ptr[i], itemsize);
+}
+
+void recordWrites(const uint64_t *ptr, const bool *mask, size_t numel,
+                  size_t itemsize) {
+  if (!writeTracker.active())
+    return;
+  for (size_t i = 0; i < numel; ++i)
+    if (!mask || mask[i])
+      writeTracker.record(ptr[i], itemsize);
+}
+
 } // namespace
 
 void init_triton_interpreter(py::module &&m) {
@@ -327,6 +612,48 @@ void init_triton_interpreter(py::module &&m) {
       .value("UMAX", RMWOp::UMAX)
       .export_values();
 
+  py::enum_<FloatKind>(m, "FLOAT_KIND", py::module_local())
+      .value("IEEE", FloatKind::IEEE)
+      .value("FN", FloatKind::FN)
+      .value("FNUZ", FloatKind::FNUZ)
+      .export_values();
+
+  // Converts the bit patterns in `input` (an unsigned integer array) from one
+  // floating-point format to another and returns the resulting bit patterns.
+  m.def("convert_float",
+        [](py::array input, FloatFormat srcFormat, FloatFormat dstFormat,
+           bool rtz) -> py::array {
+          int srcBits = std::get<0>(srcFormat);
+          int dstBits = std::get<0>(dstFormat);
+          if (input.itemsize() * 8 != srcBits)
+            throw std::invalid_argument("Unexpected input itemsize");
+          py::array src = py::array::ensure(input, py::array::c_style);
+          auto shape =
+              std::vector<ptrdiff_t>(src.shape(), src.shape() + src.ndim());
+          py::array ret(py::dtype("uint" + std::to_string(dstBits)), shape);
+          size_t numel = src.size();
+          dispatchUInt(srcBits, [&](auto srcTag) {
+            using SrcT = std::remove_pointer_t<decltype(srcTag)>;
+            dispatchUInt(dstBits, [&](auto dstTag) {
+              using DstT = std::remove_pointer_t<decltype(dstTag)>;
+              convertFloats(static_cast<const SrcT *>(src.data()),
+                            static_cast<DstT *>(ret.mutable_data()), numel,
+                            srcFormat, dstFormat, rtz);
+            });
+          });
+          return ret;
+        });
+
+  m.def("track_writes", [](const std::vector<std::pair<uint64_t, uint64_t>>
+                                &buffers) { writeTracker.reset(buffers); });
+
+  m.def("collect_writes",
+        [](uint64_t gap) { return writeTracker.collect(gap); });
+
+  m.def("set_undo_log", [](bool enabled) { undoLog.enable(enabled); });
+
+  m.def("undo_writes", []() { undoLog.undo(); });
+
   m.def("load",
         [](py::array_t<uint64_t> ptr, py::array_t<bool> mask, py::array other,
            py::dtype ret_dtype) -> py::array {
@@ -355,12 +682,18 @@ void init_triton_interpreter(py::module &&m) {
           py::array_t<uint64_t> reshaped_ptr = ptr.reshape({numel});
           py::array_t<int8_t> reshaped_mask = mask.reshape({numel});
           py::array reshaped_value = value.reshape({numel});
+          saveWrites(reshaped_ptr.data(),
+                     reinterpret_cast<const bool *>(reshaped_mask.data()),
+                     numel, value.dtype().itemsize());
           for (size_t i = 0; i < ptr.size(); ++i) {
             if (reshaped_mask.at(i)) {
               memcpy(reinterpret_cast<void *>(reshaped_ptr.mutable_at(i)),
                      reshaped_value.data(i), value.dtype().itemsize());
             }
           }
+          recordWrites(reshaped_ptr.data(),
+                       reinterpret_cast<const bool *>(reshaped_mask.data()),
+                       numel, value.dtype().itemsize());
         });
 
   m.def("atomic_rmw",
@@ -406,7 +739,9 @@ void init_triton_interpreter(py::module &&m) {
 
 #undef MAKE_ATOMIC_RMW_OP
 
+          saveWrites(ptr_data, mask_data, numel, ret_dtype.itemsize());
           atomic_op->apply();
+          recordWrites(ptr_data, mask_data, numel, ret_dtype.itemsize());
           return ret.reshape(shape);
         });
 
@@ -426,10 +761,12 @@ void init_triton_interpreter(py::module &&m) {
           memcpy(static_cast<void *>(ret.mutable_data()),
                  static_cast<const void *>(reshaped_cmp.data()),
                  itemsize * numel);
+          saveWrites(reshaped_ptr.data(), nullptr, numel, itemsize);
           AtomicCASOp(reshaped_ptr.data(), ret.mutable_data(),
                       static_cast<const void *>(reshaped_val.data()), itemsize,
                       numel, order)
               .apply();
+          recordWrites(reshaped_ptr.data(), nullptr, numel, itemsize);
           return ret.reshape(shape);
         });
 }
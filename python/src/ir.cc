@@ -900,6 +900,14 @@ void init_triton_ir(py::module &&m) {
              else
                return self.create<FpToFpOp>(dstType, src);
            })
+      // Unpacking of int4 values stored two per i8
+      .def("create_int4_to_fp",
+           [](TritonOpBuilder &self, Value &src, std::optional<Value> scale,
+              Type &dstType, int axis, bool isSigned) -> Value {
+             return self.create<Int4ToFpOp>(dstType, src,
+                                            scale.value_or(Value()), axis,
+                                            isSigned);
+           })
       // Conversions for standard LLVM builtin types
       .def("create_bitcast",
            [](TritonOpBuilder &self, Value &src, Type &dstType) -> Value {
@@ -1506,6 +1514,25 @@ void init_triton_ir(py::module &&m) {
              }
              return self.create<ScanReturnOp>(return_values);
            })
+      .def("create_sort",
+           [](TritonOpBuilder &self, std::vector<Value> operands,
+              int axis) -> OpState {
+             return self.create<SortOp>(operands, axis);
+           })
+      .def("create_topk",
+           [](TritonOpBuilder &self, std::vector<Value> operands, int axis,
+              int k) -> OpState {
+             return self.create<TopKOp>(operands, axis, k);
+           })
+      .def("create_sort_ret",
+           [](TritonOpBuilder &self, Value &result) -> OpState {
+             return self.create<SortReturnOp>(result);
+           })
+      .def("create_gather",
+           [](TritonOpBuilder &self, Value &src, Value &indices,
+              int axis) -> Value {
+             return self.create<GatherOp>(src, indices, axis);
+           })
       .def("create_ptr_to_int",
            [](TritonOpBuilder &self, Value &val, Type &type) -> Value {
              return self.create<PtrToIntOp>(type, val);
@@ -1,4 +1,5 @@
-﻿#include "mlir/IR/BuiltinOps.h" // mlir::ModuleOp
+﻿#include "lib/Target/LLVMIR/LLVMPasses.h"
+#include "mlir/IR/BuiltinOps.h" // mlir::ModuleOp
 #include "mlir/Target/LLVMIR/LLVMTranslationInterface.h"
 #include "mlir/Target/LLVMIR/ModuleTranslation.h"
 #include "triton/Tools/Sys/GetEnv.hpp"
@@ -17,12 +18,12 @@
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Passes/StandardInstrumentations.h"
 #include "llvm/Support/CodeGen.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
-#include "llvm/Transforms/InstCombine/InstCombine.h"
 #include <csignal>
 #include <memory>
 #include <pybind11/pybind11.h>
@@ -31,13 +32,6 @@
 
 namespace py = pybind11;
 
-namespace llvm {
-struct BreakStructPhiNodesPass : PassInfoMixin<BreakStructPhiNodesPass> {
-  PreservedAnalyses run(Function &F, FunctionAnalysisManager &AM);
-  static StringRef name() { return "BreakStructPhiNodesPass"; }
-};
-} // namespace llvm
-
 using namespace llvm;
 
 std::unique_ptr<TargetMachine>
@@ -274,6 +268,8 @@ void init_triton_llvm(py::module &&m) {
         llvm::CodeGenOptLevel::None)};
     // set data layout
     mod->setDataLayout(machine->createDataLayout());
+    // and the triple, which optimize_module needs to create a target machine
+    mod->setTargetTriple(triple);
   });
 
   m.def(
@@ -299,11 +295,6 @@ void init_triton_llvm(py::module &&m) {
           }
         }
         using namespace llvm;
-        LoopAnalysisManager lam;
-        FunctionAnalysisManager fam;
-        CGSCCAnalysisManager cgam;
-        ModuleAnalysisManager mam;
-
         PassInstrumentationCallbacks *instrCbPtr = nullptr;
         PassInstrumentationCallbacks passInstrCb;
         StandardInstrumentations standardInstr(mod->getContext(),
@@ -315,22 +306,9 @@ void init_triton_llvm(py::module &&m) {
             auto optPtr = static_cast<llvm::cl::opt<bool> *>(optIt->second);
             *optPtr = true;
           }
-          standardInstr.registerCallbacks(passInstrCb, &mam);
           instrCbPtr = &passInstrCb;
         }
 
-        PipelineTuningOptions tuningOptions;
-        tuningOptions.LoopUnrolling = true;
-        tuningOptions.LoopInterleaving = true;
-        tuningOptions.LoopVectorization = true;
-        // TODO: currently we run SLP vectorizer with an empty target machine.
-        // This cause the vectorizer to create larger vector which could be bad.
-        // Disabling it would currently cause regressions as this pass also
-        // applies some scheduling that helps performance in some cases. We
-        // should work on using NVPTX target instead and address the performance
-        // regressions with some scheduling solution.
-        tuningOptions.SLPVectorization = true;
-
         std::string pluginFile =
             mlir::triton::tools::getStrEnv("LLVM_PASS_PLUGIN_PATH");
 
@@ -348,39 +326,28 @@ void init_triton_llvm(py::module &&m) {
         if (!arch.empty() && pluginFile.empty())
           targetMachine =
               createTargetMachine(mod, arch, enable_fp_fusion, features);
-        PassBuilder pb(/*targetMachine=*/targetMachine.get(), tuningOptions,
-                       std::nullopt, instrCbPtr);
-
-        if (!pluginFile.empty()) {
-          // TODO: Add some logging here that we inserted a pass into the LLVM
-          // pass pipeline
-          auto passPlugin = llvm::PassPlugin::Load(pluginFile);
-          if (!passPlugin) {
-            llvm::Error Err = passPlugin.takeError();
-            std::string ErrMsg =
-                "Pass Plugin Error: " + llvm::toString(std::move(Err));
-            throw std::runtime_error(ErrMsg);
-          }
-          passPlugin->registerPassBuilderCallbacks(pb);
-        }
 
-        pb.registerModuleAnalyses(mam);
-        pb.registerCGSCCAnalyses(cgam);
-        pb.registerFunctionAnalyses(fam);
-        pb.registerLoopAnalyses(lam);
-        pb.crossRegisterProxies(lam, fam, cgam, mam);
-
-        ModulePassManager mpm;
-        pb.registerVectorizerStartEPCallback(
-            [&](llvm::FunctionPassManager &fpm, llvm::OptimizationLevel level) {
-              // Triton generates large structure of scalars which may pessimise
-              // optimizations, we run a pass to break up phi of struct to make
-              // sure all the struct are removed for the following passes.
-              fpm.addPass(BreakStructPhiNodesPass());
-              fpm.addPass(InstCombinePass());
+        // optimizeModule overrides process-wide command line options; this is
+        // safe without a lock because this binding keeps the GIL while the
+        // pipeline runs.
+        optimizeModule(
+            *mod, opt, targetMachine.get(), instrCbPtr,
+            [&](PassBuilder &pb, ModuleAnalysisManager &mam) {
+              if (instrCbPtr)
+                standardInstr.registerCallbacks(passInstrCb, &mam);
+              if (pluginFile.empty())
+                return;
+              // TODO: Add some logging here that we inserted a pass into the
+              // LLVM pass pipeline
+              auto passPlugin = llvm::PassPlugin::Load(pluginFile);
+              if (!passPlugin) {
+                llvm::Error Err = passPlugin.takeError();
+                std::string ErrMsg =
+                    "Pass Plugin Error: " + llvm::toString(std::move(Err));
+                throw std::runtime_error(ErrMsg);
+              }
+              passPlugin->registerPassBuilderCallbacks(pb);
             });
-        mpm.addPass(pb.buildPerModuleDefaultPipeline(opt));
-        mpm.run(*mod, mam);
       },
       // Mandatory parameters
       py::arg("mod"), py::arg("opt"),
@@ -39,7 +39,10 @@ void init_triton_passes_ttir(py::module &&m) {
   ADD_PASS_WRAPPER_0("add_reorder_broadcast", createReorderBroadcastPass);
   ADD_PASS_WRAPPER_0("add_rewrite_tensor_pointer",
                      createRewriteTensorPointerPass);
-  ADD_PASS_WRAPPER_0("add_loop_unroll", createLoopUnrollPass);
+  ADD_PASS_WRAPPER_2("add_loop_unroll", createLoopUnrollPass, int, int);
+  ADD_PASS_WRAPPER_0("add_loop_peeling", createLoopPeelingPass);
+  ADD_PASS_WRAPPER_0("add_loop_multiversioning",
+                     createLoopMultiVersioningPass);
   ADD_PASS_WRAPPER_4("add_convert_to_ttgpuir",
                      createConvertTritonToTritonGPUPass, const std::string &,
                      int, int, int);
@@ -60,8 +63,14 @@ void init_triton_passes_ttgpuir(py::module &&m) {
                             createTritonGPUOptimizeDotOperands, bool);
   ADD_PASS_WRAPPER_0("add_remove_layout_conversions",
                      createTritonGPURemoveLayoutConversions);
+  ADD_PASS_WRAPPER_0("add_forward_shared_memory",
+                     createTritonGPUForwardSharedMemory);
   ADD_PASS_WRAPPER_0("add_reduce_data_duplication",
                      createTritonGPUReduceDataDuplication);
+  ADD_PASS_WRAPPER_0("add_report_bank_conflicts",
+                     createTritonGPUReportBankConflicts);
+  ADD_PASS_OPTION_WRAPPER_1("add_schedule_register_pressure",
+                            createTritonGPUScheduleRegisterPressure, int);
   ADD_PASS_WRAPPER_0("add_allocate_shared_memory",
                      createAllocateSharedMemoryPass);
   ADD_PASS_WRAPPER_0("add_combine_tensor_select_and_if",
@@ -110,6 +110,56 @@ def test_experimental_tma_matmul(num_stages, BLOCK_M, BLOCK_N, BLOCK_K, byval_tm
         assert ".param .align 64 .b8" in kernel.asm["ptx"]
 
 
+@triton.jit
+def matmul_kernel_tma_epilogue(a_desc_ptr, b_desc_ptr, c_ptr, bias_ptr, row_sum_ptr,  #
+                               M, N, K, BLOCK_SIZE_M: tl.constexpr, BLOCK_SIZE_N: tl.constexpr,
+                               BLOCK_SIZE_K: tl.constexpr):
+    pid = tl.program_id(axis=0)
+    num_pid_m = tl.cdiv(M, BLOCK_SIZE_M)
+    pid_m = pid % num_pid_m
+    pid_n = pid // num_pid_m
+    offs_am = pid_m * BLOCK_SIZE_M
+    offs_bn = pid_n * BLOCK_SIZE_N
+    offs_k = 0
+    accumulator = tl.zeros((BLOCK_SIZE_M, BLOCK_SIZE_N), dtype=tl.float32)
+    for k in range(0, tl.cdiv(K, BLOCK_SIZE_K)):
+        a = tl._experimental_descriptor_load(a_desc_ptr, [offs_am, offs_k], [BLOCK_SIZE_M, BLOCK_SIZE_K], tl.float16)
+        b = tl._experimental_descriptor_load(b_desc_ptr, [offs_k, offs_bn], [BLOCK_SIZE_K, BLOCK_SIZE_N], tl.float16)
+        accumulator = tl.dot(a, b, acc=accumulator)
+        offs_k += BLOCK_SIZE_K
+    # The epilogue needs shared memory scratch (layout conversions and a
+    # reduction across warps), and the barriers that go with it.
+    offs_m = offs_am + tl.arange(0, BLOCK_SIZE_M)
+    offs_n = offs_bn + tl.arange(0, BLOCK_SIZE_N)
+    accumulator += tl.load(bias_ptr + offs_n)[None, :]
+    tl.atomic_add(row_sum_ptr + offs_m, tl.sum(accumulator, axis=1))
+    tl.store(c_ptr + offs_m[:, None] * N + offs_n[None, :], accumulator.to(tl.float16))
+
+
+@requires_tma
+@pytest.mark.parametrize("num_stages", [2, 3])
+def test_experimental_tma_matmul_warp_specialized(num_stages):
+    device = "cuda"
+    M, N, K = 512, 512, 512
+    BLOCK_M, BLOCK_N, BLOCK_K = 128, 128, 64
+    torch.manual_seed(42)
+    A = torch.randn((M, K), dtype=torch.float16, device=device)
+    B = torch.randn((K, N), dtype=torch.float16, device=device)
+    bias = torch.randn((N, ), dtype=torch.float32, device=device)
+    C = torch.empty((M, N), dtype=torch.float16, device=device)
+    row_sum = torch.zeros((M, ), dtype=torch.float32, device=device)
+    desc_a = create_2d_tma_descriptor(A.data_ptr(), M, K, BLOCK_M, BLOCK_K, A.element_size())
+    desc_b = create_2d_tma_descriptor(B.data_ptr(), K, N, BLOCK_K, BLOCK_N, B.element_size())
+    grid = (triton.cdiv(M, BLOCK_M) * triton.cdiv(N, BLOCK_N), )
+    kernel = matmul_kernel_tma_epilogue[grid](desc_a, desc_b, C, bias, row_sum, M, N, K, BLOCK_M, BLOCK_N, BLOCK_K,
+                                              num_warps=4, num_stages=num_stages, warp_specialize=True)
+    # The kernel was split between a producer and a consumer warp group.
+    assert "setmaxnreg.dec" in kernel.asm["ptx"]
+    ref = torch.matmul(A.to(torch.float32), B.to(torch.float32)) + bias[None, :]
+    torch.testing.assert_close(ref.to(torch.float16), C, rtol=1e-2, atol=1e-2)
+    torch.testing.assert_close(ref.sum(dim=1), row_sum, rtol=1e-2, atol=1e-1)
+
+
 @triton.jit
 def device_tensormap_kernel2d(in_ptr, out_ptr, in_desc, out_desc, ready_flag, M, N, M_BLOCK: tl.constexpr,
                               N_BLOCK: tl.constexpr):
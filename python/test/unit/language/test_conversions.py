@@ -350,3 +350,66 @@ def test_typeconvert_downcast(src_dtype, dst_dtype, rounding, max_repr, device):
 
     for i in range(256):
         downcast_test(getattr(tl, src_dtype), getattr(tl, dst_dtype), rounding, *stuff, max_repr, i, device=device)
+
+
+@pytest.mark.parametrize("src_dtype, dst_dtype, rounding, src_bits, dst_bits", [
+    # RTNE ties go to the even neighbour and may carry into the exponent; RTZ truncates.
+    ('float32', 'bfloat16', 'rtne', 0x3f808000, 0x3f80),
+    ('float32', 'bfloat16', 'rtne', 0x3f818000, 0x3f82),
+    ('float32', 'bfloat16', 'rtne', 0x3f81ffff, 0x3f82),
+    ('float32', 'bfloat16', 'rtz', 0x3f81ffff, 0x3f81),
+    ('float32', 'bfloat16', 'rtne', 0x3fffffff, 0x4000),
+    ('float32', 'float8e4nv', 'rtne', 0x3f880000, 0x38),
+    ('float32', 'float8e4nv', 'rtne', 0x3f980000, 0x3a),
+
+    # Overflow: IEEE 16-bit formats round to inf, RTZ stops at the largest finite value.
+    ('float32', 'float16', 'rtne', 0x477ff000, 0x7c00),
+    ('float32', 'float16', 'rtz', 0x477ff000, 0x7bff),
+
+    # Subnormals, including a tie rounding down to zero.
+    ('float32', 'float16', 'rtne', 0x33800000, 0x0001),
+    ('float32', 'float16', 'rtne', 0x33000000, 0x0000),
+    ('float32', 'float16', 'rtne', 0x33400000, 0x0001),
+    ('float32', 'float8e4nv', 'rtne', 0x3b000000, 0x01),
+    ('float16', 'float32', 'rtne', 0x0001, 0x33800000),
+
+    # NaN and inf in IEEE formats.
+    ('float32', 'float16', 'rtne', 0x7fc00000, 0x7e00),
+    ('float32', 'float16', 'rtne', 0xff800000, 0xfc00),
+    ('float16', 'float32', 'rtne', 0x7c00, 0x7f800000),
+    ('bfloat16', 'float32', 'rtne', 0x7f80, 0x7f800000),
+    ('float32', 'float8e5', 'rtne', 0x7fc00000, 0x7e),
+
+    # satfinite: 8-bit targets saturate out-of-range values and inf.
+    ('float32', 'float8e5', 'rtne', 0x7f800000, 0x7b),
+    ('float32', 'float8e4nv', 'rtne', 0x447a0000, 0x7e),
+    ('float32', 'float8e4nv', 'rtne', 0xc47a0000, 0xfe),
+    ('float32', 'float8e4nv', 'rtne', 0x7f800000, 0x7e),
+    ('float32', 'float8e4b8', 'rtne', 0x7f800000, 0x7f),
+
+    # FN formats have no inf: the all-ones code is NaN, the one below it is finite.
+    ('float32', 'float8e4nv', 'rtne', 0x7fc00000, 0x7f),
+    ('float8e4nv', 'float32', 'rtne', 0x7f, 0x7fc00000),
+    ('float8e4nv', 'float32', 'rtne', 0x7e, 0x43e00000),
+    ('float8e4nv', 'float32', 'rtne', 0x78, 0x43800000),
+
+    # FNUZ formats have no negative zero: its code is NaN.
+    ('float32', 'float8e4b8', 'rtne', 0x3f800000, 0x40),
+    ('float32', 'float8e4b8', 'rtne', 0x7fc00000, 0x80),
+    ('float32', 'float8e4b8', 'rtne', 0x80000000, 0x00),
+    ('float32', 'float8e5b16', 'rtne', 0x3f800000, 0x40),
+    ('float32', 'float8e5b16', 'rtne', 0x7fc00000, 0x80),
+    ('float8e4b8', 'float32', 'rtne', 0x80, 0x7fc00000),
+    ('float8e5b16', 'float32', 'rtne', 0x80, 0x7fc00000),
+])
+def test_interpreter_convert_float(src_dtype, dst_dtype, rounding, src_bits, dst_bits):
+    # Checks the interpreter's float converter against reference encodings; it needs no device.
+    from triton._C.libtriton import ir
+    from triton.runtime.interpreter import _convert_float
+
+    src_tl, dst_tl = getattr(tl, src_dtype), getattr(tl, dst_dtype)
+    src = np.array([src_bits], dtype=getattr(np, f"uint{src_tl.primitive_bitwidth}"))
+    mode = ir.ROUNDING_MODE.RTZ if rounding == 'rtz' else ir.ROUNDING_MODE.RTNE
+    dst = _convert_float(src, src_tl, dst_tl, mode)
+    assert dst.dtype == getattr(np, f"uint{dst_tl.primitive_bitwidth}")
+    assert hex(int(dst[0])) == hex(dst_bits)
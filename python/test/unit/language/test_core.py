@@ -825,6 +825,147 @@ def test_invalid_pid_axis(device):
     assert re.search(r"program_id axis must be 0, 1, or 2 but got 20", str(exc_info.value.__cause__))
 
 
+# ----------------------------------
+# test pid-dependent control flow
+# ----------------------------------
+@pytest.mark.interpreter
+@pytest.mark.parametrize("divergent", [False, True])
+def test_pid_control_flow(divergent, device):
+    # The interpreter runs all programs of the grid at once unless control flow depends on
+    # the program id, in which case it starts over one program at a time.
+
+    @triton.jit
+    def _kernel(x_ptr, out_ptr, DIVERGENT: tl.constexpr, BLOCK: tl.constexpr):
+        pid_x = tl.program_id(0)
+        pid_y = tl.program_id(1)
+        offs = (pid_x * tl.num_programs(1) + pid_y) * BLOCK + tl.arange(0, BLOCK)
+        # Update the input in place before diverging
+        x = tl.load(x_ptr + offs) + 1
+        tl.store(x_ptr + offs, x)
+        acc = tl.zeros((BLOCK, ), dtype=tl.int32)
+        if DIVERGENT:
+            for i in range(pid_y + 1):
+                acc += x
+        else:
+            acc += tl.where(pid_x % 2 == 0, x, -x)
+        tl.store(out_ptr + offs, tl.sum(acc[:, None] * 2, axis=1) // 2)
+
+    BLOCK = 16
+    grid = (3, 4)
+    x = torch.arange(grid[0] * grid[1] * BLOCK, dtype=torch.int32, device=device)
+    out = torch.empty_like(x)
+    x_ref = x + 1
+    _kernel[grid](x, out, divergent, BLOCK)
+    pid_x = torch.arange(grid[0], device=device)[:, None, None]
+    pid_y = torch.arange(grid[1], device=device)[None, :, None]
+    ref = x_ref.view(grid[0], grid[1], BLOCK)
+    if divergent:
+        ref = ref * (pid_y + 1)
+    else:
+        ref = torch.where(pid_x % 2 == 0, ref, -ref)
+    torch.testing.assert_close(x, x_ref)
+    torch.testing.assert_close(out, ref.reshape(-1).to(torch.int32))
+
+
+# ----------------------------------
+# test sparse stores
+# ----------------------------------
+@pytest.mark.interpreter
+@pytest.mark.parametrize("offset", [0, 5])
+def test_sparse_store(offset, device):
+    # Memory the kernel does not write must be left untouched, including outside of
+    # the view passed to the kernel.
+
+    @triton.jit
+    def _kernel(out_ptr, STRIDE: tl.constexpr, BLOCK: tl.constexpr):
+        pid = tl.program_id(0)
+        offs = pid * STRIDE + tl.arange(0, BLOCK)
+        tl.store(out_ptr + offs, pid + 1, mask=offs % 3 != 0)
+
+    BLOCK, STRIDE, grid = 8, 1000, 7
+    buf = torch.full((offset + grid * STRIDE + 3, ), -1, dtype=torch.int32, device=device)
+    out = buf[offset:offset + grid * STRIDE]
+    _kernel[(grid, )](out, STRIDE, BLOCK)
+    ref = torch.full_like(buf, -1)
+    for pid in range(grid):
+        offs = torch.arange(pid * STRIDE, pid * STRIDE + BLOCK, device=device)
+        offs = offs[offs % 3 != 0]
+        ref[offset + offs] = pid + 1
+    torch.testing.assert_close(buf, ref)
+
+
+@pytest.mark.interpreter
+def test_interpreter_write_ranges():
+    if not is_interpreter():
+        pytest.skip("only the interpreter tracks the ranges written by a kernel")
+    from triton._C.libtriton import interpreter as _interpreter
+
+    buf = np.full(1000, -1, dtype=np.int32)
+    base = buf.ctypes.data
+    offs = np.array([*range(8), 10, 11, 600, 900])
+    ptrs = (base + offs * buf.itemsize).astype(np.uint64)
+    values = np.arange(len(offs), dtype=np.int32)
+    mask = offs != 900
+
+    # (offset, size) byte ranges written back, with ranges closer than the gap merged
+    for gap, ref in [(0, [(0, 32), (40, 8), (2400, 4)]), (16, [(0, 48), (2400, 4)])]:
+        _interpreter.track_writes([(base, buf.nbytes)])
+        _interpreter.store(ptrs, values, mask)
+        assert _interpreter.collect_writes(gap) == [ref]
+
+    # Writes of a failed grid-batched run are undone before the sequential rerun
+    buf[:] = -1
+    _interpreter.set_undo_log(True)
+    _interpreter.store(ptrs, values, mask)
+    _interpreter.atomic_rmw(_interpreter.RMW_OP.ADD, ptrs, values, mask, _interpreter.MEM_SEMANTIC.RELAXED)
+    assert (buf[offs[mask]] == 2 * values[mask]).all()
+    _interpreter.undo_writes()
+    _interpreter.set_undo_log(False)
+    assert (buf == -1).all()
+
+
+@pytest.mark.interpreter
+def test_grid_batch_fallback_undoes_writes(device):
+    # The grid-batched run adds to `out` before control flow diverges; the sequential
+    # rerun must start from the original values.
+
+    @triton.jit
+    def _kernel(out_ptr, BLOCK: tl.constexpr):
+        pid = tl.program_id(0)
+        offs = tl.arange(0, BLOCK)
+        tl.atomic_add(out_ptr + offs, 1)
+        if pid == 0:
+            tl.store(out_ptr + BLOCK + offs, 1)
+
+    BLOCK, grid = 16, 4
+    out = torch.zeros(2 * BLOCK, dtype=torch.int32, device=device)
+    _kernel[(grid, )](out, BLOCK)
+    ref = torch.ones_like(out)
+    ref[:BLOCK] = grid
+    torch.testing.assert_close(out, ref)
+
+
+@pytest.mark.interpreter
+def test_write_back_views(device):
+    # Only the elements the kernel wrote through a view or a reinterpreted tensor
+    # are copied back, at the right place in the underlying tensor.
+
+    @triton.jit
+    def _kernel(out_ptr, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        tl.store(out_ptr + offs * 2, offs + 1)
+
+    BLOCK = 16
+    out = torch.zeros(4 * BLOCK, dtype=torch.int32, device=device)
+    view = out[BLOCK:]
+    _kernel[(1, )](view, BLOCK)
+    _kernel[(1, )](triton.reinterpret(out[:2 * BLOCK], tl.uint32), BLOCK)
+    ref = torch.zeros_like(out)
+    ref[BLOCK:3 * BLOCK:2] = torch.arange(1, BLOCK + 1, dtype=torch.int32, device=device)
+    ref[:2 * BLOCK:2] = torch.arange(1, BLOCK + 1, dtype=torch.int32, device=device)
+    torch.testing.assert_close(out, ref)
+
+
 # ---------------
 # test where
 # ---------------
@@ -1856,6 +1997,41 @@ def test_join_with_mma(device):
     torch.testing.assert_close(z, z_ref)
 
 
+@pytest.mark.interpreter
+@pytest.mark.parametrize("dtype_str", ["float16", "bfloat16"])
+@pytest.mark.parametrize("is_signed", [False, True])
+@pytest.mark.parametrize("axis", [0, 1])
+@pytest.mark.parametrize("with_scale", [False, True])
+def test_int4_to_fp(dtype_str, is_signed, axis, with_scale, device):
+    check_type_supported(dtype_str, device)
+    M, N = 32, 64
+    PM, PN = (M // 2, N) if axis == 0 else (M, N // 2)
+
+    @triton.jit
+    def kernel(X, S, Z, PM: tl.constexpr, PN: tl.constexpr, M: tl.constexpr, N: tl.constexpr, AXIS: tl.constexpr,
+               IS_SIGNED: tl.constexpr, WITH_SCALE: tl.constexpr, DTYPE: tl.constexpr):
+        x = tl.load(X + tl.arange(0, PM)[:, None] * PN + tl.arange(0, PN)[None, :])
+        scale = None
+        if WITH_SCALE:
+            scale = tl.load(S + tl.arange(0, N))[None, :]
+        z = tl.int4_to_fp(x, AXIS, DTYPE, scale=scale, is_signed=IS_SIGNED)
+        tl.store(Z + tl.arange(0, M)[:, None] * N + tl.arange(0, N)[None, :], z)
+
+    torch_dtype = getattr(torch, dtype_str)
+    x = torch.randint(0, 256, (PM, PN), dtype=torch.uint8, device=device)
+    s = torch.rand(N, device=device).to(torch_dtype)
+    lo, hi = (x & 0xF).to(torch.int32), (x >> 4).to(torch.int32)
+    if is_signed:
+        lo, hi = torch.where(lo >= 8, lo - 16, lo), torch.where(hi >= 8, hi - 16, hi)
+    z_ref = torch.stack([lo, hi], dim=axis + 1).reshape(M, N).to(torch.float32)
+    if with_scale:
+        z_ref = z_ref * s.to(torch.float32)[None, :]
+    z_ref = z_ref.to(torch_dtype)
+    z = torch.empty((M, N), dtype=torch_dtype, device=device)
+    kernel[(1, )](x, s, z, PM, PN, M, N, axis, is_signed, with_scale, getattr(tl, dtype_str))
+    torch.testing.assert_close(z, z_ref, atol=0, rtol=0)
+
+
 @pytest.mark.interpreter
 @pytest.mark.parametrize("debug", [False, True])
 def test_interleave(device, debug):
@@ -2461,6 +2637,50 @@ def test_histogram(M, N, device):
     assert (z_torch == z).all()
 
 
+@pytest.mark.interpreter
+@pytest.mark.parametrize("src_shape, index_shape, axis", [([4, 32], [8, 32], 0), ([32, 4], [32, 16], 1),
+                                                          ([128, 64], [256, 64], 0), ([64, 128], [64, 32], 1)])
+def test_gather(src_shape, index_shape, axis, device):
+
+    @triton.jit
+    def gather_kernel(src_ptr, idx_ptr, out_ptr, SRC_M: tl.constexpr, SRC_N: tl.constexpr, IDX_M: tl.constexpr,
+                      IDX_N: tl.constexpr, AXIS: tl.constexpr):
+        src_offs = tl.arange(0, SRC_M)[:, None] * SRC_N + tl.arange(0, SRC_N)[None, :]
+        idx_offs = tl.arange(0, IDX_M)[:, None] * IDX_N + tl.arange(0, IDX_N)[None, :]
+        src = tl.load(src_ptr + src_offs)
+        idx = tl.load(idx_ptr + idx_offs)
+        out = tl.gather(src, idx, AXIS)
+        tl.store(out_ptr + idx_offs, out)
+
+    torch.manual_seed(0)
+    src = torch.randn(src_shape, device=device)
+    idx = torch.randint(0, src_shape[axis], index_shape, device=device, dtype=torch.int32)
+    out = torch.empty(index_shape, device=device)
+    gather_kernel[(1, )](src, idx, out, *src_shape, *index_shape, axis)
+    assert torch.equal(out, torch.gather(src, axis, idx.long()))
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("index_dtype", ["uint8", "int8", "int16"])
+def test_gather_narrow_index(index_dtype, device):
+    # Unsigned indices of 128 and above must not be sign-extended.
+
+    @triton.jit
+    def gather_kernel(src_ptr, idx_ptr, out_ptr, N: tl.constexpr):
+        offs = tl.arange(0, N)
+        src = tl.load(src_ptr + offs)
+        idx = tl.load(idx_ptr + offs)
+        tl.store(out_ptr + offs, tl.gather(src, idx, 0))
+
+    N = 256 if index_dtype == "uint8" else 128
+    torch.manual_seed(0)
+    src = torch.randn(N, device=device)
+    idx = torch.randint(0, N, (N, ), device=device, dtype=getattr(torch, index_dtype))
+    out = torch.empty(N, device=device)
+    gather_kernel[(1, )](src, idx, out, N)
+    assert torch.equal(out, src[idx.long()])
+
+
 @pytest.mark.interpreter
 @pytest.mark.parametrize("op", ['sum', 'max', 'min'])
 @pytest.mark.parametrize("BLOCK_N", [32, 64, 128])
@@ -3818,6 +4038,35 @@ def test_dot_without_load(dtype_str, device):
     assert torch.all(out == out_ref)
 
 
+@pytest.mark.interpreter
+# (8, 512, 512) is too large for the skinny-M lowering and goes to the FMA path
+@pytest.mark.parametrize("M, N, K", [(1, 64, 64), (2, 32, 128), (4, 64, 32), (8, 32, 64), (8, 128, 256),
+                                     (8, 512, 512)])
+@pytest.mark.parametrize("in_dtype", ['float16', 'bfloat16', 'float32'])
+@pytest.mark.parametrize("num_warps", [1, 4])
+def test_dot_skinny_m(M, N, K, in_dtype, num_warps, device):
+    if is_hip():
+        pytest.skip("skinny-M dots are only supported on NVIDIA GPUs")
+
+    @triton.jit
+    def kernel(X, Y, Z, M: tl.constexpr, N: tl.constexpr, K: tl.constexpr):
+        off_m = tl.arange(0, M)
+        off_n = tl.arange(0, N)
+        off_k = tl.arange(0, K)
+        x = tl.load(X + off_m[:, None] * K + off_k[None, :])
+        y = tl.load(Y + off_k[:, None] * N + off_n[None, :])
+        z = tl.dot(x, y)
+        tl.store(Z + off_m[:, None] * N + off_n[None, :], z)
+
+    torch_dtype = getattr(torch, in_dtype)
+    x = torch.randn((M, K), dtype=torch_dtype, device=device)
+    y = torch.randn((K, N), dtype=torch_dtype, device=device)
+    z = torch.empty((M, N), dtype=torch.float32, device=device)
+    kernel[(1, )](x, y, z, M, N, K, num_warps=num_warps)
+    z_ref = torch.matmul(x.float(), y.float())
+    torch.testing.assert_close(z, z_ref, atol=1e-2, rtol=1e-2)
+
+
 # ---------------
 # test arange
 # ---------------
@@ -5554,6 +5803,31 @@ def test_enable_fp_fusion(enable_fp_fusion, default_override, device):
     assert found_fma == enable_fp_fusion
 
 
+@pytest.mark.parametrize("dtype_str", ["float16", "bfloat16"])
+def test_slp_packed_half_add(dtype_str, device):
+    if not is_cuda():
+        pytest.skip("packed half-precision arithmetic is specific to NVPTX")
+    if dtype_str == "bfloat16" and torch.cuda.get_device_capability()[0] < 9:
+        pytest.skip("add.bf16x2 requires sm_90")
+
+    @triton.jit
+    def add(X, Y, Z, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        tl.store(Z + offs, tl.load(X + offs) + tl.load(Y + offs))
+
+    dtype = getattr(torch, dtype_str)
+    x, y = (torch.randn(1024, device=device, dtype=dtype) for _ in range(2))
+    z = torch.empty_like(x)
+    h = add[(1, )](x, y, z, BLOCK=1024, num_warps=4)
+    torch.testing.assert_close(z, x + y)
+    # The SLP vectorizer pairs the additions into the 32-bit packed instructions,
+    # and builds no wider vectors.
+    ptx_type = "f16" if dtype_str == "float16" else "bf16"
+    assert re.search(rf'add(\.rn)?\.{ptx_type}x2', h.asm["ptx"])
+    widths = re.findall(r'fadd [a-z ]*<(\d+) x (?:half|bfloat)>', h.asm["llir"])
+    assert widths and set(widths) == {"2"}
+
+
 # -----------------------
 # test propagate_nan
 # -----------------------
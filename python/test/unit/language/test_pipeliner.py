@@ -1,5 +1,7 @@
 # End-to-end tests to check the correctness of the pipeliner
 
+import re
+
 import pytest
 import torch
 import triton
@@ -364,3 +366,40 @@ def test_pipeline_epilogue(ROW_COUNT, NUM_STAGES, device):
     BLOCK_SIZE = triton.next_power_of_2(n_cols)
     kernel_up[(1, )](y0, x, x.stride(0), y0.stride(0), n_rows, n_cols, BLOCK_SIZE, NUM_STAGES)
     assert (y0 == torch.ones_like(x)).all()
+
+
+@pytest.mark.parametrize("K", [64, 100, 1000])
+def test_pipeline_peeled_k_loop(K, device, monkeypatch):
+    check_capabilities()
+    BLOCK_M = 16
+    BLOCK_K = 32
+
+    def make_kernel():
+
+        @triton.jit
+        def row_sum_kernel(x_ptr, out_ptr, K, stride_m, BLOCK_M: tl.constexpr, BLOCK_K: tl.constexpr):
+            offs_m = tl.arange(0, BLOCK_M)
+            offs_k = tl.arange(0, BLOCK_K)
+            x_ptrs = x_ptr + offs_m[:, None] * stride_m + offs_k[None, :]
+            acc = tl.zeros((BLOCK_M, BLOCK_K), dtype=tl.float32)
+            for k in range(0, tl.cdiv(K, BLOCK_K)):
+                acc += tl.load(x_ptrs, mask=offs_k[None, :] < K - k * BLOCK_K, other=0.0)
+                x_ptrs += BLOCK_K
+            tl.store(out_ptr + offs_m, tl.sum(acc, axis=1))
+
+        return row_sum_kernel
+
+    x = torch.randn(BLOCK_M, K, dtype=torch.float32, device=device)
+    ref_out = x.sum(dim=1)
+    counts = {}
+    for peel in ["0", "1"]:
+        monkeypatch.setenv("TRITON_PEEL_MASKED_LOOPS", peel)
+        output = torch.empty(BLOCK_M, dtype=torch.float32, device=device)
+        handler = make_kernel()[(1, )](x, output, K, x.stride(0), BLOCK_M, BLOCK_K)
+        torch.testing.assert_close(ref_out, output, atol=1e-4, rtol=1e-4)
+        ttir = handler.asm["ttir"]
+        counts[peel] = (len(re.findall(r"tt\.load %\S+, ", ttir)), len(re.findall(r"tt\.load %\S+ :", ttir)))
+    # The remainder loop keeps the masked load and the main loop issues it
+    # without a mask.
+    assert counts["0"] == (1, 0), counts
+    assert counts["1"] == (1, 1), counts
@@ -48,6 +48,91 @@ def test_sort(M, N, descending, dtype_str, device):
     assert (y == z).all(), (y, z)
 
 
+@pytest.mark.interpreter
+@pytest.mark.parametrize("M, N", [[8, 64], [64, 8]])
+@pytest.mark.parametrize("descending", [False, True])
+def test_sort_dim0(M, N, descending, device):
+
+    @triton.jit
+    def sort_kernel(X, Z, N: tl.constexpr, M: tl.constexpr, descending: tl.constexpr):
+        offx = tl.arange(0, M)
+        offy = tl.arange(0, N) * M
+        off2d = offx[None, :] + offy[:, None]
+        x = tl.load(X + off2d)
+        x = x.sort(0, descending)
+        tl.store(Z + off2d, x)
+
+    x = numpy_random((N, M), dtype_str='float32')
+    x = torch.from_numpy(x).to(device)
+    y = torch.sort(x, dim=0, descending=descending)[0]
+    z = torch.empty_like(x)
+    sort_kernel[(1, )](x, z, N, M, descending, num_warps=4)
+    assert (y == z).all(), (y, z)
+
+
+# ---------------
+# test topk op
+# ---------------
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("M, N, K", [[1, 512, 8], [8, 64, 16], [256, 16, 4]])
+@pytest.mark.parametrize("largest", [False, True])
+@pytest.mark.parametrize("dtype_str", ['int32', 'float16', 'float32'])
+def test_topk(M, N, K, largest, dtype_str, device):
+
+    @triton.jit
+    def topk_kernel(X, Z, I, N: tl.constexpr, M: tl.constexpr, K: tl.constexpr, largest: tl.constexpr):
+        offy = tl.arange(0, M)[:, None]
+        x = tl.load(X + offy * N + tl.arange(0, N)[None, :])
+        values, indices = tl.topk(x, K, largest=largest)
+        offz = offy * K + tl.arange(0, K)[None, :]
+        tl.store(Z + offz, values)
+        tl.store(I + offz, indices)
+
+    x = numpy_random((M, N), dtype_str=dtype_str)
+    x = torch.from_numpy(x).to(device)
+    y = torch.topk(x, K, dim=1, largest=largest)[0]
+    z = torch.empty((M, K), dtype=x.dtype, device=device)
+    idx = torch.empty((M, K), dtype=torch.int32, device=device)
+    topk_kernel[(1, )](x, z, idx, N, M, K, largest, num_warps=4)
+    assert (y == z).all(), (y, z)
+    # Ties may be broken differently than torch, so check the indices point at the values
+    assert (torch.gather(x, 1, idx.long()) == z).all(), (x, idx, z)
+    assert all(len(set(row)) == K for row in idx.tolist())
+
+
+# ---------------
+# test device-wide cumsum
+# ---------------
+
+
+@pytest.mark.interpreter
+@pytest.mark.parametrize("N, BLOCK", [[128, 128], [4096, 128], [65536, 1024]])
+@pytest.mark.parametrize("dtype_str", ['int32', 'float32'])
+def test_device_cumsum(N, BLOCK, dtype_str, device):
+
+    @triton.jit
+    def device_cumsum_kernel(X, Z, status_ptr, counter_ptr, BLOCK: tl.constexpr):
+        tile_id = tl.atomic_add(counter_ptr, 1)
+        offs = tile_id * BLOCK + tl.arange(0, BLOCK)
+        x = tl.load(X + offs)
+        z = tl.device_cumsum(x, status_ptr, tile_id)
+        tl.store(Z + offs, z)
+
+    num_tiles = N // BLOCK
+    if dtype_str == 'int32':
+        x = torch.randint(-100, 100, (N, ), dtype=torch.int32, device=device)
+    else:
+        # Small integers keep the float sums exact whatever the order.
+        x = torch.randint(-100, 100, (N, ), device=device).to(torch.float32)
+    z = torch.empty_like(x)
+    status = torch.zeros(num_tiles, dtype=torch.int64, device=device)
+    counter = torch.zeros(1, dtype=torch.int32, device=device)
+    device_cumsum_kernel[(num_tiles, )](x, z, status, counter, BLOCK=BLOCK)
+    assert torch.equal(z, torch.cumsum(x, 0).to(x.dtype))
+
+
 # ---------------
 # test flip op
 # ---------------
@@ -1,7 +1,10 @@
 import importlib.util
 import itertools
+import os
 import shutil
 import tempfile
+import time
+from pathlib import Path
 
 import pytest
 import torch
@@ -186,6 +189,29 @@ def test_specialize(mode, device, fresh_triton_cache):
     assert counter == target
 
 
+def test_multiversion(device):
+
+    @triton.jit
+    def kernel(X, Y, N, BLOCK: tl.constexpr):
+        offs = tl.arange(0, BLOCK)
+        for i in range(0, N, BLOCK):
+            tl.store(Y + i + offs, tl.load(X + i + offs) + 1)
+
+    BLOCK = 128
+    N = 4 * BLOCK
+    x = torch.arange(N + 1, dtype=torch.float32, device=device)
+    # Aligned, then misaligned pointers.
+    for offset in [0, 1]:
+        y = torch.zeros_like(x)
+        handle = kernel[(1, )](x[offset:], y[offset:], N, BLOCK=BLOCK, multiversion=True)
+        assert torch.equal(y[offset:offset + N], x[offset:offset + N] + 1)
+    assert "scf.if" in handle.asm["ttir"]
+
+    # Alignment is checked inside the kernel, so one compilation serves both.
+    device = getattr(torch, device).current_device()
+    assert len(kernel.cache[device]) == 1
+
+
 def test_annotation(device):
 
     @triton.jit
@@ -599,3 +625,277 @@ def test_within_2gb(device, fresh_triton_cache) -> None:
     # Torch tensor <= 2GB
     kernel_add[(1, 0)](torch.empty(2**31 - 1, dtype=torch.int8, device=device))
     assert pointer_range_32 == [0]
+
+
+def test_compact_cache(fresh_triton_cache) -> None:
+    from triton.runtime.cache import FileCacheManager, compact_cache
+
+    def put_kernel(key, last_used):
+        manager = FileCacheManager(key)
+        group = {name: manager.put(b"0" * 1000, name) for name in ["kernel.ttir", "kernel.cubin"]}
+        group["kernel.json"] = manager.put("{}", "kernel.json", binary=False)
+        manager.put_group("kernel.json", group)
+        for name in os.listdir(manager.cache_dir):
+            os.utime(os.path.join(manager.cache_dir, name), (last_used, last_used))
+        return manager
+
+    last_used = time.time() - 10000
+    managers = [put_kernel(f"key{i}", last_used + i) for i in range(4)]
+    # Unreferenced files are removed once they are old enough
+    stray = os.path.join(managers[0].cache_dir, "stray")
+    Path(stray).write_text("0")
+    os.utime(stray, (last_used, last_used))
+    # The least recently used kernels are evicted first
+    assert compact_cache(max_bytes=5000) > 0
+    assert sorted(name for name in os.listdir(fresh_triton_cache) if not name.startswith(".")) == ["key2", "key3"]
+    assert set(managers[2].get_group("kernel.json")) == {"kernel.ttir", "kernel.cubin", "kernel.json"}
+    # Dropped files are removed from the groups and the disk
+    compact_cache(keep=lambda name, group: not name.endswith(".ttir"))
+    assert set(managers[3].get_group("kernel.json")) == {"kernel.cubin", "kernel.json"}
+    assert not os.path.exists(os.path.join(managers[3].cache_dir, "kernel.ttir"))
+
+
+def test_packed_cache(fresh_triton_cache) -> None:
+    from triton.runtime.cache import FileCacheManager, PackedCacheManager, pack_cache
+
+    for i in range(10):
+        manager = FileCacheManager(f"key{i}")
+        group = {
+            "kernel.cubin": manager.put(bytes([i]) * 16, "kernel.cubin"),
+            "kernel.json": manager.put(f'{{"i": {i}}}', "kernel.json", binary=False),
+        }
+        manager.put_group("kernel.json", group)
+    assert pack_cache() == 10
+    shutil.rmtree(os.path.join(fresh_triton_cache, "key3"))
+    group = PackedCacheManager("key3").get_group("kernel.json")
+    assert bytes(group["kernel.cubin"]) == bytes([3]) * 16
+    assert bytes(group["kernel.json"]) == b'{"i": 3}'
+    assert PackedCacheManager("key10").get_group("kernel.json") is None
+
+
+def test_preload_binaries(fresh_triton_cache) -> None:
+    import json
+    from triton.compiler.compiler import make_backend
+    from triton.runtime import preload
+    from triton.runtime.cache import get_cache_manager
+
+    key = "ab" * 32
+    target = triton.runtime.driver.active.get_current_target()
+    binary_ext = make_backend(target).binary_ext
+    metadata = {"name": "kernel", "shared": 0, "target": vars(target)}
+    manager = get_cache_manager(key)
+    group = {
+        f"kernel.{binary_ext}": manager.put(b"binary", f"kernel.{binary_ext}"),
+        "kernel.json": manager.put(json.dumps(metadata), "kernel.json", binary=False),
+    }
+    manager.put_group("kernel.json", group)
+
+    class StubUtils:
+
+        def __init__(self):
+            self.loaded = []
+
+        def load_binary(self, name, kernel, shared, device):
+            self.loaded.append((name, kernel, device))
+            return ("module", "function", 32, 0)
+
+    class StubDriver:
+
+        def __init__(self):
+            self.utils = StubUtils()
+
+        def get_current_device(self):
+            return 0
+
+    stub = StubDriver()
+    triton.runtime.driver.set_active(stub)
+    try:
+        assert preload.preload_kernels([key]).result() == 1
+    finally:
+        triton.runtime.driver.reset_active()
+    assert stub.utils.loaded == [("kernel", b"binary", 0)]
+    assert preload.take_preloaded_handles(key, 0) == ("module", "function", 32, 0)
+    assert preload.take_preloaded_handles(key, 0) is None
+    group = preload.take_preloaded_group(key)
+    assert group[f"kernel.{binary_ext}"] == b"binary"
+    assert preload.take_preloaded_group(key) is None
+
+
+def test_preload_manifest_on_first_launch(fresh_triton_cache, tmp_path, monkeypatch) -> None:
+    import json
+    from triton.runtime import preload
+
+    manifest = tmp_path / "manifest.json"
+    manifest.write_text(json.dumps({"kernels": [{"key": "ab" * 32, "name": "a"}, {"key": "cd" * 32, "name": "b"}]}))
+    monkeypatch.setenv("TRITON_PRELOAD_MANIFEST", str(manifest))
+    monkeypatch.setattr(preload, "_pending_manifest", None)
+    preloaded = []
+    monkeypatch.setattr(preload, "preload_kernels", lambda kernels, device: preloaded.append((kernels, device)))
+    # Nothing is loaded until the first launch, which gives the device
+    preload._init_from_env()
+    assert preloaded == []
+    assert preload.take_preloaded_handles("ab" * 32, 1) is None
+    assert preloaded == [([{"key": "cd" * 32, "name": "b"}], 1)]
+    assert preload.take_preloaded_handles("cd" * 32, 1) is None
+    assert len(preloaded) == 1
+
+
+def test_compile_server(device, fresh_triton_cache, tmp_path, monkeypatch) -> None:
+    import threading
+    from triton.compiler import compiler
+    from triton.runtime.compile_server import CompileServer, request_compile
+
+    @triton.jit
+    def kernel_add(a, b, o, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) + tl.load(b + idx))
+
+    # The server runs in this process on a thread pool: stages run on the main
+    # thread are a local compile by the client.
+    local_stages = []
+    make_backend = compiler.make_backend
+
+    def make_recording_backend(target):
+        backend = make_backend(target)
+        add_stages = backend.add_stages
+
+        def add_recording_stages(stages, options):
+            add_stages(stages, options)
+            for ext, stage in list(stages.items()):
+
+                def recording_stage(src, metadata, ext=ext, stage=stage):
+                    if threading.current_thread() is threading.main_thread():
+                        local_stages.append(ext)
+                    return stage(src, metadata)
+
+                stages[ext] = recording_stage
+
+        backend.add_stages = add_recording_stages
+        return backend
+
+    monkeypatch.setattr(compiler, "make_backend", make_recording_backend)
+
+    socket_path = str(tmp_path / "compile.sock")
+    server = CompileServer(socket_path, max_workers=2, use_processes=False)
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    monkeypatch.setenv("TRITON_COMPILE_SERVER", socket_path)
+    try:
+        a = torch.randn(32, device=device)
+        b = torch.randn(32, device=device)
+        o = torch.empty_like(a)
+        kernel_add[(1, )](a, b, o, 32)
+        assert server.num_compiles == 1
+        assert local_stages == []
+        torch.testing.assert_close(o, a + b)
+        # requests that cannot be serialized fall back to a local compile
+        assert not request_compile(socket_path, {"options": {"fn": lambda: None}})
+    finally:
+        server.shutdown()
+        server.server_close()
+
+
+def test_compile_server_dedup(tmp_path, monkeypatch) -> None:
+    import threading
+    from concurrent.futures import Future
+    from triton.runtime import compile_server
+    from triton.runtime.compile_server import CompileServer, request_compile
+
+    release = threading.Event()
+    compiled = []
+
+    def fake_compile(request):
+        compiled.append(request["key"])
+        release.wait()
+        return request["key"]
+
+    monkeypatch.setattr(compile_server, "_compile", fake_compile)
+
+    class CountingDict(dict):
+        # Counts the lookups, i.e. the requests that reached the server
+        lookups = 0
+
+        def get(self, key, default=None):
+            self.lookups += 1
+            return super().get(key, default)
+
+    socket_path = str(tmp_path / "compile.sock")
+    server = CompileServer(socket_path, max_workers=2, use_processes=False)
+    server.in_flight = CountingDict()
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    try:
+        # Two concurrent requests for the same kernel share one compilation
+        results = []
+        clients = [
+            threading.Thread(target=lambda: results.append(request_compile(socket_path, {"key": "k"})))
+            for _ in range(2)
+        ]
+        for client in clients:
+            client.start()
+        while server.in_flight.lookups < 2:
+            time.sleep(0.01)
+        release.set()
+        for client in clients:
+            client.join()
+        assert results == [True, True]
+        assert compiled == ["k"]
+        assert server.num_compiles == 1
+        assert "k" not in server.in_flight
+
+        # A compilation that is done before its callback is registered must not deadlock
+        class DoneExecutor:
+
+            def submit(self, fn, request):
+                future = Future()
+                future.set_result(request["key"])
+                return future
+
+            def shutdown(self, wait=True):
+                pass
+
+        server.executor.shutdown()
+        server.executor = DoneExecutor()
+        worker = threading.Thread(target=lambda: results.append(server.compile({"key": "done"})), daemon=True)
+        worker.start()
+        worker.join(timeout=10)
+        assert not worker.is_alive()
+        assert results[-1] and "done" not in server.in_flight
+    finally:
+        server.shutdown()
+        server.server_close()
+
+
+def test_stage_cache(device, fresh_triton_cache, monkeypatch) -> None:
+    from triton.compiler import compiler
+
+    ran = []
+    make_backend = compiler.make_backend
+
+    def make_counting_backend(target):
+        backend = make_backend(target)
+        add_stages = backend.add_stages
+
+        def add_counting_stages(stages, options):
+            add_stages(stages, options)
+            for ext, stage in list(stages.items()):
+                stages[ext] = lambda src, metadata, ext=ext, stage=stage: ran.append(ext) or stage(src, metadata)
+
+        backend.add_stages = add_counting_stages
+        return backend
+
+    monkeypatch.setattr(compiler, "make_backend", make_counting_backend)
+
+    @triton.jit
+    def kernel_fma(a, b, c, o, N: tl.constexpr):
+        idx = tl.arange(0, N)
+        tl.store(o + idx, tl.load(a + idx) * tl.load(b + idx) + tl.load(c + idx))
+
+    a, b, c = (torch.randn(32, device=device) for _ in range(3))
+    o = torch.empty_like(a)
+    kernel_fma[(1, )](a, b, c, o, 32, enable_fp_fusion=True)
+    stages = list(ran)
+    assert len(stages) == 5
+    ran.clear()
+    # only the stages after the TTGIR read enable_fp_fusion
+    kernel_fma[(1, )](a, b, c, o, 32, enable_fp_fusion=False)
+    assert ran == stages[2:]
+    torch.testing.assert_close(o, a * b + c)
@@ -25,6 +25,10 @@ from . import language
 from . import testing
 from . import tools
 
+from .runtime.preload import _init_from_env as _init_preload_from_env
+
+_init_preload_from_env()
+
 __all__ = [
     "autotune",
     "cdiv",
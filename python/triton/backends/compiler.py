@@ -5,7 +5,7 @@ import subprocess
 
 from abc import ABCMeta, abstractmethod, abstractclassmethod
 from dataclasses import dataclass
-from typing import Dict, List, Tuple, Union
+from typing import Dict, List, Optional, Tuple, Union
 from types import ModuleType
 
 # Table that associates strings to AttrsDescriptor (sub)classes.
@@ -272,6 +272,15 @@ class BaseBackend(metaclass=ABCMeta):
         """
         raise NotImplementedError
 
+    def get_stage_options(self, stage: str) -> Optional[Tuple[str]]:
+        """
+        Returns the names of the options read by `stage`, directly or through the metadata,
+        or None if unknown. The output of a stage is cached on its input and on these options,
+        so that compilations differing in the options of later stages reuse it.
+        Options objects must then implement `hash(names)` over a subset of their fields.
+        """
+        return None
+
     @abstractmethod
     def load_dialects(self, context):
         """
@@ -7,7 +7,9 @@ from ..backends.compiler import GPUTarget, AttrsDescriptor
 from .. import __version__
 from ..runtime.autotuner import OutOfResources
 from ..runtime.cache import get_cache_manager, get_dump_manager, get_override_manager
+from ..runtime.compile_server import make_request, request_compile
 from ..runtime.driver import driver
+from ..runtime.preload import take_preloaded_group, record_kernel, take_preloaded_handles
 from ..tools.disasm import get_sass
 # TODO: this shouldn't be here
 from .code_generator import ast_to_ttir
@@ -15,6 +17,7 @@ from pathlib import Path
 import re
 import functools
 import os
+import tempfile
 
 # - ^\s*tt\.func\s+ : match the start of the string, any leading whitespace, the keyword func,
 #    and any following whitespace
@@ -177,6 +180,57 @@ def parse(full_name, ext, context):
         return Path(full_name).read_bytes()
 
 
+def _ir_data(module):
+    # The printed form of a stage's output, as stored in the cache.
+    return module if isinstance(module, (str, bytes)) else str(module)
+
+
+def _parse_ir_data(data, ext, context):
+    if ext == "ttir" or ext == "ttgir":
+        with tempfile.NamedTemporaryFile("w", suffix=f".{ext}") as f:
+            f.write(data)
+            f.flush()
+            return parse(f.name, ext, context)
+    return data
+
+
+def _stage_key(backend, stage, options, ir_data, env_vars):
+    # A stage's output only depends on its input, on the options it reads and on
+    # the compiler, so that it can be reused by compilations that differ in the
+    # options of other stages only.
+    names = backend.get_stage_options(stage)
+    options_hash = options.hash() if names is None else options.hash(names)
+    data = ir_data if isinstance(ir_data, bytes) else ir_data.encode("utf-8")
+    input_hash = hashlib.sha256(data).hexdigest()
+    key = f"{triton_key()}-{backend.hash()}-{stage}-{input_hash}-{options_hash}-{str(sorted(env_vars.items()))}"
+    return hashlib.sha256(key.encode("utf-8")).hexdigest()
+
+
+def _get_cached_stage(stage_key, ext, metadata):
+    group = get_cache_manager(stage_key).get_group("stage.json") or {}
+    if "stage.json" not in group or f"stage.{ext}" not in group:
+        return None
+    stage = json.loads(_read_cached(group["stage.json"]))
+    # replay the metadata written by the stage
+    metadata.update(stage["metadata"])
+    return _read_cached(group[f"stage.{ext}"], binary=stage["binary"])
+
+
+def _put_cached_stage(stage_key, ext, ir_data, metadata_before, metadata):
+    # The kernel group keeps its own copy of the output: referencing this entry
+    # instead would break the kernel when the entry is evicted on its own.
+    cache_manager = get_cache_manager(stage_key)
+    stage = {
+        "binary": isinstance(ir_data, bytes),
+        "metadata": {k: v for k, v in metadata.items() if k not in metadata_before or metadata_before[k] != v},
+    }
+    group = {
+        f"stage.{ext}": cache_manager.put(ir_data, f"stage.{ext}"),
+        "stage.json": cache_manager.put(json.dumps(stage, default=vars), "stage.json", binary=False),
+    }
+    cache_manager.put_group("stage.json", group)
+
+
 def filter_traceback(e: BaseException):
     """
     Removes code_generator.py and related files from tracebacks.
@@ -243,12 +297,11 @@ def compile(src, target=None, options=None):
     # the file name to 150 characters to be safe.
     file_name = src.name[:150]
     metadata_filename = f"{file_name}.json"
-    metadata_group = fn_cache_manager.get_group(metadata_filename) or {}
+    metadata_group = take_preloaded_group(hash) or fn_cache_manager.get_group(metadata_filename) or {}
     metadata_path = metadata_group.get(metadata_filename)
     always_compile = os.environ.get("TRITON_ALWAYS_COMPILE", "0") == "1"
     if not always_compile and metadata_path is not None:
         # cache hit!
-        metadata = json.loads(Path(metadata_path).read_text())
         return CompiledKernel(src, metadata_group, hash)
     # initialize metadata
     metadata = {
@@ -275,24 +328,62 @@ def compile(src, target=None, options=None):
         filter_traceback(e)
         raise
     use_ir_loc = os.environ.get("USE_IR_LOC", None)
+    compile_server = os.environ.get("TRITON_COMPILE_SERVER", "").strip()
+    if compile_server and type(src) is ASTSource and not (always_compile or enable_override or enable_ir_dump
+                                                          or use_ir_loc):
+        # the rest of the pipeline runs in the shared compile server, which
+        # publishes the kernel into the cache
+        if request_compile(compile_server, make_request(hash, src, module.str(), target, options)):
+            metadata_group = fn_cache_manager.get_group(metadata_filename) or {}
+            if metadata_filename in metadata_group:
+                context.disable_multithreading()
+                return CompiledKernel(src, metadata_group, hash)
+    # stages are cached on their input and on the options they read, so that a
+    # compilation restarts from the first stage that differs from a cached one
+    keep_ir = os.environ.get("TRITON_CACHE_KEEP_IR", "1") == "1"
+    use_stage_cache = os.environ.get("TRITON_STAGE_CACHE", "1" if keep_ir else "0") == "1"
+    use_stage_cache = use_stage_cache and not (always_compile or enable_override or use_ir_loc)
+    module_ext, ir_data = src.ext, None
     for ext, compile_ir in list(stages.items())[first_stage:]:
-        next_module = compile_ir(module, metadata)
         ir_filename = f"{file_name}.{ext}"
-        if (fn_override_manager is not None and (full_name := fn_override_manager.get_file(ir_filename)) is not None):
-            print(f"\nOverriding kernel with file {full_name}")
-            next_module = parse(full_name, ext, context)
-        metadata_group[ir_filename] = fn_cache_manager.put(next_module, ir_filename)
+        stage_key, next_module, next_ir_data = None, None, None
+        if use_stage_cache:
+            if ir_data is None:
+                ir_data = _ir_data(module)
+            stage_key = _stage_key(backend, ext, options, ir_data, env_vars)
+            next_ir_data = _get_cached_stage(stage_key, ext, metadata)
+        if next_ir_data is None:
+            # cached stages are only parsed when a later stage needs to run
+            if module is None:
+                module = _parse_ir_data(ir_data, module_ext, context)
+            metadata_before = dict(metadata)
+            next_module = compile_ir(module, metadata)
+            if (fn_override_manager is not None and (full_name := fn_override_manager.get_file(ir_filename)) is not None):
+                print(f"\nOverriding kernel with file {full_name}")
+                next_module = parse(full_name, ext, context)
+            next_ir_data = _ir_data(next_module)
+            if stage_key is not None:
+                _put_cached_stage(stage_key, ext, next_ir_data, metadata_before, metadata)
+        metadata_group[ir_filename] = fn_cache_manager.put(next_ir_data, ir_filename)
         if fn_dump_manager is not None:
-            fn_dump_manager.put(next_module, ir_filename)
+            fn_dump_manager.put(next_ir_data, ir_filename)
         # use an env variable to parse ir from file
         if use_ir_loc == ext:
             ir_full_name = fn_cache_manager.get_file(ir_filename)
             next_module.create_location_snapshot(ir_full_name)
             print(f"Creating new locations for {ir_full_name}")
-        module = next_module
+        module, module_ext, ir_data = next_module, ext, next_ir_data
     # write-back metadata
     metadata_group[metadata_filename] = fn_cache_manager.put(json.dumps(metadata, default=vars), metadata_filename,
                                                              binary=False)
+    if not keep_ir:
+        # only the binary and the metadata are needed to load the kernel; the
+        # unreferenced IRs are removed when the cache is compacted
+        metadata_group = {
+            name: path
+            for name, path in metadata_group.items()
+            if name == metadata_filename or name == f"{file_name}.{backend.binary_ext}"
+        }
     fn_cache_manager.put_group(metadata_filename, metadata_group)
     # Compilation completed, disabling multithreading in context.
     # This is needed to safely finalize threads pool inside context: if current process forks before
@@ -340,6 +431,15 @@ class AsmDict(dict):
         return value
 
 
+def _read_cached(artifact, binary=False):
+    # Cache managers return either the path of an artifact or, for packed
+    # caches, a buffer holding its contents.
+    if isinstance(artifact, (bytes, memoryview)):
+        data = bytes(artifact)
+        return data if binary else data.decode("utf-8")
+    return Path(artifact).read_bytes() if binary else Path(artifact).read_text()
+
+
 class CompiledKernel:
 
     # Hooks for external tools to monitor the execution of triton kernels
@@ -349,8 +449,7 @@ class CompiledKernel:
 
     def __init__(self, src, metadata_group, hash):
         from collections import namedtuple
-        metadata_path = next((Path(p) for c, p in metadata_group.items() if c.endswith(".json")))
-        metadata = json.loads(metadata_path.read_text())
+        metadata = json.loads(next(_read_cached(p) for c, p in metadata_group.items() if c.endswith(".json")))
         metadata['cluster_dims'] = tuple(metadata['cluster_dims'])
         # JSON serialization dumps the target as a dict. Restore it to a GPUTarget.
         target = metadata['target']
@@ -363,11 +462,11 @@ class CompiledKernel:
         self.hash = hash
         self.name = self.metadata.name
         # stores the text of each level of IR that was generated during compilation
-        asm_files = [Path(p) for c, p in metadata_group.items() if not c.endswith(".json")]
         binary_ext = backend.binary_ext
         self.asm = AsmDict({
-            file.suffix[1:]: file.read_bytes() if file.suffix[1:] == binary_ext else file.read_text()
-            for file in asm_files
+            Path(c).suffix[1:]: _read_cached(p, binary=Path(c).suffix[1:] == binary_ext)
+            for c, p in metadata_group.items()
+            if not c.endswith(".json")
         })
         self.kernel = self.asm[binary_ext]
         # binaries are lazily initialized
@@ -387,8 +486,11 @@ class CompiledKernel:
         if self.metadata.shared > max_shared:
             raise OutOfResources(self.metadata.shared, max_shared, "shared memory")
         # TODO: n_regs, n_spills should be metadata generated when calling `ptxas`
-        self.module, self.function, self.n_regs, self.n_spills = driver.active.utils.load_binary(
-            self.name, self.kernel, self.metadata.shared, device)
+        handles = take_preloaded_handles(self.hash, device)
+        if handles is None:
+            handles = driver.active.utils.load_binary(self.name, self.kernel, self.metadata.shared, device)
+        self.module, self.function, self.n_regs, self.n_spills = handles
+        record_kernel(self.hash, self.src.name[:150])
 
     def __getattribute__(self, name):
         if name == 'run':
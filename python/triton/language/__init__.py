@@ -9,6 +9,7 @@ from .standard import (
     cdiv,
     cumprod,
     cumsum,
+    device_cumsum,
     flip,
     interleave,
     max,
@@ -19,6 +20,7 @@ from .standard import (
     sort,
     sum,
     swizzle2d,
+    topk,
     xor_sum,
     zeros,
     zeros_like,
@@ -67,11 +69,13 @@ from .core import (
     float8e5b16,
     full,
     function_type,
+    gather,
     histogram,
     inline_asm_elementwise,
     int1,
     int16,
     int32,
+    int4_to_fp,
     int64,
     int8,
     join,
@@ -159,6 +163,7 @@ __all__ = [
     "cumsum",
     "debug_barrier",
     "device_assert",
+    "device_cumsum",
     "device_print",
     "div_rn",
     "dot",
@@ -183,12 +188,14 @@ __all__ = [
     "fma",
     "full",
     "function_type",
+    "gather",
     "histogram",
     "inline_asm_elementwise",
     "interleave",
     "int1",
     "int16",
     "int32",
+    "int4_to_fp",
     "int64",
     "int8",
     "ir",
@@ -239,6 +246,7 @@ __all__ = [
     "sum",
     "swizzle2d",
     "tensor",
+    "topk",
     "trans",
     "triton",
     "uint16",
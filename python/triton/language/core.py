@@ -1506,6 +1506,36 @@ def cast(input, dtype: dtype, fp_downcast_rounding: Optional[str] = None, bitcas
     return semantic.cast(input, dtype, _builder, fp_downcast_rounding)
 
 
+@builtin
+def int4_to_fp(input, axis, dtype=float16, scale=None, is_signed=True, _builder=None):
+    """
+    Unpacks 4-bit integers stored two per :code:`int8`/:code:`uint8` and converts
+    them to :code:`dtype`, optionally multiplying them by :code:`scale`.
+
+    The lower 4 bits of each byte hold the first element and the upper 4 bits
+    the second one, so the result is twice as large as :code:`input` along
+    :code:`axis`.
+
+    :param input: The packed tensor.
+    :type input: Tensor of scalar-type in {:code:`int8`, :code:`uint8`}
+    :param axis: The dimension along which the values are packed.
+    :type axis: int
+    :param dtype: The result type, :code:`float16` or :code:`bfloat16`.
+    :type dtype: tl.dtype
+    :param scale: If given, multiplied into the unpacked values. It is broadcast
+        to the shape of the result.
+    :type scale: Tensor, optional
+    :param is_signed: Whether the 4-bit values are two's complement (int4) or
+        unsigned (uint4).
+    :type is_signed: bool, optional
+    """
+    axis = _constexpr_to_value(axis)
+    dtype = _constexpr_to_value(dtype)
+    is_signed = _constexpr_to_value(is_signed)
+    scale = _constexpr_to_value(scale)
+    return semantic.int4_to_fp(input, axis, dtype, scale, is_signed, _builder)
+
+
 # -----------------------
 # Linear Algebra
 # -----------------------
@@ -1889,6 +1919,26 @@ def where(condition, x, y, _builder=None):
     return semantic.where(condition, x, y, _builder)
 
 
+@_tensor_member_fn
+@builtin
+def gather(src, index, axis, _builder=None):
+    """Gather from a tensor along a given dimension.
+
+    :code:`result[i][j] = src[index[i][j]][j]` for :code:`axis=0`, and likewise
+    for other axes and ranks. :code:`index` must have the same rank as
+    :code:`src` and the same size on every dimension but :code:`axis`.
+
+    :param src: the source tensor
+    :type src: Tensor
+    :param index: the index tensor
+    :type index: Tensor
+    :param axis: the dimension to gather along
+    :type axis: int
+    """
+    axis = _constexpr_to_value(axis)
+    return semantic.gather(src, index, axis, _builder)
+
+
 # -----------------------
 # Math
 # -----------------------
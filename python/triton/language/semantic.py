@@ -700,6 +700,29 @@ def join(a: tl.tensor, b: tl.tensor, builder: ir.builder) -> tl.tensor:
     return ret
 
 
+def int4_to_fp(input: tl.tensor, axis: int, dtype: tl.dtype, scale: Optional[tl.tensor], is_signed: bool,
+               builder: ir.builder) -> tl.tensor:
+    assert input.type.is_block(), "int4_to_fp expects a tensor"
+    assert input.type.scalar.primitive_bitwidth == 8 and input.type.scalar.is_int(), \
+        f"int4_to_fp expects packed int8 or uint8 values, got {input.type.scalar}"
+    assert dtype in (tl.float16, tl.bfloat16), f"int4_to_fp only supports fp16 and bf16 results, got {dtype}"
+    rank = len(input.shape)
+    if axis < 0:
+        axis += rank
+    assert 0 <= axis < rank, f"invalid axis {axis} for a tensor of rank {rank}"
+    if input.type.scalar.is_int_unsigned():
+        input = bitcast(input, tl.int8, builder)
+    shape = [tl._constexpr_to_value(d) for d in input.shape]
+    shape[axis] *= 2
+    ret_ty = tl.block_type(dtype, shape)
+    scale_handle = None
+    if scale is not None:
+        scale = cast(broadcast_impl_shape(to_tensor(scale, builder), shape, builder), dtype, builder)
+        scale_handle = scale.handle
+    return tl.tensor(builder.create_int4_to_fp(input.handle, scale_handle, ret_ty.to_ir(builder), axis, is_signed),
+                     ret_ty)
+
+
 def split(a: tl.tensor, builder: ir.builder) -> Tuple[tl.tensor, tl.tensor]:
     assert (len(a.shape) > 0)
     assert (tl._constexpr_to_value(a.shape[-1]) == 2)
@@ -1598,6 +1621,23 @@ def where(condition: tl.tensor, x: tl.tensor, y: tl.tensor, builder: ir.builder)
     return tl.tensor(builder.create_select(condition.handle, x.handle, y.handle), ret_ty)
 
 
+def gather(src: tl.tensor, index: tl.tensor, axis: int, builder: ir.builder) -> tl.tensor:
+    assert index.dtype.is_int(), "index must be an integer tensor"
+    rank = len(src.type.shape)
+    assert len(index.type.shape) == rank, "source and index tensors must have the same rank"
+    assert -rank <= axis < rank, f"gather axis {axis} must be < source rank ({rank})"
+    if axis < 0:
+        axis += rank
+    for d, (src_dim, index_dim) in enumerate(zip(src.type.shape, index.type.shape)):
+        if d != axis and src_dim != index_dim:
+            raise ValueError(f"index dim {d} must match the corresponding source dim")
+    # The IR is signless; widen narrow indices here, where their signedness is known.
+    if index.dtype.primitive_bitwidth < 32:
+        index = cast(index, tl.int32 if index.dtype.is_int_signed() else tl.uint32, builder)
+    ret_ty = tl.block_type(src.type.scalar, index.type.shape)
+    return tl.tensor(builder.create_gather(src.handle, index.handle, axis), ret_ty)
+
+
 # ===----------------------------------------------------------------------===//
 #                               Reduction
 # ===----------------------------------------------------------------------===
@@ -1655,6 +1695,72 @@ def associative_scan(inputs: Sequence[tl.tensor], axis: int, region_builder_fn,
     return tuple(wrap_tensor(scan_op.get_result(i), inputs[i].type.scalar, shape) for i in range(len(inputs)))
 
 
+# ===----------------------------------------------------------------------===
+#                               Sort
+# ===----------------------------------------------------------------------===
+
+
+def _compare(lhs: ir.value, rhs: ir.value, ty: tl.dtype, greater: bool, builder: ir.builder) -> ir.value:
+    if ty.is_floating():
+        return builder.create_fcmpOGT(lhs, rhs) if greater else builder.create_fcmpOLT(lhs, rhs)
+    if ty.is_int_signed():
+        return builder.create_icmpSGT(lhs, rhs) if greater else builder.create_icmpSLT(lhs, rhs)
+    return builder.create_icmpUGT(lhs, rhs) if greater else builder.create_icmpULT(lhs, rhs)
+
+
+def _equal(lhs: ir.value, rhs: ir.value, ty: tl.dtype, builder: ir.builder) -> ir.value:
+    return builder.create_fcmpOEQ(lhs, rhs) if ty.is_floating() else builder.create_icmpEQ(lhs, rhs)
+
+
+def _make_sort_comparator(op, inputs: Sequence[tl.tensor], descending: bool, builder: ir.builder):
+    # The first input holds the keys. When there is a second one, equal keys are
+    # ordered by it in ascending order, e.g. by their index along the axis.
+    scalar_tys = [t.type.scalar for t in inputs]
+    region = op.get_region(0)
+    ip = builder.get_insertion_point()
+    block = builder.create_block_with_parent(region, [ty.to_ir(builder) for ty in scalar_tys * 2])
+    lhs = [block.arg(i) for i in range(len(inputs))]
+    rhs = [block.arg(len(inputs) + i) for i in range(len(inputs))]
+    before = _compare(lhs[0], rhs[0], scalar_tys[0], descending, builder)
+    if len(inputs) > 1:
+        tie = builder.create_and(_equal(lhs[0], rhs[0], scalar_tys[0], builder),
+                                 _compare(lhs[1], rhs[1], scalar_tys[1], False, builder))
+        before = builder.create_or(before, tie)
+    builder.create_sort_ret(before)
+    builder.restore_insertion_point(ip)
+
+
+def sort(inputs: Sequence[tl.tensor], axis: int, descending: bool, k: Optional[int],
+         builder: ir.builder) -> Tuple[tl.tensor, ...]:
+    """
+    Sorts `inputs` along `axis` by the keys in `inputs[0]`, permuting the other
+    inputs with them. With `k`, only the first `k` elements along `axis` are
+    returned.
+    """
+    shape = inputs[0].type.shape
+    rank = len(shape)
+    assert -rank <= axis < rank, f"sort axis {axis} must be < inputs rank ({rank})"
+    if axis < 0:
+        axis += rank
+    for t in inputs:
+        assert t.type.shape == shape, "all sort inputs must have the same shape"
+    n = shape[axis]
+    if n & (n - 1) != 0:
+        raise ValueError(f"the size of the sorted dimension must be a power of 2, got {n}")
+    handles = [t.handle for t in inputs]
+    if k is None:
+        op = builder.create_sort(handles, axis)
+        ret_shape = list(shape)
+    else:
+        if not 0 < k <= n:
+            raise ValueError(f"k must be in [1, {n}], got {k}")
+        op = builder.create_topk(handles, axis, k)
+        ret_shape = [k if i == axis else s for i, s in enumerate(shape)]
+    _make_sort_comparator(op, inputs, descending, builder)
+    op.verify()
+    return tuple(tl.tensor(op.get_result(i), tl.block_type(t.type.scalar, ret_shape)) for i, t in enumerate(inputs))
+
+
 # ===----------------------------------------------------------------------===
 #                               Histogram
 # ===----------------------------------------------------------------------===
@@ -3,6 +3,7 @@ from __future__ import annotations
 from ..runtime.jit import jit
 from . import core
 from . import math
+from . import semantic
 
 # constexpr utilities
 
@@ -316,75 +317,125 @@ def cumprod(input, axis=0, reverse=False):
     return core.associative_scan(input, axis, _prod_combine, reverse)
 
 
-# sort
+# device-wide cumsum
+
+# The status of a tile is stored in the upper 32 bits of its look-back entry,
+# next to the value in the lower 32 bits, so that both are published and read
+# with a single atomic.
+_SCAN_STATUS_AGGREGATE = core.constexpr(1)
+_SCAN_STATUS_PREFIX = core.constexpr(2)
 
 
 @jit
-def _compare_and_swap(x, flip, i: core.constexpr, n_dims: core.constexpr):
-    n_outer: core.constexpr = x.numel >> n_dims
-    shape: core.constexpr = [n_outer * 2**i, 2, 2**(n_dims - i - 1)]
-    y = core.reshape(x, shape)
-    # slice left/right with 'stride' 2**(n_dims - i - 1)
-    mask = core.arange(0, 2)[None, :, None]
-    left = core.broadcast_to(sum(y * (1 - mask), 1)[:, None, :], shape).to(y.dtype)
-    right = core.broadcast_to(sum(y * mask, 1)[:, None, :], shape).to(y.dtype)
-    left = core.reshape(left, x.shape)
-    right = core.reshape(right, x.shape)
-    # actual compare-and-swap
-    idtype = core.get_int_dtype(bitwidth=x.dtype.primitive_bitwidth, signed=True)
-    ileft = left.to(idtype, bitcast=True)
-    iright = right.to(idtype, bitcast=True)
-    ix = x.to(idtype, bitcast=True)
-    ret = ix ^ core.where((left > right) != flip, ileft ^ iright, zeros_like(ix))
-    return ret.to(x.dtype, bitcast=True)
+def _pack_scan_status(value, status: core.constexpr):
+    return value.to(core.uint32, bitcast=True).to(core.int64) | (status << 32)
 
 
 @jit
-def _bitonic_merge(x, stage: core.constexpr, order: core.constexpr, n_dims: core.constexpr):
-    '''
-    order_type 0 == ascending
-    order_type 1 == descending
-    order_type 2 == alternating
-    '''
-    n_outer: core.constexpr = x.numel >> n_dims
-    core.static_assert(stage <= n_dims)
-    # flip denotes whether to re-arrange sub-sequences of elements in ascending or
-    # descending order.
-    # if flip = 00000000... then all elements will be re-arranged ascendingly at this stage
-    # if flip = 00110011... then all the elements will be re-arranged alternatingly (with
-    # a stride of 2) at this stage
-    if order == 2:
-        shape: core.constexpr = [n_outer * 2**(n_dims - 1 - stage), 2, 2**stage]
-        flip = core.reshape(core.broadcast_to(core.arange(0, 2)[None, :, None], shape), x.shape)
-    else:
-        flip = order
-    # perform `stage` rounds of `compare-and-swap`
-    for i in core.static_range(stage):
-        x = _compare_and_swap(x, flip, i + (n_dims - stage), n_dims)
-    return x
+def _unpack_scan_status(entry, dtype: core.constexpr):
+    value = (entry & 0xFFFFFFFF).to(core.uint32).to(dtype, bitcast=True)
+    return value, entry >> 32
 
 
-@core._tensor_member_fn
 @jit
-def sort(x, dim: core.constexpr = None, descending: core.constexpr = core.CONSTEXPR_0):
+def device_cumsum(input, status_ptr, tile_id):
+    """
+    Computes the inclusive prefix sum of a 1D tile across all the tiles of a
+    grid in a single pass, with the decoupled look-back protocol.
+
+    Every tile publishes its aggregate, then walks back over its predecessors
+    accumulating their aggregates until it finds one that has published its
+    inclusive prefix, and finally publishes its own inclusive prefix.
+
+    :param input: the tile to scan, with a 32-bit dtype
+    :param status_ptr: pointer to a zero-initialized int64 buffer with one
+        entry per tile
+    :param tile_id: the position of the tile in the scan. Tiles wait on their
+        predecessors, so ids must be handed out in the order programs start,
+        e.g. with :code:`tl.atomic_add(counter_ptr, 1)`, rather than taken from
+        :code:`tl.program_id`.
+    """
+    core.static_assert(len(input.shape) == 1, "device_cumsum only supports 1D tiles")
+    core.static_assert(input.dtype.primitive_bitwidth == 32, "device_cumsum only supports 32-bit dtypes")
+    local = cumsum(input, 0)
+    aggregate = sum(input, 0)
+    first = tile_id == 0
+    # The first tile has no predecessor: its aggregate is its inclusive prefix.
+    entry = core.where(first, _pack_scan_status(aggregate, _SCAN_STATUS_PREFIX),
+                       _pack_scan_status(aggregate, _SCAN_STATUS_AGGREGATE))
+    core.atomic_xchg(status_ptr + tile_id, entry, sem="release")
+    exclusive = core.full([], 0, input.dtype)
+    predecessor = tile_id - 1
+    done = first
+    while not done:
+        entry = core.atomic_add(status_ptr + predecessor, 0, sem="acquire")
+        value, status = _unpack_scan_status(entry, input.dtype)
+        # Spin until the predecessor has published something.
+        ready = status != 0
+        exclusive = core.where(ready, exclusive + value, exclusive)
+        done = status == _SCAN_STATUS_PREFIX
+        predecessor = core.where(ready, predecessor - 1, predecessor)
+    core.atomic_xchg(status_ptr + tile_id, _pack_scan_status(exclusive + aggregate, _SCAN_STATUS_PREFIX),
+                     sem="release")
+    return local + exclusive
+
+
+# sort
+
+
+@core._tensor_member_fn
+@core.builtin
+def sort(x, dim: core.constexpr = None, descending: core.constexpr = core.CONSTEXPR_0, _builder=None):
     """
     Sorts a tensor along a specified dimension.
 
     :param x: The input tensor to be sorted.
     :type x: Tensor
-    :param dim: The dimension along which to sort the tensor. If None, the tensor is sorted along the last dimension. Currently, only sorting along the last dimension is supported.
+    :param dim: The dimension along which to sort the tensor. If None, the tensor is sorted along the last dimension.
     :type dim: int, optional
     :param descending: If set to True, the tensor is sorted in descending order. If set to False, the tensor is sorted in ascending order.
     :type descending: bool, optional
     """
-    # handle default dimension or check that it is the most minor dim
-    _dim: core.constexpr = len(x.shape) - 1 if dim is None else dim
-    core.static_assert(_dim == len(x.shape) - 1, "only minor dimension is currently supported")
-    # iteratively run bitonic merge-sort steps
-    n_dims: core.constexpr = _log2(x.shape[_dim])
-    for i in core.static_range(1, n_dims + 1):
-        x = _bitonic_merge(x, i, 2 if i < n_dims else descending, n_dims)
-    return x
+    dim = core._constexpr_to_value(dim)
+    dim = len(x.shape) - 1 if dim is None else dim
+    if dim < 0:
+        dim += len(x.shape)
+    descending = bool(core._constexpr_to_value(descending))
+    return semantic.sort((x, ), dim, descending, None, _builder)[0]
+
+
+@core._tensor_member_fn
+@core.builtin
+def topk(x, k: core.constexpr, dim: core.constexpr = None, largest: core.constexpr = True, _builder=None):
+    """
+    Returns the :code:`k` largest (or smallest) elements of a tensor along a
+    specified dimension, in order, together with their indices along that
+    dimension. Equal elements are ordered by their index.
+
+    :param x: The input tensor.
+    :type x: Tensor
+    :param k: The number of elements to return. Must be at most the size of :code:`dim`.
+    :type k: int
+    :param dim: The dimension along which to select the elements. If None, the last dimension is used.
+    :type dim: int, optional
+    :param largest: If set to True, the largest elements are returned, otherwise the smallest ones.
+    :type largest: bool, optional
+    :return: The values and their int32 indices, both with the size of :code:`dim` replaced by :code:`k`.
+    """
+    k = core._constexpr_to_value(k)
+    dim = core._constexpr_to_value(dim)
+    dim = len(x.shape) - 1 if dim is None else dim
+    if dim < 0:
+        dim += len(x.shape)
+    largest = bool(core._constexpr_to_value(largest))
+    index = core.arange(0, x.shape[dim], _builder=_builder)
+    if len(x.shape) > 1:
+        # Broadcast the index across the other dimensions
+        other_dims = [core.constexpr(d) for d in range(len(x.shape)) if d != dim]
+        index = core.expand_dims(index, other_dims, _builder=_builder)
+        index = core.broadcast_to(index, x.shape, _builder=_builder)
+    values, indices = semantic.sort((x, index), dim, largest, k, _builder)
+    return values, indices
 
 
 # flip
@@ -1,10 +1,16 @@
 import importlib
 import json
+import mmap
 import os
+import shutil
+import struct
+import time
 import uuid
 from abc import ABC, abstractmethod
+from contextlib import contextmanager
+from dataclasses import dataclass, field
 from pathlib import Path
-from typing import Dict, List, Optional
+from typing import Callable, Dict, List, Optional
 import base64
 import hashlib
 
@@ -17,6 +23,16 @@ def default_cache_dir():
     return os.path.join(get_home_dir(), ".triton", "cache")
 
 
+def default_cache_max_bytes():
+    # 0 means unbounded
+    return int(os.getenv("TRITON_CACHE_MAX_BYTES", "0"))
+
+
+def default_cache_pack():
+    return os.getenv("TRITON_CACHE_PACK", "").strip() or os.path.join(
+        os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir(), "cache.pack")
+
+
 def default_override_dir():
     return os.path.join(get_home_dir(), ".triton", "override")
 
@@ -52,6 +68,7 @@ class FileCacheManager(CacheManager):
     def __init__(self, key, override=False, dump=False):
         self.key = key
         self.lock_path = None
+        self.cache_root = None
         if dump:
             self.cache_dir = os.getenv("TRITON_DUMP_DIR", "").strip() or default_dump_dir()
             self.cache_dir = os.path.join(self.cache_dir, self.key)
@@ -64,6 +81,7 @@ class FileCacheManager(CacheManager):
             # create cache directory if it doesn't exist
             self.cache_dir = os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir()
             if self.cache_dir:
+                self.cache_root = self.cache_dir
                 self.cache_dir = os.path.join(self.cache_dir, self.key)
                 self.lock_path = os.path.join(self.cache_dir, "lock")
                 os.makedirs(self.cache_dir, exist_ok=True)
@@ -99,6 +117,13 @@ class FileCacheManager(CacheManager):
         for c, p in child_paths.items():
             if os.path.exists(p):
                 result[c] = p
+        # The group's mtime is the entry's last use for LRU eviction; atime is
+        # unreliable on relatime/noatime mounts.
+        if self.cache_root is not None:
+            try:
+                os.utime(grp_filepath)
+            except OSError:
+                pass
         return result
 
     # Note a group of pushed files as being part of a group
@@ -107,7 +132,11 @@ class FileCacheManager(CacheManager):
             raise RuntimeError("Could not create or locate cache dir")
         grp_contents = json.dumps({"child_paths": group})
         grp_filename = f"__grp__{filename}"
-        return self.put(grp_contents, grp_filename, binary=False)
+        grp_filepath = self.put(grp_contents, grp_filename, binary=False)
+        max_bytes = default_cache_max_bytes()
+        if self.cache_root is not None and max_bytes > 0:
+            _maybe_compact_cache(self.cache_root, max_bytes)
+        return grp_filepath
 
     def put(self, data, filename, binary=True) -> str:
         if not self.cache_dir:
@@ -136,6 +165,369 @@ class FileCacheManager(CacheManager):
         return filepath
 
 
+# ------------------------------------------------------------------------------
+# Cache maintenance
+# ------------------------------------------------------------------------------
+
+# Files and entries modified more recently than this many seconds are never
+# removed, so that a concurrent process can finish writing or reading them.
+CACHE_GRACE_PERIOD = 600
+# Minimum number of seconds between two size checks triggered by compilations.
+CACHE_COMPACTION_INTERVAL = 300
+
+_GRP_PREFIX = "__grp__"
+_TMP_PREFIX = "tmp."
+_TRASH_PREFIX = ".trash."
+_LOCK_FILENAME = ".lock"
+_LAST_COMPACTION_FILENAME = ".last_compaction"
+
+
+@contextmanager
+def _cache_lock(cache_dir, blocking=True):
+    # Serializes maintenance between processes. Compilations do not take this
+    # lock: they only ever add files with atomic renames.
+    import fcntl
+    with open(os.path.join(cache_dir, _LOCK_FILENAME), "a") as f:
+        try:
+            fcntl.flock(f, fcntl.LOCK_EX | (0 if blocking else fcntl.LOCK_NB))
+        except BlockingIOError:
+            yield False
+            return
+        try:
+            yield True
+        finally:
+            fcntl.flock(f, fcntl.LOCK_UN)
+
+
+@dataclass
+class _CacheEntry:
+    path: str
+    nbytes: int = 0
+    last_used: float = 0.0
+    # file name -> (size, mtime)
+    files: Dict[str, tuple] = field(default_factory=dict)
+    # group file name -> {child name: child path}
+    groups: Dict[str, Dict[str, str]] = field(default_factory=dict)
+    tmp_dirs: List[str] = field(default_factory=list)
+
+
+def _dir_nbytes(path):
+    nbytes = 0
+    for root, _, files in os.walk(path):
+        for name in files:
+            try:
+                nbytes += os.stat(os.path.join(root, name)).st_size
+            except OSError:
+                pass
+    return nbytes
+
+
+def _scan_entry(path) -> _CacheEntry:
+    entry = _CacheEntry(path)
+    for item in os.scandir(path):
+        try:
+            if item.is_dir():
+                if item.name.startswith(_TMP_PREFIX):
+                    entry.tmp_dirs.append(item.name)
+                continue
+            stat = item.stat()
+        except OSError:
+            continue
+        entry.files[item.name] = (stat.st_size, stat.st_mtime)
+        entry.nbytes += stat.st_size
+        if item.name.startswith(_GRP_PREFIX):
+            entry.last_used = max(entry.last_used, stat.st_mtime)
+            try:
+                with open(item.path) as f:
+                    child_paths = json.load(f).get("child_paths", {})
+            except (OSError, ValueError):
+                continue
+            # Groups materialized by the remote cache list child names only
+            if isinstance(child_paths, list):
+                child_paths = {name: os.path.join(path, name) for name in child_paths}
+            entry.groups[item.name] = child_paths
+    if not entry.groups:
+        entry.last_used = max((mtime for _, mtime in entry.files.values()), default=0.0)
+    return entry
+
+
+def _remove(path):
+    # Rename first so that the removal looks atomic to other processes.
+    trash = os.path.join(os.path.dirname(path), f"{_TRASH_PREFIX}{uuid.uuid4()}")
+    try:
+        os.rename(path, trash)
+    except OSError:
+        return
+    if os.path.isdir(trash):
+        shutil.rmtree(trash, ignore_errors=True)
+    else:
+        os.remove(trash)
+
+
+def _write_group(path, group):
+    temp_path = f"{path}.{_TMP_PREFIX}pid_{os.getpid()}_{uuid.uuid4()}"
+    with open(temp_path, "w") as f:
+        f.write(json.dumps({"child_paths": group}))
+    os.replace(temp_path, path)
+
+
+def compact_cache(cache_dir: Optional[str] = None, max_bytes: Optional[int] = None,
+                  keep: Optional[Callable[[str, Dict[str, str]], bool]] = None, blocking: bool = True) -> int:
+    """
+    Compacts the on-disk kernel cache and returns the number of bytes freed.
+
+    Leftovers of interrupted compilations and files that no group refers to are
+    removed. If `keep` is given, it is called with the name of every file of a
+    group and the whole group, and only the files it returns True for are
+    kept. If `max_bytes` is given, the least recently used entries are then
+    evicted until the cache fits in that many bytes.
+
+    Safe to run concurrently with compilations and with other compactions; if
+    `blocking` is False, returns immediately when another compaction is running.
+    """
+    cache_dir = cache_dir or os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir()
+    if not os.path.isdir(cache_dir):
+        return 0
+    now = time.time()
+    freed = 0
+    with _cache_lock(cache_dir, blocking) as locked:
+        if not locked:
+            return 0
+        entries = []
+        for item in os.scandir(cache_dir):
+            if item.name.startswith(_TRASH_PREFIX):
+                _remove(item.path)
+            elif item.is_dir():
+                entries.append(_scan_entry(item.path))
+        live_entries = []
+        for entry in entries:
+            for name in entry.tmp_dirs:
+                path = os.path.join(entry.path, name)
+                if now - os.path.getmtime(path) > CACHE_GRACE_PERIOD:
+                    freed += _dir_nbytes(path)
+                    _remove(path)
+            dropped = set()
+            if keep is not None:
+                for grp_name, group in entry.groups.items():
+                    kept = {name: path for name, path in group.items() if keep(name, group)}
+                    if kept != group:
+                        _write_group(os.path.join(entry.path, grp_name), kept)
+                        entry.groups[grp_name] = kept
+                        dropped.update(os.path.basename(path) for path in group.values())
+            referenced = set(entry.groups)
+            for group in entry.groups.values():
+                referenced.update(os.path.basename(path) for path in group.values())
+            for name, (size, mtime) in list(entry.files.items()):
+                # Files of an in-flight compilation are not referenced until its group is written
+                if name in referenced or (now - mtime <= CACHE_GRACE_PERIOD and name not in dropped):
+                    continue
+                _remove(os.path.join(entry.path, name))
+                del entry.files[name]
+                entry.nbytes -= size
+                freed += size
+            if not entry.files and now - entry.last_used > CACHE_GRACE_PERIOD:
+                try:
+                    os.rmdir(entry.path)
+                except OSError:
+                    pass
+                continue
+            live_entries.append(entry)
+        if max_bytes is not None:
+            total = sum(entry.nbytes for entry in live_entries)
+            for entry in sorted(live_entries, key=lambda entry: entry.last_used):
+                if total <= max_bytes or now - entry.last_used <= CACHE_GRACE_PERIOD:
+                    break
+                _remove(entry.path)
+                total -= entry.nbytes
+                freed += entry.nbytes
+    return freed
+
+
+def _maybe_compact_cache(cache_dir, max_bytes):
+    # Scanning a large cache is not free, so compilations only trigger it every
+    # CACHE_COMPACTION_INTERVAL seconds.
+    marker = os.path.join(cache_dir, _LAST_COMPACTION_FILENAME)
+    try:
+        if time.time() - os.path.getmtime(marker) < CACHE_COMPACTION_INTERVAL:
+            return
+    except OSError:
+        pass
+    Path(marker).touch()
+    try:
+        compact_cache(cache_dir, max_bytes=max_bytes, blocking=False)
+    except OSError:
+        # Maintenance must never fail a compilation.
+        pass
+
+
+# ------------------------------------------------------------------------------
+# Packed cache
+# ------------------------------------------------------------------------------
+
+# Layout of a cache pack:
+#   header: magic, version, number of index slots, index offset
+#   blobs:  the artifacts of every group, then one JSON record per group
+#           {"key": ..., "children": {name: [offset, size]}}
+#   index:  open-addressing hash table of (hash, record offset, record size)
+#           slots; a zero hash marks an empty slot
+_PACK_MAGIC = b"TRITONPK"
+_PACK_VERSION = 1
+_PACK_HEADER = struct.Struct("<8sIIQ")
+_PACK_SLOT = struct.Struct("<QQQ")
+
+
+def _pack_hash(key: str) -> int:
+    # Never zero, which marks empty slots
+    return int.from_bytes(hashlib.blake2b(key.encode("utf-8"), digest_size=8).digest(), "little") | 1
+
+
+class CachePack:
+    """
+    Read-only, memory-mapped view of a cache pack written by `pack_cache`.
+    Looking a group up is a hash probe into the mapping; artifacts are returned
+    as zero-copy memoryviews.
+    """
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, self._num_slots, self._index_offset = _PACK_HEADER.unpack_from(self._map, 0)
+        if magic != _PACK_MAGIC or version != _PACK_VERSION:
+            raise RuntimeError(f"{path} is not a Triton cache pack")
+        self._view = memoryview(self._map)
+
+    def get_group(self, key: str, filename: str) -> Optional[Dict[str, memoryview]]:
+        full_key = f"{key}/{filename}"
+        h = _pack_hash(full_key)
+        mask = self._num_slots - 1
+        slot = h & mask
+        while True:
+            slot_hash, offset, size = _PACK_SLOT.unpack_from(self._map, self._index_offset + slot * _PACK_SLOT.size)
+            if slot_hash == 0:
+                return None
+            if slot_hash == h:
+                record = json.loads(bytes(self._view[offset:offset + size]))
+                if record["key"] == full_key:
+                    return {name: self._view[start:start + n] for name, (start, n) in record["children"].items()}
+            slot = (slot + 1) & mask
+
+
+_cache_packs: Dict[str, Optional[CachePack]] = {}
+
+
+def _get_cache_pack(path) -> Optional[CachePack]:
+    # Packs are opened once per process; rewriting a pack replaces the file, so
+    # existing mappings stay valid.
+    if path not in _cache_packs:
+        _cache_packs[path] = CachePack(path) if os.path.exists(path) else None
+    return _cache_packs[path]
+
+
+def pack_cache(cache_dir: Optional[str] = None, pack_path: Optional[str] = None) -> int:
+    """
+    Packs every group of the on-disk cache, and of the existing pack if any, into
+    a single cache pack. The pack is replaced atomically. Returns the number of
+    groups in the pack.
+    """
+    cache_dir = cache_dir or os.getenv("TRITON_CACHE_DIR", "").strip() or default_cache_dir()
+    pack_path = pack_path or default_cache_pack()
+    groups = {}
+    if os.path.exists(pack_path):
+        pack = CachePack(pack_path)
+        for slot in range(pack._num_slots):
+            slot_hash, offset, size = _PACK_SLOT.unpack_from(pack._map, pack._index_offset + slot * _PACK_SLOT.size)
+            if slot_hash != 0:
+                record = json.loads(bytes(pack._view[offset:offset + size]))
+                groups[record["key"]] = {
+                    name: bytes(pack._view[start:start + n])
+                    for name, (start, n) in record["children"].items()
+                }
+    if os.path.isdir(cache_dir):
+        for entry in os.scandir(cache_dir):
+            if not entry.is_dir() or entry.name.startswith("."):
+                continue
+            for item in os.scandir(entry.path):
+                if not item.name.startswith(_GRP_PREFIX) or not item.is_file():
+                    continue
+                try:
+                    with open(item.path) as f:
+                        child_paths = json.load(f).get("child_paths", None)
+                    # Only groups whose children are all present are packed
+                    groups[f"{entry.name}/{item.name}"] = {
+                        name: Path(path).read_bytes()
+                        for name, path in child_paths.items()
+                    }
+                except (OSError, ValueError, AttributeError):
+                    continue
+
+    num_slots = 1
+    while num_slots < 2 * len(groups):
+        num_slots *= 2
+    temp_path = f"{pack_path}.{_TMP_PREFIX}pid_{os.getpid()}_{uuid.uuid4()}"
+    index = bytearray(num_slots * _PACK_SLOT.size)
+    with open(temp_path, "wb") as f:
+        f.write(b"\0" * _PACK_HEADER.size)
+        for key, children in groups.items():
+            record = {"key": key, "children": {}}
+            for name, data in children.items():
+                record["children"][name] = [f.tell(), len(data)]
+                f.write(data)
+            record = json.dumps(record).encode("utf-8")
+            offset = f.tell()
+            f.write(record)
+            h = _pack_hash(key)
+            slot = h & (num_slots - 1)
+            while _PACK_SLOT.unpack_from(index, slot * _PACK_SLOT.size)[0] != 0:
+                slot = (slot + 1) & (num_slots - 1)
+            _PACK_SLOT.pack_into(index, slot * _PACK_SLOT.size, h, offset, len(record))
+        index_offset = f.tell()
+        f.write(index)
+        f.seek(0)
+        f.write(_PACK_HEADER.pack(_PACK_MAGIC, _PACK_VERSION, num_slots, index_offset))
+    os.replace(temp_path, pack_path)
+    return len(groups)
+
+
+class PackedCacheManager(CacheManager):
+    """
+    Serves lookups from the cache pack (`TRITON_CACHE_PACK`, by default
+    cache.pack in the cache directory) and falls back to a `FileCacheManager`
+    for misses and new kernels. Select it with
+    TRITON_CACHE_MANAGER=triton.runtime.cache:PackedCacheManager.
+    """
+
+    def __init__(self, key, override=False, dump=False):
+        self.key = key
+        self._override = override
+        self._dump = dump
+        self._pack = None if override or dump else _get_cache_pack(default_cache_pack())
+        self.__file_cache_manager = None
+
+    @property
+    def _file_cache_manager(self):
+        # Created lazily as it creates the cache directory of the key, which
+        # packed kernels do not need.
+        if self.__file_cache_manager is None:
+            self.__file_cache_manager = FileCacheManager(self.key, override=self._override, dump=self._dump)
+        return self.__file_cache_manager
+
+    def get_file(self, filename) -> Optional[str]:
+        return self._file_cache_manager.get_file(filename)
+
+    def put(self, data, filename, binary=True) -> str:
+        return self._file_cache_manager.put(data, filename, binary=binary)
+
+    def get_group(self, filename: str) -> Optional[Dict[str, str]]:
+        if self._pack is not None:
+            group = self._pack.get_group(self.key, f"{_GRP_PREFIX}{filename}")
+            if group is not None:
+                return group
+        return self._file_cache_manager.get_group(filename)
+
+    def put_group(self, filename: str, group: Dict[str, str]):
+        return self._file_cache_manager.put_group(filename, group)
+
+
 class RemoteCacheBackend:
     """
     A backend implementation for accessing a remote/distributed cache.
@@ -0,0 +1,195 @@
+"""
+Local compilation service shared by the processes of a node.
+
+Processes that launch the same kernels (e.g. the ranks of a distributed job)
+otherwise compile them independently and race on the cache. With
+`TRITON_COMPILE_SERVER=<socket path>`, `compile()` sends the kernels it misses
+in the cache to a server listening on that Unix domain socket, started with
+
+    python -m triton.runtime.compile_server --socket <socket path>
+
+The client still generates the Triton IR of the kernel, which needs its Python
+source; the server runs the rest of the pipeline on a process pool, compiling
+each kernel only once however many clients ask for it, and publishes the result
+into the cache (`TRITON_CACHE_DIR` must be shared with the clients). The client
+then loads the kernel from the cache, and compiles it itself if anything fails.
+"""
+
+import json
+import os
+import socket
+import socketserver
+import struct
+import tempfile
+import threading
+from argparse import ArgumentParser
+from concurrent.futures import Future, ProcessPoolExecutor, ThreadPoolExecutor
+from typing import Dict
+
+# Compilations can be slow; this only guards against a stuck server.
+COMPILE_SERVER_TIMEOUT = 600
+
+_LENGTH = struct.Struct("!I")
+
+
+def _send(sock, message):
+    data = json.dumps(message).encode("utf-8")
+    sock.sendall(_LENGTH.pack(len(data)) + data)
+
+
+def _recv_exactly(sock, size):
+    data = bytearray()
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("compile server connection closed")
+        data += chunk
+    return bytes(data)
+
+
+def _recv(sock):
+    size, = _LENGTH.unpack(_recv_exactly(sock, _LENGTH.size))
+    return json.loads(_recv_exactly(sock, size))
+
+
+def _to_tuples(value):
+    # JSON turns the tuples of the options into lists.
+    if isinstance(value, list):
+        return tuple(_to_tuples(v) for v in value)
+    if isinstance(value, dict):
+        return {k: _to_tuples(v) for k, v in value.items()}
+    return value
+
+
+def make_request(key, src, ir_text, target, options):
+    return {
+        "key": key,
+        "name": src.name,
+        "src_hash": src.hash(),
+        "ir": ir_text,
+        "target": vars(target),
+        "options": options.__dict__,
+    }
+
+
+def request_compile(socket_path, request) -> bool:
+    """
+    Asks the server to compile a kernel into the cache. Returns whether it did.
+    """
+    try:
+        with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+            sock.settimeout(COMPILE_SERVER_TIMEOUT)
+            sock.connect(socket_path)
+            _send(sock, request)
+            return _recv(sock).get("ok", False)
+    except (OSError, ValueError, TypeError):
+        # TypeError: options that JSON cannot serialize; the kernel is then
+        # compiled locally.
+        return False
+
+
+def _compile(request):
+    from ..backends.compiler import GPUTarget
+    from ..compiler.compiler import ASTSource, compile
+    from .._C.libtriton import ir
+
+    class ServedSource(ASTSource):
+        # The Triton IR generated by the client, hashed like the client's source
+        # so that the kernel is cached under the key the client looks up.
+
+        def __init__(self, name, src_hash, ir_text):
+            self.ext = "ttir"
+            self.name = name
+            self.src_hash = src_hash
+            self.ir_text = ir_text
+
+        def hash(self):
+            return self.src_hash
+
+        def make_ir(self, options, codegen_fns, module_map, context):
+            with tempfile.NamedTemporaryFile("w", suffix=".ttir") as f:
+                f.write(self.ir_text)
+                f.flush()
+                module = ir.parse_mlir_module(f.name, context)
+            module.context = context
+            return module
+
+    src = ServedSource(request["name"], request["src_hash"], request["ir"])
+    target = GPUTarget(**request["target"])
+    kernel = compile(src, target=target, options=_to_tuples(request["options"]))
+    return kernel.hash
+
+
+class CompileServer(socketserver.ThreadingMixIn, socketserver.UnixStreamServer):
+    """
+    Compiles the kernels requested by clients on a pool of `max_workers`
+    processes (threads if `use_processes` is False). Concurrent requests for the
+    same kernel share one compilation.
+    """
+
+    daemon_threads = True
+
+    def __init__(self, socket_path, max_workers=None, use_processes=True):
+        if os.path.exists(socket_path):
+            os.remove(socket_path)
+        super().__init__(socket_path, _CompileRequestHandler)
+        if use_processes:
+            import multiprocessing
+            self.executor = ProcessPoolExecutor(max_workers, mp_context=multiprocessing.get_context("spawn"))
+        else:
+            self.executor = ThreadPoolExecutor(max_workers)
+        self.in_flight: Dict[str, Future] = {}
+        self.num_compiles = 0
+        self.lock = threading.Lock()
+
+    def compile(self, request) -> bool:
+        key = request["key"]
+        with self.lock:
+            future = self.in_flight.get(key)
+            submitted = future is None
+            if submitted:
+                future = self.executor.submit(_compile, request)
+                self.in_flight[key] = future
+                self.num_compiles += 1
+        if submitted:
+            # Outside the lock: the callback runs right away, and takes the lock,
+            # if the compilation already finished.
+            future.add_done_callback(lambda _: self._done(key))
+        try:
+            # The kernel is only usable by the client if its key matches, i.e. if the
+            # server runs the same version of triton with the same environment.
+            return future.result() == key
+        except Exception:
+            return False
+
+    def _done(self, key):
+        with self.lock:
+            self.in_flight.pop(key, None)
+
+    def server_close(self):
+        super().server_close()
+        self.executor.shutdown(wait=False)
+        if os.path.exists(self.server_address):
+            os.remove(self.server_address)
+
+
+class _CompileRequestHandler(socketserver.BaseRequestHandler):
+
+    def handle(self):
+        try:
+            request = _recv(self.request)
+        except (OSError, ValueError):
+            return
+        _send(self.request, {"ok": self.server.compile(request)})
+
+
+if __name__ == "__main__":
+    parser = ArgumentParser(description="Triton compile server")
+    parser.add_argument("--socket", type=str, default=os.getenv("TRITON_COMPILE_SERVER", ""), required=False,
+                        help="Path of the Unix domain socket to listen on")
+    parser.add_argument("--workers", type=int, default=None, help="Number of compiler processes")
+    args = parser.parse_args()
+    if not args.socket:
+        parser.error("--socket or TRITON_COMPILE_SERVER is required")
+    with CompileServer(args.socket, args.workers) as server:
+        server.serve_forever()
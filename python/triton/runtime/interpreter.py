@@ -1,4 +1,5 @@
 import ast
+import os
 import textwrap
 import inspect
 from typing import Tuple
@@ -10,6 +11,7 @@ import triton
 import triton.language as tl
 from dataclasses import dataclass
 from .errors import InterpreterError
+from .jit import TensorWrapper
 from functools import partial
 from .._C.libtriton import interpreter as _interpreter
 from .._C.libtriton import ir as _ir
@@ -44,6 +46,31 @@ class TensorHandle:
         self.attr[key] = value
 
 
+class GridBatchFallback(Exception):
+    '''
+        Raised when a kernel cannot run with all of its programs batched together,
+        e.g. because its control flow depends on the program id.
+    '''
+    pass
+
+
+def _uniform(data):
+    '''
+        Returns the value shared by all programs of a grid-batched scalar.
+    '''
+    if data.shape[0] > 1 and not np.all(data == data[:1]):
+        raise GridBatchFallback("control flow diverges across programs")
+    return data[0]
+
+
+def _broadcast_handles(*handles):
+    '''
+        Broadcasts the data of the given handles against each other, so that their
+        grid dimensions match in the grid-batched mode.
+    '''
+    return [np.ascontiguousarray(data) for data in np.broadcast_arrays(*[h.data for h in handles])]
+
+
 class BlockPointerHandle:
 
     def __init__(self, base, shape, strides, offsets, tensor_shape, order):
@@ -57,18 +84,26 @@ class BlockPointerHandle:
     def materialize_pointers(self, boundary_check):
         dtype_tt = self.base.get_element_ty()
         n_bytes = dtype_tt.primitive_bitwidth // 8
-        tensor_shape = self.tensor_shape
-        ptrs = np.broadcast_to(self.base.data, self.tensor_shape)
-        masks = np.ones(self.tensor_shape, dtype=bool)
-        for dim in range(len(tensor_shape)):
-            bcast_dims = [1] * len(tensor_shape)
+        tensor_shape = tuple(self.tensor_shape)
+        rank = len(tensor_shape)
+        # Scalars carry a leading grid dimension in the grid-batched mode
+        lead = self.base.data.shape[:-1]
+
+        def per_program(handle):
+            return handle.data.reshape(handle.data.shape[:-1] + (1, ) * rank)
+
+        ptrs = np.broadcast_to(per_program(self.base), lead + tensor_shape)
+        masks = np.ones((1, ) * len(lead) + tensor_shape, dtype=bool)
+        for dim in range(rank):
+            bcast_dims = [1] * rank
             bcast_dims[dim] = tensor_shape[dim]
-            off = (self.offsets[dim].data + np.arange(tensor_shape[dim])).reshape(bcast_dims)
-            ptrs = ptrs + (n_bytes * off * self.strides[dim].data).astype(np.uint64)
+            off = per_program(self.offsets[dim]) + np.arange(tensor_shape[dim]).reshape(bcast_dims)
+            ptrs = ptrs + (n_bytes * off * per_program(self.strides[dim])).astype(np.uint64)
             if dim in boundary_check:
-                masks = np.logical_and(masks, off < self.shape[dim].data)
-        ptrs = TensorHandle(ptrs, self.base.dtype.scalar)
-        return ptrs, masks
+                masks = np.logical_and(masks, off < per_program(self.shape[dim]))
+        ptrs, masks = np.broadcast_arrays(ptrs, masks)
+        ptrs = TensorHandle(np.ascontiguousarray(ptrs), self.base.dtype.scalar)
+        return ptrs, np.ascontiguousarray(masks)
 
 
 @dataclass(frozen=True)
@@ -129,68 +164,25 @@ def _get_np_dtype(tt_dtype):
     return np_types[tt_dtype]
 
 
+def _float_format(dtype):
+    # (bitwidth, exponent bits, mantissa bits, exponent bias, special value encoding)
+    bits = dtype.primitive_bitwidth
+    mant_bits = dtype.fp_mantissa_width
+    if dtype.name in ('fp8e4nv', 'fp8e4b15'):
+        kind = _interpreter.FLOAT_KIND.FN
+    elif dtype.name in ('fp8e4b8', 'fp8e5b16'):
+        kind = _interpreter.FLOAT_KIND.FNUZ
+    else:
+        kind = _interpreter.FLOAT_KIND.IEEE
+    return (bits, bits - mant_bits - 1, mant_bits, dtype.exponent_bias, kind)
+
+
 def _convert_float(input, input_dtype, output_dtype, rounding_mode):
+    # Rounds to nearest even unless RTZ is requested, like the GPU lowering.
     input_uint_dtype = getattr(np, f"uint{input_dtype.primitive_bitwidth}")
-    output_unint_dtype = getattr(np, f"uint{output_dtype.primitive_bitwidth}")
-    input_bin = np.frombuffer(input.tobytes(), dtype=input_uint_dtype)
-    sign = (input_bin >> (input_dtype.primitive_bitwidth - 1)) & 0x01
-    input_exponent_width = input_dtype.primitive_bitwidth - input_dtype.fp_mantissa_width - 1
-    output_exponent_width = output_dtype.primitive_bitwidth - output_dtype.fp_mantissa_width - 1
-    significand = input_bin & ((1 << input_dtype.fp_mantissa_width) - 1)
-    bias_input = input_dtype.exponent_bias
-    bias_output = output_dtype.exponent_bias
-    exponent = ((input_bin >> input_dtype.fp_mantissa_width) & ((1 << input_exponent_width) - 1)).astype(np.int32)
-    subnormal_index = exponent == 0
-    if np.any(subnormal_index):
-        # Credit to Phil: phil@openai.com
-        # subnormal repr: ((-1.0)**sign) * (2.0**(1 - exp_bias)) * (2^(m0) + 2^(m1) + ... + 2^(mn))
-        # where m0, m1, ..., mn are the 1-bit of the mantissa
-        # convert it to normal repr: ((-1.0)**sign) * (2.0**(1 + m0 - exp_bias)) * (1 + 2^(m1 - m0) + ... + 2^(mn - m0))
-        bit_pos = np.zeros_like(input_bin, dtype=np.int32)
-        # Find the most significant bit of the mantissa in the significand
-        for i in range(input_dtype.fp_mantissa_width):
-            bit_index = ((significand >> i) & 0x01)
-            # pos should be >= 1
-            bit_pos[bit_index == 1] = input_dtype.fp_mantissa_width - i
-        zero_significand_index = significand == 0
-        exponent[subnormal_index] = 1 - bit_pos[subnormal_index]
-        # 0 significand and subnormal should be treated as 0
-        exponent[zero_significand_index & subnormal_index] = bias_input - bias_output
-        significand[subnormal_index] = (significand[subnormal_index] << bit_pos[subnormal_index]) & (
-            (1 << input_dtype.fp_mantissa_width) - 1)
-    # Prevent overflow and underflow
-    exponent_output = np.maximum(0, np.minimum((exponent - bias_input + bias_output), (1 << output_exponent_width) - 1))
-    exponent_output = exponent_output.astype(output_unint_dtype)
-    sign_output = sign.astype(output_unint_dtype)
-    if input_dtype.primitive_bitwidth > output_dtype.primitive_bitwidth:  # Downcast
-        significand_output = (significand >> (input_dtype.fp_mantissa_width - output_dtype.fp_mantissa_width)) & (
-            (1 << output_dtype.fp_mantissa_width) - 1)
-        if rounding_mode == _ir.ROUNDING_MODE.RTNE:  # Round to nearst even
-            # find the cut-off bit
-            cut_off = significand & (1 << (input_dtype.fp_mantissa_width - output_dtype.fp_mantissa_width - 1))
-            significand_output = significand_output + (cut_off > 0)
-        significand_output = significand_output.astype(output_unint_dtype)
-    else:  # Upcast
-        significand_output = (significand.astype(output_unint_dtype) <<
-                              (output_dtype.fp_mantissa_width - input_dtype.fp_mantissa_width)) & (
-                                  (1 << output_dtype.fp_mantissa_width) - 1)
-    subnormal_index = exponent_output == 0
-    if np.any(subnormal_index):  # underflow
-        # normal repr: ((-1.0)**sign) * (2.0**(exp - exp_bias_input)) * (1 + 2^(m0) + 2^(m1) + ... + 2^(mn))
-        # where m0, m1, ..., mn are the 1-bit of the mantissa
-        # shift = (1 - exp_bias_output) - (exp - exp_bias_input)
-        # convert it to subnormal repr: ((-1.0)**sign) * (2.0**(1 - exp_bias_output)) * (2^(-shift) + 2^(m0 - shift) + 2^(m1 - shift) + ... + 2^(mn - shift))
-        exponent = ((input_bin >> input_dtype.fp_mantissa_width) & ((1 << input_exponent_width) - 1)).astype(np.int32)
-        non_zero_exponent_index = exponent != 0
-        # If the original exponent is not zero, we still need to shift the significand and consider the 1.0 part in mantissa
-        subnormal_index = subnormal_index & non_zero_exponent_index
-        shift = np.zeros_like(input_bin, dtype=np.int32)
-        shift[subnormal_index] = (1 - bias_output) - (exponent[subnormal_index] - bias_input)
-        significand_output[subnormal_index] = (significand_output[subnormal_index] >> shift[subnormal_index]) | (
-            1 << (output_dtype.fp_mantissa_width - shift[subnormal_index]))
-    output = (sign_output << (output_dtype.primitive_bitwidth - 1)) | (
-        exponent_output << output_dtype.fp_mantissa_width) | significand_output
-    return output.reshape(input.shape)
+    input_bin = np.require(input, requirements="C").view(input_uint_dtype)
+    rtz = rounding_mode == _ir.ROUNDING_MODE.RTZ
+    return _interpreter.convert_float(input_bin, _float_format(input_dtype), _float_format(output_dtype), rtz)
 
 
 def _erf(x):
@@ -242,7 +234,10 @@ class InterpreterBuilder:
         self.options = InterpreterOptions()
         self.codegen_fns = {}
         self.codegen_fns["convert_custom_types"] = ExtraFunctions._convert_custom_types
-        self.codegen_fns["min_dot_size"] = lambda lhsType, rhsType: (16, 16, 16)
+        # M < 16 is accepted for floating-point dots only, as on NVIDIA; int8 keeps the old minimum.
+        self.codegen_fns["min_dot_size"] = lambda lhsType, rhsType: (16, 16, 16) if lhsType.is_int8() else (1, 16, 16)
+        self.grid_idx = None
+        self.grid_batch = None
 
     def set_grid_idx(self, x, y, z):
         if not x < self.grid_dim[0]:
@@ -256,6 +251,28 @@ class InterpreterBuilder:
     def set_grid_dim(self, nx, ny, nz):
         self.grid_dim = (nx, ny, nz)
 
+    def set_grid_batch(self, program_ids):
+        '''
+            program_ids: None for the default mode, which runs one program at a time, or an
+            int array of shape (num_programs, 3) holding the (x, y, z) ids of the programs
+            that run together. In the grid-batched mode every tensor handle carries a leading
+            grid dimension of size 1 (the value is the same for all programs) or num_programs.
+        '''
+        self.grid_batch = program_ids
+        self.grid_idx = None
+
+    def _lead(self, data):
+        # Adds the grid dimension to a value shared by all programs
+        return data if self.grid_batch is None else data[np.newaxis]
+
+    def _axis(self, axis):
+        # Maps a per-program axis to an axis of the (possibly grid-batched) data
+        return axis + 1 if self.grid_batch is not None and axis >= 0 else axis
+
+    def _shape(self, data, shape):
+        # Maps a per-program shape to a shape of the (possibly grid-batched) data
+        return tuple(shape) if self.grid_batch is None else (data.shape[0], ) + tuple(shape)
+
     # constants
 
     def get_half_ty(self):
@@ -316,52 +333,54 @@ class InterpreterBuilder:
         return tl.block_type(dtype, shape)
 
     def get_int1(self, value):
-        return TensorHandle(np.array([value], dtype=np.bool_), tl.int1)
+        return TensorHandle(self._lead(np.array([value], dtype=np.bool_)), tl.int1)
 
     def get_uint8(self, value):
-        return TensorHandle(np.array([value], dtype=np.uint8), tl.uint8)
+        return TensorHandle(self._lead(np.array([value], dtype=np.uint8)), tl.uint8)
 
     def get_int8(self, value):
-        return TensorHandle(np.array([value], dtype=np.int8), tl.int8)
+        return TensorHandle(self._lead(np.array([value], dtype=np.int8)), tl.int8)
 
     def get_uint16(self, value):
-        return TensorHandle(np.array([value], dtype=np.uint16), tl.uint16)
+        return TensorHandle(self._lead(np.array([value], dtype=np.uint16)), tl.uint16)
 
     def get_int16(self, value):
-        return TensorHandle(np.array([value], dtype=np.int16), tl.int16)
+        return TensorHandle(self._lead(np.array([value], dtype=np.int16)), tl.int16)
 
     def get_uint32(self, value):
-        return TensorHandle(np.array([value], dtype=np.uint32), tl.uint32)
+        return TensorHandle(self._lead(np.array([value], dtype=np.uint32)), tl.uint32)
 
     def get_int32(self, value):
-        return TensorHandle(np.array([value], dtype=np.int32), tl.int32)
+        return TensorHandle(self._lead(np.array([value], dtype=np.int32)), tl.int32)
 
     def get_uint64(self, value):
-        return TensorHandle(np.array([value], dtype=np.uint64), tl.uint64)
+        return TensorHandle(self._lead(np.array([value], dtype=np.uint64)), tl.uint64)
 
     def get_int64(self, value):
-        return TensorHandle(np.array([value], dtype=np.int64), tl.int64)
+        return TensorHandle(self._lead(np.array([value], dtype=np.int64)), tl.int64)
 
     def get_fp16(self, value):
-        return TensorHandle(np.array([value], dtype=np.float16), tl.float16)
+        return TensorHandle(self._lead(np.array([value], dtype=np.float16)), tl.float16)
 
     def get_fp32(self, value):
-        return TensorHandle(np.array([value], dtype=np.float32), tl.float32)
+        return TensorHandle(self._lead(np.array([value], dtype=np.float32)), tl.float32)
 
     def get_fp64(self, value):
-        return TensorHandle(np.array([value], dtype=np.float64), tl.float64)
+        return TensorHandle(self._lead(np.array([value], dtype=np.float64)), tl.float64)
 
     def get_null_value(self, type):
-        return TensorHandle(np.array([0], dtype=_get_np_dtype(type)), type)
+        return TensorHandle(self._lead(np.array([0], dtype=_get_np_dtype(type))), type)
 
     # programming model
     def create_get_program_id(self, axis):
+        if self.grid_batch is not None:
+            return TensorHandle(self.grid_batch[:, axis:axis + 1].astype(np.int32), tl.int32)
         if self.grid_idx is None:
             raise ValueError("grid_idx is None")
         return TensorHandle(np.array([self.grid_idx[axis]], dtype=np.int32), tl.int32)
 
     def create_get_num_programs(self, axis):
-        return TensorHandle(np.array([self.grid_dim[axis]], dtype=np.int32), tl.int32)
+        return TensorHandle(self._lead(np.array([self.grid_dim[axis]], dtype=np.int32)), tl.int32)
 
     # memory ops
     def create_load(self, ptr, _0, _1, is_volatile):
@@ -378,11 +397,12 @@ class InterpreterBuilder:
         dtype_np = _get_np_dtype(dtype_tt)
         if other is None:
             other = TensorHandle(np.zeros_like(ptrs.data, dtype=dtype_np), dtype_tt)
-        ret = _interpreter.load(ptrs.data, mask.data, other.data, dtype_np)
+        ptrs_data, mask_data, other_data = _broadcast_handles(ptrs, mask, other)
+        ret = _interpreter.load(ptrs_data, mask_data, other_data, dtype_np)
         return TensorHandle(ret, dtype_tt)
 
     def create_masked_store(self, ptrs, value, mask, cache_modifier, eviction_policy):
-        return _interpreter.store(ptrs.data, value.data, mask.data)
+        return _interpreter.store(*_broadcast_handles(ptrs, value, mask))
 
     # casting ops
     def cast_impl(self, src, dst_type):
@@ -409,6 +429,30 @@ class InterpreterBuilder:
         data = _convert_float(src.data, src_element_type, dst_element_type, rounding_mode).view(_get_np_dtype(dst_type))
         return TensorHandle(data, dst_type.scalar)
 
+    def create_int4_to_fp(self, src, scale, dst_type, axis, is_signed):
+        packed = src.data.view(np.uint8)
+        lo = (packed & 0xF).astype(np.int8)
+        hi = (packed >> 4).astype(np.int8)
+        if is_signed:
+            lo = np.where(lo >= 8, lo - 16, lo)
+            hi = np.where(hi >= 8, hi - 16, hi)
+        # Interleave the two nibbles of each byte along the packed axis.
+        axis = self._axis(axis)
+        data = np.stack([lo, hi], axis=axis + 1)
+        shape = list(packed.shape)
+        shape[axis] *= 2
+        data = data.reshape(shape).astype(np.float32)
+        if scale is not None:
+            if scale.dtype.scalar == tl.bfloat16:
+                data = data * _convert_float(scale.data, tl.bfloat16, tl.float32, None).view(np.float32)
+            else:
+                data = data * scale.data.astype(np.float32)
+        if dst_type.scalar == tl.bfloat16:
+            data = _convert_float(data, tl.float32, tl.bfloat16, None).view(np.uint16)
+        else:
+            data = data.astype(np.float16)
+        return TensorHandle(data, dst_type.scalar)
+
     def create_bitcast(self, src, dst_type):
         return TensorHandle(src.data.view(_get_np_dtype(dst_type)), dst_type.scalar)
 
@@ -537,9 +581,12 @@ class InterpreterBuilder:
         return TensorHandle(1 / np.sqrt(arg.data), arg.dtype.scalar)
 
     # tensor operators
-    create_reshape = lambda self, arg, shape, allow_reorder: TensorHandle(arg.data.reshape(shape), arg.dtype.scalar)
+    def create_reshape(self, arg, shape, allow_reorder):
+        return TensorHandle(arg.data.reshape(self._shape(arg.data, shape)), arg.dtype.scalar)
 
     def create_trans(self, arg, perm):
+        if self.grid_batch is not None:
+            perm = [0] + [self._axis(p) for p in perm]
         return TensorHandle(np.transpose(arg.data, perm), arg.dtype.scalar)
 
     def create_dot(self, a, b, d, input_precision, max_num_imprecise_acc):
@@ -552,11 +599,22 @@ class InterpreterBuilder:
         return TensorHandle(np.matmul(a_data, b_data, dtype=d.data.dtype) + d.data, d.dtype.scalar)
 
     def create_make_range(self, start, stop):
-        return TensorHandle(np.arange(start, stop, dtype=np.int32), tl.int32)
+        return TensorHandle(self._lead(np.arange(start, stop, dtype=np.int32)), tl.int32)
 
     def create_histogram(self, data, bins):
+        if self.grid_batch is not None:
+            hists = [np.histogram(row, bins=bins, range=(0, bins))[0] for row in data.data]
+            return TensorHandle(np.stack(hists).astype(np.int32), tl.int32)
         return TensorHandle(np.histogram(data.data, bins=bins, range=(0, bins))[0], tl.int32)
 
+    def create_gather(self, src, indices, axis):
+        src_data, indices_data = src.data, indices.data
+        if self.grid_batch is not None:
+            num_programs = max(src_data.shape[0], indices_data.shape[0])
+            src_data = np.broadcast_to(src_data, (num_programs, ) + src_data.shape[1:])
+            indices_data = np.broadcast_to(indices_data, (num_programs, ) + indices_data.shape[1:])
+        return TensorHandle(np.take_along_axis(src_data, indices_data, axis=self._axis(axis)), src.dtype.scalar)
+
     # pointer arithmetic
 
     def create_addptr(self, ptr, offset):
@@ -586,23 +644,27 @@ class InterpreterBuilder:
         return self.create_masked_store(ptrs, value, masks, cache_modifier, eviction_policy)
 
     def create_expand_dims(self, arg, axis):
-        return TensorHandle(np.expand_dims(arg.data, axis), arg.dtype.scalar)
+        return TensorHandle(np.expand_dims(arg.data, self._axis(axis)), arg.dtype.scalar)
 
     def create_broadcast(self, arg, shape):
-        return TensorHandle(np.broadcast_to(arg.data, shape), arg.dtype.scalar)
+        return TensorHandle(np.broadcast_to(arg.data, self._shape(arg.data, shape)), arg.dtype.scalar)
 
     def create_cat(self, lhs, rhs):
-        return TensorHandle(np.concatenate([lhs.data, rhs.data]), lhs.dtype.scalar)
+        lhs_data, rhs_data = _broadcast_handles(lhs, rhs) if self.grid_batch is not None else (lhs.data, rhs.data)
+        return TensorHandle(np.concatenate([lhs_data, rhs_data], axis=self._axis(0)), lhs.dtype.scalar)
 
     def create_join(self, lhs, rhs):
         # Triton only supports joining two original tensors into a new one along the last axis
-        return TensorHandle(np.stack([lhs.data, rhs.data], axis=-1), lhs.dtype.scalar)
+        return TensorHandle(np.stack(np.broadcast_arrays(lhs.data, rhs.data), axis=-1), lhs.dtype.scalar)
 
     def create_split(self, val):
         # Triton only supports splitting the original tensor into two along the last axis
         return (TensorHandle(val.data[..., 0], val.dtype.scalar), TensorHandle(val.data[..., 1], val.dtype.scalar))
 
     def create_splat(self, arg, shape):
+        if self.grid_batch is not None:
+            data = arg.data.reshape(arg.data.shape[0], -1)[:, :1].reshape((-1, ) + (1, ) * len(shape))
+            return TensorHandle(np.broadcast_to(data, self._shape(data, shape)).copy(), arg.dtype.scalar)
         if isinstance(arg.dtype, tl.block_type):
             return TensorHandle(np.full(shape, arg.data[0], dtype=_get_np_dtype(arg.dtype)), arg.dtype.scalar)
         else:  # scalar
@@ -612,7 +674,7 @@ class InterpreterBuilder:
         if sem not in self.ir_sem_to_interpreter_sem:
             raise ValueError(f"unsupported semantic {sem}")
         sem = self.ir_sem_to_interpreter_sem[sem]
-        return TensorHandle(_interpreter.atomic_cas(ptr.data, cmp.data, val.data, sem), cmp.dtype.scalar)
+        return TensorHandle(_interpreter.atomic_cas(*_broadcast_handles(ptr, cmp, val), sem), cmp.dtype.scalar)
 
     def create_atomic_rmw(self, rmwOp, ptr, val, mask, sem, scope):
         if rmwOp not in self.ir_rmw_op_to_interpreter_rmw_op:
@@ -621,7 +683,8 @@ class InterpreterBuilder:
             raise ValueError(f"unsupported semantic {sem}")
         rmwOp = self.ir_rmw_op_to_interpreter_rmw_op[rmwOp]
         sem = self.ir_sem_to_interpreter_sem[sem]
-        return TensorHandle(_interpreter.atomic_rmw(rmwOp, ptr.data, val.data, mask.data, sem), val.dtype.scalar)
+        ptr_data, val_data, mask_data = _broadcast_handles(ptr, val, mask)
+        return TensorHandle(_interpreter.atomic_rmw(rmwOp, ptr_data, val_data, mask_data, sem), val.dtype.scalar)
 
     def create_extern_elementwise(self, libName, libPath, symbol, argList, retType, isPure):
         raise NotImplementedError("extern_elementwise not supported in interpreter mode")
@@ -634,6 +697,9 @@ class InterpreterBuilder:
         # by `values` themselves in python interpreter, thus not really needed here;
         # it is only used for triton PrintOpToLLVM to correctly construct the format specifier.
         # Interpreter's device_print function has a different format than Triton's device_print
+        if self.grid_batch is not None:
+            # Messages are printed one program at a time
+            raise GridBatchFallback("device_print")
         msg = f"({self.grid_idx[0]}, {self.grid_idx[1]}, {self.grid_idx[2]})"
         if prefix:
             msg += f" {prefix}"
@@ -667,13 +733,13 @@ class InterpreterBuilder:
         new_offsets = [offset.clone() for offset in ptr.offsets]
         ret = BlockPointerHandle(ptr.base, ptr.shape, ptr.strides, new_offsets, ptr.tensor_shape, ptr.order)
         for i in range(len(offsets)):
-            ret.offsets[i].data += offsets[i].data
+            ret.offsets[i].data = (ret.offsets[i].data + offsets[i].data).astype(ret.offsets[i].data.dtype)
         return ret
 
     def get_all_ones_value(self, type):
         np_type = _get_np_dtype(type)
         if "int" in np_type.name:
-            return TensorHandle(np.full(1, -1, dtype=np_type), type.scalar)
+            return TensorHandle(self._lead(np.full(1, -1, dtype=np_type)), type.scalar)
         else:
             raise TypeError(f"unsupported type {type}")
 
@@ -694,16 +760,27 @@ def _patch_builtin(pkg, builder):
 
 def _patch_lang_tensor(tensor):
 
-    def _get_bool(self):
+    def _get_scalar_data(self):
         data = self.handle.data
+        if interpreter_builder.grid_batch is not None and not self.type.is_block():
+            # Python control flow must take the same path in every program
+            data = _uniform(data)
+        return data
+
+    def _get_bool(self):
+        data = _get_scalar_data(self)
         # in triton, only scalars can be converted to booleans
         # here we need this hack because all scalars are tensors
         return bool(data) if data.size == 1 else True
 
     def _get_transpose(self):
-        return tl.core.tensor(TensorHandle(np.transpose(self.handle.data), self.handle.dtype), self.dtype.scalar)
+        data = self.handle.data
+        axes = list(reversed(range(data.ndim)))
+        if interpreter_builder.grid_batch is not None:
+            axes = [0] + axes[:-1]
+        return tl.core.tensor(TensorHandle(np.transpose(data, axes), self.handle.dtype), self.dtype.scalar)
 
-    tensor.__index__ = lambda self: int(self.handle.data)
+    tensor.__index__ = lambda self: int(_get_scalar_data(self))
     tensor.__bool__ = lambda self: _get_bool(self)
     tensor.__repr__ = lambda self: repr(self.handle.data)
     tensor.__str__ = lambda self: str(self.handle.data)
@@ -726,7 +803,21 @@ class ReduceScanOpIneterface:
                 raise ValueError(f"input must be a tensor, got {type(arg)}")
             self.check_axis(arg.shape, self.axis)
 
+    def np_axis(self, data):
+        # Numpy axis to reduce/scan on, skipping the leading grid dimension in the grid-batched mode
+        if interpreter_builder.grid_batch is None:
+            return self.axis
+        if self.axis is None:
+            return tuple(range(1, data.ndim))
+        return self.axis + 1
+
     def to_tensor(self, ret, dtype):
+        if interpreter_builder.grid_batch is not None:
+            ret = np.asarray(ret)
+            if ret.ndim > 1:
+                return tl.core.tensor(TensorHandle(ret, dtype.scalar), tl.block_type(dtype, list(ret.shape[1:])))
+            ret = ret.reshape(-1, 1).astype(_get_np_dtype(dtype))
+            return tl.core.tensor(TensorHandle(ret, dtype.scalar), dtype)
         if hasattr(ret, "shape") and ret.shape:
             ret_type = tl.block_type(dtype, ret.shape)
         else:
@@ -761,6 +852,8 @@ class ReduceOps(ReduceScanOpIneterface):
         return tuple(ret), axis
 
     def generic_reduce(self, input):
+        if interpreter_builder.grid_batch is not None:
+            raise GridBatchFallback("generic reduce")
         original_axis = self.axis
         input, axis = self.unravel(input, self.axis)
         input_data = []
@@ -808,10 +901,21 @@ class ReduceOps(ReduceScanOpIneterface):
         input = input[0] if isinstance(input, tuple) else input
         val = None
         idx = None
+        data = input.handle.data
         if val_reduce_op:
-            val = self.to_tensor(val_reduce_op(input.handle.data, axis=self.axis, keepdims=self.keep_dims), input.dtype)
+            val = self.to_tensor(val_reduce_op(data, axis=self.np_axis(data), keepdims=self.keep_dims), input.dtype)
         if idx_reduce_op:
-            idx = self.to_tensor(idx_reduce_op(input.handle.data, axis=self.axis, keepdims=self.keep_dims), tl.int32)
+            idx_data = data
+            idx_axis = self.axis
+            if interpreter_builder.grid_batch is not None:
+                if self.axis is None:
+                    # arg{min,max} over the flattened values of each program
+                    idx_data = data.reshape(data.shape[0], -1)
+                idx_axis = 1 if self.axis is None else self.axis + 1
+            ret = idx_reduce_op(idx_data, axis=idx_axis, keepdims=self.keep_dims)
+            if self.keep_dims and idx_data is not data:
+                ret = ret.reshape((data.shape[0], ) + (1, ) * (data.ndim - 1))
+            idx = self.to_tensor(ret, tl.int32)
         if val is not None and idx is not None:
             return val, idx
         elif val is not None:
@@ -822,7 +926,8 @@ class ReduceOps(ReduceScanOpIneterface):
             raise ValueError("val_reduce_op and idx_reduce_op are both None")
 
     def sum(self, input):
-        return self.to_tensor(np.sum(input.handle.data, axis=self.axis, keepdims=self.keep_dims), input.dtype)
+        data = input.handle.data
+        return self.to_tensor(np.sum(data, axis=self.np_axis(data), keepdims=self.keep_dims), input.dtype)
 
     def apply_impl(self, input):
         if self.combine_fn == tl.standard._argmin_combine_tie_break_left:
@@ -847,12 +952,16 @@ class ScanOps(ReduceScanOpIneterface):
         self.reverse = reverse
 
     def cumsum(self, input):
-        return [self.to_tensor(np.cumsum(input.handle.data, axis=self.axis), dtype=input.dtype)]
+        data = input.handle.data
+        return [self.to_tensor(np.cumsum(data, axis=self.np_axis(data)), dtype=input.dtype)]
 
     def cumprod(self, input):
-        return [self.to_tensor(np.cumprod(input.handle.data, axis=self.axis), dtype=input.dtype)]
+        data = input.handle.data
+        return [self.to_tensor(np.cumprod(data, axis=self.np_axis(data)), dtype=input.dtype)]
 
     def generic_scan(self, input):
+        if interpreter_builder.grid_batch is not None:
+            raise GridBatchFallback("generic scan")
         input_data = []
         output_data = []
         shape = input[0].handle.data.shape
@@ -886,7 +995,8 @@ class ScanOps(ReduceScanOpIneterface):
         new_input = []
         if self.reverse:
             for arg in input:
-                new_input.append(self.to_tensor(np.flip(arg.handle.data, axis=self.axis), arg.dtype))
+                data = arg.handle.data
+                new_input.append(self.to_tensor(np.flip(data, axis=self.np_axis(data)), arg.dtype))
         else:
             new_input = input
         if self.combine_fn == tl.standard._sum_combine:
@@ -898,10 +1008,34 @@ class ScanOps(ReduceScanOpIneterface):
             ret = self.generic_scan(new_input)
         if self.reverse:
             for arg in ret:
-                arg.handle.data = np.flip(arg.handle.data, axis=self.axis)
+                arg.handle.data = np.flip(arg.handle.data, axis=self.np_axis(arg.handle.data))
         return len(ret) == 1 and ret[0] or tuple(ret)
 
 
+class SortOps(ReduceScanOpIneterface):
+
+    def __init__(self, axis, descending, k):
+        super().__init__(axis, None)
+        self.descending = descending
+        self.k = k
+
+    def apply_impl(self, input):
+        data = input[0].handle.data
+        axis = self.np_axis(data)
+        if self.descending:
+            # Stable descending order: equal elements keep their index order
+            n = data.shape[axis]
+            order = n - 1 - np.flip(np.argsort(np.flip(data, axis), axis=axis, kind="stable"), axis)
+        else:
+            order = np.argsort(data, axis=axis, kind="stable")
+        if self.k is not None:
+            order = np.take(order, np.arange(self.k), axis=axis)
+        ret = []
+        for arg in input:
+            ret.append(self.to_tensor(np.take_along_axis(arg.handle.data, order, axis), arg.dtype))
+        return ret
+
+
 def _patch_reduce_scan():
     # Because interpreter doesn't support region_builder_fn, we cannot patch the builder
     # to use the new reduce and scan functions.
@@ -918,6 +1052,37 @@ def _patch_reduce_scan():
     tl.core.associative_scan = _new_scan
 
 
+def _patch_sort():
+    # tl.sort and tl.topk build a comparator region, so they are patched like reduce and scan
+    def _sort_dim(x, dim):
+        dim = tl.core._constexpr_to_value(dim)
+        dim = len(x.shape) - 1 if dim is None else dim
+        return dim + len(x.shape) if dim < 0 else dim
+
+    def _new_sort(x, dim=None, descending=tl.core.CONSTEXPR_0, **kwargs):
+        descending = bool(tl.core._constexpr_to_value(descending))
+        return SortOps(_sort_dim(x, dim), descending, None).apply(x)[0]
+
+    def _new_topk(x, k, dim=None, largest=True, **kwargs):
+        k = tl.core._constexpr_to_value(k)
+        largest = bool(tl.core._constexpr_to_value(largest))
+        dim = _sort_dim(x, dim)
+        shape = [1] * len(x.shape)
+        shape[dim] = x.shape[dim]
+        index = np.arange(x.shape[dim], dtype=np.int32).reshape(shape)
+        index = np.broadcast_to(index, x.handle.data.shape).copy()
+        index = tl.core.tensor(TensorHandle(index, tl.int32), tl.block_type(tl.int32, list(x.shape)))
+        values, indices = SortOps(dim, largest, k).apply((x, index))
+        return values, indices
+
+    tl.sort = _new_sort
+    tl.topk = _new_topk
+    tl.standard.sort = _new_sort
+    tl.standard.topk = _new_topk
+    tl.core.tensor.sort = _new_sort
+    tl.core.tensor.topk = _new_topk
+
+
 def _patch_lang_core(lang):
 
     def _new_to_ir(self, builder):
@@ -994,6 +1159,7 @@ def _patch_lang_core(lang):
     lang.max_constancy = partial(_set_attr, name="tt.constancy")
 
     _patch_reduce_scan()
+    _patch_sort()
 
 
 def _patch_lang(fn):
@@ -1023,19 +1189,39 @@ def _implicit_cvt(arg):
             dtype = np.uint64
         else:
             raise ValueError(f"Unsupported integer value {arg}")
-        handle = TensorHandle(np.array([arg], dtype=dtype), ty)
+        handle = TensorHandle(interpreter_builder._lead(np.array([arg], dtype=dtype)), ty)
         return tl.tensor(handle, ty)
     if hasattr(arg, "data_ptr"):
         ty = tl.str_to_ty(triton.runtime.jit.JITFunction._type_of(triton.runtime.jit.JITFunction._key_of(arg)))
-        handle = TensorHandle(np.array([arg.data_ptr()], dtype=np.uint64), ty)
+        handle = TensorHandle(interpreter_builder._lead(np.array([arg.data_ptr()], dtype=np.uint64)), ty)
         return tl.tensor(handle, ty)
     return arg
 
 
+def _unwrap_tensor(arg):
+    # Arguments reinterpreted with triton.reinterpret wrap the torch tensor holding the data.
+    # Torch views are kept as they are: their data_ptr is where the kernel's pointer starts.
+    return arg.base if isinstance(arg, TensorWrapper) else arg
+
+
+def _tensor_nbytes(arg):
+    # Bytes from the first element to the end of the storage, which covers views of a larger tensor
+    arg = _unwrap_tensor(arg)
+    return arg.untyped_storage().nbytes() - arg.storage_offset() * arg.element_size()
+
+
 interpreter_builder = InterpreterBuilder()
 
 # These keywords are not supported by the interpreter
-RESERVED_KWS = ["num_warps", "num_stages", "num_ctas", "enable_fp_fusion", "grid", "maxnreg"]
+RESERVED_KWS = [
+    "num_warps", "num_stages", "num_ctas", "enable_fp_fusion", "grid", "maxnreg", "multiversion", "warp_specialize",
+    "schedule_register_pressure"
+]
+
+# Number of programs run together in the grid-batched mode
+GRID_BATCH_SIZE = 256
+# Dirty ranges of an argument closer than this many bytes are written back with a single copy
+WRITE_BACK_MERGE_GAP = 1 << 16
 
 
 class GridExecutor:
@@ -1050,31 +1236,69 @@ class GridExecutor:
         self.constexprs = [name for name in arg_names if __annotations__.get(name) == "constexpr"]
 
     def _init_args_hst(self, args_dev, kwargs):
-        args_hst = []
-        for arg in args_dev:
-            if hasattr(arg, "data_ptr"):
-                args_hst.append(arg.cpu())
-            else:
-                args_hst.append(arg)
+        # CPU tensors are used in place; others are copied to the host
+        def to_hst(arg):
+            if not hasattr(arg, "data_ptr") or arg.device.type == "cpu":
+                return arg
+            return arg.cpu()
+
+        args_hst = [to_hst(arg) for arg in args_dev]
         # Process keyword arguments
-        kwargs_hst = {}
-        for key, value in kwargs.items():
-            if hasattr(value, "data_ptr"):
-                kwargs_hst[key] = value.cpu()
-            else:
-                kwargs_hst[key] = value
+        kwargs_hst = {key: to_hst(value) for key, value in kwargs.items()}
         return args_hst, kwargs_hst
 
-    def _restore_args_dev(self, args_dev, args_hst, kwargs, kwargs_hst):
-        for arg_dev, arg_hst in zip(args_dev, args_hst):
-            if hasattr(arg_dev, "data_ptr"):
+    def _copied_args(self, args_dev, args_hst, kwargs, kwargs_hst):
+        pairs = [*zip(args_dev, args_hst), *((kwargs[key], kwargs_hst[key]) for key in kwargs)]
+        return [(arg_dev, arg_hst) for arg_dev, arg_hst in pairs if hasattr(arg_dev, "data_ptr") and arg_hst is not arg_dev]
+
+    def _track_writes(self, copied_args):
+        _interpreter.track_writes([(arg_hst.data_ptr(), _tensor_nbytes(arg_hst)) for _, arg_hst in copied_args])
+
+    def _restore_args_dev(self, copied_args):
+        # Only the byte ranges written by the kernel are copied back
+        dirty_ranges = _interpreter.collect_writes(WRITE_BACK_MERGE_GAP)
+        for (arg_dev, arg_hst), ranges in zip(copied_args, dirty_ranges):
+            if not ranges:
+                continue
+            base_dev = _unwrap_tensor(arg_dev)
+            base_hst = _unwrap_tensor(arg_hst)
+            if not base_dev.is_contiguous() or not base_hst.is_contiguous():
                 arg_dev.data.copy_(arg_hst.to(arg_dev.device).data)
+                continue
+            flat_dev = base_dev.reshape(-1)
+            flat_hst = base_hst.reshape(-1)
+            itemsize = base_hst.element_size()
+            for offset, size in ranges:
+                start, end = offset // itemsize, -(-(offset + size) // itemsize)
+                flat_dev[start:end].copy_(flat_hst[start:end])
+
+    def _get_args(self, args_hst, kwargs_hst):
+        # implicitly convert tensor arguments to their base pointers
+        args = inspect.getcallargs(self.fn, *args_hst, **kwargs_hst)
+        return {name: arg if name in self.constexprs else _implicit_cvt(arg) for name, arg in args.items()}
+
+    def _run_sequential(self, args, grid):
+        for x in range(grid[0]):
+            for y in range(grid[1]):
+                for z in range(grid[2]):
+                    interpreter_builder.set_grid_idx(x, y, z)
+                    self.fn(**args)
+
+    def _run_batched(self, args_hst, kwargs_hst, grid):
+        # Program ids in the order the sequential mode runs them, so that conflicting
+        # stores and atomics are applied in the same order.
+        program_ids = np.stack(np.meshgrid(*[np.arange(n) for n in grid], indexing="ij"), axis=-1).reshape(-1, 3)
+        try:
+            for start in range(0, len(program_ids), GRID_BATCH_SIZE):
+                interpreter_builder.set_grid_batch(program_ids[start:start + GRID_BATCH_SIZE])
+                self.fn(**self._get_args(args_hst, kwargs_hst))
+        finally:
+            interpreter_builder.set_grid_batch(None)
 
-        # Restore keyword arguments
-        for key, kwarg_dev in kwargs.items():
-            kwarg_hst = kwargs_hst[key]
-            if hasattr(kwarg_dev, "data_ptr"):
-                kwarg_dev.data.copy_(kwarg_hst.to(kwarg_dev.device).data)
+    def _use_grid_batch(self, grid):
+        if os.environ.get("TRITON_INTERPRET_GRID_BATCH", "1") != "1":
+            return False
+        return grid[0] * grid[1] * grid[2] > 1
 
     def __call__(self, *args_dev, **kwargs):
         # removes reserved keywords from kwargs
@@ -1083,27 +1307,39 @@ class GridExecutor:
             return
         # copy arguments to the host
         args_hst, kwargs_hst = self._init_args_hst(args_dev, kwargs)
+        copied_args = self._copied_args(args_dev, args_hst, kwargs, kwargs_hst)
         # remaps core language functions to interpreted ones
         _patch_lang(self.fn)
         # we need to copy arguments to the host for the interpreter
-        # implicitly convert tensor arguments to their base pointers
-        args = inspect.getcallargs(self.fn, *args_hst, **kwargs_hst)
-        args = {name: arg if name in self.constexprs else _implicit_cvt(arg) for name, arg in args.items()}
+        args = self._get_args(args_hst, kwargs_hst)
         # iterate through grid
         grid = self.grid(args) if callable(self.grid) else self.grid
         assert len(grid) <= 3, "grid must have at most 3 dimensions"
         grid = grid + (1, ) * (3 - len(grid))
         interpreter_builder.set_grid_dim(*grid)
+        self._track_writes(copied_args)
         try:
-            for x in range(grid[0]):
-                for y in range(grid[1]):
-                    for z in range(grid[2]):
-                        interpreter_builder.set_grid_idx(x, y, z)
-                        self.fn(**args)
+            if self._use_grid_batch(grid):
+                # Run all programs at once, with program ids as a tensor dimension. Kernels whose
+                # control flow depends on the program id (or that fail for any other reason) are
+                # rerun one program at a time, after undoing the writes of the batched run. Only
+                # the bytes that are overwritten get saved, not whole arguments.
+                _interpreter.set_undo_log(True)
+                try:
+                    self._run_batched(args_hst, kwargs_hst, grid)
+                except Exception:
+                    _interpreter.undo_writes()
+                    _interpreter.set_undo_log(False)
+                    self._run_sequential(args, grid)
+                finally:
+                    _interpreter.set_undo_log(False)
+            else:
+                self._run_sequential(args, grid)
         except Exception as e:
+            _interpreter.track_writes([])
             raise InterpreterError(repr(e)) from e
         # copy arguments back to propagate side-effects
-        self._restore_args_dev(args_dev, args_hst, kwargs, kwargs_hst)
+        self._restore_args_dev(copied_args)
 
 
 class ASTTransformer(ast.NodeTransformer):
@@ -1231,5 +1467,7 @@ class InterpretedFunction:
         fn = self.rewrite()
         try:
             return fn(*args, **kwargs)
+        except GridBatchFallback:
+            raise
         except Exception as e:
             raise InterpreterError(repr(e)) from e
@@ -554,6 +554,7 @@ class JITFunction(KernelInterface[T]):
         self.ASTSource = ASTSource
         self.make_backend = make_backend
         self.binder = create_function_from_signature(self.signature, self.params, backend)
+        self.multiversion_binder = create_function_from_signature(self.signature, self.multiversion_params, backend)
         self.constexpr_indices = [i for (i, p) in enumerate(self.params) if p.is_constexpr]
         self.non_constexpr_indices = [i for (i, p) in enumerate(self.params) if not p.is_constexpr]
         self.specialised_indices = [
@@ -577,7 +578,9 @@ class JITFunction(KernelInterface[T]):
         if self.binder is None:
             self.create_binder(backend)
 
-        bound_args, sig_and_spec, constexpr_vals, non_constexpr_vals, excess_kwargs = self.binder(*args, **kwargs)
+        multiversion = kwargs.get("multiversion", False)
+        binder = self.multiversion_binder if multiversion else self.binder
+        bound_args, sig_and_spec, constexpr_vals, non_constexpr_vals, excess_kwargs = binder(*args, **kwargs)
 
         # compute cache key
         key = ''.join(sig_and_spec) + str((constexpr_vals, excess_kwargs))
@@ -605,7 +608,8 @@ class JITFunction(KernelInterface[T]):
             sigvals = sig_and_spec[:len(sigkeys)]
             signature = {k: ('*i8' if (v == 'none') else v) for (k, v) in zip(sigkeys, sigvals)}
 
-            configs = (backend.get_attrs_descriptor(self.params, bound_vals), )
+            params = self.multiversion_params if multiversion else self.params
+            configs = (backend.get_attrs_descriptor(params, bound_vals), )
             constant_params = configs[0].get_constants()
             constants = {
                 p.name: v
@@ -676,6 +680,9 @@ class JITFunction(KernelInterface[T]):
             dns = i in do_not_specialize or param.name in do_not_specialize
             dns_oa = i in do_not_specialize_on_alignment or param.name in do_not_specialize_on_alignment
             self.params.append(KernelParam(i, param, dns, dns_oa))
+        # With `multiversion=True`, alignment is checked at runtime inside the
+        # kernel instead of being part of the specialization.
+        self.multiversion_params = [KernelParam(p.num, p._param, p.do_not_specialize, True) for p in self.params]
 
         # function source code (without decorators)
         self.src = textwrap.dedent(inspect.getsource(fn))
@@ -0,0 +1,181 @@
+"""
+Loading of cached kernel binaries ahead of their first launch.
+
+`CompiledKernel` loads its binary into the driver on first launch, which puts the
+module load latency on the path of the first request that uses the kernel. The
+functions below load kernels from the cache on background threads instead; the
+first launch then reuses the loaded module.
+
+The kernels to load are given by their cache keys (`CompiledKernel.hash`) or by a
+manifest recorded from a previous run of the process:
+
+- `TRITON_KERNEL_MANIFEST=<path>` records the kernels a process launches into a
+  manifest, written at exit.
+- `TRITON_PRELOAD_MANIFEST=<path>` preloads the kernels of a manifest, on the
+  device of the first kernel launch of the process.
+"""
+
+import atexit
+import json
+import os
+import threading
+import uuid
+from concurrent.futures import Future, ThreadPoolExecutor
+from typing import Dict, Iterable, List, Optional, Tuple, Union
+
+from .cache import get_cache_manager
+from .driver import driver
+
+# (hash, device) -> future of the (module, function, n_regs, n_spills) handles
+_preloaded: Dict[Tuple[str, int], Future] = {}
+# hash -> group of the kernel, with its metadata and binary read in memory
+_preloaded_groups: Dict[str, Dict[str, Union[str, bytes]]] = {}
+_lock = threading.Lock()
+# manifest to preload on the first kernel launch, see `_init_from_env`
+_pending_manifest: Optional[str] = None
+
+# hash -> file name of the kernel's group, in launch order
+_manifest: Dict[str, str] = {}
+
+
+def take_preloaded_handles(hash: str, device: int):
+    """
+    Returns the driver handles of a preloaded kernel, waiting for its load if it is
+    in flight, or None if it was not preloaded or failed to load.
+    """
+    global _pending_manifest
+    with _lock:
+        manifest_path, _pending_manifest = _pending_manifest, None
+    if manifest_path is not None:
+        # First launch of the process: preload the other kernels of the manifest on
+        # its device. This one is loaded by the caller.
+        try:
+            with open(manifest_path) as f:
+                kernels = [kernel for kernel in json.load(f)["kernels"] if kernel["key"] != hash]
+            preload_kernels(kernels, device=device)
+        except (OSError, ValueError, KeyError):
+            pass
+        return None
+    with _lock:
+        future = _preloaded.pop((hash, device), None)
+    if future is None:
+        return None
+    try:
+        return future.result()
+    except Exception:
+        return None
+
+
+def take_preloaded_group(hash: str) -> Optional[Dict[str, Union[str, bytes]]]:
+    """
+    Returns the cache group of a preloaded kernel, which `compile` uses instead of
+    reading the group again, and forgets it.
+    """
+    with _lock:
+        return _preloaded_groups.pop(hash, None)
+
+
+def record_kernel(hash: str, name: str):
+    if hash not in _manifest:
+        with _lock:
+            _manifest.setdefault(hash, name)
+
+
+def get_manifest() -> List[Dict[str, str]]:
+    """Returns the kernels launched by this process so far."""
+    with _lock:
+        return [{"key": hash, "name": name} for hash, name in _manifest.items()]
+
+
+def write_manifest(path: str):
+    temp_path = f"{path}.tmp.pid_{os.getpid()}_{uuid.uuid4()}"
+    with open(temp_path, "w") as f:
+        json.dump({"kernels": get_manifest()}, f)
+    os.replace(temp_path, path)
+
+
+def _find_group_names(key):
+    # Only file-based caches can be listed.
+    cache_dir = getattr(get_cache_manager(key), "cache_dir", None)
+    if cache_dir is None or not os.path.isdir(cache_dir):
+        return []
+    return [name[len("__grp__"):-len(".json")] for name in os.listdir(cache_dir) if name.startswith("__grp__")]
+
+
+def _load_kernel(key, name, device, utils):
+    from ..backends.compiler import GPUTarget
+    from ..compiler.compiler import _read_cached, make_backend
+    group = get_cache_manager(key).get_group(f"{name}.json")
+    if not group or f"{name}.json" not in group:
+        raise RuntimeError(f"kernel {key}/{name} is not in the cache")
+    metadata_bytes = _read_cached(group[f"{name}.json"], binary=True)
+    metadata = json.loads(metadata_bytes)
+    target = metadata["target"]
+    binary_ext = make_backend(GPUTarget(target["backend"], target["arch"], target["warp_size"])).binary_ext
+    binary = _read_cached(group[f"{name}.{binary_ext}"], binary=True)
+    # The metadata and the binary are kept as bytes, which `CompiledKernel` reads
+    # like the cached files; the other artifacts are left in the cache.
+    with _lock:
+        _preloaded_groups[key] = {**group, f"{name}.json": metadata_bytes, f"{name}.{binary_ext}": binary}
+    return utils.load_binary(metadata["name"], binary, metadata["shared"], device)
+
+
+def preload_kernels(kernels: Iterable[Union[str, Tuple[str, str], Dict[str, str]]], device: Optional[int] = None,
+                    max_workers: Optional[int] = None) -> Future:
+    """
+    Loads the given kernels from the cache on a background thread pool. Kernels are
+    given by their cache key, by (key, name) pairs, or by manifest entries. Returns
+    a future of the number of kernels loaded; failures are not fatal, the kernel is
+    then loaded on first launch as usual.
+    """
+    entries = []
+    for kernel in kernels:
+        if isinstance(kernel, dict):
+            entries.append((kernel["key"], kernel["name"]))
+        elif isinstance(kernel, str):
+            entries.append((kernel, None))
+        else:
+            entries.append(tuple(kernel))
+    done = Future()
+    # The current device is a property of the calling thread
+    dev = driver.active.get_current_device() if device is None else device
+
+    def run():
+        try:
+            # Initializing the driver utilities can be slow; it is done here rather
+            # than on the caller's thread.
+            utils = driver.active.utils
+            with ThreadPoolExecutor(max_workers or min(8, os.cpu_count() or 1),
+                                    thread_name_prefix="triton-preload") as executor:
+                futures = []
+                for key, name in entries:
+                    for name in [name] if name is not None else _find_group_names(key):
+                        future = executor.submit(_load_kernel, key, name, dev, utils)
+                        with _lock:
+                            _preloaded[(key, dev)] = future
+                        futures.append(future)
+            done.set_result(sum(1 for future in futures if future.exception() is None))
+        except Exception as e:
+            done.set_exception(e)
+
+    threading.Thread(target=run, name="triton-preload", daemon=True).start()
+    return done
+
+
+def preload_manifest(path: str, device: Optional[int] = None, max_workers: Optional[int] = None) -> Future:
+    """Preloads the kernels of a manifest written by `write_manifest`."""
+    with open(path) as f:
+        kernels = json.load(f)["kernels"]
+    return preload_kernels(kernels, device=device, max_workers=max_workers)
+
+
+def _init_from_env():
+    manifest_path = os.getenv("TRITON_KERNEL_MANIFEST", "").strip()
+    if manifest_path:
+        atexit.register(write_manifest, manifest_path)
+    # Preloading waits for the first launch, which tells the device to load on, so
+    # that importing triton does not initialize the driver.
+    global _pending_manifest
+    preload_path = os.getenv("TRITON_PRELOAD_MANIFEST", "").strip()
+    if preload_path and os.path.exists(preload_path):
+        _pending_manifest = preload_path
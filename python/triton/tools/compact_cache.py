@@ -0,0 +1,52 @@
+import functools
+import json
+from argparse import ArgumentParser
+from pathlib import Path
+
+from triton.backends.compiler import GPUTarget
+from triton.compiler.compiler import make_backend
+from triton.runtime.cache import compact_cache
+
+desc = """
+Triton cache compaction:
+
+Removes leftovers of interrupted compilations and unreferenced files from the
+kernel cache (`TRITON_CACHE_DIR`, by default ~/.triton/cache). With
+`--max-bytes`, the least recently used kernels are evicted until the cache
+fits in the given size. With `--drop-ir`, only the binary and the metadata of
+each kernel are kept.
+
+It is safe to run while other processes compile or load kernels.
+"""
+
+
+@functools.lru_cache()
+def _binary_ext(backend, arch, warp_size):
+    return make_backend(GPUTarget(backend, arch, warp_size)).binary_ext
+
+
+def keep_binary_and_metadata(name, group):
+    if name.endswith(".json"):
+        return True
+    metadata_path = next((path for child, path in group.items() if child.endswith(".json")), None)
+    if metadata_path is None:
+        return True
+    try:
+        target = json.loads(Path(metadata_path).read_text())["target"]
+        binary_ext = _binary_ext(target["backend"], target["arch"], target["warp_size"])
+    except Exception:
+        # Keep what cannot be classified
+        return True
+    return name.endswith(f".{binary_ext}")
+
+
+if __name__ == "__main__":
+    parser = ArgumentParser(description=desc)
+    parser.add_argument("--cache-dir", type=str, default=None, help="Cache directory to compact")
+    parser.add_argument("--max-bytes", type=int, default=None, help="Size budget of the cache in bytes")
+    parser.add_argument("--drop-ir", action="store_true", help="Only keep the binary and metadata of each kernel")
+    args = parser.parse_args()
+
+    keep = keep_binary_and_metadata if args.drop_ir else None
+    freed = compact_cache(args.cache_dir, max_bytes=args.max_bytes, keep=keep)
+    print(f"Freed {freed} bytes")
@@ -0,0 +1,26 @@
+from argparse import ArgumentParser
+
+from triton.runtime.cache import pack_cache
+
+desc = """
+Triton cache packing:
+
+Packs the kernels of the cache directory (`TRITON_CACHE_DIR`, by default
+~/.triton/cache) into a single memory-mapped file (`TRITON_CACHE_PACK`, by
+default cache.pack in the cache directory). Kernels already in the pack are
+kept. Processes that use
+
+`TRITON_CACHE_MANAGER=triton.runtime.cache:PackedCacheManager`
+
+then load packed kernels with one hash probe each instead of opening their
+files; other kernels are still looked up and compiled into the directory.
+"""
+
+if __name__ == "__main__":
+    parser = ArgumentParser(description=desc)
+    parser.add_argument("--cache-dir", type=str, default=None, help="Cache directory to pack")
+    parser.add_argument("--output", "-o", type=str, default=None, help="Path of the cache pack")
+    args = parser.parse_args()
+
+    num_groups = pack_cache(args.cache_dir, args.output)
+    print(f"Packed {num_groups} kernels")
@@ -609,3 +609,28 @@ tt.func @call_graph_2(%A : !tt.ptr<f16>, %cond : i1) {
 }
 
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+
+// Few bins: a single histogram combined from the warp ballots.
+// CHECK-LABEL: histogram_warp_ballot
+tt.func @histogram_warp_ballot(%arg0: tensor<128xi32, #blocked>) {
+  // CHECK: scratch offset = 0, size = 128
+  %0 = tt.histogram %arg0 : tensor<128xi32, #blocked> -> tensor<32xi32, #blocked>
+  tt.return
+  // CHECK-NEXT: size = 128
+}
+
+// Many bins: one private histogram per warp.
+// CHECK-LABEL: histogram_privatized
+tt.func @histogram_privatized(%arg0: tensor<512xi32, #blocked>) {
+  // CHECK: scratch offset = 0, size = 16384
+  %0 = tt.histogram %arg0 : tensor<512xi32, #blocked> -> tensor<1024xi32, #blocked>
+  tt.return
+  // CHECK-NEXT: size = 16384
+}
+
+}
@@ -0,0 +1,99 @@
+// Flash attention backward: dK and dV of one 64-key block of one head, looping
+// over 32-query blocks with a head dimension of 64, as in the fused attention
+// tutorial (_attn_bwd_dkdv).
+// compile-bench: num-warps=4 num-stages=3
+module {
+  tt.func public @attn_bwd_dkdv(%q_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %k_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %v_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %do_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %dk_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %dv_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %lse_ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %delta_ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %sm_scale: f32, %stride_tok: i32 {tt.divisibility = 16 : i32}, %n_ctx: i32 {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+    %c0_i32 = arith.constant 0 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %zero_kv = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+    %zero_qk = arith.constant dense<0.000000e+00> : tensor<64x32xf32>
+    %ml_step = arith.constant dense<32> : tensor<32xi32>
+    %start_n = tt.get_program_id x : i32
+    %head = tt.get_program_id y : i32
+    %head_tok = arith.muli %head, %n_ctx : i32
+    %head_off = arith.muli %head_tok, %stride_tok : i32
+    %q_head = tt.addptr %q_ptr, %head_off : !tt.ptr<f16>, i32
+    %k_head = tt.addptr %k_ptr, %head_off : !tt.ptr<f16>, i32
+    %v_head = tt.addptr %v_ptr, %head_off : !tt.ptr<f16>, i32
+    %do_head = tt.addptr %do_ptr, %head_off : !tt.ptr<f16>, i32
+    %dk_head = tt.addptr %dk_ptr, %head_off : !tt.ptr<f16>, i32
+    %dv_head = tt.addptr %dv_ptr, %head_off : !tt.ptr<f16>, i32
+    %lse_head = tt.addptr %lse_ptr, %head_tok : !tt.ptr<f32>, i32
+    %delta_head = tt.addptr %delta_ptr, %head_tok : !tt.ptr<f32>, i32
+    %off_n = arith.muli %start_n, %c64_i32 : i32
+    %range_n = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %off_n_s = tt.splat %off_n : i32 -> tensor<64xi32>
+    %offs_n = arith.addi %off_n_s, %range_n : tensor<64xi32>
+    %offs_m = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+    %offs_d = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %offs_d_r = tt.expand_dims %offs_d {axis = 0 : i32} : tensor<64xi32> -> tensor<1x64xi32>
+    %offs_n_e = tt.expand_dims %offs_n {axis = 1 : i32} : tensor<64xi32> -> tensor<64x1xi32>
+    %stride_n = tt.splat %stride_tok : i32 -> tensor<64x1xi32>
+    %kv_row = arith.muli %offs_n_e, %stride_n : tensor<64x1xi32>
+    %kv_row_b = tt.broadcast %kv_row : tensor<64x1xi32> -> tensor<64x64xi32>
+    %offs_d_kv = tt.broadcast %offs_d_r : tensor<1x64xi32> -> tensor<64x64xi32>
+    %kv_offs = arith.addi %kv_row_b, %offs_d_kv : tensor<64x64xi32>
+    %k_base = tt.splat %k_head : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %k_ptrs = tt.addptr %k_base, %kv_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %k = tt.load %k_ptrs : tensor<64x64x!tt.ptr<f16>>
+    %v_base = tt.splat %v_head : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %v_ptrs = tt.addptr %v_base, %kv_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %v = tt.load %v_ptrs : tensor<64x64x!tt.ptr<f16>>
+    %offs_m_e = tt.expand_dims %offs_m {axis = 1 : i32} : tensor<32xi32> -> tensor<32x1xi32>
+    %stride_m = tt.splat %stride_tok : i32 -> tensor<32x1xi32>
+    %qo_row = arith.muli %offs_m_e, %stride_m : tensor<32x1xi32>
+    %qo_row_b = tt.broadcast %qo_row : tensor<32x1xi32> -> tensor<32x64xi32>
+    %offs_d_qo = tt.broadcast %offs_d_r : tensor<1x64xi32> -> tensor<32x64xi32>
+    %qo_offs = arith.addi %qo_row_b, %offs_d_qo : tensor<32x64xi32>
+    %q_base = tt.splat %q_head : !tt.ptr<f16> -> tensor<32x64x!tt.ptr<f16>>
+    %q_ptrs = tt.addptr %q_base, %qo_offs : tensor<32x64x!tt.ptr<f16>>, tensor<32x64xi32>
+    %do_base = tt.splat %do_head : !tt.ptr<f16> -> tensor<32x64x!tt.ptr<f16>>
+    %do_ptrs = tt.addptr %do_base, %qo_offs : tensor<32x64x!tt.ptr<f16>>, tensor<32x64xi32>
+    %lse_base = tt.splat %lse_head : !tt.ptr<f32> -> tensor<32x!tt.ptr<f32>>
+    %lse_ptrs = tt.addptr %lse_base, %offs_m : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+    %delta_base = tt.splat %delta_head : !tt.ptr<f32> -> tensor<32x!tt.ptr<f32>>
+    %delta_ptrs = tt.addptr %delta_base, %offs_m : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+    %qo_step_s = arith.muli %stride_tok, %c32_i32 : i32
+    %qo_step = tt.splat %qo_step_s : i32 -> tensor<32x64xi32>
+    %res:6 = scf.for %start_m = %c0_i32 to %n_ctx step %c32_i32 iter_args(%dk = %zero_kv, %dv = %zero_kv, %q_i = %q_ptrs, %do_i = %do_ptrs, %lse_i = %lse_ptrs, %delta_i = %delta_ptrs) -> (tensor<64x64xf32>, tensor<64x64xf32>, tensor<32x64x!tt.ptr<f16>>, tensor<32x64x!tt.ptr<f16>>, tensor<32x!tt.ptr<f32>>, tensor<32x!tt.ptr<f32>>)  : i32 {
+      %q = tt.load %q_i : tensor<32x64x!tt.ptr<f16>>
+      %qt = tt.trans %q {order = array<i32: 1, 0>} : tensor<32x64xf16> -> tensor<64x32xf16>
+      %lse = tt.load %lse_i : tensor<32x!tt.ptr<f32>>
+      %qkt = tt.dot %k, %qt, %zero_qk : tensor<64x64xf16> * tensor<64x32xf16> -> tensor<64x32xf32>
+      %lse_r = tt.expand_dims %lse {axis = 0 : i32} : tensor<32xf32> -> tensor<1x32xf32>
+      %lse_b = tt.broadcast %lse_r : tensor<1x32xf32> -> tensor<64x32xf32>
+      %qkt_c = arith.subf %qkt, %lse_b : tensor<64x32xf32>
+      %pt = math.exp2 %qkt_c : tensor<64x32xf32>
+      %do = tt.load %do_i : tensor<32x64x!tt.ptr<f16>>
+      %pt_h = arith.truncf %pt : tensor<64x32xf32> to tensor<64x32xf16>
+      %dv_n = tt.dot %pt_h, %do, %dv : tensor<64x32xf16> * tensor<32x64xf16> -> tensor<64x64xf32>
+      %delta = tt.load %delta_i : tensor<32x!tt.ptr<f32>>
+      %dot = tt.trans %do {order = array<i32: 1, 0>} : tensor<32x64xf16> -> tensor<64x32xf16>
+      %dpt = tt.dot %v, %dot, %zero_qk : tensor<64x64xf16> * tensor<64x32xf16> -> tensor<64x32xf32>
+      %delta_r = tt.expand_dims %delta {axis = 0 : i32} : tensor<32xf32> -> tensor<1x32xf32>
+      %delta_b = tt.broadcast %delta_r : tensor<1x32xf32> -> tensor<64x32xf32>
+      %dpt_c = arith.subf %dpt, %delta_b : tensor<64x32xf32>
+      %dst = arith.mulf %pt, %dpt_c : tensor<64x32xf32>
+      %dst_h = arith.truncf %dst : tensor<64x32xf32> to tensor<64x32xf16>
+      %dk_n = tt.dot %dst_h, %q, %dk : tensor<64x32xf16> * tensor<32x64xf16> -> tensor<64x64xf32>
+      %q_n = tt.addptr %q_i, %qo_step : tensor<32x64x!tt.ptr<f16>>, tensor<32x64xi32>
+      %do_n = tt.addptr %do_i, %qo_step : tensor<32x64x!tt.ptr<f16>>, tensor<32x64xi32>
+      %lse_n = tt.addptr %lse_i, %ml_step : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+      %delta_n = tt.addptr %delta_i, %ml_step : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+      scf.yield %dk_n, %dv_n, %q_n, %do_n, %lse_n, %delta_n : tensor<64x64xf32>, tensor<64x64xf32>, tensor<32x64x!tt.ptr<f16>>, tensor<32x64x!tt.ptr<f16>>, tensor<32x!tt.ptr<f32>>, tensor<32x!tt.ptr<f32>>
+    }
+    %scale_s = tt.splat %sm_scale : f32 -> tensor<64x64xf32>
+    %dk_scaled = arith.mulf %res#0, %scale_s : tensor<64x64xf32>
+    %dk_h = arith.truncf %dk_scaled : tensor<64x64xf32> to tensor<64x64xf16>
+    %dv_h = arith.truncf %res#1 : tensor<64x64xf32> to tensor<64x64xf16>
+    %dk_base = tt.splat %dk_head : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %dk_ptrs = tt.addptr %dk_base, %kv_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    tt.store %dk_ptrs, %dk_h : tensor<64x64x!tt.ptr<f16>>
+    %dv_base = tt.splat %dv_head : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %dv_ptrs = tt.addptr %dv_base, %kv_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    tt.store %dv_ptrs, %dv_h : tensor<64x64x!tt.ptr<f16>>
+    tt.return
+  }
+}
@@ -0,0 +1,101 @@
+// Flash attention forward of one 128-query block of one head, with 64-key
+// blocks and a head dimension of 64, as in the fused attention tutorial
+// (non-causal stage).
+// compile-bench: num-warps=8 num-stages=3
+module {
+  tt.func public @attn_fwd(%q_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %k_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %v_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %o_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %lse_ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %sm_scale: f32, %stride_tok: i32 {tt.divisibility = 16 : i32}, %n_ctx: i32 {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+    %c0_i32 = arith.constant 0 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c128_i32 = arith.constant 128 : i32
+    %log2e = arith.constant 1.44269502 : f32
+    %neg_inf = arith.constant dense<0xFF800000> : tensor<128xf32>
+    %ones = arith.constant dense<1.000000e+00> : tensor<128xf32>
+    %zero_acc = arith.constant dense<0.000000e+00> : tensor<128x64xf32>
+    %start_m = tt.get_program_id x : i32
+    %head = tt.get_program_id y : i32
+    %head_tok = arith.muli %head, %n_ctx : i32
+    %head_off = arith.muli %head_tok, %stride_tok : i32
+    %q_head = tt.addptr %q_ptr, %head_off : !tt.ptr<f16>, i32
+    %k_head = tt.addptr %k_ptr, %head_off : !tt.ptr<f16>, i32
+    %v_head = tt.addptr %v_ptr, %head_off : !tt.ptr<f16>, i32
+    %o_head = tt.addptr %o_ptr, %head_off : !tt.ptr<f16>, i32
+    %lse_head = tt.addptr %lse_ptr, %head_tok : !tt.ptr<f32>, i32
+    %off_m = arith.muli %start_m, %c128_i32 : i32
+    %range_m = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+    %off_m_s = tt.splat %off_m : i32 -> tensor<128xi32>
+    %offs_m = arith.addi %off_m_s, %range_m : tensor<128xi32>
+    %offs_n = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %offs_d = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %offs_d_r = tt.expand_dims %offs_d {axis = 0 : i32} : tensor<64xi32> -> tensor<1x64xi32>
+    %offs_m_e = tt.expand_dims %offs_m {axis = 1 : i32} : tensor<128xi32> -> tensor<128x1xi32>
+    %stride_m = tt.splat %stride_tok : i32 -> tensor<128x1xi32>
+    %q_row = arith.muli %offs_m_e, %stride_m : tensor<128x1xi32>
+    %q_row_b = tt.broadcast %q_row : tensor<128x1xi32> -> tensor<128x64xi32>
+    %offs_d_qb = tt.broadcast %offs_d_r : tensor<1x64xi32> -> tensor<128x64xi32>
+    %q_offs = arith.addi %q_row_b, %offs_d_qb : tensor<128x64xi32>
+    %q_base = tt.splat %q_head : !tt.ptr<f16> -> tensor<128x64x!tt.ptr<f16>>
+    %q_ptrs = tt.addptr %q_base, %q_offs : tensor<128x64x!tt.ptr<f16>>, tensor<128x64xi32>
+    %q = tt.load %q_ptrs : tensor<128x64x!tt.ptr<f16>>
+    %qk_scale = arith.mulf %sm_scale, %log2e : f32
+    %qk_scale_s = tt.splat %qk_scale : f32 -> tensor<128x64xf32>
+    %offs_n_e = tt.expand_dims %offs_n {axis = 1 : i32} : tensor<64xi32> -> tensor<64x1xi32>
+    %stride_n = tt.splat %stride_tok : i32 -> tensor<64x1xi32>
+    %kv_row = arith.muli %offs_n_e, %stride_n : tensor<64x1xi32>
+    %kv_row_b = tt.broadcast %kv_row : tensor<64x1xi32> -> tensor<64x64xi32>
+    %offs_d_kb = tt.broadcast %offs_d_r : tensor<1x64xi32> -> tensor<64x64xi32>
+    %kv_offs = arith.addi %kv_row_b, %offs_d_kb : tensor<64x64xi32>
+    %k_base = tt.splat %k_head : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %k_ptrs = tt.addptr %k_base, %kv_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %v_base = tt.splat %v_head : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %v_ptrs = tt.addptr %v_base, %kv_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %kv_step_s = arith.muli %stride_tok, %c64_i32 : i32
+    %kv_step = tt.splat %kv_step_s : i32 -> tensor<64x64xi32>
+    %res:5 = scf.for %start_n = %c0_i32 to %n_ctx step %c64_i32 iter_args(%acc = %zero_acc, %l_i = %ones, %m_i = %neg_inf, %k_i = %k_ptrs, %v_i = %v_ptrs) -> (tensor<128x64xf32>, tensor<128xf32>, tensor<128xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>)  : i32 {
+      %k = tt.load %k_i : tensor<64x64x!tt.ptr<f16>>
+      %kt = tt.trans %k {order = array<i32: 1, 0>} : tensor<64x64xf16> -> tensor<64x64xf16>
+      %qk = tt.dot %q, %kt, %zero_acc : tensor<128x64xf16> * tensor<64x64xf16> -> tensor<128x64xf32>
+      %qk_s = arith.mulf %qk, %qk_scale_s : tensor<128x64xf32>
+      %m_blk = "tt.reduce"(%qk_s) ({
+      ^bb0(%max_l: f32, %max_r: f32):
+        %max_lr = arith.maxnumf %max_l, %max_r : f32
+        tt.reduce.return %max_lr : f32
+      }) {axis = 1 : i32} : (tensor<128x64xf32>) -> tensor<128xf32>
+      %m_new = arith.maxnumf %m_i, %m_blk : tensor<128xf32>
+      %m_new_e = tt.expand_dims %m_new {axis = 1 : i32} : tensor<128xf32> -> tensor<128x1xf32>
+      %m_new_b = tt.broadcast %m_new_e : tensor<128x1xf32> -> tensor<128x64xf32>
+      %qk_c = arith.subf %qk_s, %m_new_b : tensor<128x64xf32>
+      %p = math.exp2 %qk_c : tensor<128x64xf32>
+      %l_blk = "tt.reduce"(%p) ({
+      ^bb0(%sum_l: f32, %sum_r: f32):
+        %sum_lr = arith.addf %sum_l, %sum_r : f32
+        tt.reduce.return %sum_lr : f32
+      }) {axis = 1 : i32} : (tensor<128x64xf32>) -> tensor<128xf32>
+      %m_diff = arith.subf %m_i, %m_new : tensor<128xf32>
+      %alpha = math.exp2 %m_diff : tensor<128xf32>
+      %l_scaled = arith.mulf %l_i, %alpha : tensor<128xf32>
+      %l_new = arith.addf %l_scaled, %l_blk : tensor<128xf32>
+      %alpha_e = tt.expand_dims %alpha {axis = 1 : i32} : tensor<128xf32> -> tensor<128x1xf32>
+      %alpha_b = tt.broadcast %alpha_e : tensor<128x1xf32> -> tensor<128x64xf32>
+      %acc_scaled = arith.mulf %acc, %alpha_b : tensor<128x64xf32>
+      %v = tt.load %v_i : tensor<64x64x!tt.ptr<f16>>
+      %p_h = arith.truncf %p : tensor<128x64xf32> to tensor<128x64xf16>
+      %acc_new = tt.dot %p_h, %v, %acc_scaled : tensor<128x64xf16> * tensor<64x64xf16> -> tensor<128x64xf32>
+      %k_n = tt.addptr %k_i, %kv_step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+      %v_n = tt.addptr %v_i, %kv_step : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+      scf.yield %acc_new, %l_new, %m_new, %k_n, %v_n : tensor<128x64xf32>, tensor<128xf32>, tensor<128xf32>, tensor<64x64x!tt.ptr<f16>>, tensor<64x64x!tt.ptr<f16>>
+    }
+    %l_e = tt.expand_dims %res#1 {axis = 1 : i32} : tensor<128xf32> -> tensor<128x1xf32>
+    %l_b = tt.broadcast %l_e : tensor<128x1xf32> -> tensor<128x64xf32>
+    %o = arith.divf %res#0, %l_b : tensor<128x64xf32>
+    %log_l = math.log2 %res#1 : tensor<128xf32>
+    %lse = arith.addf %res#2, %log_l : tensor<128xf32>
+    %lse_base = tt.splat %lse_head : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+    %lse_ptrs = tt.addptr %lse_base, %offs_m : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+    tt.store %lse_ptrs, %lse : tensor<128x!tt.ptr<f32>>
+    %o_h = arith.truncf %o : tensor<128x64xf32> to tensor<128x64xf16>
+    %o_base = tt.splat %o_head : !tt.ptr<f16> -> tensor<128x64x!tt.ptr<f16>>
+    %o_ptrs = tt.addptr %o_base, %q_offs : tensor<128x64x!tt.ptr<f16>>, tensor<128x64xi32>
+    tt.store %o_ptrs, %o_h : tensor<128x64x!tt.ptr<f16>>
+    tt.return
+  }
+}
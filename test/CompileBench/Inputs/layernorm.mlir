@@ -0,0 +1,62 @@
+// Layer normalization forward of rows of up to 1024 fp16 elements, one row per
+// program, as in the layer norm tutorial.
+// compile-bench: num-warps=8
+module {
+  tt.func public @layer_norm_fwd(%x_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %y_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %w_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %b_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %mean_ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %rstd_ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %stride: i32 {tt.divisibility = 16 : i32}, %N: i32, %eps: f32) attributes {noinline = false} {
+    %one = arith.constant 1.000000e+00 : f32
+    %zero = arith.constant dense<0.000000e+00> : tensor<1024xf32>
+    %zero_h = arith.constant dense<0.000000e+00> : tensor<1024xf16>
+    %row = tt.get_program_id x : i32
+    %row_off = arith.muli %row, %stride : i32
+    %x_row = tt.addptr %x_ptr, %row_off : !tt.ptr<f16>, i32
+    %y_row = tt.addptr %y_ptr, %row_off : !tt.ptr<f16>, i32
+    %cols = tt.make_range {end = 1024 : i32, start = 0 : i32} : tensor<1024xi32>
+    %N_s = tt.splat %N : i32 -> tensor<1024xi32>
+    %mask = arith.cmpi slt, %cols, %N_s : tensor<1024xi32>
+    %x_base = tt.splat %x_row : !tt.ptr<f16> -> tensor<1024x!tt.ptr<f16>>
+    %x_ptrs = tt.addptr %x_base, %cols : tensor<1024x!tt.ptr<f16>>, tensor<1024xi32>
+    %x_h = tt.load %x_ptrs, %mask, %zero_h : tensor<1024x!tt.ptr<f16>>
+    %x = arith.extf %x_h : tensor<1024xf16> to tensor<1024xf32>
+    %sum = "tt.reduce"(%x) ({
+    ^bb0(%sum_l: f32, %sum_r: f32):
+      %sum_lr = arith.addf %sum_l, %sum_r : f32
+      tt.reduce.return %sum_lr : f32
+    }) {axis = 0 : i32} : (tensor<1024xf32>) -> f32
+    %N_f = arith.sitofp %N : i32 to f32
+    %mean = arith.divf %sum, %N_f : f32
+    %mean_s = tt.splat %mean : f32 -> tensor<1024xf32>
+    %diff = arith.subf %x, %mean_s : tensor<1024xf32>
+    %xc = arith.select %mask, %diff, %zero : tensor<1024xi1>, tensor<1024xf32>
+    %sq = arith.mulf %xc, %xc : tensor<1024xf32>
+    %sq_sum = "tt.reduce"(%sq) ({
+    ^bb0(%sq_l: f32, %sq_r: f32):
+      %sq_lr = arith.addf %sq_l, %sq_r : f32
+      tt.reduce.return %sq_lr : f32
+    }) {axis = 0 : i32} : (tensor<1024xf32>) -> f32
+    %var = arith.divf %sq_sum, %N_f : f32
+    %var_eps = arith.addf %var, %eps : f32
+    %std = math.sqrt %var_eps : f32
+    %rstd = arith.divf %one, %std : f32
+    %mean_p = tt.addptr %mean_ptr, %row : !tt.ptr<f32>, i32
+    tt.store %mean_p, %mean : !tt.ptr<f32>
+    %rstd_p = tt.addptr %rstd_ptr, %row : !tt.ptr<f32>, i32
+    tt.store %rstd_p, %rstd : !tt.ptr<f32>
+    %w_base = tt.splat %w_ptr : !tt.ptr<f16> -> tensor<1024x!tt.ptr<f16>>
+    %w_ptrs = tt.addptr %w_base, %cols : tensor<1024x!tt.ptr<f16>>, tensor<1024xi32>
+    %w_h = tt.load %w_ptrs, %mask : tensor<1024x!tt.ptr<f16>>
+    %w = arith.extf %w_h : tensor<1024xf16> to tensor<1024xf32>
+    %b_base = tt.splat %b_ptr : !tt.ptr<f16> -> tensor<1024x!tt.ptr<f16>>
+    %b_ptrs = tt.addptr %b_base, %cols : tensor<1024x!tt.ptr<f16>>, tensor<1024xi32>
+    %b_h = tt.load %b_ptrs, %mask : tensor<1024x!tt.ptr<f16>>
+    %b = arith.extf %b_h : tensor<1024xf16> to tensor<1024xf32>
+    %rstd_s = tt.splat %rstd : f32 -> tensor<1024xf32>
+    %x_hat = arith.mulf %xc, %rstd_s : tensor<1024xf32>
+    %y_w = arith.mulf %x_hat, %w : tensor<1024xf32>
+    %y = arith.addf %y_w, %b : tensor<1024xf32>
+    %y_h = arith.truncf %y : tensor<1024xf32> to tensor<1024xf16>
+    %y_base = tt.splat %y_row : !tt.ptr<f16> -> tensor<1024x!tt.ptr<f16>>
+    %y_ptrs = tt.addptr %y_base, %cols : tensor<1024x!tt.ptr<f16>>, tensor<1024xi32>
+    tt.store %y_ptrs, %y_h, %mask : tensor<1024x!tt.ptr<f16>>
+    tt.return
+  }
+}
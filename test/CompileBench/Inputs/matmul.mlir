@@ -0,0 +1,85 @@
+// Matrix multiplication C = A x B in fp16 with fp32 accumulation and
+// 128x128x64 tiles, as in the matmul tutorial.
+// compile-bench: num-warps=8 num-stages=3
+module {
+  tt.func public @matmul_kernel(%a_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %b_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %c_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %M: i32 {tt.divisibility = 16 : i32}, %N: i32 {tt.divisibility = 16 : i32}, %K: i32 {tt.divisibility = 16 : i32}, %stride_am: i32 {tt.divisibility = 16 : i32}, %stride_bk: i32 {tt.divisibility = 16 : i32}, %stride_cm: i32 {tt.divisibility = 16 : i32}) attributes {noinline = false} {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c63_i32 = arith.constant 63 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c127_i32 = arith.constant 127 : i32
+    %c128_i32 = arith.constant 128 : i32
+    %zero = arith.constant dense<0.000000e+00> : tensor<128x128xf32>
+    %a_other = arith.constant dense<0.000000e+00> : tensor<128x64xf16>
+    %b_other = arith.constant dense<0.000000e+00> : tensor<64x128xf16>
+    %a_step = arith.constant dense<64> : tensor<128x64xi32>
+    %pid = tt.get_program_id x : i32
+    %n_plus = arith.addi %N, %c127_i32 : i32
+    %num_pid_n = arith.divsi %n_plus, %c128_i32 : i32
+    %pid_m = arith.divsi %pid, %num_pid_n : i32
+    %pid_n = arith.remsi %pid, %num_pid_n : i32
+    %off_m = arith.muli %pid_m, %c128_i32 : i32
+    %off_n = arith.muli %pid_n, %c128_i32 : i32
+    %range128 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+    %range64 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %off_m_s = tt.splat %off_m : i32 -> tensor<128xi32>
+    %rm = arith.addi %off_m_s, %range128 : tensor<128xi32>
+    %off_n_s = tt.splat %off_n : i32 -> tensor<128xi32>
+    %rn = arith.addi %off_n_s, %range128 : tensor<128xi32>
+    %rm_e = tt.expand_dims %rm {axis = 1 : i32} : tensor<128xi32> -> tensor<128x1xi32>
+    %sam = tt.splat %stride_am : i32 -> tensor<128x1xi32>
+    %a_row = arith.muli %rm_e, %sam : tensor<128x1xi32>
+    %a_row_b = tt.broadcast %a_row : tensor<128x1xi32> -> tensor<128x64xi32>
+    %rk_a = tt.expand_dims %range64 {axis = 0 : i32} : tensor<64xi32> -> tensor<1x64xi32>
+    %rk_a_b = tt.broadcast %rk_a : tensor<1x64xi32> -> tensor<128x64xi32>
+    %a_offs = arith.addi %a_row_b, %rk_a_b : tensor<128x64xi32>
+    %a_base = tt.splat %a_ptr : !tt.ptr<f16> -> tensor<128x64x!tt.ptr<f16>>
+    %a_ptrs = tt.addptr %a_base, %a_offs : tensor<128x64x!tt.ptr<f16>>, tensor<128x64xi32>
+    %rk_b = tt.expand_dims %range64 {axis = 1 : i32} : tensor<64xi32> -> tensor<64x1xi32>
+    %sbk = tt.splat %stride_bk : i32 -> tensor<64x1xi32>
+    %b_row = arith.muli %rk_b, %sbk : tensor<64x1xi32>
+    %b_row_b = tt.broadcast %b_row : tensor<64x1xi32> -> tensor<64x128xi32>
+    %rn_r = tt.expand_dims %rn {axis = 0 : i32} : tensor<128xi32> -> tensor<1x128xi32>
+    %rn_b = tt.broadcast %rn_r : tensor<1x128xi32> -> tensor<64x128xi32>
+    %b_offs = arith.addi %b_row_b, %rn_b : tensor<64x128xi32>
+    %b_base = tt.splat %b_ptr : !tt.ptr<f16> -> tensor<64x128x!tt.ptr<f16>>
+    %b_ptrs = tt.addptr %b_base, %b_offs : tensor<64x128x!tt.ptr<f16>>, tensor<64x128xi32>
+    %b_step_s = arith.muli %stride_bk, %c64_i32 : i32
+    %b_step = tt.splat %b_step_s : i32 -> tensor<64x128xi32>
+    %k_plus = arith.addi %K, %c63_i32 : i32
+    %k_tiles = arith.divsi %k_plus, %c64_i32 : i32
+    %acc:3 = scf.for %kt = %c0_i32 to %k_tiles step %c1_i32 iter_args(%acc_i = %zero, %a_i = %a_ptrs, %b_i = %b_ptrs) -> (tensor<128x128xf32>, tensor<128x64x!tt.ptr<f16>>, tensor<64x128x!tt.ptr<f16>>)  : i32 {
+      %k_off = arith.muli %kt, %c64_i32 : i32
+      %k_left = arith.subi %K, %k_off : i32
+      %k_left_r = tt.splat %k_left : i32 -> tensor<1x64xi32>
+      %a_k_mask = arith.cmpi slt, %rk_a, %k_left_r : tensor<1x64xi32>
+      %a_mask = tt.broadcast %a_k_mask : tensor<1x64xi1> -> tensor<128x64xi1>
+      %a = tt.load %a_i, %a_mask, %a_other : tensor<128x64x!tt.ptr<f16>>
+      %k_left_c = tt.splat %k_left : i32 -> tensor<64x1xi32>
+      %b_k_mask = arith.cmpi slt, %rk_b, %k_left_c : tensor<64x1xi32>
+      %b_mask = tt.broadcast %b_k_mask : tensor<64x1xi1> -> tensor<64x128xi1>
+      %b = tt.load %b_i, %b_mask, %b_other : tensor<64x128x!tt.ptr<f16>>
+      %acc_n = tt.dot %a, %b, %acc_i : tensor<128x64xf16> * tensor<64x128xf16> -> tensor<128x128xf32>
+      %a_n = tt.addptr %a_i, %a_step : tensor<128x64x!tt.ptr<f16>>, tensor<128x64xi32>
+      %b_n = tt.addptr %b_i, %b_step : tensor<64x128x!tt.ptr<f16>>, tensor<64x128xi32>
+      scf.yield %acc_n, %a_n, %b_n : tensor<128x128xf32>, tensor<128x64x!tt.ptr<f16>>, tensor<64x128x!tt.ptr<f16>>
+    }
+    %c = arith.truncf %acc#0 : tensor<128x128xf32> to tensor<128x128xf16>
+    %scm = tt.splat %stride_cm : i32 -> tensor<128x1xi32>
+    %c_row = arith.muli %rm_e, %scm : tensor<128x1xi32>
+    %c_row_b = tt.broadcast %c_row : tensor<128x1xi32> -> tensor<128x128xi32>
+    %rn_cb = tt.broadcast %rn_r : tensor<1x128xi32> -> tensor<128x128xi32>
+    %c_offs = arith.addi %c_row_b, %rn_cb : tensor<128x128xi32>
+    %c_base = tt.splat %c_ptr : !tt.ptr<f16> -> tensor<128x128x!tt.ptr<f16>>
+    %c_ptrs = tt.addptr %c_base, %c_offs : tensor<128x128x!tt.ptr<f16>>, tensor<128x128xi32>
+    %M_s = tt.splat %M : i32 -> tensor<128x1xi32>
+    %m_mask = arith.cmpi slt, %rm_e, %M_s : tensor<128x1xi32>
+    %N_s = tt.splat %N : i32 -> tensor<1x128xi32>
+    %n_mask = arith.cmpi slt, %rn_r, %N_s : tensor<1x128xi32>
+    %m_mask_b = tt.broadcast %m_mask : tensor<128x1xi1> -> tensor<128x128xi1>
+    %n_mask_b = tt.broadcast %n_mask : tensor<1x128xi1> -> tensor<128x128xi1>
+    %c_mask = arith.andi %m_mask_b, %n_mask_b : tensor<128x128xi1>
+    tt.store %c_ptrs, %c, %c_mask : tensor<128x128x!tt.ptr<f16>>
+    tt.return
+  }
+}
@@ -0,0 +1,106 @@
+// Fused mixture-of-experts matmul: each 64-row block of tokens sorted by
+// expert gathers its rows of A, multiplies them by the weights of its expert
+// and scales the result by the routing weights (vLLM's fused_moe_kernel).
+// compile-bench: num-warps=4 num-stages=3
+module {
+  tt.func public @fused_moe_kernel(%a_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %b_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %c_ptr: !tt.ptr<f16> {tt.divisibility = 16 : i32}, %topk_weights_ptr: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %sorted_token_ids_ptr: !tt.ptr<i32> {tt.divisibility = 16 : i32}, %expert_ids_ptr: !tt.ptr<i32> {tt.divisibility = 16 : i32}, %N: i32 {tt.divisibility = 16 : i32}, %K: i32 {tt.divisibility = 16 : i32}, %num_valid_tokens: i32, %stride_am: i32 {tt.divisibility = 16 : i32}, %stride_be: i32 {tt.divisibility = 16 : i32}, %stride_bk: i32 {tt.divisibility = 16 : i32}, %stride_cm: i32 {tt.divisibility = 16 : i32}, %top_k: i32) attributes {noinline = false} {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c31_i32 = arith.constant 31 : i32
+    %c32_i32 = arith.constant 32 : i32
+    %c63_i32 = arith.constant 63 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %zero = arith.constant dense<0.000000e+00> : tensor<64x64xf32>
+    %a_other = arith.constant dense<0.000000e+00> : tensor<64x32xf16>
+    %b_other = arith.constant dense<0.000000e+00> : tensor<32x64xf16>
+    %w_other = arith.constant dense<0.000000e+00> : tensor<64xf32>
+    %a_step = arith.constant dense<32> : tensor<64x32xi32>
+    %pid = tt.get_program_id x : i32
+    %n_plus = arith.addi %N, %c63_i32 : i32
+    %num_pid_n = arith.divsi %n_plus, %c64_i32 : i32
+    %pid_m = arith.divsi %pid, %num_pid_n : i32
+    %pid_n = arith.remsi %pid, %num_pid_n : i32
+    %off_m = arith.muli %pid_m, %c64_i32 : i32
+    %range64 = tt.make_range {end = 64 : i32, start = 0 : i32} : tensor<64xi32>
+    %off_m_s = tt.splat %off_m : i32 -> tensor<64xi32>
+    %offs_token_id = arith.addi %off_m_s, %range64 : tensor<64xi32>
+    %tok_base = tt.splat %sorted_token_ids_ptr : !tt.ptr<i32> -> tensor<64x!tt.ptr<i32>>
+    %tok_ptrs = tt.addptr %tok_base, %offs_token_id : tensor<64x!tt.ptr<i32>>, tensor<64xi32>
+    %offs_token = tt.load %tok_ptrs : tensor<64x!tt.ptr<i32>>
+    %valid_s = tt.splat %num_valid_tokens : i32 -> tensor<64xi32>
+    %token_mask = arith.cmpi slt, %offs_token, %valid_s : tensor<64xi32>
+    %expert_p = tt.addptr %expert_ids_ptr, %pid_m : !tt.ptr<i32>, i32
+    %expert = tt.load %expert_p : !tt.ptr<i32>
+    %off_n = arith.muli %pid_n, %c64_i32 : i32
+    %off_n_s = tt.splat %off_n : i32 -> tensor<64xi32>
+    %offs_bn = arith.addi %off_n_s, %range64 : tensor<64xi32>
+    %offs_k = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+    %top_k_s = tt.splat %top_k : i32 -> tensor<64xi32>
+    %a_rows = arith.divsi %offs_token, %top_k_s : tensor<64xi32>
+    %a_rows_e = tt.expand_dims %a_rows {axis = 1 : i32} : tensor<64xi32> -> tensor<64x1xi32>
+    %sam = tt.splat %stride_am : i32 -> tensor<64x1xi32>
+    %a_row_off = arith.muli %a_rows_e, %sam : tensor<64x1xi32>
+    %a_row_b = tt.broadcast %a_row_off : tensor<64x1xi32> -> tensor<64x32xi32>
+    %offs_k_r = tt.expand_dims %offs_k {axis = 0 : i32} : tensor<32xi32> -> tensor<1x32xi32>
+    %offs_k_rb = tt.broadcast %offs_k_r : tensor<1x32xi32> -> tensor<64x32xi32>
+    %a_offs = arith.addi %a_row_b, %offs_k_rb : tensor<64x32xi32>
+    %a_base = tt.splat %a_ptr : !tt.ptr<f16> -> tensor<64x32x!tt.ptr<f16>>
+    %a_ptrs = tt.addptr %a_base, %a_offs : tensor<64x32x!tt.ptr<f16>>, tensor<64x32xi32>
+    %expert_off = arith.muli %expert, %stride_be : i32
+    %b_expert = tt.addptr %b_ptr, %expert_off : !tt.ptr<f16>, i32
+    %offs_k_c = tt.expand_dims %offs_k {axis = 1 : i32} : tensor<32xi32> -> tensor<32x1xi32>
+    %sbk = tt.splat %stride_bk : i32 -> tensor<32x1xi32>
+    %b_row = arith.muli %offs_k_c, %sbk : tensor<32x1xi32>
+    %b_row_b = tt.broadcast %b_row : tensor<32x1xi32> -> tensor<32x64xi32>
+    %offs_bn_r = tt.expand_dims %offs_bn {axis = 0 : i32} : tensor<64xi32> -> tensor<1x64xi32>
+    %offs_bn_rb = tt.broadcast %offs_bn_r : tensor<1x64xi32> -> tensor<32x64xi32>
+    %b_offs = arith.addi %b_row_b, %offs_bn_rb : tensor<32x64xi32>
+    %b_base = tt.splat %b_expert : !tt.ptr<f16> -> tensor<32x64x!tt.ptr<f16>>
+    %b_ptrs = tt.addptr %b_base, %b_offs : tensor<32x64x!tt.ptr<f16>>, tensor<32x64xi32>
+    %b_step_s = arith.muli %stride_bk, %c32_i32 : i32
+    %b_step = tt.splat %b_step_s : i32 -> tensor<32x64xi32>
+    %token_mask_e = tt.expand_dims %token_mask {axis = 1 : i32} : tensor<64xi1> -> tensor<64x1xi1>
+    %token_mask_b = tt.broadcast %token_mask_e : tensor<64x1xi1> -> tensor<64x32xi1>
+    %k_plus = arith.addi %K, %c31_i32 : i32
+    %k_tiles = arith.divsi %k_plus, %c32_i32 : i32
+    %acc:3 = scf.for %kt = %c0_i32 to %k_tiles step %c1_i32 iter_args(%acc_i = %zero, %a_i = %a_ptrs, %b_i = %b_ptrs) -> (tensor<64x64xf32>, tensor<64x32x!tt.ptr<f16>>, tensor<32x64x!tt.ptr<f16>>)  : i32 {
+      %k_off = arith.muli %kt, %c32_i32 : i32
+      %k_left = arith.subi %K, %k_off : i32
+      %k_left_r = tt.splat %k_left : i32 -> tensor<1x32xi32>
+      %a_k_mask = arith.cmpi slt, %offs_k_r, %k_left_r : tensor<1x32xi32>
+      %a_k_mask_b = tt.broadcast %a_k_mask : tensor<1x32xi1> -> tensor<64x32xi1>
+      %a_mask = arith.andi %token_mask_b, %a_k_mask_b : tensor<64x32xi1>
+      %a = tt.load %a_i, %a_mask, %a_other : tensor<64x32x!tt.ptr<f16>>
+      %k_left_c = tt.splat %k_left : i32 -> tensor<32x1xi32>
+      %b_k_mask = arith.cmpi slt, %offs_k_c, %k_left_c : tensor<32x1xi32>
+      %b_mask = tt.broadcast %b_k_mask : tensor<32x1xi1> -> tensor<32x64xi1>
+      %b = tt.load %b_i, %b_mask, %b_other : tensor<32x64x!tt.ptr<f16>>
+      %acc_n = tt.dot %a, %b, %acc_i : tensor<64x32xf16> * tensor<32x64xf16> -> tensor<64x64xf32>
+      %a_n = tt.addptr %a_i, %a_step : tensor<64x32x!tt.ptr<f16>>, tensor<64x32xi32>
+      %b_n = tt.addptr %b_i, %b_step : tensor<32x64x!tt.ptr<f16>>, tensor<32x64xi32>
+      scf.yield %acc_n, %a_n, %b_n : tensor<64x64xf32>, tensor<64x32x!tt.ptr<f16>>, tensor<32x64x!tt.ptr<f16>>
+    }
+    %w_base = tt.splat %topk_weights_ptr : !tt.ptr<f32> -> tensor<64x!tt.ptr<f32>>
+    %w_ptrs = tt.addptr %w_base, %offs_token : tensor<64x!tt.ptr<f32>>, tensor<64xi32>
+    %w = tt.load %w_ptrs, %token_mask, %w_other : tensor<64x!tt.ptr<f32>>
+    %w_e = tt.expand_dims %w {axis = 1 : i32} : tensor<64xf32> -> tensor<64x1xf32>
+    %w_b = tt.broadcast %w_e : tensor<64x1xf32> -> tensor<64x64xf32>
+    %acc_w = arith.mulf %acc#0, %w_b : tensor<64x64xf32>
+    %c = arith.truncf %acc_w : tensor<64x64xf32> to tensor<64x64xf16>
+    %offs_token_e = tt.expand_dims %offs_token {axis = 1 : i32} : tensor<64xi32> -> tensor<64x1xi32>
+    %scm = tt.splat %stride_cm : i32 -> tensor<64x1xi32>
+    %c_row = arith.muli %offs_token_e, %scm : tensor<64x1xi32>
+    %c_row_b = tt.broadcast %c_row : tensor<64x1xi32> -> tensor<64x64xi32>
+    %offs_bn_cb = tt.broadcast %offs_bn_r : tensor<1x64xi32> -> tensor<64x64xi32>
+    %c_offs = arith.addi %c_row_b, %offs_bn_cb : tensor<64x64xi32>
+    %c_base = tt.splat %c_ptr : !tt.ptr<f16> -> tensor<64x64x!tt.ptr<f16>>
+    %c_ptrs = tt.addptr %c_base, %c_offs : tensor<64x64x!tt.ptr<f16>>, tensor<64x64xi32>
+    %N_s = tt.splat %N : i32 -> tensor<1x64xi32>
+    %n_mask = arith.cmpi slt, %offs_bn_r, %N_s : tensor<1x64xi32>
+    %n_mask_b = tt.broadcast %n_mask : tensor<1x64xi1> -> tensor<64x64xi1>
+    %token_mask_cb = tt.broadcast %token_mask_e : tensor<64x1xi1> -> tensor<64x64xi1>
+    %c_mask = arith.andi %token_mask_cb, %n_mask_b : tensor<64x64xi1>
+    tt.store %c_ptrs, %c, %c_mask : tensor<64x64x!tt.ptr<f16>>
+    tt.return
+  }
+}
@@ -0,0 +1,29 @@
+// RUN: triton-compile-bench %S/Inputs/layernorm.mlir --targets=cuda:80,hip:gfx942 --num-stages=2 | FileCheck %s
+
+// CHECK: "kernels": [
+// CHECK:      "name": "layernorm",
+// CHECK:      "target": "cuda:80",
+// CHECK-NEXT: "num_warps": 8,
+// CHECK-NEXT: "num_stages": 2,
+// CHECK-NEXT: "num_ctas": 1,
+// CHECK-NOT:  "error"
+// CHECK:      "stages": [
+// CHECK:      "name": "ttir",
+// CHECK-NEXT: "wall_ms":
+// CHECK-NEXT: "peak_rss_kb":
+// CHECK-NEXT: "ir_bytes":
+// CHECK-NEXT: "ir_ops":
+// CHECK-NEXT: "passes": [
+// CHECK:      "name": "inline",
+// CHECK:      "name": "ttgir",
+// CHECK:      "name": "convert-triton-to-tritongpu",
+// CHECK:      "name": "llir",
+// CHECK:      "name": "convert-triton-gpu-to-llvm",
+// CHECK:      "name": "translate-to-llvmir",
+// CHECK:      "name": "InstCombinePass",
+// CHECK:      "name": "ptx",
+// CHECK:      "name": "codegen",
+// CHECK:      "target": "hip:gfx942",
+// CHECK-NOT:  "error"
+// CHECK:      "name": "amdgcn",
+// CHECK:      "name": "codegen",
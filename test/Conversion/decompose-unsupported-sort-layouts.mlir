@@ -0,0 +1,50 @@
+// RUN: triton-opt %s --split-input-file --decompose-unsupported-nvidia-conversions | FileCheck %s
+
+// The sorted axis is split across the CTAs, which the sorting network does not
+// support: sort in a layout that replicates the axis in every CTA instead.
+
+// CHECK-DAG: #[[$SPLIT:.+]] = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [2], CTAOrder = [0]}>
+// CHECK-DAG: #[[$WHOLE:.+]] = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [1], CTAOrder = [0]}>
+// CHECK-LABEL: sort_split_across_ctas
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [2], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 2 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @sort_split_across_ctas(%arg0: tensor<256xf32, #blocked>, %arg1: tensor<256xi32, #blocked>) -> (tensor<256xf32, #blocked>, tensor<8xi32, #blocked>) {
+    // CHECK: %[[SRC:.+]] = triton_gpu.convert_layout %arg0 : tensor<256xf32, #[[$SPLIT]]> -> tensor<256xf32, #[[$WHOLE]]>
+    // CHECK: %[[SORT:.+]] = "tt.sort"(%[[SRC]])
+    // CHECK: arith.cmpf olt
+    // CHECK: (tensor<256xf32, #[[$WHOLE]]>) -> tensor<256xf32, #[[$WHOLE]]>
+    // CHECK: triton_gpu.convert_layout %[[SORT]] : tensor<256xf32, #[[$WHOLE]]> -> tensor<256xf32, #[[$SPLIT]]>
+    %0 = "tt.sort"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%lhs: f32, %rhs: f32):
+      %lt = arith.cmpf olt, %lhs, %rhs : f32
+      tt.sort.return %lt : i1
+    }) : (tensor<256xf32, #blocked>) -> tensor<256xf32, #blocked>
+    // CHECK: %[[TOPK:.+]] = "tt.topk"(%{{.+}}) <{axis = 0 : i32, k = 8 : i32}>
+    // CHECK: (tensor<256xi32, #[[$WHOLE]]>) -> tensor<8xi32, #[[$WHOLE]]>
+    // CHECK: triton_gpu.convert_layout %[[TOPK]] : tensor<8xi32, #[[$WHOLE]]> -> tensor<8xi32, #[[$SPLIT]]>
+    %1 = "tt.topk"(%arg1) <{axis = 0 : i32, k = 8 : i32}> ({
+    ^bb0(%lhs: i32, %rhs: i32):
+      %gt = arith.cmpi sgt, %lhs, %rhs : i32
+      tt.sort.return %gt : i1
+    }) : (tensor<256xi32, #blocked>) -> tensor<8xi32, #blocked>
+    tt.return %0, %1 : tensor<256xf32, #blocked>, tensor<8xi32, #blocked>
+  }
+}
+
+// -----
+
+// CHECK-LABEL: sort_supported_layout
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @sort_supported_layout(%arg0: tensor<256xf32, #blocked>) -> tensor<256xf32, #blocked> {
+    // CHECK-NOT: triton_gpu.convert_layout
+    // CHECK: "tt.sort"(%arg0)
+    // CHECK-NOT: triton_gpu.convert_layout
+    %0 = "tt.sort"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%lhs: f32, %rhs: f32):
+      %lt = arith.cmpf olt, %lhs, %rhs : f32
+      tt.sort.return %lt : i1
+    }) : (tensor<256xf32, #blocked>) -> tensor<256xf32, #blocked>
+    tt.return %0 : tensor<256xf32, #blocked>
+  }
+}
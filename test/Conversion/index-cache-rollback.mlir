@@ -0,0 +1,19 @@
+// RUN: triton-opt %s --test-index-cache-rollback | FileCheck %s
+
+// A pattern that requests indices and then fails has the hoisted index math
+// rolled back; the lowering that follows re-emits it once for the function
+// instead of reusing the erased values.
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: make_range_after_failed_pattern
+  tt.func @make_range_after_failed_pattern() -> (tensor<128xi32, #blocked>, tensor<128xi32, #blocked>) {
+    // CHECK: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: tt.make_range
+    // CHECK: tt.return
+    %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32, #blocked>
+    %1 = tt.make_range {end = 256 : i32, start = 128 : i32} : tensor<128xi32, #blocked>
+    tt.return %0, %1 : tensor<128xi32, #blocked>, tensor<128xi32, #blocked>
+  }
+}
@@ -1221,12 +1221,34 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
   // CHECK-LABEL: test_index_cache
   tt.func @test_index_cache() {
     // CHECK: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    // CHECK: llvm.return
     %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked0>
     %1 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked0>
     tt.return
   }
 }
 
+// -----
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: test_index_cache_across_blocks
+  tt.func @test_index_cache_across_blocks(%arg0: i1) {
+    // CHECK: nvvm.read.ptx.sreg.tid.x
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    // CHECK: llvm.cond_br
+    // CHECK-NOT: nvvm.read.ptx.sreg.tid.x
+    // CHECK: llvm.return
+    cf.cond_br %arg0, ^bb1, ^bb2
+    ^bb1:  // pred: ^bb0
+      %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked0>
+      cf.br ^bb2
+    ^bb2:  // 2 preds: ^bb0, ^bb1
+      %1 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked0>
+      tt.return
+  }
+}
+
 // -----
 #blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 8], threadsPerWarp = [8, 4], warpsPerCTA = [8, 1], order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
 #shared0 = #triton_gpu.shared<{vec = 8, perPhase = 2, maxPhase = 4, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
@@ -1739,3 +1761,196 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
 #loc3 = loc("inner_call":29:28)
 #loc4 = loc(callsite(#loc3 at #loc1))
 #loc5 = loc(callsite(#loc4 at #loc2))
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: sort_warp_synchronous
+  tt.func @sort_warp_synchronous(%arg0: tensor<64xf32, #blocked>) {
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK: llvm.fcmp "olt"
+    // CHECK: nvvm.shfl.sync bfly
+    // CHECK: llvm.fcmp "olt"
+    // CHECK-NOT: nvvm.barrier0
+    %0 = "tt.sort"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%lhs: f32, %rhs: f32):
+      %lt = arith.cmpf olt, %lhs, %rhs : f32
+      tt.sort.return %lt : i1
+    }) : (tensor<64xf32, #blocked>) -> tensor<64xf32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: sort_across_warps
+  tt.func @sort_across_warps(%arg0: tensor<128xi32, #blocked>) {
+    // CHECK: nvvm.shfl.sync bfly
+    // CHECK: st.shared
+    // CHECK: nvvm.barrier0
+    // CHECK: ld.shared
+    // CHECK: nvvm.barrier0
+    // CHECK: llvm.icmp "slt"
+    %0 = "tt.sort"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%lhs: i32, %rhs: i32):
+      %lt = arith.cmpi slt, %lhs, %rhs : i32
+      tt.sort.return %lt : i1
+    }) : (tensor<128xi32, #blocked>) -> tensor<128xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [32, 1], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: gather_thread_local
+  tt.func @gather_thread_local(%src: tensor<128x4xf32, #blocked>, %idx: tensor<128x4xi32, #blocked>) -> tensor<128x4xf32, #blocked> {
+    // CHECK-NOT: nvvm.shfl.sync
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK: llvm.icmp "eq"
+    // CHECK: llvm.select
+    %0 = tt.gather %src[%idx] {axis = 1 : i32} : (tensor<128x4xf32, #blocked>, tensor<128x4xi32, #blocked>) -> tensor<128x4xf32, #blocked>
+    tt.return %0 : tensor<128x4xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: gather_warp_local
+  tt.func @gather_warp_local(%src: tensor<16x8xf32, #blocked>, %idx: tensor<16x8xi32, #blocked>) -> tensor<16x8xf32, #blocked> {
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK: nvvm.shfl.sync idx
+    // CHECK-NOT: nvvm.barrier0
+    %0 = tt.gather %src[%idx] {axis = 1 : i32} : (tensor<16x8xf32, #blocked>, tensor<16x8xi32, #blocked>) -> tensor<16x8xf32, #blocked>
+    tt.return %0 : tensor<16x8xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: gather_shared_memory
+  tt.func @gather_shared_memory(%src: tensor<128xf32, #blocked>, %idx: tensor<128xi32, #blocked>) -> tensor<128xf32, #blocked> {
+    // CHECK-NOT: nvvm.shfl.sync
+    // CHECK: st.shared
+    // CHECK: nvvm.barrier0
+    // CHECK: ld.shared
+    %0 = tt.gather %src[%idx] {axis = 0 : i32} : (tensor<128xf32, #blocked>, tensor<128xi32, #blocked>) -> tensor<128xf32, #blocked>
+    tt.return %0 : tensor<128xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [8], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 8 : i32} {
+  // CHECK-LABEL: gather_shared_memory_i8_index
+  tt.func @gather_shared_memory_i8_index(%src: tensor<256xf32, #blocked>, %idx: tensor<256xi8, #blocked>) -> tensor<256xf32, #blocked> {
+    // CHECK-NOT: llvm.sext
+    // CHECK: llvm.zext %{{.*}} : i8 to i32
+    // CHECK-NOT: llvm.sext
+    // CHECK: ld.shared
+    %0 = tt.gather %src[%idx] {axis = 0 : i32} : (tensor<256xf32, #blocked>, tensor<256xi8, #blocked>) -> tensor<256xf32, #blocked>
+    tt.return %0 : tensor<256xf32, #blocked>
+  }
+}
+
+// -----
+
+// With few bins the histogram is computed with warp ballots, whose cost grows
+// with the number of bins; with many bins every warp updates a private
+// histogram with one atomic per element, and the private histograms are merged
+// in log2(num-warps) steps.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: histogram_warp_ballot
+  tt.func @histogram_warp_ballot(%arg0: tensor<128xi32, #blocked>) {
+    // CHECK-COUNT-5: nvvm.vote.ballot.sync
+    // CHECK: llvm.intr.ctpop
+    // CHECK: llvm.atomicrmw add
+    // CHECK-NOT: llvm.atomicrmw
+    // CHECK: llvm.return
+    %0 = tt.histogram %arg0 : tensor<128xi32, #blocked> -> tensor<32xi32, #blocked>
+    tt.return
+  }
+
+  // CHECK-LABEL: histogram_privatized
+  tt.func @histogram_privatized(%arg0: tensor<512xi32, #blocked>) {
+    // CHECK-NOT: nvvm.vote.ballot.sync
+    // CHECK: nvvm.barrier0
+    // CHECK-COUNT-4: llvm.atomicrmw add
+    // CHECK-NOT: llvm.atomicrmw
+    // CHECK: nvvm.barrier0
+    // CHECK: nvvm.barrier0
+    // CHECK: nvvm.barrier0
+    // CHECK: llvm.return
+    %0 = tt.histogram %arg0 : tensor<512xi32, #blocked> -> tensor<1024xi32, #blocked>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 2], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  // CHECK-LABEL: int4_to_fp_scaled
+  tt.func @int4_to_fp_scaled(%arg0: tensor<4x64xi8, #blocked>, %arg1: tensor<4x128xf16, #blocked1>) {
+    // CHECK: llvm.mlir.constant(1.032000e+03 : f16) : f16
+    // CHECK: llvm.zext %{{.*}} : i8 to i32
+    // CHECK: llvm.mlir.constant(1678271496 : i32) : i32
+    // CHECK: llvm.xor
+    // CHECK: llvm.bitcast %{{.*}} : i32 to vector<2xf16>
+    // CHECK: llvm.fsub %{{.*}} : vector<2xf16>
+    // CHECK: llvm.fmul %{{.*}} : vector<2xf16>
+    %0 = tt.int4_to_fp %arg0, scale = %arg1 {axis = 1 : i32, is_signed = true} : tensor<4x64xi8, #blocked>, tensor<4x128xf16, #blocked1> -> tensor<4x128xf16, #blocked1>
+    tt.return
+  }
+
+  // CHECK-LABEL: uint4_to_bf16
+  tt.func @uint4_to_bf16(%arg0: tensor<4x64xi8, #blocked>) {
+    // CHECK: llvm.mlir.constant(1.280000e+02 : bf16) : bf16
+    // CHECK: llvm.mlir.constant(1124090624 : i32) : i32
+    // CHECK: llvm.or
+    // CHECK: llvm.bitcast %{{.*}} : i32 to vector<2xbf16>
+    // CHECK: llvm.fsub %{{.*}} : vector<2xbf16>
+    // CHECK-NOT: llvm.fmul
+    %0 = tt.int4_to_fp %arg0 {axis = 1 : i32, is_signed = false} : tensor<4x64xi8, #blocked> -> tensor<4x128xbf16, #blocked1>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [1], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 : i32} {
+  // CHECK-LABEL: topk_warp_synchronous
+  tt.func @topk_warp_synchronous(%arg0: tensor<64xf32, #blocked>) -> tensor<8xf32, #blocked> {
+    // The sort itself stays within the warp.
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK: llvm.fcmp "ogt"
+    // CHECK: nvvm.shfl.sync bfly
+    // CHECK: llvm.fcmp "ogt"
+    // The sorted values are written back once and the leading 8 read in the
+    // result layout.
+    // CHECK-COUNT-2: st.shared
+    // CHECK-NOT: st.shared
+    // CHECK: nvvm.barrier0
+    // CHECK-NOT: nvvm.shfl.sync
+    // CHECK: ld.shared
+    // CHECK: llvm.return
+    %0 = "tt.topk"(%arg0) <{axis = 0 : i32, k = 8 : i32}> ({
+    ^bb0(%lhs: f32, %rhs: f32):
+      %gt = arith.cmpf ogt, %lhs, %rhs : f32
+      tt.sort.return %gt : i1
+    }) : (tensor<64xf32, #blocked>) -> tensor<8xf32, #blocked>
+    tt.return %0 : tensor<8xf32, #blocked>
+  }
+}
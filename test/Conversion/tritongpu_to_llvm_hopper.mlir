@@ -279,3 +279,51 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 1 :
     tt.return
   }
 }
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [4], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [2], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 2 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: cross_cta_reduce
+  tt.func public @cross_cta_reduce(%arg0: tensor<2048xf32, #blocked>) {
+    // CHECK: nvgpu.cluster_arrive {relaxed = false}
+    // CHECK-NEXT: nvgpu.cluster_wait
+    // CHECK: nvgpu.cluster_id
+    // CHECK: mapa.shared::cluster.u32
+    // CHECK: ld.shared::cluster.b32
+    // CHECK: mapa.shared::cluster.u32
+    // CHECK: ld.shared::cluster.b32
+    // CHECK: llvm.fadd
+    // CHECK: nvgpu.cluster_arrive {relaxed = false}
+    // CHECK-NEXT: nvgpu.cluster_wait
+    %0 = "tt.reduce"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %1 : f32
+    }) : (tensor<2048xf32, #blocked>) -> f32
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32, "triton_gpu.num-warp-groups-per-cta" = 2 : i32} {
+  // In a warp-specialized kernel the barriers of a lowering synchronize the
+  // warp group running it, through named barrier 1 + warp group id.
+  // CHECK-LABEL: warp_specialized_barriers
+  tt.func public @warp_specialized_barriers(%arg0: tensor<512xf32, #blocked>) {
+    // CHECK: bar.sync 0, 256;
+    gpu.barrier {bar_id = 0 : i32, num_threads = 256 : i32}
+    // CHECK-NOT: nvvm.barrier0
+    // CHECK: llvm.udiv %{{.*}}, %{{.*}} : i32
+    // CHECK: "bar.sync $0, 128;", "r"
+    // CHECK-NOT: nvvm.barrier0
+    %0 = "tt.reduce"(%arg0) <{axis = 0 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %1 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %1 : f32
+    }) : (tensor<512xf32, #blocked>) -> f32
+    tt.return
+  }
+}
@@ -6,6 +6,8 @@
 
 // RUN: triton-tensor-layout -i %s -alias-names="mfma" -t "tensor<16x16xf16>" -use-hw-view | FileCheck %s --check-prefix=CHECK-HW
 
+// RUN: triton-tensor-layout -i %s -alias-names="blocked" -t "tensor<16x16xf16>" -shared-layout "#triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0]}>" | FileCheck %s --check-prefix=CHECK-SHARED
+
 #blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
 #mfma = #triton_gpu.amd_mfma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [4, 1], instrShape = [16, 16], isTransposed = true}>
 tt.func @print(%A : !tt.ptr<f16>) {
@@ -56,3 +58,7 @@ tt.func @print(%A : !tt.ptr<f16>) {
 // CHECK-HW: Warp1:
 // CHECK-HW: Warp2:
 // CHECK-HW: Warp3:
+
+
+// CHECK-SHARED: Print layout attribute: #blocked
+// CHECK-SHARED: Bank conflicts with #triton_gpu.shared<{{.*}}>: at worst 1-way, on average 1.00-way over 1 accesses of 4 elements per thread
@@ -145,6 +145,42 @@ tt.func public @fn(%v1: tensor<4x128xf32>, %v2: tensor<4x128xi64>) {
 
 // -----
 
+tt.func public @fn(%v: tensor<4x96xf32>) {
+    // expected-error @+1 {{size of the sorted axis must be a power of 2}}
+    %a = "tt.sort" (%v) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %lt = arith.cmpf olt, %arg0, %arg1 : f32
+      tt.sort.return %lt : i1
+    }) {axis = 1 : i32}  : (tensor<4x96xf32>) -> tensor<4x96xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @fn(%v: tensor<4x128xf32>) {
+    // expected-error @+1 {{nested block must take 2 arguments}}
+    %a = "tt.sort" (%v) ({
+    ^bb0(%arg0: f32):
+      %true = arith.constant true
+      tt.sort.return %true : i1
+    }) {axis = 1 : i32}  : (tensor<4x128xf32>) -> tensor<4x128xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @fn(%v: tensor<4x128xf32>) {
+    // expected-error @+1 {{k must be a power of 2}}
+    %a = "tt.topk" (%v) ({
+    ^bb0(%arg0: f32, %arg1: f32):
+      %gt = arith.cmpf ogt, %arg0, %arg1 : f32
+      tt.sort.return %gt : i1
+    }) {axis = 1 : i32, k = 3 : i32}  : (tensor<4x128xf32>) -> tensor<4x3xf32>
+    tt.return
+}
+
+// -----
+
 tt.func public @fn(%v1: tensor<4x128xf32>, %v2: tensor<4x128xi64>) {
     // expected-error @+1 {{operand types and result types}}
     %a, %b = "tt.reduce" (%v1, %v2) ({
@@ -352,3 +388,19 @@ tt.func public @fn(%arg0: tensor<16x32x64xf32, #shared>) {
     tt.return
 }
 }  // end module
+
+// -----
+
+tt.func public @fn(%src: tensor<4x8xf32>, %idx: tensor<8xi32>) {
+    // expected-error @+1 {{indices must have the same rank as the source}}
+    %0 = tt.gather %src[%idx] {axis = 0 : i32} : (tensor<4x8xf32>, tensor<8xi32>) -> tensor<8xf32>
+    tt.return
+}
+
+// -----
+
+tt.func public @fn(%src: tensor<4x8xf32>, %idx: tensor<8x16xi32>) {
+    // expected-error @+1 {{indices and source must have the same size on dimension 0}}
+    %0 = tt.gather %src[%idx] {axis = 1 : i32} : (tensor<4x8xf32>, tensor<8x16xi32>) -> tensor<8x16xf32>
+    tt.return
+}
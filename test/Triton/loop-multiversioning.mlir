@@ -0,0 +1,99 @@
+// RUN: triton-opt --split-input-file %s -triton-loop-multiversioning | FileCheck %s
+
+// CHECK-LABEL: @version_loop
+// CHECK-DAG: %[[PTR:.*]] = tt.ptr_to_int %arg0 : !tt.ptr<f32> -> i64
+// CHECK-DAG: arith.andi %[[PTR]], %{{.*}} : i64
+// CHECK-DAG: arith.andi %arg2, %{{.*}} : i32
+// CHECK-NOT: tt.ptr_to_int %arg1
+// CHECK-NOT: arith.andi %arg3
+// CHECK: %[[RES:.*]] = scf.if %{{.*}} -> (tensor<128xf32>) {
+// CHECK-DAG:   %[[ALIGNED:.*]] = tt.addptr %arg0, %{{.*}} {tt.divisibility = dense<16> : tensor<1xi32>} : !tt.ptr<f32>, i32
+// CHECK-DAG:   %[[Q:.*]] = arith.divsi %arg2, %{{.*}} : i32
+// CHECK-DAG:   %[[STRIDE:.*]] = arith.muli %[[Q]], %{{.*}} : i32
+// CHECK:       tt.splat %[[STRIDE]] : i32 -> tensor<128xi32>
+// CHECK:       tt.splat %[[ALIGNED]] : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+// CHECK-NOT:   arith.divsi %arg3
+// CHECK:       scf.for %{{.*}} = %{{.*}} to %arg3
+// CHECK:         tt.load
+// CHECK:       scf.yield
+// CHECK: } else {
+// CHECK:       scf.for %{{.*}} = %{{.*}} to %arg3
+// CHECK:         tt.load
+// CHECK:       scf.yield
+// CHECK: }
+// CHECK: tt.store %{{.*}}, %[[RES]]
+tt.func public @version_loop(%arg0: !tt.ptr<f32>, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg2: i32, %arg3: i32) {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<128xf32>
+  %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %1 = tt.splat %arg2 : i32 -> tensor<128xi32>
+  %2 = arith.muli %0, %1 : tensor<128xi32>
+  %3 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+  %4 = tt.addptr %3, %2 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  %5 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+  %6 = tt.addptr %5, %0 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  %7 = scf.for %arg4 = %c0_i32 to %arg3 step %c1_i32 iter_args(%arg5 = %cst) -> (tensor<128xf32>)  : i32 {
+    %8 = tt.load %4 : tensor<128x!tt.ptr<f32>>
+    %9 = arith.addf %arg5, %8 : tensor<128xf32>
+    scf.yield %9 : tensor<128xf32>
+  }
+  tt.store %6, %7 : tensor<128x!tt.ptr<f32>>
+  tt.return
+}
+
+// -----
+
+// Arguments already known to be aligned need no runtime check.
+// CHECK-LABEL: @aligned_args
+// CHECK-NOT: scf.if
+tt.func public @aligned_args(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: i32 {tt.divisibility = 16 : i32}) {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %cst = arith.constant dense<1.000000e+00> : tensor<128xf32>
+  %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+  %2 = tt.addptr %1, %0 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  scf.for %arg2 = %c0_i32 to %arg1 step %c1_i32  : i32 {
+    tt.store %2, %cst : tensor<128x!tt.ptr<f32>>
+  }
+  tt.return
+}
+
+// -----
+
+// A pointer advanced through iter_args is traced back to its init value and
+// to the stride it is advanced by. The loop bound is not address arithmetic
+// and stays unchecked.
+// CHECK-LABEL: @loop_carried_pointer
+// CHECK-DAG: %[[PTR:.*]] = tt.ptr_to_int %arg0 : !tt.ptr<f32> -> i64
+// CHECK-DAG: arith.andi %[[PTR]], %{{.*}} : i64
+// CHECK-DAG: arith.andi %arg1, %{{.*}} : i32
+// CHECK-NOT: arith.andi %arg2
+// CHECK: scf.if %{{.*}} -> (tensor<128x!tt.ptr<f32>>) {
+// CHECK-DAG:   %[[ALIGNED:.*]] = tt.addptr %arg0, %{{.*}} {tt.divisibility = dense<16> : tensor<1xi32>} : !tt.ptr<f32>, i32
+// CHECK-DAG:   %[[Q:.*]] = arith.divsi %arg1, %{{.*}} : i32
+// CHECK-DAG:   %[[STRIDE:.*]] = arith.muli %[[Q]], %{{.*}} : i32
+// CHECK:       tt.splat %[[ALIGNED]] : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+// CHECK:       tt.splat %[[STRIDE]] : i32 -> tensor<128xi32>
+// CHECK:       scf.for %{{.*}} = %{{.*}} to %arg2
+// CHECK:         tt.store
+// CHECK: } else {
+// CHECK:       scf.for %{{.*}} = %{{.*}} to %arg2
+// CHECK:         tt.store
+// CHECK: }
+tt.func public @loop_carried_pointer(%arg0: !tt.ptr<f32>, %arg1: i32, %arg2: i32) {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %cst = arith.constant dense<1.000000e+00> : tensor<128xf32>
+  %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32>
+  %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x!tt.ptr<f32>>
+  %2 = tt.addptr %1, %0 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+  %3 = tt.splat %arg1 : i32 -> tensor<128xi32>
+  %4 = scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32 iter_args(%arg4 = %2) -> (tensor<128x!tt.ptr<f32>>)  : i32 {
+    tt.store %arg4, %cst : tensor<128x!tt.ptr<f32>>
+    %5 = tt.addptr %arg4, %3 : tensor<128x!tt.ptr<f32>>, tensor<128xi32>
+    scf.yield %5 : tensor<128x!tt.ptr<f32>>
+  }
+  tt.return
+}
@@ -0,0 +1,92 @@
+// RUN: triton-opt --split-input-file %s -triton-loop-peeling | FileCheck %s
+
+// A K loop in the style of the matmul tutorial: `offs < K - k * 32` holds for
+// every element while k < K / 32.
+// CHECK-LABEL: @peel_k_loop
+// CHECK: %[[SUM:.*]] = arith.addi %{{.*}}, %arg1 : i32
+// CHECK: %[[BOUND:.*]] = arith.ceildivsi %[[SUM]], %{{.*}} : i32
+// CHECK: %[[MIN:.*]] = arith.minsi %[[BOUND]], %{{.*}} : i32
+// CHECK: %[[SPLIT:.*]] = arith.maxsi %[[MIN]], %{{.*}} : i32
+// CHECK: %[[MAIN:.*]]:2 = scf.for %{{.*}} = %{{.*}} to %[[SPLIT]] step
+// CHECK:   tt.load %{{[a-z0-9_]+}} : tensor<32x!tt.ptr<f32>>
+// CHECK: scf.for %{{.*}} = %[[SPLIT]] to %{{.*}} step %{{.*}} iter_args(%{{.*}} = %[[MAIN]]#0, %{{.*}} = %[[MAIN]]#1)
+// CHECK:   tt.load %{{.*}}, %{{.*}}, %{{.*}} : tensor<32x!tt.ptr<f32>>
+// CHECK: } {tt.num_stages = 1 : i32}
+tt.func @peel_k_loop(%arg0: !tt.ptr<f32>, %arg1: i32) -> tensor<32xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c32_i32 = arith.constant 32 : i32
+  %cst = arith.constant dense<0.000000e+00> : tensor<32xf32>
+  %cst_0 = arith.constant dense<32> : tensor<32xi32>
+  %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<32x!tt.ptr<f32>>
+  %2 = tt.addptr %1, %0 : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+  %3 = arith.addi %arg1, %c32_i32 : i32
+  %4 = arith.subi %3, %c1_i32 : i32
+  %5 = arith.divsi %4, %c32_i32 : i32
+  %6:2 = scf.for %arg2 = %c0_i32 to %5 step %c1_i32 iter_args(%arg3 = %cst, %arg4 = %2) -> (tensor<32xf32>, tensor<32x!tt.ptr<f32>>)  : i32 {
+    %7 = arith.muli %arg2, %c32_i32 : i32
+    %8 = arith.subi %arg1, %7 : i32
+    %9 = tt.splat %8 : i32 -> tensor<32xi32>
+    %10 = arith.cmpi slt, %0, %9 : tensor<32xi32>
+    %11 = tt.load %arg4, %10, %cst : tensor<32x!tt.ptr<f32>>
+    %12 = arith.addf %arg3, %11 : tensor<32xf32>
+    %13 = tt.addptr %arg4, %cst_0 : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+    scf.yield %12, %13 : tensor<32xf32>, tensor<32x!tt.ptr<f32>>
+  } {tt.num_stages = 3 : i32}
+  tt.return %6#0 : tensor<32xf32>
+}
+
+// -----
+
+// The bound of `k + offs < N` is N - 31; a dynamic step rounds the split up
+// to the next iteration of the loop.
+// CHECK-LABEL: @peel_store_dynamic_step
+// CHECK: %[[SUM:.*]] = arith.addi %{{.*}}, %arg1 : i32
+// CHECK: %[[MIN:.*]] = arith.minsi %[[SUM]], %arg1 : i32
+// CHECK: %[[CLAMPED:.*]] = arith.maxsi %[[MIN]], %{{.*}} : i32
+// CHECK: %[[DIST:.*]] = arith.subi %[[CLAMPED]], %{{.*}} : i32
+// CHECK: %[[ITERS:.*]] = arith.ceildivsi %[[DIST]], %arg2 : i32
+// CHECK: %[[OFFSET:.*]] = arith.muli %[[ITERS]], %arg2 : i32
+// CHECK: %[[SPLIT:.*]] = arith.addi %{{.*}}, %[[OFFSET]] : i32
+// CHECK: scf.for %{{.*}} = %{{.*}} to %[[SPLIT]] step %arg2
+// CHECK:   tt.store %{{[a-z0-9_]+}}, %{{[a-z0-9_]+}} : tensor<32x!tt.ptr<f32>>
+// CHECK: scf.for %{{.*}} = %[[SPLIT]] to %arg1 step %arg2
+// CHECK:   tt.store %{{.*}}, %{{.*}}, %{{.*}} : tensor<32x!tt.ptr<f32>>
+tt.func @peel_store_dynamic_step(%arg0: !tt.ptr<f32>, %arg1: i32, %arg2: i32) {
+  %c0_i32 = arith.constant 0 : i32
+  %cst = arith.constant dense<1.000000e+00> : tensor<32xf32>
+  %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<32x!tt.ptr<f32>>
+  %2 = tt.splat %arg1 : i32 -> tensor<32xi32>
+  scf.for %arg3 = %c0_i32 to %arg1 step %arg2  : i32 {
+    %3 = tt.splat %arg3 : i32 -> tensor<32xi32>
+    %4 = arith.addi %3, %0 : tensor<32xi32>
+    %5 = arith.cmpi slt, %4, %2 : tensor<32xi32>
+    %6 = tt.addptr %1, %4 : tensor<32x!tt.ptr<f32>>, tensor<32xi32>
+    tt.store %6, %cst, %5 : tensor<32x!tt.ptr<f32>>
+  }
+  tt.return
+}
+
+// -----
+
+// Masks that depend on loaded data or loosen as the loop advances are kept.
+// CHECK-LABEL: @no_peel
+// CHECK: scf.for
+// CHECK-NOT: scf.for
+tt.func @no_peel(%arg0: tensor<32x!tt.ptr<i32>>, %arg1: tensor<32x!tt.ptr<f32>>, %arg2: i32) {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %cst = arith.constant dense<1.000000e+00> : tensor<32xf32>
+  %0 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32>
+  scf.for %arg3 = %c0_i32 to %arg2 step %c1_i32  : i32 {
+    %1 = tt.load %arg0 : tensor<32x!tt.ptr<i32>>
+    %2 = arith.cmpi slt, %0, %1 : tensor<32xi32>
+    tt.store %arg1, %cst, %2 : tensor<32x!tt.ptr<f32>>
+    %3 = tt.splat %arg3 : i32 -> tensor<32xi32>
+    %4 = arith.cmpi sge, %3, %0 : tensor<32xi32>
+    tt.store %arg1, %cst, %4 : tensor<32x!tt.ptr<f32>>
+  }
+  tt.return
+}
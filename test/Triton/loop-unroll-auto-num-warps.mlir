@@ -0,0 +1,31 @@
+// RUN: triton-opt %s -triton-loop-unroll=auto-unroll=true 2>&1 | FileCheck %s --check-prefix=WARPS4
+// RUN: triton-opt %s -triton-loop-unroll="auto-unroll=true num-warps=8" 2>&1 | FileCheck %s --check-prefix=WARPS8
+
+// The register budget grows with the number of warps: four copies of the body
+// only fit once the program runs eight warps.
+
+// WARPS4: remark: unrolled by 2: trip count 4, 3 ops, 45056 live bytes
+// WARPS4-LABEL: budget_scales_with_warps
+// WARPS4: scf.for
+// WARPS4-COUNT-2: tt.load
+// WARPS4-NOT: tt.load
+
+// WARPS8: remark: unrolled by 4: trip count 4, 3 ops, 77824 live bytes
+// WARPS8-LABEL: budget_scales_with_warps
+// WARPS8-COUNT-4: tt.load
+// WARPS8-NOT: tt.load
+tt.func @budget_scales_with_warps(%arg0: tensor<1024x!tt.ptr<f32>>) -> tensor<1024xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c4_i32 = arith.constant 4 : i32
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tt.splat %c1_i32 : i32 -> tensor<1024xi32>
+  %1 = tt.splat %cst : f32 -> tensor<1024xf32>
+  %2:2 = scf.for %arg1 = %c0_i32 to %c4_i32 step %c1_i32 iter_args(%arg2 = %1, %arg3 = %arg0) -> (tensor<1024xf32>, tensor<1024x!tt.ptr<f32>>)  : i32 {
+    %3 = tt.load %arg3 : tensor<1024x!tt.ptr<f32>>
+    %4 = arith.addf %arg2, %3 : tensor<1024xf32>
+    %5 = tt.addptr %arg3, %0 : tensor<1024x!tt.ptr<f32>>, tensor<1024xi32>
+    scf.yield %4, %5 : tensor<1024xf32>, tensor<1024x!tt.ptr<f32>>
+  }
+  tt.return %2#0 : tensor<1024xf32>
+}
@@ -0,0 +1,115 @@
+// RUN: triton-opt --split-input-file %s -triton-loop-unroll=auto-unroll=true -verify-diagnostics | FileCheck %s
+
+tt.func @short_constant_loop(%arg0: tensor<256x!tt.ptr<f32>>) -> tensor<256xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c4_i32 = arith.constant 4 : i32
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tt.splat %c1_i32 : i32 -> tensor<256xi32>
+  %1 = tt.splat %cst : f32 -> tensor<256xf32>
+  // Check a four-iteration loop with a small body is fully unrolled.
+  // CHECK-LABEL: short_constant_loop
+  // CHECK-COUNT-4: tt.load
+  // CHECK-NOT: tt.load
+  // expected-remark @+1 {{unrolled by 4: trip count 4, 3 ops, 19456 live bytes}}
+  %2:2 = scf.for %arg1 = %c0_i32 to %c4_i32 step %c1_i32 iter_args(%arg2 = %1, %arg3 = %arg0) -> (tensor<256xf32>, tensor<256x!tt.ptr<f32>>)  : i32 {
+    %3 = tt.load %arg3 : tensor<256x!tt.ptr<f32>>
+    %4 = arith.addf %arg2, %3 : tensor<256xf32>
+    %5 = tt.addptr %arg3, %0 : tensor<256x!tt.ptr<f32>>, tensor<256xi32>
+    scf.yield %4, %5 : tensor<256xf32>, tensor<256x!tt.ptr<f32>>
+  }
+  tt.return %2#0 : tensor<256xf32>
+}
+
+// -----
+
+tt.func @dynamic_trip_count(%arg0: tensor<256x!tt.ptr<f32>>, %arg1: i32) -> tensor<256xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tt.splat %c1_i32 : i32 -> tensor<256xi32>
+  %1 = tt.splat %cst : f32 -> tensor<256xf32>
+  // CHECK-LABEL: dynamic_trip_count
+  // CHECK: scf.for
+  // CHECK-COUNT-1: tt.load
+  // CHECK-NOT: tt.load
+  // expected-remark @+1 {{not unrolled: trip count is not a constant}}
+  %2:2 = scf.for %arg2 = %c0_i32 to %arg1 step %c1_i32 iter_args(%arg3 = %1, %arg4 = %arg0) -> (tensor<256xf32>, tensor<256x!tt.ptr<f32>>)  : i32 {
+    %3 = tt.load %arg4 : tensor<256x!tt.ptr<f32>>
+    %4 = arith.addf %arg3, %3 : tensor<256xf32>
+    %5 = tt.addptr %arg4, %0 : tensor<256x!tt.ptr<f32>>, tensor<256xi32>
+    scf.yield %4, %5 : tensor<256xf32>, tensor<256x!tt.ptr<f32>>
+  }
+  tt.return %2#0 : tensor<256xf32>
+}
+
+// -----
+
+tt.func @pipelined_loop(%arg0: tensor<256x!tt.ptr<f32>>) -> tensor<256xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c4_i32 = arith.constant 4 : i32
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tt.splat %c1_i32 : i32 -> tensor<256xi32>
+  %1 = tt.splat %cst : f32 -> tensor<256xf32>
+  // Check loops tagged for the pipeliner keep their shape.
+  // CHECK-LABEL: pipelined_loop
+  // CHECK: scf.for
+  // CHECK-COUNT-1: tt.load
+  // CHECK-NOT: tt.load
+  // expected-remark @+1 {{not unrolled: loop is tagged for software pipelining}}
+  %2:2 = scf.for %arg1 = %c0_i32 to %c4_i32 step %c1_i32 iter_args(%arg2 = %1, %arg3 = %arg0) -> (tensor<256xf32>, tensor<256x!tt.ptr<f32>>)  : i32 {
+    %3 = tt.load %arg3 : tensor<256x!tt.ptr<f32>>
+    %4 = arith.addf %arg2, %3 : tensor<256xf32>
+    %5 = tt.addptr %arg3, %0 : tensor<256x!tt.ptr<f32>>, tensor<256xi32>
+    scf.yield %4, %5 : tensor<256xf32>, tensor<256x!tt.ptr<f32>>
+  } {tt.num_stages = 3 : i32}
+  tt.return %2#0 : tensor<256xf32>
+}
+
+// -----
+
+tt.func @large_body(%arg0: tensor<8192x!tt.ptr<f32>>) -> tensor<8192xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c4_i32 = arith.constant 4 : i32
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tt.splat %c1_i32 : i32 -> tensor<8192xi32>
+  %1 = tt.splat %cst : f32 -> tensor<8192xf32>
+  // Check the register estimate blocks unrolling of large tensors.
+  // CHECK-LABEL: large_body
+  // CHECK: scf.for
+  // CHECK-COUNT-1: tt.load
+  // CHECK-NOT: tt.load
+  // expected-remark @+1 {{not unrolled: body of 3 ops and 229376 live bytes leaves no room to unroll}}
+  %2:2 = scf.for %arg1 = %c0_i32 to %c4_i32 step %c1_i32 iter_args(%arg2 = %1, %arg3 = %arg0) -> (tensor<8192xf32>, tensor<8192x!tt.ptr<f32>>)  : i32 {
+    %3 = tt.load %arg3 : tensor<8192x!tt.ptr<f32>>
+    %4 = arith.addf %arg2, %3 : tensor<8192xf32>
+    %5 = tt.addptr %arg3, %0 : tensor<8192x!tt.ptr<f32>>, tensor<8192xi32>
+    scf.yield %4, %5 : tensor<8192xf32>, tensor<8192x!tt.ptr<f32>>
+  }
+  tt.return %2#0 : tensor<8192xf32>
+}
+
+// -----
+
+tt.func @explicit_factor_wins(%arg0: tensor<256x!tt.ptr<f32>>) -> tensor<256xf32> {
+  %c0_i32 = arith.constant 0 : i32
+  %c1_i32 = arith.constant 1 : i32
+  %c4_i32 = arith.constant 4 : i32
+  %cst = arith.constant 0.000000e+00 : f32
+  %0 = tt.splat %c1_i32 : i32 -> tensor<256xi32>
+  %1 = tt.splat %cst : f32 -> tensor<256xf32>
+  // Check a user-provided factor of 1 suppresses the heuristic.
+  // CHECK-LABEL: explicit_factor_wins
+  // CHECK: scf.for
+  // CHECK-COUNT-1: tt.load
+  // CHECK-NOT: tt.load
+  %2:2 = scf.for %arg1 = %c0_i32 to %c4_i32 step %c1_i32 iter_args(%arg2 = %1, %arg3 = %arg0) -> (tensor<256xf32>, tensor<256x!tt.ptr<f32>>)  : i32 {
+    %3 = tt.load %arg3 : tensor<256x!tt.ptr<f32>>
+    %4 = arith.addf %arg2, %3 : tensor<256xf32>
+    %5 = tt.addptr %arg3, %0 : tensor<256x!tt.ptr<f32>>, tensor<256xi32>
+    scf.yield %4, %5 : tensor<256xf32>, tensor<256x!tt.ptr<f32>>
+  } {tt.loop_unroll_factor = 1 : i32}
+  tt.return %2#0 : tensor<256xf32>
+}
@@ -207,6 +207,42 @@ tt.func @scan_op(%ptr: tensor<1x2x4x!tt.ptr<f32>>, %v : tensor<1x2x4xf32>) {
   tt.return
 }
 
+// CHECK-LABEL: sort_op
+tt.func @sort_op(%v : tensor<2x4xf32>, %i : tensor<2x4xi32>) {
+  // CHECK: tt.sort
+  // CHECK-SAME: axis = 1
+  // CHECK: tt.sort.return
+  // CHECK-NEXT: (tensor<2x4xf32>, tensor<2x4xi32>) -> (tensor<2x4xf32>, tensor<2x4xi32>)
+  %a:2 = "tt.sort"(%v, %i) <{axis = 1 : i32}>({
+  ^bb0(%lhs: f32, %lhs_idx: i32, %rhs: f32, %rhs_idx: i32):
+    %lt = arith.cmpf olt, %lhs, %rhs : f32
+    tt.sort.return %lt : i1
+  }) : (tensor<2x4xf32>, tensor<2x4xi32>) -> (tensor<2x4xf32>, tensor<2x4xi32>)
+  tt.return
+}
+
+// CHECK-LABEL: topk_op
+tt.func @topk_op(%v : tensor<2x8xf32>) {
+  // CHECK: tt.topk
+  // CHECK-SAME: axis = 1
+  // CHECK-SAME: k = 2
+  // CHECK: tt.sort.return
+  // CHECK-NEXT: (tensor<2x8xf32>) -> tensor<2x2xf32>
+  %a = "tt.topk"(%v) <{axis = 1 : i32, k = 2 : i32}>({
+  ^bb0(%lhs: f32, %rhs: f32):
+    %gt = arith.cmpf ogt, %lhs, %rhs : f32
+    tt.sort.return %gt : i1
+  }) : (tensor<2x8xf32>) -> tensor<2x2xf32>
+  tt.return
+}
+
+// CHECK-LABEL: gather_op
+tt.func @gather_op(%src : tensor<4x8xf32>, %idx : tensor<4x16xi32>) -> tensor<4x16xf32> {
+  // CHECK: %[[RES:.*]] = tt.gather %arg0[%arg1] {axis = 1 : i32} : (tensor<4x8xf32>, tensor<4x16xi32>) -> tensor<4x16xf32>
+  %0 = tt.gather %src[%idx] {axis = 1 : i32} : (tensor<4x8xf32>, tensor<4x16xi32>) -> tensor<4x16xf32>
+  tt.return %0 : tensor<4x16xf32>
+}
+
 // CHECK-LABEL: inline_asm
 // CHECK: tt.elementwise_inline_asm "shl.b32 $0, $0, 3;"
 tt.func @inline_asm(%0: tensor<512xi8>) {
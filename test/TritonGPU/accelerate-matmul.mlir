@@ -182,3 +182,52 @@ module attributes {"triton_gpu.target" = "cuda:90", "triton_gpu.num-ctas" = 1 :
     tt.return %result : tensor<128x128xf32, #blocked>
   }
 }
+
+// -----
+
+// Verify that skinny-M dots are decomposed into a broadcasted multiply and a
+// reduction along K split across lanes and warps.
+// CHECK: #[[PROD:.+]] = #triton_gpu.blocked<{sizePerThread = [4, 1, 8], threadsPerWarp = [1, 32, 1], warpsPerCTA = [1, 2, 2], order = [2, 1, 0]}>
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: skinny_m_dot
+  // CHECK-NOT: triton_gpu.nvidia_mma
+  // CHECK: arith.extf {{.*}} to tensor<4x64xf32, #triton_gpu.slice<{dim = 2, parent = #[[PROD]]}>>
+  // CHECK: arith.extf {{.*}} to tensor<64x32xf32, #triton_gpu.slice<{dim = 0, parent = #[[PROD]]}>>
+  // CHECK: %[[PRODUCT:.+]] = arith.mulf {{.*}} : tensor<4x64x32xf32, #[[PROD]]>
+  // CHECK: "tt.reduce"(%[[PRODUCT]]) <{axis = 1 : i32}>
+  // CHECK: arith.addf
+  // CHECK: tt.reduce.return
+  // CHECK: arith.addf {{.*}} : tensor<4x32xf32, #triton_gpu.slice<{dim = 1, parent = #[[PROD]]}>>
+  // CHECK-NOT: tt.dot
+  tt.func @skinny_m_dot(
+    %a: tensor<4x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>)
+    -> tensor<4x32xf32, #blocked> {
+    %zero_f32 = arith.constant dense<0.000000e+00> : tensor<4x32xf32, #blocked>
+    %result = tt.dot %a, %b, %zero_f32 : tensor<4x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<64x32xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<4x32xf32, #blocked>
+    tt.return %result : tensor<4x32xf32, #blocked>
+  }
+}
+
+// -----
+
+// Skinny-M dots whose product would not fit in registers are not decomposed,
+// and are too small for MMA: they stay on the FMA path with promoted operands.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [4, 8], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: skinny_m_dot_too_large
+  // CHECK-NOT: "tt.reduce"
+  // CHECK-NOT: triton_gpu.nvidia_mma
+  // CHECK: arith.extf {{.*}} to tensor<8x256xf32, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>
+  // CHECK: arith.extf {{.*}} to tensor<256x256xf32, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>
+  // CHECK: tt.dot {{.*}} -> tensor<8x256xf32, #blocked>
+  tt.func @skinny_m_dot_too_large(
+    %a: tensor<8x256xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>>,
+    %b: tensor<256x256xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>>)
+    -> tensor<8x256xf32, #blocked> {
+    %zero_f32 = arith.constant dense<0.000000e+00> : tensor<8x256xf32, #blocked>
+    %result = tt.dot %a, %b, %zero_f32 : tensor<8x256xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #blocked}>> * tensor<256x256xf16, #triton_gpu.dot_op<{opIdx = 1, parent = #blocked}>> -> tensor<8x256xf32, #blocked>
+    tt.return %result : tensor<8x256xf32, #blocked>
+  }
+}
@@ -0,0 +1,32 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-report-bank-conflicts -verify-diagnostics
+
+// Each lane owns a row, so an unswizzled row-major buffer puts the whole warp
+// in one bank.
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [32, 1], warpsPerCTA = [1, 4], order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  tt.func @unswizzled(%arg0: tensor<32x32xf32, #blocked>) -> tensor<32x32xf32, #blocked> {
+    // expected-remark @below {{shared memory store has at worst 32-way and on average 32.00-way bank conflicts over 8 accesses of 1 elements}}
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<32x32xf32, #blocked>) -> !tt.memdesc<32x32xf32, #shared, #triton_gpu.shared_memory>
+    // expected-remark @below {{shared memory load has at worst 32-way and on average 32.00-way bank conflicts over 8 accesses of 1 elements}}
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<32x32xf32, #shared, #triton_gpu.shared_memory> -> tensor<32x32xf32, #blocked>
+    tt.return %1 : tensor<32x32xf32, #blocked>
+  }
+}
+
+// -----
+
+// Xoring the column with the row spreads the lanes over all banks.
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [32, 1], warpsPerCTA = [1, 4], order = [0, 1], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 32, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32} {
+  tt.func @swizzled(%arg0: tensor<32x32xf32, #blocked>) -> tensor<32x32xf32, #blocked> {
+    // expected-remark @below {{shared memory store has at worst 1-way and on average 1.00-way bank conflicts over 8 accesses of 1 elements}}
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<32x32xf32, #blocked>) -> !tt.memdesc<32x32xf32, #shared, #triton_gpu.shared_memory>
+    // expected-remark @below {{shared memory load has at worst 1-way and on average 1.00-way bank conflicts over 8 accesses of 1 elements}}
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<32x32xf32, #shared, #triton_gpu.shared_memory> -> tensor<32x32xf32, #blocked>
+    tt.return %1 : tensor<32x32xf32, #blocked>
+  }
+}
@@ -2649,3 +2649,27 @@ module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 :
     tt.return
   }
 }
+
+// -----
+
+// The upcast of packed int4 values is rematerialized in the layout of its
+// user instead of converting the unpacked tensor.
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 2], threadsPerWarp = [1, 32], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked2 = #triton_gpu.blocked<{sizePerThread = [1, 2], threadsPerWarp = [32, 1], warpsPerCTA = [1, 4], order = [1, 0]}>
+#blocked3 = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [32, 1], warpsPerCTA = [1, 4], order = [1, 0]}>
+module attributes {"triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-ctas" = 1 : i32} {
+  // CHECK-LABEL: @int4_to_fp_propagation
+  tt.func @int4_to_fp_propagation(%arg0: tensor<32x64x!tt.ptr<i8>, #blocked2>, %arg1: tensor<32x128x!tt.ptr<f16>, #blocked3>) {
+    // CHECK-NOT: triton_gpu.convert_layout
+    // CHECK: tt.int4_to_fp %{{.*}} : tensor<32x64xi8, #[[SRC:.*]]> -> tensor<32x128xf16, #[[DST:.*]]>
+    // CHECK-NOT: triton_gpu.convert_layout
+    // CHECK: tt.store %{{.*}} : tensor<32x128x!tt.ptr<f16>, #[[DST]]>
+    %0 = tt.load %arg0 : tensor<32x64x!tt.ptr<i8>, #blocked2>
+    %1 = triton_gpu.convert_layout %0 : tensor<32x64xi8, #blocked2> -> tensor<32x64xi8, #blocked>
+    %2 = tt.int4_to_fp %1 {axis = 1 : i32, is_signed = true} : tensor<32x64xi8, #blocked> -> tensor<32x128xf16, #blocked1>
+    %3 = triton_gpu.convert_layout %2 : tensor<32x128xf16, #blocked1> -> tensor<32x128xf16, #blocked3>
+    tt.store %arg1, %3 : tensor<32x128x!tt.ptr<f16>, #blocked3>
+    tt.return
+  }
+}
@@ -0,0 +1,109 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-forward-shared-memory | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: @forward_immutable_alloc
+  // CHECK-SAME: %[[ARG:.*]]: tensor
+  // CHECK-NOT: triton_gpu.local_alloc
+  // CHECK-NOT: triton_gpu.local_load
+  // CHECK: tt.return %[[ARG]]
+  tt.func @forward_immutable_alloc(%arg0: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #blocked> {
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<32x32xf16, #blocked>) -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory> -> tensor<32x32xf16, #blocked>
+    tt.return %1 : tensor<32x32xf16, #blocked>
+  }
+
+  // CHECK-LABEL: @forward_store
+  // CHECK-SAME: %[[ARG0:.*]]: tensor<32x32xf16, #{{.*}}>, %[[ARG1:.*]]: tensor
+  // CHECK-NOT: triton_gpu.local_alloc
+  // CHECK-NOT: triton_gpu.local_store
+  // CHECK-NOT: triton_gpu.local_dealloc
+  // CHECK: tt.return %[[ARG1]]
+  tt.func @forward_store(%arg0: tensor<32x32xf16, #blocked>, %arg1: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #blocked> {
+    %0 = triton_gpu.local_alloc  : () -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg0, %0 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg1, %0 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> tensor<32x32xf16, #blocked>
+    triton_gpu.local_dealloc %0 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    tt.return %1 : tensor<32x32xf16, #blocked>
+  }
+
+  // The second store writes to an alias of the buffer the load reads.
+  // CHECK-LABEL: @aliasing_store
+  // CHECK: triton_gpu.local_store
+  // CHECK: triton_gpu.local_store
+  // CHECK: %[[LOAD:.*]] = triton_gpu.local_load
+  // CHECK: tt.return %[[LOAD]]
+  tt.func @aliasing_store(%arg0: tensor<32x32xf16, #blocked>, %arg1: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %0 = triton_gpu.local_alloc  : () -> !tt.memdesc<2x32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %1 = triton_gpu.memdesc_subview %0[%c0_i32, %c0_i32, %c0_i32] : !tt.memdesc<2x32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %2 = triton_gpu.memdesc_subview %0[%c0_i32, %c0_i32, %c0_i32] : !tt.memdesc<2x32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg0, %1 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg1, %2 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %3 = triton_gpu.local_load %1 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> tensor<32x32xf16, #blocked>
+    tt.return %3 : tensor<32x32xf16, #blocked>
+  }
+
+  // Forwarding across a subview store is fine when nothing in between writes
+  // to the buffer.
+  // CHECK-LABEL: @forward_subview_store
+  // CHECK-SAME: %[[ARG0:.*]]: tensor<32x32xf16, #{{.*}}>, %[[ARG1:.*]]: tensor
+  // CHECK-NOT: triton_gpu.local_load
+  // CHECK: tt.return %[[ARG0]]
+  tt.func @forward_subview_store(%arg0: tensor<32x32xf16, #blocked>, %arg1: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #blocked> {
+    %c0_i32 = arith.constant 0 : i32
+    %0 = triton_gpu.local_alloc  : () -> !tt.memdesc<2x32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %1 = triton_gpu.local_alloc  : () -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %2 = triton_gpu.memdesc_subview %0[%c0_i32, %c0_i32, %c0_i32] : !tt.memdesc<2x32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg0, %2 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg1, %1 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    %3 = triton_gpu.local_load %2 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> tensor<32x32xf16, #blocked>
+    tt.return %3 : tensor<32x32xf16, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [8, 4], warpsPerCTA = [4, 1], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [4, 1], threadsPerWarp = [4, 8], warpsPerCTA = [1, 4], order = [0, 1]}>
+#mma = #triton_gpu.nvidia_mma<{versionMajor = 2, versionMinor = 0, warpsPerCTA = [4, 1], instrShape = [16, 8]}>
+#shared = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0]}>
+module attributes {"triton_gpu.target" = "cuda:80", "triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // A round trip that only reorders registers becomes a convert_layout.
+  // CHECK-LABEL: @forward_register_conversion
+  // CHECK-NOT: triton_gpu.local_alloc
+  // CHECK: triton_gpu.convert_layout %{{.*}} : tensor<64x64xf16, #mma> -> tensor<64x64xf16, #triton_gpu.dot_op
+  tt.func @forward_register_conversion(%arg0: tensor<64x64xf16, #mma>) -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #mma, kWidth = 2}>> {
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<64x64xf16, #mma>) -> !tt.memdesc<64x64xf16, #shared, #triton_gpu.shared_memory>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<64x64xf16, #shared, #triton_gpu.shared_memory> -> tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #mma, kWidth = 2}>>
+    tt.return %1 : tensor<64x64xf16, #triton_gpu.dot_op<{opIdx = 0, parent = #mma, kWidth = 2}>>
+  }
+
+  // A transpose between the layouts needs shared memory anyway.
+  // CHECK-LABEL: @keep_shared_memory_conversion
+  // CHECK: triton_gpu.local_alloc
+  // CHECK: triton_gpu.local_load
+  tt.func @keep_shared_memory_conversion(%arg0: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #blocked1> {
+    %0 = triton_gpu.local_alloc %arg0 : (tensor<32x32xf16, #blocked>) -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory>
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory> -> tensor<32x32xf16, #blocked1>
+    tt.return %1 : tensor<32x32xf16, #blocked1>
+  }
+
+  // Calls may write to any buffer.
+  // CHECK-LABEL: @unknown_writer
+  // CHECK: tt.call
+  // CHECK: triton_gpu.local_load
+  tt.func @unknown_writer(%arg0: tensor<32x32xf16, #blocked>) -> tensor<32x32xf16, #blocked> {
+    %0 = triton_gpu.local_alloc  : () -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    triton_gpu.local_store %arg0, %0 : tensor<32x32xf16, #blocked> -> !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>
+    tt.call @opaque(%0) : (!tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>) -> ()
+    %1 = triton_gpu.local_load %0 : !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable> -> tensor<32x32xf16, #blocked>
+    tt.return %1 : tensor<32x32xf16, #blocked>
+  }
+
+  tt.func private @opaque(%arg0: !tt.memdesc<32x32xf16, #shared, #triton_gpu.shared_memory, mutable>) {
+    tt.return
+  }
+}
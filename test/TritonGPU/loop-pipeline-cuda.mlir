@@ -197,3 +197,46 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     tt.return %0#0 : tensor<128x256xf32, #mma>
   }
 }
+
+// -----
+
+// A load that does not feed a dot is read back in its own layout. Each lane
+// owns a row, so the unswizzled buffer would put the 8 lanes of a wavefront on
+// the same banks; an xor swizzle over 8 phases makes the accesses conflict-free.
+// CHECK: #[[$SHARED:shared.*]] = #triton_gpu.shared<{vec = 4, perPhase = 1, maxPhase = 8, order = [1, 0], hasLeadingOffset = false}>
+// CHECK-LABEL: tt.func @non_dot_load_least_conflicting_swizzle
+// CHECK: triton_gpu.local_alloc : () -> !tt.memdesc<{{.*}}x128x32xf32, #[[$SHARED]], #triton_gpu.shared_memory, mutable>
+// CHECK: scf.for
+// CHECK:   triton_gpu.local_load {{.*}} : !tt.memdesc<128x32xf32, #[[$SHARED]], #triton_gpu.shared_memory, mutable> -> tensor<128x32xf32, #blocked>
+// CHECK:   triton_gpu.async_copy_global_to_local
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 4], threadsPerWarp = [32, 1], warpsPerCTA = [4, 1], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @non_dot_load_least_conflicting_swizzle(%arg0: !tt.ptr<f32> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<f32> {tt.divisibility = 16 : i32}) {
+    %c0_i32 = arith.constant 0 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %c8_i32 = arith.constant 8 : i32
+    %cst = arith.constant dense<32> : tensor<128x1xi32, #blocked>
+    %cst_0 = arith.constant dense<4096> : tensor<128x32xi32, #blocked>
+    %cst_1 = arith.constant dense<0.000000e+00> : tensor<128x32xf32, #blocked>
+    %0 = tt.make_range {end = 128 : i32, start = 0 : i32} : tensor<128xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>>
+    %1 = tt.expand_dims %0 {axis = 1 : i32} : tensor<128xi32, #triton_gpu.slice<{dim = 1, parent = #blocked}>> -> tensor<128x1xi32, #blocked>
+    %2 = arith.muli %1, %cst : tensor<128x1xi32, #blocked>
+    %3 = tt.make_range {end = 32 : i32, start = 0 : i32} : tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>>
+    %4 = tt.expand_dims %3 {axis = 0 : i32} : tensor<32xi32, #triton_gpu.slice<{dim = 0, parent = #blocked}>> -> tensor<1x32xi32, #blocked>
+    %5 = tt.broadcast %2 : tensor<128x1xi32, #blocked> -> tensor<128x32xi32, #blocked>
+    %6 = tt.broadcast %4 : tensor<1x32xi32, #blocked> -> tensor<128x32xi32, #blocked>
+    %7 = arith.addi %5, %6 : tensor<128x32xi32, #blocked>
+    %8 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<128x32x!tt.ptr<f32>, #blocked>
+    %9 = tt.addptr %8, %7 : tensor<128x32x!tt.ptr<f32>, #blocked>, tensor<128x32xi32, #blocked>
+    %10:2 = scf.for %arg2 = %c0_i32 to %c8_i32 step %c1_i32 iter_args(%arg3 = %9, %arg4 = %cst_1) -> (tensor<128x32x!tt.ptr<f32>, #blocked>, tensor<128x32xf32, #blocked>)  : i32 {
+      %13 = tt.load %arg3 : tensor<128x32x!tt.ptr<f32>, #blocked>
+      %14 = arith.addf %arg4, %13 : tensor<128x32xf32, #blocked>
+      %15 = tt.addptr %arg3, %cst_0 : tensor<128x32x!tt.ptr<f32>, #blocked>, tensor<128x32xi32, #blocked>
+      scf.yield %15, %14 : tensor<128x32x!tt.ptr<f32>, #blocked>, tensor<128x32xf32, #blocked>
+    } {tt.num_stages = 3 : i32}
+    %11 = tt.splat %arg1 : !tt.ptr<f32> -> tensor<128x32x!tt.ptr<f32>, #blocked>
+    %12 = tt.addptr %11, %7 : tensor<128x32x!tt.ptr<f32>, #blocked>, tensor<128x32xi32, #blocked>
+    tt.store %12, %10#1 : tensor<128x32x!tt.ptr<f32>, #blocked>
+    tt.return
+  }
+}
@@ -0,0 +1,95 @@
+// RUN: triton-opt %s -split-input-file -tritongpu-schedule-register-pressure -verify-diagnostics | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // Under the budget, the second load is issued before the math on the first.
+  // CHECK-LABEL: @hoist_global_loads
+  // CHECK: %[[A:.*]] = tt.load
+  // CHECK-NEXT: %[[B:.*]] = tt.load
+  // CHECK-NEXT: %[[X:.*]] = arith.addf %[[A]], %[[A]]
+  // CHECK-NEXT: arith.addf %[[X]], %[[B]]
+  // expected-remark @below {{estimated peak register pressure: 5 before and 5 after scheduling, budget 255}}
+  tt.func @hoist_global_loads(%arg0: tensor<128x!tt.ptr<f32>, #blocked>, %arg1: tensor<128x!tt.ptr<f32>, #blocked>) -> tensor<128xf32, #blocked> {
+    %0 = tt.load %arg0 : tensor<128x!tt.ptr<f32>, #blocked>
+    %1 = arith.addf %0, %0 : tensor<128xf32, #blocked>
+    %2 = tt.load %arg1 : tensor<128x!tt.ptr<f32>, #blocked>
+    %3 = arith.addf %1, %2 : tensor<128xf32, #blocked>
+    tt.return %3 : tensor<128xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // A load never moves above a store it may alias.
+  // CHECK-LABEL: @keep_memory_order
+  // CHECK: arith.addf
+  // CHECK-NEXT: tt.store
+  // CHECK-NEXT: tt.load
+  // expected-remark @below {{estimated peak register pressure: 4 before and 4 after scheduling, budget 255}}
+  tt.func @keep_memory_order(%arg0: tensor<128x!tt.ptr<f32>, #blocked>, %arg1: tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked> {
+    %0 = arith.addf %arg1, %arg1 : tensor<128xf32, #blocked>
+    tt.store %arg0, %0 : tensor<128x!tt.ptr<f32>, #blocked>
+    %1 = tt.load %arg0 : tensor<128x!tt.ptr<f32>, #blocked>
+    tt.return %1 : tensor<128xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // Loop bodies are scheduled like any other block.
+  // CHECK-LABEL: @hoist_global_loads_in_loop
+  // CHECK: scf.for
+  // CHECK-NEXT: %[[A:.*]] = tt.load
+  // CHECK-NEXT: %[[B:.*]] = tt.load
+  // CHECK-NEXT: %[[X:.*]] = arith.addf %[[A]], %[[A]]
+  // CHECK-NEXT: arith.addf %[[X]], %[[B]]
+  // expected-remark @below {{estimated peak register pressure: 9 before and 9 after scheduling, budget 255}}
+  tt.func @hoist_global_loads_in_loop(%arg0: tensor<128x!tt.ptr<f32>, #blocked>, %arg1: tensor<128x!tt.ptr<f32>, #blocked>, %lb: i32, %ub: i32, %step: i32) -> tensor<128xf32, #blocked> {
+    %cst = arith.constant dense<0.000000e+00> : tensor<128xf32, #blocked>
+    %0 = scf.for %iv = %lb to %ub step %step iter_args(%acc = %cst) -> (tensor<128xf32, #blocked>)  : i32 {
+      %1 = tt.load %arg0 : tensor<128x!tt.ptr<f32>, #blocked>
+      %2 = arith.addf %1, %1 : tensor<128xf32, #blocked>
+      %3 = tt.load %arg1 : tensor<128x!tt.ptr<f32>, #blocked>
+      %4 = arith.addf %2, %3 : tensor<128xf32, #blocked>
+      %5 = arith.addf %acc, %4 : tensor<128xf32, #blocked>
+      scf.yield %5 : tensor<128xf32, #blocked>
+    }
+    tt.return %0 : tensor<128xf32, #blocked>
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [1], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // A load moves above a region op without memory effects, but not above one
+  // that stores.
+  // CHECK-LABEL: @loads_next_to_region_ops
+  // CHECK: tt.load %arg0
+  // CHECK-NEXT: scf.if %arg2 -> (tensor<128xf32, #blocked>)
+  // CHECK: scf.if %arg2 {
+  // CHECK-NEXT: tt.store
+  // CHECK-NEXT: }
+  // CHECK-NEXT: tt.load %arg1
+  // expected-remark @below {{estimated peak register pressure: 7 before and 7 after scheduling, budget 255}}
+  tt.func @loads_next_to_region_ops(%arg0: tensor<128x!tt.ptr<f32>, #blocked>, %arg1: tensor<128x!tt.ptr<f32>, #blocked>, %arg2: i1, %arg3: tensor<128xf32, #blocked>) -> tensor<128xf32, #blocked> {
+    %0 = scf.if %arg2 -> (tensor<128xf32, #blocked>) {
+      %5 = arith.addf %arg3, %arg3 : tensor<128xf32, #blocked>
+      scf.yield %5 : tensor<128xf32, #blocked>
+    } else {
+      scf.yield %arg3 : tensor<128xf32, #blocked>
+    }
+    %1 = tt.load %arg0 : tensor<128x!tt.ptr<f32>, #blocked>
+    scf.if %arg2 {
+      tt.store %arg1, %0 : tensor<128x!tt.ptr<f32>, #blocked>
+    }
+    %2 = tt.load %arg1 : tensor<128x!tt.ptr<f32>, #blocked>
+    %3 = arith.addf %1, %2 : tensor<128xf32, #blocked>
+    %4 = arith.addf %3, %0 : tensor<128xf32, #blocked>
+    tt.return %4 : tensor<128xf32, #blocked>
+  }
+}
@@ -114,3 +114,31 @@ module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 :
     tt.return
   }
 }
+
+// -----
+
+#shared0 = #triton_gpu.shared<{vec = 1, perPhase = 1, maxPhase = 1, order = [1, 0], CTAsPerCGA = [1, 1], CTASplitNum = [1, 1], CTAOrder = [0, 1]}>
+#blocked0 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.num-warp-groups-per-cta" = 2 : i32} {
+// Only the warps of a warp-specialized partition synchronize inside of it.
+// CHECK-LABEL: partition_barrier
+//       CHECK: triton_nvidia_gpu.reg_alloc
+//       CHECK: triton_gpu.local_store
+//  CHECK-NEXT: gpu.barrier {bar_id = 1 : i32, num_threads = 128 : i32}
+//  CHECK-NEXT: triton_gpu.local_load
+//       CHECK: ^bb2:
+//  CHECK-NEXT: gpu.barrier {bar_id = 0 : i32, num_threads = 256 : i32}
+//  CHECK-NEXT: triton_gpu.local_store
+  tt.func public @partition_barrier(%arg0: tensor<32x32xf16, #blocked0>, %arg1: i1) {
+    %alloc = triton_gpu.local_alloc  : () -> !tt.memdesc<32x32xf16, #shared0, #triton_gpu.shared_memory, mutable>
+    cf.cond_br %arg1, ^bb1, ^bb2
+  ^bb1:
+    triton_nvidia_gpu.reg_alloc 232 {triton_gpu.partition_barrier = array<i32: 1, 128>}
+    triton_gpu.local_store %arg0, %alloc : tensor<32x32xf16, #blocked0> -> !tt.memdesc<32x32xf16, #shared0, #triton_gpu.shared_memory, mutable>
+    %0 = triton_gpu.local_load %alloc : !tt.memdesc<32x32xf16, #shared0, #triton_gpu.shared_memory, mutable> -> tensor<32x32xf16, #blocked0>
+    cf.br ^bb2
+  ^bb2:
+    triton_gpu.local_store %arg0, %alloc : tensor<32x32xf16, #blocked0> -> !tt.memdesc<32x32xf16, #shared0, #triton_gpu.shared_memory, mutable>
+    tt.return
+  }
+}
@@ -0,0 +1,48 @@
+// RUN: triton-opt %s -split-input-file -triton-nvidia-gpu-plan-cta | FileCheck %s
+
+// A rank-1 reduce wide enough to give every CTA of the cluster a slice of the
+// reduced axis is split across the cluster.
+// CHECK-DAG: #[[$SPLIT:.*]] = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [2], CTAOrder = [0]}>
+// CHECK-LABEL: tt.func @reduce_split_across_cluster
+// CHECK: tt.load %{{.*}} : tensor<256x!tt.ptr<f32>, #[[$SPLIT]]>
+// CHECK: "tt.reduce"
+// CHECK: (tensor<256xf32, #[[$SPLIT]]>) -> f32
+#blocked = #triton_gpu.blocked<{sizePerThread = [1], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 2 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @reduce_split_across_cluster(%arg0: !tt.ptr<f32>) -> f32 {
+    %0 = tt.make_range {end = 256 : i32, start = 0 : i32} : tensor<256xi32, #blocked>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<256x!tt.ptr<f32>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<256x!tt.ptr<f32>, #blocked>, tensor<256xi32, #blocked>
+    %3 = tt.load %2 : tensor<256x!tt.ptr<f32>, #blocked>
+    %4 = "tt.reduce"(%3) <{axis = 0 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %5 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %5 : f32
+    }) : (tensor<256xf32, #blocked>) -> f32
+    tt.return %4 : f32
+  }
+}
+
+// -----
+
+// With fewer elements per thread along the axis than CTAs, every CTA computes
+// the whole reduction instead.
+// CHECK-DAG: #[[$DUP:.*]] = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [1], CTAOrder = [0]}>
+// CHECK-LABEL: tt.func @reduce_duplicated_across_cluster
+// CHECK: "tt.reduce"
+// CHECK: (tensor<2xf32, #[[$DUP]]>) -> f32
+#blocked = #triton_gpu.blocked<{sizePerThread = [2], threadsPerWarp = [32], warpsPerCTA = [4], order = [0], CTAsPerCGA = [2], CTASplitNum = [1], CTAOrder = [0]}>
+module attributes {"triton_gpu.num-ctas" = 2 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  tt.func @reduce_duplicated_across_cluster(%arg0: !tt.ptr<f32>) -> f32 {
+    %0 = tt.make_range {end = 2 : i32, start = 0 : i32} : tensor<2xi32, #blocked>
+    %1 = tt.splat %arg0 : !tt.ptr<f32> -> tensor<2x!tt.ptr<f32>, #blocked>
+    %2 = tt.addptr %1, %0 : tensor<2x!tt.ptr<f32>, #blocked>, tensor<2xi32, #blocked>
+    %3 = tt.load %2 : tensor<2x!tt.ptr<f32>, #blocked>
+    %4 = "tt.reduce"(%3) <{axis = 0 : i32}> ({
+    ^bb0(%arg1: f32, %arg2: f32):
+      %5 = arith.addf %arg1, %arg2 : f32
+      tt.reduce.return %5 : f32
+    }) : (tensor<2xf32, #blocked>) -> f32
+    tt.return %4 : f32
+  }
+}
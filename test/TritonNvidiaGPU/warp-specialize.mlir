@@ -0,0 +1,101 @@
+// RUN: triton-opt %s -split-input-file -triton-nvidia-gpu-warp-specialize | FileCheck %s
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [2, 2], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+#mma = #triton_gpu.nvidia_mma<{versionMajor = 3, versionMinor = 0, warpsPerCTA = [4, 1], instrShape = [16, 256, 16]}>
+#shared = #triton_gpu.shared<{vec = 8, perPhase = 1, maxPhase = 8, order = [1, 0], hasLeadingOffset = true}>
+// CHECK: module attributes {{.*}}"triton_gpu.num-warp-groups-per-cta" = 2 : i32
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // CHECK-LABEL: @matmul_tma
+  // CHECK-DAG:     %[[A:.*]] = triton_gpu.local_alloc  : () -> !tt.memdesc<3x128x64xf16, #{{.+}}, #triton_gpu.shared_memory, mutable>
+  // CHECK-DAG:     %[[B:.*]] = triton_gpu.local_alloc  : () -> !tt.memdesc<3x64x256xf16, #{{.+}}, #triton_gpu.shared_memory, mutable>
+  // CHECK:         %[[FULL:.*]] = triton_gpu.local_alloc  : () -> !tt.memdesc<3xi64
+  // CHECK-COUNT-3: triton_nvidia_gpu.init_barrier %{{.*}}, 1 :
+  // CHECK:         %[[EMPTY:.*]] = triton_gpu.local_alloc  : () -> !tt.memdesc<3xi64
+  // CHECK-COUNT-3: triton_nvidia_gpu.init_barrier %{{.*}}, 128 :
+  // CHECK:         gpu.barrier {bar_id = 0 : i32, num_threads = 256 : i32}
+  // CHECK:         %[[WG:.*]] = triton_nvidia_gpu.get_warp_group_id : i32
+  // CHECK:         %[[IS_PRODUCER:.*]] = arith.cmpi eq, %[[WG]], %{{.*}} : i32
+  // CHECK:         scf.if %[[IS_PRODUCER]] {
+  // CHECK:           triton_nvidia_gpu.reg_dealloc 40 {triton_gpu.partition_barrier = array<i32: 2, 128>}
+  // CHECK:           scf.for
+  // CHECK:             %[[SLOT:.*]] = arith.remsi
+  // CHECK:             %[[EMPTY_VIEW:.*]] = triton_gpu.memdesc_subview %[[EMPTY]][%[[SLOT]]]
+  // CHECK:             triton_nvidia_gpu.wait_barrier %[[EMPTY_VIEW]]
+  // CHECK:             %[[FULL_VIEW:.*]] = triton_gpu.memdesc_subview %[[FULL]][%[[SLOT]]]
+  // CHECK:             triton_nvidia_gpu.barrier_expect %[[FULL_VIEW]], 49152
+  // CHECK:             %[[A_VIEW:.*]] = triton_gpu.memdesc_subview %[[A]][%[[SLOT]],
+  // CHECK:             triton_nvidia_gpu.async_tma_copy_global_to_local %arg0[{{.*}}] %[[A_VIEW]], %[[FULL_VIEW]]
+  // CHECK:             %[[B_VIEW:.*]] = triton_gpu.memdesc_subview %[[B]][%[[SLOT]],
+  // CHECK:             triton_nvidia_gpu.async_tma_copy_global_to_local %arg1[{{.*}}] %[[B_VIEW]], %[[FULL_VIEW]]
+  // CHECK-NOT:         triton_nvidia_gpu.warp_group_dot
+  // CHECK:           } {tt.num_stages = 1 : i32}
+  // CHECK:         } else {
+  // CHECK:           triton_nvidia_gpu.reg_alloc 232 {triton_gpu.partition_barrier = array<i32: 1, 128>}
+  // CHECK:           %[[RES:.*]]:2 = scf.for
+  // CHECK:             %[[SLOT:.*]] = arith.remsi
+  // CHECK:             %[[FULL_VIEW:.*]] = triton_gpu.memdesc_subview %[[FULL]][%[[SLOT]]]
+  // CHECK:             triton_nvidia_gpu.wait_barrier %[[FULL_VIEW]]
+  // CHECK-NOT:         tt.experimental_descriptor_load
+  // CHECK:             %[[A_VIEW:.*]] = triton_gpu.memdesc_subview %[[A]][%[[SLOT]],
+  // CHECK:             %[[B_VIEW:.*]] = triton_gpu.memdesc_subview %[[B]][%[[SLOT]],
+  // CHECK:             triton_nvidia_gpu.warp_group_dot %[[A_VIEW]], %[[B_VIEW]]
+  // CHECK:             %[[EMPTY_VIEW:.*]] = triton_gpu.memdesc_subview %[[EMPTY]][%[[SLOT]]]
+  // CHECK:             triton_nvidia_gpu.arrive_barrier %[[EMPTY_VIEW]]
+  // CHECK:           } {tt.num_stages = 1 : i32}
+  // CHECK:           tt.store %arg2, %[[RES]]#0
+  // CHECK:         }
+  // CHECK-COUNT-6: triton_nvidia_gpu.inval_barrier
+  // CHECK:         tt.return
+  tt.func public @matmul_tma(%arg0: !tt.ptr<i8> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<i8> {tt.divisibility = 16 : i32}, %arg2: tensor<128x256x!tt.ptr<f32>, #mma>) {
+    %c256_i32 = arith.constant 256 : i32
+    %c0_i32 = arith.constant 0 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x256xf32, #mma>
+    %0:2 = scf.for %arg3 = %c0_i32 to %c256_i32 step %c1_i32 iter_args(%arg4 = %cst, %arg5 = %c0_i32) -> (tensor<128x256xf32, #mma>, i32)  : i32 {
+      %1 = tt.experimental_descriptor_load %arg0[%c0_i32, %arg5] : !tt.ptr<i8> -> tensor<128x64xf16, #blocked>
+      %2 = triton_gpu.local_alloc %1 : (tensor<128x64xf16, #blocked>) -> !tt.memdesc<128x64xf16, #shared, #triton_gpu.shared_memory>
+      %3 = tt.experimental_descriptor_load %arg1[%arg5, %c0_i32] : !tt.ptr<i8> -> tensor<64x256xf16, #blocked1>
+      %4 = triton_gpu.local_alloc %3 : (tensor<64x256xf16, #blocked1>) -> !tt.memdesc<64x256xf16, #shared, #triton_gpu.shared_memory>
+      %5 = triton_nvidia_gpu.warp_group_dot %2, %4, %arg4 { inputPrecision = 0 : i32 } : !tt.memdesc<128x64xf16, #shared, #triton_gpu.shared_memory> * !tt.memdesc<64x256xf16, #shared, #triton_gpu.shared_memory> -> tensor<128x256xf32, #mma>
+      %6 = arith.addi %arg5, %c64_i32 : i32
+      scf.yield %5, %6 : tensor<128x256xf32, #mma>, i32
+    }
+    tt.store %arg2, %0#0 : tensor<128x256x!tt.ptr<f32>, #mma>
+    tt.return
+  }
+}
+
+// -----
+
+#blocked = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [2, 2], order = [1, 0]}>
+#blocked1 = #triton_gpu.blocked<{sizePerThread = [1, 1], threadsPerWarp = [1, 32], warpsPerCTA = [1, 4], order = [1, 0]}>
+#mma = #triton_gpu.nvidia_mma<{versionMajor = 3, versionMinor = 0, warpsPerCTA = [4, 1], instrShape = [16, 256, 16]}>
+#shared = #triton_gpu.shared<{vec = 8, perPhase = 1, maxPhase = 8, order = [1, 0], hasLeadingOffset = true}>
+// CHECK-NOT: triton_gpu.num-warp-groups-per-cta
+module attributes {"triton_gpu.num-ctas" = 1 : i32, "triton_gpu.num-warps" = 4 : i32, "triton_gpu.threads-per-warp" = 32 : i32} {
+  // Both warp groups would run the store before the loop.
+  // CHECK-LABEL: @store_before_loop
+  // CHECK-NOT: scf.if
+  // CHECK: tt.experimental_descriptor_load
+  tt.func public @store_before_loop(%arg0: !tt.ptr<i8> {tt.divisibility = 16 : i32}, %arg1: !tt.ptr<i8> {tt.divisibility = 16 : i32}, %arg2: tensor<128x256x!tt.ptr<f32>, #mma>) {
+    %c256_i32 = arith.constant 256 : i32
+    %c0_i32 = arith.constant 0 : i32
+    %c64_i32 = arith.constant 64 : i32
+    %c1_i32 = arith.constant 1 : i32
+    %cst = arith.constant dense<0.000000e+00> : tensor<128x256xf32, #mma>
+    tt.store %arg2, %cst : tensor<128x256x!tt.ptr<f32>, #mma>
+    %0:2 = scf.for %arg3 = %c0_i32 to %c256_i32 step %c1_i32 iter_args(%arg4 = %cst, %arg5 = %c0_i32) -> (tensor<128x256xf32, #mma>, i32)  : i32 {
+      %1 = tt.experimental_descriptor_load %arg0[%c0_i32, %arg5] : !tt.ptr<i8> -> tensor<128x64xf16, #blocked>
+      %2 = triton_gpu.local_alloc %1 : (tensor<128x64xf16, #blocked>) -> !tt.memdesc<128x64xf16, #shared, #triton_gpu.shared_memory>
+      %3 = tt.experimental_descriptor_load %arg1[%arg5, %c0_i32] : !tt.ptr<i8> -> tensor<64x256xf16, #blocked1>
+      %4 = triton_gpu.local_alloc %3 : (tensor<64x256xf16, #blocked1>) -> !tt.memdesc<64x256xf16, #shared, #triton_gpu.shared_memory>
+      %5 = triton_nvidia_gpu.warp_group_dot %2, %4, %arg4 { inputPrecision = 0 : i32 } : !tt.memdesc<128x64xf16, #shared, #triton_gpu.shared_memory> * !tt.memdesc<64x256xf16, #shared, #triton_gpu.shared_memory> -> tensor<128x256xf32, #mma>
+      %6 = arith.addi %arg5, %c64_i32 : i32
+      scf.yield %5, %6 : tensor<128x256xf32, #mma>, i32
+    }
+    tt.store %arg2, %0#0 : tensor<128x256x!tt.ptr<f32>, #mma>
+    tt.return
+  }
+}
@@ -0,0 +1,75 @@
+#include "../third_party/nvidia/lib/TritonNVIDIAGPUToLLVM/TargetInfo.h"
+#include "mlir/Conversion/LLVMCommon/Pattern.h"
+#include "mlir/Pass/Pass.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "triton/Conversion/TritonGPUToLLVM/PatternTritonGPUOpToLLVM.h"
+#include "triton/Conversion/TritonGPUToLLVM/TypeConverter.h"
+#include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include "triton/Dialect/Triton/IR/Dialect.h"
+
+using namespace mlir;
+
+namespace {
+
+// Requests the indices of a tt.make_range and then gives up, so that the
+// conversion rolls back the index math that was hoisted to the entry block.
+struct RequestIndicesAndFail
+    : public ConvertOpToLLVMPattern<triton::MakeRangeOp> {
+  RequestIndicesAndFail(LLVMTypeConverter &converter,
+                        const TargetInfoBase &targetInfo,
+                        PatternBenefit benefit)
+      : ConvertOpToLLVMPattern<triton::MakeRangeOp>(converter, benefit),
+        targetInfo(targetInfo) {}
+
+  LogicalResult
+  matchAndRewrite(triton::MakeRangeOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    RankedTensorType ty = op.getType();
+    emitIndices(op.getLoc(), rewriter, targetInfo, ty.getEncoding(), ty,
+                true);
+    return failure();
+  }
+
+private:
+  const TargetInfoBase &targetInfo;
+};
+
+struct TestIndexCachePass
+    : public PassWrapper<TestIndexCachePass, OperationPass<ModuleOp>> {
+
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(TestIndexCachePass);
+
+  StringRef getArgument() const final { return "test-index-cache-rollback"; }
+  StringRef getDescription() const final {
+    return "lower tt.make_range under an IndexCache after a pattern that "
+           "requested indices failed";
+  }
+
+  void runOnOperation() override {
+    MLIRContext *context = &getContext();
+    ModuleOp mod = getOperation();
+
+    mlir::triton::NVIDIA::TargetInfo targetInfo(90);
+    mlir::LowerToLLVMOptions option(context);
+    TritonGPUToLLVMTypeConverter typeConverter(context, option, targetInfo);
+    ConversionTarget target(*context);
+    target.addIllegalOp<triton::MakeRangeOp>();
+
+    RewritePatternSet patterns(context);
+    patterns.add<RequestIndicesAndFail>(typeConverter, targetInfo,
+                                        /*benefit=*/2);
+    mlir::triton::populateMakeRangeOpToLLVMPattern(typeConverter, targetInfo,
+                                                   patterns, /*benefit=*/1);
+    IndexCache indexCache;
+    if (failed(applyPartialConversion(mod, target, std::move(patterns))))
+      return signalPassFailure();
+  }
+};
+
+} // namespace
+
+namespace mlir {
+namespace test {
+void registerTestIndexCachePass() { PassRegistration<TestIndexCachePass>(); }
+} // namespace test
+} // namespace mlir
@@ -60,6 +60,7 @@ for d in tool_dirs:
 tools = [
     'triton-opt',
     'triton-llvm-opt',
+    'triton-compile-bench',
     ToolSubst('%PYTHON', config.python_executable, unresolved='ignore'),
 ]
 
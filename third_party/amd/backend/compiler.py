@@ -35,6 +35,7 @@ class HIPOptions:
     cluster_dims: tuple = (1, 1, 1)
     debug: bool = False
     sanitize_overflow: bool = True
+    multiversion: bool = False
     arch: str = None
     supported_fp8_dtypes: Tuple[str] = ("fp8e5", )
     deprecated_fp8_dtypes: Tuple[str] = ()
@@ -46,6 +47,8 @@ class HIPOptions:
     allow_flush_denorm: bool = False
     max_num_imprecise_acc_default: int = 0
     backend_name: str = 'hip'
+    # Reorder TTGIR blocks to lower the estimated register pressure.
+    schedule_register_pressure: bool = False
 
     # The following option provides hints to the AMDGPU backend regarding instruction scheduling
     # for all `tt.dot` operations in a kernel. The "default" variant preserves the default
@@ -67,8 +70,8 @@ class HIPOptions:
         assert self.num_warps > 0 and (self.num_warps & (self.num_warps - 1)) == 0, \
                "num_warps must be a power of 2"
 
-    def hash(self):
-        key = '_'.join([f'{name}-{val}' for name, val in self.__dict__.items()])
+    def hash(self, names=None):
+        key = '_'.join([f'{name}-{val}' for name, val in self.__dict__.items() if names is None or name in names])
         return hashlib.sha256(key.encode("utf-8")).hexdigest()
 
 
@@ -195,7 +198,11 @@ class HIPBackend(BaseBackend):
         passes.common.add_cse(pm)
         passes.common.add_licm(pm)
         passes.common.add_symbol_dce(pm)
-        passes.ttir.add_loop_unroll(pm)
+        if options.multiversion:
+            passes.ttir.add_loop_multiversioning(pm)
+        passes.ttir.add_loop_unroll(pm, options.num_warps, options.warp_size)
+        if os.environ.get("TRITON_PEEL_MASKED_LOOPS", "0") == "1":
+            passes.ttir.add_loop_peeling(pm)
         pm.run(mod)
         return mod
 
@@ -226,9 +233,12 @@ class HIPBackend(BaseBackend):
         amd.passes.ttgpuir.insert_instruction_sched_hints(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm, True)
         passes.ttgpuir.add_remove_layout_conversions(pm)
+        passes.ttgpuir.add_forward_shared_memory(pm)
         passes.ttgpuir.add_reduce_data_duplication(pm)
         if amd.has_matrix_core_feature(options.arch):
             amd.passes.ttgpuir.add_reorder_instructions(pm)
+            if options.schedule_register_pressure:
+                passes.ttgpuir.add_schedule_register_pressure(pm, 0)
         amd.passes.ttgpuir.add_canonicalize_pointers(pm)
         passes.common.add_canonicalizer(pm)
         passes.common.add_cse(pm)
@@ -360,6 +370,17 @@ class HIPBackend(BaseBackend):
         stages["amdgcn"] = lambda src, metadata: self.make_amdgcn(src, metadata, options)
         stages["hsaco"] = lambda src, metadata: self.make_hsaco(src, metadata, options)
 
+    def get_stage_options(self, stage):
+        return {
+            "ttir": ("multiversion", ),
+            "ttgir": ("arch", "num_warps", "warp_size", "num_ctas", "matrix_instr_nonkdim", "kpack", "num_stages",
+                      "schedule_register_pressure"),
+            "llir": ("arch", "num_warps", "warp_size", "waves_per_eu", "allow_flush_denorm", "instruction_sched_variant",
+                     "extern_libs", "enable_fp_fusion"),
+            "amdgcn": ("arch", "enable_fp_fusion"),
+            "hsaco": ("arch", ),
+        }.get(stage)
+
     @functools.lru_cache()
     def hash(self):
         version = subprocess.check_output([HIPBackend.path_to_rocm_lld(), "--version"], encoding='utf-8')
@@ -37,6 +37,7 @@ struct DecomposeUnsupportedAMDConversions
     int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
 
     triton::gpu::decomposeSplatOpToSharedLayoutConversion(mod);
+    triton::gpu::decomposeUnsupportedSortLayouts(mod);
 
     triton::gpu::decomposeTensorCoreToDotLayoutConversion(mod,
                                                           isMfmaToDotShortcut);
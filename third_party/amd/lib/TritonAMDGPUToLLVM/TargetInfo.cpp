@@ -67,6 +67,10 @@ Value TargetInfo::getClusterCTAId(RewriterBase &rewriter, Location loc) const {
   return rewriter.create<arith::ConstantIntOp>(loc, 0, 32);
 }
 
+void TargetInfo::barrierCluster(RewriterBase &rewriter, Location loc) const {
+  llvm::report_fatal_error("AMDGPU does not support CTA clusters");
+}
+
 Value TargetInfo::ballot(RewriterBase &rewriter, Location loc, Type type,
                          Value cmp) const {
   return LLVM::createLLVMIntrinsicCallOp(rewriter, loc, "llvm.amdgcn.ballot",
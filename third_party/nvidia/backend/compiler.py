@@ -15,7 +15,8 @@ from pathlib import Path
 
 
 def min_dot_size(target: GPUTarget):
-    return lambda lhsType, rhsType: (16, 32, 16) if lhsType.is_int8() else (16, 16, 16)
+    # M below the MMA instruction shape is handled by the skinny-M dot lowering.
+    return lambda lhsType, rhsType: (16, 32, 16) if lhsType.is_int8() else (1, 16, 16)
 
 
 @functools.lru_cache()
@@ -103,6 +104,10 @@ class CUDAOptions:
     debug: bool = False
     backend_name: str = 'cuda'
     sanitize_overflow: bool = True
+    multiversion: bool = False
+    warp_specialize: bool = False
+    # Reorder TTGIR blocks to lower the estimated register pressure.
+    schedule_register_pressure: bool = False
 
     def __post_init__(self):
         default_libdir = Path(__file__).parent / 'lib'
@@ -113,9 +118,10 @@ class CUDAOptions:
         assert self.num_warps > 0 and (self.num_warps & (self.num_warps - 1)) == 0, \
                "num_warps must be a power of 2"
 
-    def hash(self):
-        hash_dict = dict(self.__dict__)
-        hash_dict["extern_libs"] = tuple((k, file_hash(v)) for k, v in sorted(hash_dict["extern_libs"]))
+    def hash(self, names=None):
+        hash_dict = dict(self.__dict__) if names is None else {name: self.__dict__[name] for name in names}
+        if "extern_libs" in hash_dict:
+            hash_dict["extern_libs"] = tuple((k, file_hash(v)) for k, v in sorted(hash_dict["extern_libs"]))
         key = "_".join([f"{name}-{val}" for name, val in sorted(hash_dict.items())])
         return hashlib.sha256(key.encode("utf-8")).hexdigest()
 
@@ -187,7 +193,11 @@ class CUDABackend(BaseBackend):
         passes.common.add_cse(pm)
         passes.common.add_licm(pm)
         passes.common.add_symbol_dce(pm)
-        passes.ttir.add_loop_unroll(pm)
+        if opt.multiversion:
+            passes.ttir.add_loop_multiversioning(pm)
+        passes.ttir.add_loop_unroll(pm, opt.num_warps, 32)
+        if os.environ.get("TRITON_PEEL_MASKED_LOOPS", "0") == "1":
+            passes.ttir.add_loop_peeling(pm)
         pm.run(mod)
         return mod
 
@@ -222,18 +232,25 @@ class CUDABackend(BaseBackend):
         if capability // 10 >= 8:
             passes.ttgpuir.add_optimize_accumulator_init(pm)
             passes.ttgpuir.add_combine_tensor_select_and_if(pm)
+            if capability // 10 >= 9 and opt.warp_specialize:
+                nvidia.passes.ttnvgpuir.add_warp_specialize(pm, opt.num_stages)
             passes.ttgpuir.add_pipeline(pm, opt.num_stages)
         passes.ttgpuir.add_prefetch(pm)
         passes.ttgpuir.add_optimize_dot_operands(pm, capability >= 80)
         passes.ttgpuir.add_remove_layout_conversions(pm)
+        passes.ttgpuir.add_forward_shared_memory(pm)
         passes.ttgpuir.add_reduce_data_duplication(pm)
         passes.ttgpuir.add_reorder_instructions(pm)
+        if opt.schedule_register_pressure:
+            passes.ttgpuir.add_schedule_register_pressure(pm, 0)
         passes.common.add_cse(pm)
         passes.common.add_symbol_dce(pm)
         if capability // 10 >= 9:
             nvidia.passes.ttnvgpuir.add_fence_insertion(pm)
             nvidia.passes.ttnvgpuir.add_tma_lowering(pm)
         passes.common.add_canonicalizer(pm)
+        if os.environ.get("MLIR_ENABLE_REMARK", "0") == "1":
+            passes.ttgpuir.add_report_bank_conflicts(pm)
         pm.run(mod)
         metadata["cluster_dims"] = (cluster_info.clusterDimX, cluster_info.clusterDimY, cluster_info.clusterDimZ)
         return mod
@@ -288,7 +305,7 @@ class CUDABackend(BaseBackend):
             paths = [path for (name, path) in options.extern_libs]
             llvm.link_extern_libs(llvm_mod, paths)
 
-        llvm.optimize_module(llvm_mod, llvm.OPTIMIZE_O3)
+        llvm.optimize_module(llvm_mod, llvm.OPTIMIZE_O3, proc, features, [], options.enable_fp_fusion)
 
         # Get some metadata
         metadata["shared"] = src.get_int_attr("triton_gpu.shared")
@@ -374,6 +391,17 @@ class CUDABackend(BaseBackend):
         stages["ptx"] = lambda src, metadata: self.make_ptx(src, metadata, options, self.capability)
         stages["cubin"] = lambda src, metadata: self.make_cubin(src, metadata, options, self.capability)
 
+    def get_stage_options(self, stage):
+        return {
+            "ttir": ("multiversion", ),
+            "ttgir": ("num_warps", "num_ctas", "num_stages", "cluster_dims", "warp_specialize",
+                      "schedule_register_pressure"),
+            # num_warps is scaled by the number of warp groups in the metadata
+            "llir": ("num_warps", "maxnreg", "extern_libs", "enable_fp_fusion", "ptx_version"),
+            "ptx": ("enable_fp_fusion", "ptx_version"),
+            "cubin": ("enable_fp_fusion", ),
+        }.get(stage)
+
     @functools.lru_cache()
     def hash(self):
         version = get_ptxas_version()
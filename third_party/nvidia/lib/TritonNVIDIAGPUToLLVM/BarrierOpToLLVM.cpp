@@ -50,6 +50,24 @@ struct BarrierOpConversion
       rewriter.eraseOp(op);
       return success();
     }
+    auto mod = op->getParentOfType<ModuleOp>();
+    if (mod->hasAttr("triton_gpu.num-warp-groups-per-cta")) {
+      // The barriers emitted by the lowering of an op synchronize the warps
+      // computing it, i.e. one warp group of a warp-specialized kernel. Warp
+      // group i synchronizes through named barrier i + 1, the barrier of its
+      // partition.
+      int numThreads = triton::gpu::TritonGPUDialect::getNumWarps(mod) *
+                       triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+      Value barId = add(udiv(getThreadId(rewriter, loc), i32_val(numThreads)),
+                        i32_val(1));
+      ::mlir::triton::PTXBuilder ptxBuilder;
+      auto &barSyncOp = *ptxBuilder.create<>("bar.sync");
+      barSyncOp(ptxBuilder.newOperand(barId, "r"),
+                ptxBuilder.newConstantOperand(numThreads));
+      ptxBuilder.launch(rewriter, loc, void_ty(op->getContext()));
+      rewriter.eraseOp(op);
+      return success();
+    }
     // Otherwise we let the default lowering handle it
     return failure();
   }
@@ -140,7 +158,10 @@ struct BarrierExpectConversion
         typeConverter->convertType(op.getAlloc().getType().getElementType()),
         rewriter);
 
-    auto id = getThreadId(rewriter, loc);
+    // In a warp-specialized kernel the expect is issued by the producer warp
+    // group, whose first thread is not thread 0.
+    auto id = LLVM::NVIDIA::getThreadIdInWarpGroup(
+        loc, rewriter, op->getParentOfType<ModuleOp>());
     Value pred = icmp_eq(id, i32_val(0));
     pred = and_(pred, adaptor.getPred());
     ::mlir::triton::PTXBuilder ptxBuilder;
@@ -188,6 +209,30 @@ struct WaitBarrierOpConversion
     return success();
   }
 };
+
+struct ArriveBarrierOpConversion
+    : public ConvertOpToLLVMPattern<triton::nvidia_gpu::ArriveBarrierOp> {
+  using ConvertOpToLLVMPattern::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::nvidia_gpu::ArriveBarrierOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto smemObj = LLVM::getSharedMemoryObjectFromStruct(
+        loc, adaptor.getAlloc(),
+        typeConverter->convertType(op.getAlloc().getType().getElementType()),
+        rewriter);
+    ::mlir::triton::PTXBuilder ptxBuilder;
+    const std::string ptx = "mbarrier.arrive.shared.b64 _, [$0];";
+    auto &arriveOp = *ptxBuilder.create<>(ptx);
+    arriveOp({ptxBuilder.newOperand(smemObj.getBase(), "r")},
+             /*onlyAttachMLIRArgs=*/true);
+    auto voidTy = void_ty(op->getContext());
+    ptxBuilder.launch(rewriter, loc, voidTy);
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
 } // namespace
 
 void mlir::triton::NVIDIA::populateBarrierOpToLLVMPatterns(
@@ -197,6 +242,7 @@ void mlir::triton::NVIDIA::populateBarrierOpToLLVMPatterns(
   patterns.add<FenceAsyncSharedOpConversion>(typeConverter, benefit);
   patterns.add<InitBarrierOpConversion, InvalBarrierOpConversion>(typeConverter,
                                                                   benefit);
-  patterns.add<WaitBarrierOpConversion>(typeConverter, benefit);
+  patterns.add<WaitBarrierOpConversion, ArriveBarrierOpConversion>(
+      typeConverter, benefit);
   patterns.add<BarrierExpectConversion>(typeConverter, benefit);
 }
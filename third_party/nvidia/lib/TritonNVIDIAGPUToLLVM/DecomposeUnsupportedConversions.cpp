@@ -75,6 +75,7 @@ struct DecomposeUnsupportedConversions
     triton::gpu::decomposeTensorCoreToDotLayoutConversion(mod,
                                                           isMmaToDotShortcut);
     triton::gpu::decomposeBlockedToDotLayoutConversion(mod);
+    triton::gpu::decomposeUnsupportedSortLayouts(mod);
 
     mlir::RewritePatternSet patterns(&getContext());
     patterns.add<DecomposeLocalLoadToDotOperand>(&getContext());
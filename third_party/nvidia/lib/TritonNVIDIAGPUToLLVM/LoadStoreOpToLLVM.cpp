@@ -1050,9 +1050,9 @@ struct AsyncTMACopyGlobalToLocalOpConversion
     auto dstMemObj = LLVM::getSharedMemoryObjectFromStruct(
         loc, adaptor.getResult(), llvmElemTy, rewriter);
     auto voidTy = void_ty(op->getContext());
-    auto id = getThreadId(rewriter, loc);
-
     auto mod = op->getParentOfType<ModuleOp>();
+    auto id = LLVM::NVIDIA::getThreadIdInWarpGroup(loc, rewriter, mod);
+
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
     int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
     Value warpID = udiv(id, i32_val(warpSize));
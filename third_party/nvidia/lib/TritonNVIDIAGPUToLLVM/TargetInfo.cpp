@@ -135,6 +135,13 @@ Value TargetInfo::getClusterCTAId(RewriterBase &rewriter, Location loc) const {
                                                         rewriter.getI32Type());
 }
 
+void TargetInfo::barrierCluster(RewriterBase &rewriter, Location loc) const {
+  // The non-relaxed arrive has release semantics and the wait has acquire
+  // semantics at cluster scope.
+  rewriter.create<triton::nvgpu::ClusterArriveOp>(loc, /*relaxed=*/false);
+  rewriter.create<triton::nvgpu::ClusterWaitOp>(loc);
+}
+
 Value TargetInfo::ballot(RewriterBase &rewriter, Location loc, Type type,
                          Value cmp) const {
   Value threadMask = int_val(type.getIntOrFloatBitWidth(), -1);
@@ -265,7 +272,7 @@ void TargetInfo::storeDShared(RewriterBase &rewriter, Location loc, Value ptr,
 
   PTXBuilder builder;
   auto st = builder.create<>("st")
-                ->o("shared::cta", ctaId.has_value())
+                ->o("shared::cluster", ctaId.has_value())
                 .o("shared", !ctaId.has_value())
                 .v(vec, /*predicate=*/vec > 1)
                 .b(elemBitwidth);
@@ -378,13 +385,14 @@ Value TargetInfo::loadDShared(RewriterBase &rewriter, Location loc, Value ptr,
 
   PTXBuilder builder;
   auto ld = builder.create<>("ld")
-                ->o("shared::cta", ctaId.has_value())
+                ->o("shared::cluster", ctaId.has_value())
                 .o("shared", !ctaId.has_value())
                 .v(vec, /*predicate=*/vec > 1)
                 .b(elemBitwidth);
 
   Value load;
-  if (isConstantTruePred(pred)) {
+  // A remote address returned by mapa is only accessible through PTX.
+  if (isConstantTruePred(pred) && !ctaId.has_value()) {
     Type resultTy = vec == 1 ? Type(int_ty(elemBitwidth))
                              : Type(vec_ty(int_ty(elemBitwidth), vec));
     load = load(resultTy, ptr);
@@ -91,6 +91,11 @@ struct ConvertTritonGPUToLLVM
     int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
     int numCTAs = triton::gpu::TritonGPUDialect::getNumCTAs(mod);
     int threadsPerWarp = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    // Warp-specialized kernels launch one group of num-warps warps per
+    // partition.
+    if (auto attr = mod->getAttrOfType<IntegerAttr>(
+            "triton_gpu.num-warp-groups-per-cta"))
+      numWarps *= attr.getInt();
 
     // Allocate shared memory and set barrier
     ModuleAllocation allocation(mod);
@@ -142,9 +147,14 @@ struct ConvertTritonGPUToLLVM
                                                  targetInfo, benefit);
     mlir::triton::populateScanOpToLLVMPatterns(typeConverter, patterns,
                                                targetInfo, benefit);
+    mlir::triton::populateSortOpToLLVMPatterns(typeConverter, patterns,
+                                               targetInfo, benefit);
+    mlir::triton::populateGatherOpToLLVMPatterns(typeConverter, patterns,
+                                                 targetInfo, benefit);
     populateBarrierOpToLLVMPatterns(typeConverter, patterns, benefit);
     populateTensorPtrOpsToLLVMPatterns(typeConverter, patterns, benefit);
     populateClusterOpsToLLVMPatterns(typeConverter, patterns, benefit);
+    populateWarpGroupOpsToLLVMPatterns(typeConverter, patterns, benefit);
     mlir::triton::populateHistogramOpToLLVMPatterns(typeConverter, patterns,
                                                     targetInfo, benefit);
     mlir::triton::populatePrintOpToLLVMPattern(typeConverter, patterns,
@@ -174,8 +184,12 @@ struct ConvertTritonGPUToLLVM
                                                    patterns, benefit);
     mlir::triton::NVIDIA::populateUpcastMXFPToLLVMPatterns(
         typeConverter, patterns, targetInfo, benefit);
-    if (failed(applyPartialConversion(mod, convTarget, std::move(patterns))))
-      return signalPassFailure();
+    {
+      // Share index computations across all patterns of a function.
+      IndexCache indexCache;
+      if (failed(applyPartialConversion(mod, convTarget, std::move(patterns))))
+        return signalPassFailure();
+    }
 
     // Fold CTAId when there is only 1 CTA.
     if (numCTAs == 1) {
@@ -252,9 +266,11 @@ bool NVIDIA::canSkipBarSync(Operation *before, Operation *after) {
   // valid for them to happen in different order on different threads, therefore
   // we don't need a barrier between those operations.
   if (isa<triton::nvidia_gpu::WaitBarrierOp,
+          triton::nvidia_gpu::ArriveBarrierOp,
           triton::nvidia_gpu::AsyncTMACopyGlobalToLocalOp,
           triton::nvidia_gpu::BarrierExpectOp>(before) &&
       isa<triton::nvidia_gpu::WaitBarrierOp,
+          triton::nvidia_gpu::ArriveBarrierOp,
           triton::nvidia_gpu::AsyncTMACopyGlobalToLocalOp,
           triton::nvidia_gpu::BarrierExpectOp>(after))
     return true;
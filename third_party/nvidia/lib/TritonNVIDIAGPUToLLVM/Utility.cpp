@@ -110,6 +110,16 @@ Value createElectPredicate(Location loc, RewriterBase &rewriter) {
   return ptxBuilder.launch(rewriter, loc, i1_ty, /*hasSideEffect=*/false);
 }
 
+Value getThreadIdInWarpGroup(Location loc, RewriterBase &rewriter,
+                             ModuleOp moduleOp) {
+  Value tid = getThreadId(rewriter, loc);
+  if (!moduleOp->hasAttr("triton_gpu.num-warp-groups-per-cta"))
+    return tid;
+  int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(moduleOp);
+  int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(moduleOp);
+  return urem(tid, i32_val(numWarps * warpSize));
+}
+
 } // namespace NVIDIA
 } // namespace LLVM
 } // namespace mlir
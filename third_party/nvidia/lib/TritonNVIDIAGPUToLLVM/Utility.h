@@ -48,6 +48,12 @@ Value llGetPid(Location loc, RewriterBase &rewriter, ModuleOp moduleOp,
 /// Create a predicate with just single active thread.
 Value createElectPredicate(Location loc, RewriterBase &rewriter);
 
+/// Thread id relative to the first thread of its warp group. This is the
+/// thread id unless the kernel was warp-specialized into several groups of
+/// num-warps warps.
+Value getThreadIdInWarpGroup(Location loc, RewriterBase &rewriter,
+                             ModuleOp moduleOp);
+
 } // namespace NVIDIA
 } // namespace LLVM
 
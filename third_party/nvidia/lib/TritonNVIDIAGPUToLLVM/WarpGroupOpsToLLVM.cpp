@@ -0,0 +1,67 @@
+#include "PatternTritonGPUOpToLLVM.h"
+#include "TritonNVIDIAGPUToLLVM/PTXAsmFormat.h"
+#include "Utility.h"
+#include "mlir/Conversion/LLVMCommon/Pattern.h"
+#include "triton/Conversion/TritonGPUToLLVM/Utility.h"
+#include "triton/Dialect/TritonNvidiaGPU/IR/Dialect.h"
+
+using namespace mlir;
+using namespace mlir::triton;
+
+namespace {
+struct GetWarpGroupIdOpConversion
+    : public ConvertOpToLLVMPattern<triton::nvidia_gpu::GetWarpGroupIdOp> {
+  using ConvertOpToLLVMPattern::ConvertOpToLLVMPattern;
+
+  LogicalResult
+  matchAndRewrite(triton::nvidia_gpu::GetWarpGroupIdOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    Location loc = op->getLoc();
+    auto mod = op->getParentOfType<ModuleOp>();
+    int numWarps = triton::gpu::TritonGPUDialect::getNumWarps(mod);
+    int warpSize = triton::gpu::TritonGPUDialect::getThreadsPerWarp(mod);
+    Value warpGroupId =
+        udiv(getThreadId(rewriter, loc), i32_val(numWarps * warpSize));
+    // The id is uniform across the warp; make it so for the compiler too.
+    warpGroupId = LLVM::NVIDIA::shuffleIdx(loc, rewriter, warpGroupId, 0);
+    rewriter.replaceOp(op, warpGroupId);
+    return success();
+  }
+};
+
+template <typename OpTy>
+struct SetMaxNRegOpConversion : public ConvertOpToLLVMPattern<OpTy> {
+  SetMaxNRegOpConversion(LLVMTypeConverter &typeConverter,
+                         StringRef direction, PatternBenefit benefit)
+      : ConvertOpToLLVMPattern<OpTy>(typeConverter, benefit),
+        direction(direction) {}
+
+  LogicalResult
+  matchAndRewrite(OpTy op, typename OpTy::Adaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    ::mlir::triton::PTXBuilder ptxBuilder;
+    const std::string ptx = "setmaxnreg." + direction.str() +
+                            ".sync.aligned.u32 " +
+                            std::to_string(op.getRegCount()) + ";";
+    auto &setMaxNReg = *ptxBuilder.create<>(ptx);
+    setMaxNReg({}, /*onlyAttachMLIRArgs=*/true);
+    auto voidTy = void_ty(op->getContext());
+    ptxBuilder.launch(rewriter, op->getLoc(), voidTy);
+    rewriter.eraseOp(op);
+    return success();
+  }
+
+private:
+  StringRef direction;
+};
+} // namespace
+
+void mlir::triton::NVIDIA::populateWarpGroupOpsToLLVMPatterns(
+    LLVMTypeConverter &typeConverter, RewritePatternSet &patterns,
+    PatternBenefit benefit) {
+  patterns.add<GetWarpGroupIdOpConversion>(typeConverter, benefit);
+  patterns.add<SetMaxNRegOpConversion<triton::nvidia_gpu::RegAllocOp>>(
+      typeConverter, "inc", benefit);
+  patterns.add<SetMaxNRegOpConversion<triton::nvidia_gpu::RegDeallocOp>>(
+      typeConverter, "dec", benefit);
+}
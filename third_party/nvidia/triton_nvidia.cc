@@ -33,6 +33,8 @@ void init_triton_nvidia_passes_ttnvgpuir(py::module &&m) {
                      mlir::createTritonNvidiaGPUFenceInsertionPass);
   ADD_PASS_WRAPPER_0("add_tma_lowering",
                      mlir::createTritonNvidiaGPUTMALoweringPass);
+  ADD_PASS_WRAPPER_1("add_warp_specialize",
+                     mlir::createTritonNvidiaGPUWarpSpecializePass, int);
   ADD_PASS_WRAPPER_0("add_nvgpu_to_llvm",
                      mlir::triton::createConvertNVGPUToLLVMPass);
 }